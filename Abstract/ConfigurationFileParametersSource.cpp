@@ -3,7 +3,7 @@ ConfigurationFileParametersSource - Class for parameter sources reading
 from a configuration file section.
 Part of the abstract interface to the templatized visualization
 components.
-Copyright (c) 2010-2013 Oliver Kreylos
+Copyright (c) 2010-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -41,6 +41,11 @@ ConfigurationFileParametersSource::ConfigurationFileParametersSource(VariableMan
 	{
 	}
 
+bool ConfigurationFileParametersSource::hasValue(const char* name) const
+	{
+	return cfg.hasTag(name);
+	}
+
 void ConfigurationFileParametersSource::read(const char* name,const ReaderBase& value)
 	{
 	/* Retrieve the named string from the configuration file section: */
@@ -3,7 +3,7 @@ FileParametersSource - Class for parameter sources reading from text
 files.
 Part of the abstract interface to the templatized visualization
 components.
-Copyright (c) 2010 Oliver Kreylos
+Copyright (c) 2010-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -63,6 +63,11 @@ FileParametersSource::FileParametersSource(VariableManager* sVariableManager,IO:
 		Misc::throwStdErr("FileParameterSource::FileParameterSource: Missing closing brace in input file");
 	}
 
+bool FileParametersSource::hasValue(const char* name) const
+	{
+	return tagValueMap.isEntry(name);
+	}
+
 void FileParametersSource::read(const char* name,const ReaderBase& value)
 	{
 	/* Retrieve the named string from the tag/value map: */
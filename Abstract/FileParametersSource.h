@@ -3,7 +3,7 @@ FileParametersSource - Class for parameter sources reading from text
 files.
 Part of the abstract interface to the templatized visualization
 components.
-Copyright (c) 2010 Oliver Kreylos
+Copyright (c) 2010-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -57,6 +57,7 @@ class FileParametersSource:public ParametersSource
 	FileParametersSource(VariableManager* sVariableManager,IO::ValueSource& sSource);
 	
 	/* Methods from ParametersSource: */
+	virtual bool hasValue(const char* name) const;
 	virtual void read(const char* name,const ReaderBase& value);
 	virtual void readScalarVariable(const char* name,int& scalarVariableIndex);
 	virtual void readVectorVariable(const char* name,int& vectorVariableIndex);
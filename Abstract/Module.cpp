@@ -4,7 +4,7 @@ types and algorithms. A module corresponds to a dynamically-linkable
 unit of functionality in a 3D visualization application.
 Part of the abstract interface to the templatized visualization
 components.
-Copyright (c) 2005-2011 Oliver Kreylos
+Copyright (c) 2005-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -26,11 +26,21 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Abstract/Module.h>
 
 #include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdexcept>
+#include <Misc/SizedTypes.h>
 #include <Misc/ThrowStdErr.h>
+#include <Misc/Endianness.h>
 #include <IO/OpenFile.h>
 #include <Cluster/MulticastPipe.h>
 #include <Cluster/OpenFile.h>
 
+#include <Abstract/DataSet.h>
+
 namespace Visualization {
 
 namespace Abstract {
@@ -39,6 +49,119 @@ namespace Abstract {
 Methods of class Module:
 ***********************/
 
+namespace {
+
+/****************
+Helper functions:
+****************/
+
+const char cacheFileMagic[]="Visualizer data set cache file v1.0\n";
+
+void writeCacheString(IO::File& file,const std::string& string)
+	{
+	file.write<Misc::UInt32>(Misc::UInt32(string.size()));
+	file.write<char>(string.data(),string.size());
+	}
+
+std::string readCacheString(IO::File& file)
+	{
+	Misc::UInt32 length=file.read<Misc::UInt32>();
+	std::string result(length,'\0');
+	if(length>0)
+		file.read<char>(&result[0],length);
+	return result;
+	}
+
+bool readSourceFileStamps(IO::File& file,std::vector<std::string>& sourceFiles)
+	{
+	/* Check that none of the source files changed since the stamps were written: */
+	Misc::UInt32 numSourceFiles=file.read<Misc::UInt32>();
+	for(Misc::UInt32 i=0;i<numSourceFiles;++i)
+		{
+		std::string sourceFileName=readCacheString(file);
+		Misc::UInt64 size=file.read<Misc::UInt64>();
+		Misc::SInt64 modificationTime=file.read<Misc::SInt64>();
+		struct stat sourceFileStat;
+		if(stat(sourceFileName.c_str(),&sourceFileStat)!=0||Misc::UInt64(sourceFileStat.st_size)!=size||Misc::SInt64(sourceFileStat.st_mtime)!=modificationTime)
+			return false;
+		sourceFiles.push_back(sourceFileName);
+		}
+	
+	return true;
+	}
+
+}
+
+void Module::recordSourceFile(const std::string& fullPath) const
+	{
+	Threads::Mutex::Lock sourceFileNamesLock(sourceFileNamesMutex);
+	sourceFileNames.push_back(fullPath);
+	}
+
+std::string Module::getCacheFileName(const std::string& key) const
+	{
+	/* Name the file after a 64-bit FNV-1a hash of the key; the key itself is stored in the file to resolve collisions: */
+	unsigned long long hash=0xcbf29ce484222325ULL;
+	for(std::string::const_iterator kIt=key.begin();kIt!=key.end();++kIt)
+		{
+		hash^=(unsigned long long)(unsigned char)(*kIt);
+		hash*=0x100000001b3ULL;
+		}
+	char hashName[32];
+	snprintf(hashName,sizeof(hashName),"%016llx.dsc",hash);
+	return cacheDirectory+"/"+hashName;
+	}
+
+bool Module::checkCacheFileHeader(IO::File& cacheFile,const std::string& key,std::vector<std::string>& sourceFiles) const
+	{
+	/* Check the file format and the data set key: */
+	char magic[sizeof(cacheFileMagic)-1];
+	cacheFile.read<char>(magic,sizeof(magic));
+	if(memcmp(magic,cacheFileMagic,sizeof(magic))!=0)
+		return false;
+	if(readCacheString(cacheFile)!=key)
+		return false;
+	
+	/* Check that none of the data set's source files changed since the cache file was written: */
+	return readSourceFileStamps(cacheFile,sourceFiles);
+	}
+
+void Module::writeCacheFile(const std::string& key,const std::vector<std::string>& args,const DataSet* dataSet) const
+	{
+	/* Write the data set to a temporary file and move it into place, so that concurrent readers never see partial files: */
+	std::string cacheFileName=getCacheFileName(key);
+	char tempSuffix[32];
+	snprintf(tempSuffix,sizeof(tempSuffix),".%d",int(getpid()));
+	std::string tempFileName=cacheFileName+tempSuffix;
+	try
+		{
+		bool cached;
+			{
+			IO::FilePtr cacheFile(IO::openFile(tempFileName.c_str(),IO::File::WriteOnly));
+			cacheFile->setEndianness(Misc::LittleEndian);
+			
+			/* Write the file header: */
+			cacheFile->write<char>(cacheFileMagic,sizeof(cacheFileMagic)-1);
+			writeCacheString(*cacheFile,key);
+			
+			/* Write the sizes and modification times of all source files to detect stale cache files: */
+			writeSourceFileStamps(*cacheFile);
+			
+			/* Write the data set: */
+			cached=writeDataSetCache(args,dataSet,*cacheFile);
+			}
+		if(cached)
+			rename(tempFileName.c_str(),cacheFileName.c_str());
+		else
+			remove(tempFileName.c_str());
+		}
+	catch(std::runtime_error)
+		{
+		/* The data set cache is best-effort; ignore write errors: */
+		remove(tempFileName.c_str());
+		}
+	}
+
 std::string Module::makeVectorSliceName(std::string vectorName,int sliceIndex)
 	{
 	std::string result=vectorName;
@@ -74,23 +197,78 @@ std::string Module::getFullPath(std::string fileName) const
 IO::FilePtr Module::openFile(std::string fileName,Cluster::MulticastPipe* pipe) const
 	{
 	if(pipe!=0)
-		return Cluster::openFile(pipe->getMultiplexer(),getFullPath(fileName).c_str());
+		{
+		/* Only the master node reads the file directly: */
+		std::string fullPath=getFullPath(fileName);
+		IO::FilePtr result=Cluster::openFile(pipe->getMultiplexer(),fullPath.c_str());
+		if(pipe->isMaster())
+			recordSourceFile(fullPath);
+		return result;
+		}
 	else
-		return IO::openFile(getFullPath(fileName).c_str());
+		{
+		std::string fullPath=getFullPath(fileName);
+		IO::FilePtr result=IO::openFile(fullPath.c_str());
+		recordSourceFile(fullPath);
+		return result;
+		}
 	}
 
 IO::SeekableFilePtr Module::openSeekableFile(std::string fileName,Cluster::MulticastPipe* pipe) const
 	{
 	if(pipe!=0)
-		return Cluster::openSeekableFile(pipe->getMultiplexer(),getFullPath(fileName).c_str());
+		{
+		/* Only the master node reads the file directly: */
+		std::string fullPath=getFullPath(fileName);
+		IO::SeekableFilePtr result=Cluster::openSeekableFile(pipe->getMultiplexer(),fullPath.c_str());
+		if(pipe->isMaster())
+			recordSourceFile(fullPath);
+		return result;
+		}
 	else
-		return IO::openSeekableFile(getFullPath(fileName).c_str());
+		{
+		std::string fullPath=getFullPath(fileName);
+		IO::SeekableFilePtr result=IO::openSeekableFile(fullPath.c_str());
+		recordSourceFile(fullPath);
+		return result;
+		}
+	}
+
+void Module::checkFileSize(std::string fileName,Misc::UInt64 minSize) const
+	{
+	/* Skip compressed files, which are decompressed transparently when opened: */
+	std::string fullPath=getFullPath(fileName);
+	if(fullPath.size()>=3&&strcasecmp(fullPath.c_str()+fullPath.size()-3,".gz")==0)
+		return;
+	
+	/* Check the file's size; files that cannot be accessed are reported when they are opened: */
+	struct stat fileStat;
+	if(stat(fullPath.c_str(),&fileStat)==0&&Misc::UInt64(fileStat.st_size)<minSize)
+		Misc::throwStdErr("Module::checkFileSize: File %s is truncated; expected at least %llu bytes, found %llu bytes",fullPath.c_str(),(unsigned long long)minSize,(unsigned long long)fileStat.st_size);
+	}
+
+bool Module::writeDataSetCache(const std::vector<std::string>& args,const DataSet* dataSet,IO::File& cacheFile) const
+	{
+	return false;
+	}
+
+void Module::loadDeferredData(const DataSet* dataSet) const
+	{
+	}
+
+DataSet* Module::readDataSetCache(const std::vector<std::string>& args,IO::File& cacheFile) const
+	{
+	return 0;
 	}
 
 Module::Module(const char* sClassName)
 	:Plugins::Factory(sClassName),
 	 baseDirectory("")
 	{
+	/* Enable data set caching if requested by the environment: */
+	const char* cacheDirectoryEnv=getenv("VISUALIZER_DATASETCACHEDIR");
+	if(cacheDirectoryEnv!=0)
+		cacheDirectory=cacheDirectoryEnv;
 	}
 
 Module::~Module(void)
@@ -107,6 +285,78 @@ void Module::setBaseDirectory(std::string newBaseDirectory)
 		baseDirectory.push_back('/');
 	}
 
+void Module::setCacheDirectory(std::string newCacheDirectory)
+	{
+	cacheDirectory=newCacheDirectory;
+	}
+
+DataSet* Module::loadCached(const std::vector<std::string>& args,Cluster::MulticastPipe* pipe) const
+	{
+	/* Start recording the new data set's source files: */
+	{
+	Threads::Mutex::Lock sourceFileNamesLock(sourceFileNamesMutex);
+	sourceFileNames.clear();
+	}
+	
+	/* Bypass the cache if it is disabled, or on clusters where all nodes must read the same input files through multicast pipes: */
+	if(cacheDirectory.empty()||pipe!=0)
+		return load(args,pipe);
+	
+	/* Identify the data set by its module class, base directory, and arguments: */
+	std::string key=getClassName();
+	key.push_back('\0');
+	key.append(baseDirectory);
+	for(std::vector<std::string>::const_iterator aIt=args.begin();aIt!=args.end();++aIt)
+		{
+		key.push_back('\0');
+		key.append(*aIt);
+		}
+	
+	/* Try recreating the data set from an up-to-date cache file: */
+	try
+		{
+		IO::FilePtr cacheFile(IO::openFile(getCacheFileName(key).c_str()));
+		cacheFile->setEndianness(Misc::LittleEndian);
+		std::vector<std::string> cachedSourceFiles;
+		if(checkCacheFileHeader(*cacheFile,key,cachedSourceFiles))
+			{
+			DataSet* result=readDataSetCache(args,*cacheFile);
+			if(result!=0)
+				{
+				/* The data set's source files are the ones listed in the cache file: */
+				Threads::Mutex::Lock sourceFileNamesLock(sourceFileNamesMutex);
+				sourceFileNames=cachedSourceFiles;
+				return result;
+				}
+			}
+		}
+	catch(std::runtime_error)
+		{
+		/* Treat missing, stale, or truncated cache files as cache misses: */
+		}
+	
+	/* Load the data set from its source files while recording their names: */
+	DataSet* result=load(args,pipe);
+	
+	/* Read the parts of the data set that were deferred until first use, so that the cache file is complete and lists all source files: */
+	bool complete=true;
+	try
+		{
+		loadDeferredData(result);
+		}
+	catch(std::runtime_error)
+		{
+		/* Leave the error to be reported when the data set's affected parts are first used, and do not cache the data set: */
+		complete=false;
+		}
+	
+	/* Write the data set to its cache file for the next load: */
+	if(complete)
+		writeCacheFile(key,args,result);
+	
+	return result;
+	}
+
 int Module::getNumScalarAlgorithms(void) const
 	{
 	return 0;
@@ -159,6 +409,34 @@ Algorithm* Module::getAlgorithm(const char* algorithmName,VariableManager* varia
 	return 0;
 	}
 
+void Module::writeSourceFileStamps(IO::File& file) const
+	{
+	/* Copy the list of source files, which parallel loaders might extend concurrently: */
+	std::vector<std::string> sourceFiles;
+	{
+	Threads::Mutex::Lock sourceFileNamesLock(sourceFileNamesMutex);
+	sourceFiles=sourceFileNames;
+	}
+	
+	/* Write the sizes and modification times of all source files: */
+	file.write<Misc::UInt32>(Misc::UInt32(sourceFiles.size()));
+	for(std::vector<std::string>::const_iterator sfIt=sourceFiles.begin();sfIt!=sourceFiles.end();++sfIt)
+		{
+		struct stat sourceFileStat;
+		if(stat(sfIt->c_str(),&sourceFileStat)!=0)
+			Misc::throwStdErr("Module::writeSourceFileStamps: Unable to query source file %s",sfIt->c_str());
+		writeCacheString(file,*sfIt);
+		file.write<Misc::UInt64>(Misc::UInt64(sourceFileStat.st_size));
+		file.write<Misc::SInt64>(Misc::SInt64(sourceFileStat.st_mtime));
+		}
+	}
+
+bool Module::checkSourceFileStamps(IO::File& file)
+	{
+	std::vector<std::string> sourceFiles;
+	return readSourceFileStamps(file,sourceFiles);
+	}
+
 }
 
 }
@@ -4,7 +4,7 @@ types and algorithms. A module corresponds to a dynamically-linkable
 unit of functionality in a 3D visualization application.
 Part of the abstract interface to the templatized visualization
 components.
-Copyright (c) 2005-2011 Oliver Kreylos
+Copyright (c) 2005-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -28,6 +28,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <string>
 #include <vector>
+#include <Misc/SizedTypes.h>
+#include <Threads/Mutex.h>
 #include <Plugins/Factory.h>
 #include <IO/File.h>
 #include <IO/SeekableFile.h>
@@ -57,6 +59,15 @@ class Module:public Plugins::Factory
 	/* Elements: */
 	private:
 	std::string baseDirectory; // Base directory for all input files
+	std::string cacheDirectory; // Directory holding binary data set cache files, or empty to disable data set caching
+	mutable Threads::Mutex sourceFileNamesMutex; // Mutex serializing access to the source file name list from parallel loaders
+	mutable std::vector<std::string> sourceFileNames; // List recording the full path names of all files opened for the most recently loaded data set, including files read on first use
+	
+	/* Private methods: */
+	void recordSourceFile(const std::string& fullPath) const; // Records the given file as a source file of the data set currently being loaded
+	std::string getCacheFileName(const std::string& key) const; // Returns the name of the data set cache file for the given data set key
+	bool checkCacheFileHeader(IO::File& cacheFile,const std::string& key,std::vector<std::string>& sourceFiles) const; // Returns true if the given cache file was written for the given data set key and its source files are unchanged; returns the source files' names
+	void writeCacheFile(const std::string& key,const std::vector<std::string>& args,const DataSet* dataSet) const; // Writes the given freshly loaded data set to its cache file
 	
 	/* Protected methods: */
 	protected:
@@ -64,6 +75,10 @@ class Module:public Plugins::Factory
 	std::string getFullPath(std::string fileName) const; // Returns the full path name of the given file relative to the base directory
 	IO::FilePtr openFile(std::string fileName,Cluster::MulticastPipe* pipe) const; // Opens the given file relative to the base directory
 	IO::SeekableFilePtr openSeekableFile(std::string fileName,Cluster::MulticastPipe* pipe) const; // Ditto, for seekable files
+	void checkFileSize(std::string fileName,Misc::UInt64 minSize) const; // Throws an exception if the given uncompressed file relative to the base directory is shorter than the given number of bytes
+	virtual bool writeDataSetCache(const std::vector<std::string>& args,const DataSet* dataSet,IO::File& cacheFile) const; // Writes the given data set, loaded from the given arguments, to the given cache file; returns false if the data set cannot be cached
+	virtual void loadDeferredData(const DataSet* dataSet) const; // Reads all parts of the given freshly loaded data set whose reading was deferred until first use
+	virtual DataSet* readDataSetCache(const std::vector<std::string>& args,IO::File& cacheFile) const; // Recreates a data set for the given arguments from the given cache file; returns null if the module does not support data set caching
 	
 	/* Constructors and destructors: */
 	public:
@@ -76,7 +91,9 @@ class Module:public Plugins::Factory
 	
 	/* Methods: */
 	void setBaseDirectory(std::string newBaseDirectory); // Sets the base directory for all following file operations
+	void setCacheDirectory(std::string newCacheDirectory); // Sets the directory holding data set cache files; empty string disables data set caching
 	virtual DataSet* load(const std::vector<std::string>& args,Cluster::MulticastPipe* pipe) const =0; // Loads a data set from the given list of arguments
+	DataSet* loadCached(const std::vector<std::string>& args,Cluster::MulticastPipe* pipe) const; // Loads a data set from the given list of arguments through the data set cache, if enabled
 	virtual DataSetRenderer* getRenderer(const DataSet* dataSet) const =0; // Creates a renderer for the given data set
 	virtual int getNumScalarAlgorithms(void) const; // Returns number of available visualization algorithms
 	virtual const char* getScalarAlgorithmName(int scalarAlgorithmIndex) const; // Returns the name of the given algorithm
@@ -85,6 +102,8 @@ class Module:public Plugins::Factory
 	virtual const char* getVectorAlgorithmName(int vectorAlgorithmIndex) const; // Returns the name of the given algorithm
 	virtual Algorithm* getVectorAlgorithm(int vectorAlgorithmIndex,VariableManager* variableManager,Cluster::MulticastPipe* pipe) const; // Returns the given visualization algorithm
 	Algorithm* getAlgorithm(const char* algorithmName,VariableManager* variableManager,Cluster::MulticastPipe* pipe) const; // Convenience function to retrieve a scalar or vector algorithm by name
+	void writeSourceFileStamps(IO::File& file) const; // Writes the names, sizes, and modification times of the most recently loaded data set's source files read so far to the given file
+	static bool checkSourceFileStamps(IO::File& file); // Reads source file stamps written by writeSourceFileStamps from the given file; returns true if none of the source files changed since
 	};
 
 }
@@ -1,7 +1,7 @@
 /***********************************************************************
 VariableManager - Helper class to manage the scalar and vector variables
 that can be extracted from a data set.
-Copyright (c) 2008-2013 Oliver Kreylos
+Copyright (c) 2008-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -25,6 +25,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <string.h>
 #include <stdio.h>
 #include <stdexcept>
+#include <iostream>
+#include <Misc/ThrowStdErr.h>
 #include <Misc/CreateNumberedFileName.h>
 #include <GL/gl.h>
 #include <GL/GLContextData.h>
@@ -95,11 +97,22 @@ void VariableManager::prepareScalarVariable(int scalarVariableIndex)
 	{
 	ScalarVariable& sv=scalarVariables[scalarVariableIndex];
 	
-	/* Get a new scalar extractor: */
-	sv.scalarExtractor=dataSet->getScalarExtractor(scalarVariableIndex);
-	
-	/* Calculate the scalar extractor's value range: */
-	sv.valueRange=dataSet->calcScalarValueRange(sv.scalarExtractor);
+	try
+		{
+		/* Get a new scalar extractor, which reads the variable's values if they were deferred until first use: */
+		sv.scalarExtractor=dataSet->getScalarExtractor(scalarVariableIndex);
+		
+		/* Calculate the scalar extractor's value range: */
+		sv.valueRange=dataSet->calcScalarValueRange(sv.scalarExtractor);
+		}
+	catch(const std::exception& err)
+		{
+		/* Report the error and leave the scalar variable without an extractor: */
+		std::cerr<<"Caught exception "<<err.what()<<" while reading scalar variable "<<dataSet->getScalarVariableName(scalarVariableIndex)<<std::endl;
+		delete sv.scalarExtractor;
+		sv.scalarExtractor=0;
+		sv.valueRange=DataSet::VScalarRange(0,0);
+		}
 	
 	/* Check for and correct an empty value range: */
 	if(sv.valueRange.first==sv.valueRange.second)
@@ -116,6 +129,22 @@ void VariableManager::prepareScalarVariable(int scalarVariableIndex)
 	sv.colorMapRange=sv.valueRange;
 	}
 
+void VariableManager::prepareVectorVariable(int vectorVariableIndex)
+	{
+	try
+		{
+		/* Get a new vector extractor, which reads the variable's values if they were deferred until first use: */
+		vectorExtractors[vectorVariableIndex]=dataSet->getVectorExtractor(vectorVariableIndex);
+		}
+	catch(const std::exception& err)
+		{
+		/* Report the error and leave the vector variable without an extractor: */
+		std::cerr<<"Caught exception "<<err.what()<<" while reading vector variable "<<dataSet->getVectorVariableName(vectorVariableIndex)<<std::endl;
+		vectorExtractors[vectorVariableIndex]=0;
+		vectorVariablesFailed[vectorVariableIndex]=true;
+		}
+	}
+
 void VariableManager::colorMapChangedCallback(Misc::CallbackData* cbData)
 	{
 	/* Export the changed palette to the current color map: */
@@ -148,7 +177,7 @@ VariableManager::VariableManager(const DataSet* sDataSet,const char* sDefaultCol
 	 scalarVariables(0),
 	 colorBarDialogPopup(0),colorBar(0),
 	 paletteEditor(0),
-	 vectorExtractors(0),
+	 vectorExtractors(0),vectorVariablesFailed(0),
 	 currentScalarVariableIndex(-1),currentVectorVariableIndex(-1)
 	{
 	if(sDefaultColorMapName!=0)
@@ -183,8 +212,12 @@ VariableManager::VariableManager(const DataSet* sDataSet,const char* sDefaultCol
 	if(numVectorVariables>0)
 		{
 		vectorExtractors=new VectorExtractor*[numVectorVariables];
+		vectorVariablesFailed=new bool[numVectorVariables];
 		for(int i=0;i<numVectorVariables;++i)
+			{
 			vectorExtractors[i]=0;
+			vectorVariablesFailed[i]=false;
+			}
 		}
 	
 	/* Initialize the current variable state: */
@@ -204,6 +237,7 @@ VariableManager::~VariableManager(void)
 		for(int i=0;i<numVectorVariables;++i)
 			delete vectorExtractors[i];
 		delete[] vectorExtractors;
+		delete[] vectorVariablesFailed;
 		}
 	
 	delete colorBarDialogPopup;
@@ -258,7 +292,7 @@ void VariableManager::setCurrentScalarVariable(int newCurrentScalarVariableIndex
 	
 	/* Check if the scalar variable has not been requested before: */
 	ScalarVariable& sv=scalarVariables[newCurrentScalarVariableIndex];
-	if(sv.scalarExtractor==0)
+	if(sv.colorMap==0)
 		prepareScalarVariable(newCurrentScalarVariableIndex);
 	
 	/* Save the palette editor's current palette: */
@@ -315,8 +349,8 @@ void VariableManager::setCurrentVectorVariable(int newCurrentVectorVariableIndex
 		return;
 	
 	/* Check if the vector variable has not been requested before: */
-	if(vectorExtractors[newCurrentVectorVariableIndex]==0)
-		vectorExtractors[newCurrentVectorVariableIndex]=dataSet->getVectorExtractor(newCurrentVectorVariableIndex);
+	if(vectorExtractors[newCurrentVectorVariableIndex]==0&&!vectorVariablesFailed[newCurrentVectorVariableIndex])
+		prepareVectorVariable(newCurrentVectorVariableIndex);
 	
 	/* Update the current vector variable: */
 	currentVectorVariableIndex=newCurrentVectorVariableIndex;
@@ -328,9 +362,13 @@ const ScalarExtractor* VariableManager::getScalarExtractor(int scalarVariableInd
 		return 0;
 	
 	/* Check if the scalar variable has not been requested before: */
-	if(scalarVariables[scalarVariableIndex].scalarExtractor==0)
+	if(scalarVariables[scalarVariableIndex].colorMap==0)
 		prepareScalarVariable(scalarVariableIndex);
 	
+	/* Refuse to hand out an extractor for a variable whose values could not be read: */
+	if(scalarVariables[scalarVariableIndex].scalarExtractor==0)
+		Misc::throwStdErr("VariableManager::getScalarExtractor: Values of scalar variable %s could not be read",dataSet->getScalarVariableName(scalarVariableIndex));
+	
 	return scalarVariables[scalarVariableIndex].scalarExtractor;
 	}
 
@@ -350,7 +388,7 @@ const DataSet::VScalarRange& VariableManager::getScalarValueRange(int scalarVari
 		return scalarVariables[currentScalarVariableIndex].valueRange;
 	
 	/* Check if the scalar variable has not been requested before: */
-	if(scalarVariables[scalarVariableIndex].scalarExtractor==0)
+	if(scalarVariables[scalarVariableIndex].colorMap==0)
 		prepareScalarVariable(scalarVariableIndex);
 	
 	return scalarVariables[scalarVariableIndex].valueRange;
@@ -362,7 +400,7 @@ const GLColorMap* VariableManager::getColorMap(int scalarVariableIndex)
 		return 0;
 	
 	/* Check if the scalar variable has not been requested before: */
-	if(scalarVariables[scalarVariableIndex].scalarExtractor==0)
+	if(scalarVariables[scalarVariableIndex].colorMap==0)
 		prepareScalarVariable(scalarVariableIndex);
 	
 	return scalarVariables[scalarVariableIndex].colorMap;
@@ -374,7 +412,7 @@ const DataSet::VScalarRange& VariableManager::getScalarColorMapRange(int scalarV
 		return scalarVariables[currentScalarVariableIndex].colorMapRange;
 	
 	/* Check if the scalar variable has not been requested before: */
-	if(scalarVariables[scalarVariableIndex].scalarExtractor==0)
+	if(scalarVariables[scalarVariableIndex].colorMap==0)
 		prepareScalarVariable(scalarVariableIndex);
 	
 	return scalarVariables[scalarVariableIndex].colorMapRange;
@@ -386,8 +424,12 @@ const VectorExtractor* VariableManager::getVectorExtractor(int vectorVariableInd
 		return 0;
 	
 	/* Check if the vector variable has not been requested before: */
-	if(vectorExtractors[vectorVariableIndex]==0)
-		vectorExtractors[vectorVariableIndex]=dataSet->getVectorExtractor(vectorVariableIndex);
+	if(vectorExtractors[vectorVariableIndex]==0&&!vectorVariablesFailed[vectorVariableIndex])
+		prepareVectorVariable(vectorVariableIndex);
+	
+	/* Refuse to hand out an extractor for a variable whose values could not be read: */
+	if(vectorVariablesFailed[vectorVariableIndex])
+		Misc::throwStdErr("VariableManager::getVectorExtractor: Values of vector variable %s could not be read",dataSet->getVectorVariableName(vectorVariableIndex));
 	
 	return vectorExtractors[vectorVariableIndex];
 	}
@@ -402,6 +444,24 @@ int VariableManager::getVectorVariable(const VectorExtractor* vectorExtractor) c
 	return -1;
 	}
 
+const ScalarExtractor* VariableManager::getCurrentScalarExtractor(void) const
+	{
+	/* Refuse to hand out an extractor for a variable whose values could not be read: */
+	if(scalarVariables[currentScalarVariableIndex].scalarExtractor==0)
+		Misc::throwStdErr("VariableManager::getCurrentScalarExtractor: Values of scalar variable %s could not be read",dataSet->getScalarVariableName(currentScalarVariableIndex));
+	
+	return scalarVariables[currentScalarVariableIndex].scalarExtractor;
+	}
+
+const VectorExtractor* VariableManager::getCurrentVectorExtractor(void) const
+	{
+	/* Refuse to hand out an extractor for a variable whose values could not be read: */
+	if(vectorExtractors[currentVectorVariableIndex]==0)
+		Misc::throwStdErr("VariableManager::getCurrentVectorExtractor: Values of vector variable %s could not be read",dataSet->getVectorVariableName(currentVectorVariableIndex));
+	
+	return vectorExtractors[currentVectorVariableIndex];
+	}
+
 void VariableManager::showColorBar(bool show)
 	{
 	/* Hide or show color bar dialog based on parameter: */
@@ -1,7 +1,7 @@
 /***********************************************************************
 VariableManager - Helper class to manage the scalar and vector variables
 that can be extracted from a data set.
-Copyright (c) 2008-2013 Oliver Kreylos
+Copyright (c) 2008-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -65,9 +65,9 @@ class VariableManager:public GLObject
 		{
 		/* Elements: */
 		public:
-		ScalarExtractor* scalarExtractor; // Scalar extractor for the scalar variable
+		ScalarExtractor* scalarExtractor; // Scalar extractor for the scalar variable, or null if the variable's values could not be read
 		DataSet::VScalarRange valueRange; // Value range of the scalar variable
-		GLColorMap* colorMap; // The color map to render the scalar variable
+		GLColorMap* colorMap; // The color map to render the scalar variable; null until the scalar variable is first requested
 		unsigned int colorMapVersion; // Version number of the color map
 		DataSet::VScalarRange colorMapRange; // Scalar variable range that is mapped to the full extent of the color map
 		PaletteEditor::Storage* palette; // Pointer to palette editor state for the scalar variable
@@ -101,12 +101,14 @@ class VariableManager:public GLObject
 	GLMotif::ColorBar* colorBar; // Widget to display color maps
 	PaletteEditor* paletteEditor; // Editor for color maps
 	int numVectorVariables; // Total number of vector variables
-	VectorExtractor** vectorExtractors; // Array of extractors for the data set's vector variables
+	VectorExtractor** vectorExtractors; // Array of extractors for the data set's vector variables; null until a vector variable is first successfully requested
+	bool* vectorVariablesFailed; // Array of flags for vector variables whose values could not be read
 	int currentScalarVariableIndex; // The index of the currently selected scalar variable
 	int currentVectorVariableIndex; // The index of the currently selected vector variable
 	
 	/* Private methods: */
-	void prepareScalarVariable(int scalarVariableIndex);
+	void prepareScalarVariable(int scalarVariableIndex); // Creates the given scalar variable's extractor and color map; reports errors while reading the variable's values and leaves it without an extractor
+	void prepareVectorVariable(int vectorVariableIndex); // Creates the given vector variable's extractor; reports errors while reading the variable's values and leaves it without an extractor
 	void colorMapChangedCallback(Misc::CallbackData* cbData);
 	void savePaletteCallback(Misc::CallbackData* cbData);
 	
@@ -149,17 +151,14 @@ class VariableManager:public GLObject
 		}
 	void setCurrentScalarVariable(int newCurrentScalarVariable); // Sets the currently selected scalar variable
 	void setCurrentVectorVariable(int newCurrentVectorVariable); // Sets the currently selected vector variable
-	const ScalarExtractor* getScalarExtractor(int scalarVariableIndex); // Returns a new scalar extractor for the given scalar variable
+	const ScalarExtractor* getScalarExtractor(int scalarVariableIndex); // Returns a new scalar extractor for the given scalar variable, or null for an invalid index; throws an exception if the variable's values could not be read
 	int getScalarVariable(const ScalarExtractor* scalarExtractor) const; // Returns the index of the given scalar extractor
 	const DataSet::VScalarRange& getScalarValueRange(int scalarVariableIndex); // Returns the value range of the given scalar variable
 	const GLColorMap* getColorMap(int scalarVariableIndex); // Returns the color map for the given scalar variable
 	const DataSet::VScalarRange& getScalarColorMapRange(int scalarVariableIndex); // Returns the value range of the given scalar variable that is mapped to the full extent of the color map
-	const VectorExtractor* getVectorExtractor(int vectorVariableIndex); // Returns a new vector extractor for the given vector variable
+	const VectorExtractor* getVectorExtractor(int vectorVariableIndex); // Returns a new vector extractor for the given vector variable, or null for an invalid index; throws an exception if the variable's values could not be read
 	int getVectorVariable(const VectorExtractor* vectorExtractor) const; // Returns the index of the given vector extractor
-	const ScalarExtractor* getCurrentScalarExtractor(void) const // Returns the current scalar extractor
-		{
-		return scalarVariables[currentScalarVariableIndex].scalarExtractor;
-		}
+	const ScalarExtractor* getCurrentScalarExtractor(void) const; // Returns the current scalar extractor; throws an exception if the variable's values could not be read
 	const DataSet::VScalarRange& getCurrentScalarValueRange(void) const // Returns the current scalar value range
 		{
 		return scalarVariables[currentScalarVariableIndex].valueRange;
@@ -168,10 +167,7 @@ class VariableManager:public GLObject
 		{
 		return scalarVariables[currentScalarVariableIndex].colorMap;
 		}
-	const VectorExtractor* getCurrentVectorExtractor(void) const // Returns the current vector extractor
-		{
-		return vectorExtractors[currentVectorVariableIndex];
-		}
+	const VectorExtractor* getCurrentVectorExtractor(void) const; // Returns the current vector extractor; throws an exception if the variable's values could not be read
 	void showColorBar(bool show); // Shows or hides the color bar dialog
 	GLMotif::PopupWindow* getColorBarDialog(void) // Returns the color bar dialog
 		{
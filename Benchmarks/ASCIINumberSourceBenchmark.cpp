@@ -0,0 +1,198 @@
+/***********************************************************************
+ASCIINumberSourceBenchmark - Program to compare the parsing throughput
+and results of the block-buffered ASCII number reader and
+IO::ValueSource on synthetic ASCII data files.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <Misc/Timer.h>
+#include <IO/FixedMemoryFile.h>
+#include <IO/ValueSource.h>
+
+#include <Concrete/ASCIINumberSource.h>
+
+namespace {
+
+/****************
+Helper functions:
+****************/
+
+double randomValue(double min,double max)
+	{
+	return min+(max-min)*double(rand())/double(RAND_MAX);
+	}
+
+void createNumbers(int format,size_t numNumbers,int numColumns,std::string& text,std::vector<double>& values) // Writes the given number of values in the given format into a text with the given number of columns per line
+	{
+	text.clear();
+	values.clear();
+	char number[64];
+	for(size_t i=0;i<numNumbers;++i)
+		{
+		switch(format)
+			{
+			case 0: // Integers
+				snprintf(number,sizeof(number),"%d",int(rand()%200001)-100000);
+				break;
+			
+			case 1: // Fixed-point numbers
+				snprintf(number,sizeof(number),"%.6f",randomValue(-1000.0,1000.0));
+				break;
+			
+			case 2: // Exponential notation, as written by CitcomS
+				snprintf(number,sizeof(number),"%.6e",randomValue(-1.0,1.0)*pow(10.0,double(rand()%41-20)));
+				break;
+			
+			default: // Full double precision
+				snprintf(number,sizeof(number),"%.17g",randomValue(-1.0,1.0)*pow(10.0,double(rand()%61-30)));
+			}
+		text.append(number);
+		text.push_back(i%numColumns==numColumns-1?'\n':' ');
+		
+		/* Use the C library's conversion as reference: */
+		values.push_back(strtod(number,0));
+		}
+	}
+
+IO::FilePtr createTextFile(const std::string& text) // Returns a memory file containing the given text
+	{
+	IO::FixedMemoryFile* file=new IO::FixedMemoryFile(text.size());
+	memcpy(file->getMemory(),text.data(),text.size());
+	return IO::FilePtr(file);
+	}
+
+template <class SourceParam>
+size_t readNumbers(SourceParam& source,std::vector<double>& values) // Reads all numbers from the given source and returns the number of values that differ from the reference values
+	{
+	size_t numMismatches=0;
+	size_t index=0;
+	source.skipWs();
+	while(!source.eof())
+		{
+		double value=source.readNumber();
+		if(index>=values.size()||value!=values[index])
+			++numMismatches;
+		++index;
+		}
+	if(index!=values.size())
+		numMismatches+=index<values.size()?values.size()-index:index-values.size();
+	
+	return numMismatches;
+	}
+
+}
+
+int main(int argc,char* argv[])
+	{
+	/* Parse the command line: */
+	size_t numNumbers=3000000;
+	int numColumns=3;
+	int numIterations=5;
+	for(int i=1;i<argc;++i)
+		{
+		if(argv[i][0]=='-')
+			{
+			if(strcasecmp(argv[i]+1,"numbers")==0&&i+1<argc)
+				numNumbers=size_t(atol(argv[++i]));
+			else if(strcasecmp(argv[i]+1,"columns")==0&&i+1<argc)
+				numColumns=atoi(argv[++i]);
+			else if(strcasecmp(argv[i]+1,"iterations")==0&&i+1<argc)
+				numIterations=atoi(argv[++i]);
+			else
+				std::cerr<<"Ignoring unrecognized option "<<argv[i]<<std::endl;
+			}
+		else
+			std::cerr<<"Ignoring command line argument "<<argv[i]<<std::endl;
+		}
+	if(numNumbers==0||numColumns<1||numIterations<1)
+		{
+		std::cerr<<"Usage: "<<argv[0]<<" [-numbers <num numbers>] [-columns <num columns>] [-iterations <num iterations>]"<<std::endl;
+		return 1;
+		}
+	
+	static const char* formatNames[4]={"integer","fixed-point","exponential","full precision"};
+	bool allPassed=true;
+	for(int format=0;format<4;++format)
+		{
+		/* Create the test data: */
+		std::string text;
+		std::vector<double> values;
+		createNumbers(format,numNumbers,numColumns,text,values);
+		double megabytes=double(text.size())/(1024.0*1024.0);
+		std::cout<<"Format "<<formatNames[format]<<": "<<numNumbers<<" numbers, "<<megabytes<<" MB"<<std::endl;
+		
+		/* Measure both readers, keeping the best time of all iterations: */
+		double bestTimes[2]={0.0,0.0};
+		size_t numMismatches[2]={0,0};
+		for(int iteration=0;iteration<numIterations;++iteration)
+			{
+			for(int reader=0;reader<2;++reader)
+				{
+				try
+					{
+					IO::FilePtr file=createTextFile(text);
+					Misc::Timer t;
+					if(reader==0)
+						{
+						IO::ValueSource source(file);
+						numMismatches[reader]=readNumbers(source,values);
+						}
+					else
+						{
+						Visualization::Concrete::ASCIINumberSource source(file);
+						numMismatches[reader]=readNumbers(source,values);
+						}
+					t.elapse();
+					if(iteration==0||bestTimes[reader]>t.getTime())
+						bestTimes[reader]=t.getTime();
+					}
+				catch(std::runtime_error err)
+					{
+					std::cerr<<"Caught exception "<<err.what()<<" while reading "<<formatNames[format]<<" numbers"<<std::endl;
+					numMismatches[reader]=values.size();
+					}
+				}
+			}
+		
+		static const char* readerNames[2]={"IO::ValueSource","ASCIINumberSource"};
+		for(int reader=0;reader<2;++reader)
+			{
+			std::cout<<"  "<<readerNames[reader]<<": "<<bestTimes[reader]*1000.0<<" ms, "<<megabytes/bestTimes[reader]<<" MB/s, "<<double(numNumbers)*1.0e-6/bestTimes[reader]<<" Mnumbers/s";
+			if(numMismatches[reader]==0)
+				std::cout<<", all values match strtod"<<std::endl;
+			else
+				std::cout<<", "<<numMismatches[reader]<<" values differ from strtod"<<std::endl;
+			}
+		std::cout<<"  Speed-up: "<<bestTimes[0]/bestTimes[1]<<std::endl;
+		
+		/* Only the new reader is required to match the C library exactly: */
+		if(numMismatches[1]!=0)
+			allPassed=false;
+		}
+	
+	return allPassed?0:1;
+	}
@@ -0,0 +1,554 @@
+/***********************************************************************
+JPEGDecompressorBenchmark - Program to verify and measure the decoding
+throughput of the lossless JPEG decompressor on synthetic images
+compressed by a simple lossless JPEG encoder.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <Misc/ThrowStdErr.h>
+#include <Misc/Timer.h>
+#include <IO/FixedMemoryFile.h>
+
+#include <Concrete/JPEGImageWriter.h>
+#include <Concrete/JPEGDecompressor.h>
+
+namespace {
+
+/****************
+Helper functions:
+****************/
+
+inline int predict(int predictor,int a,int b,int c) // Returns the lossless JPEG prediction from the left (a), upper (b), and upper-left (c) neighbors
+	{
+	switch(predictor)
+		{
+		case 1:
+			return a;
+		
+		case 2:
+			return b;
+		
+		case 3:
+			return c;
+		
+		case 4:
+			return a+b-c;
+		
+		case 5:
+			return a+((b-c)>>1);
+		
+		case 6:
+			return b+((a-c)>>1);
+		
+		default:
+			return (a+b)>>1;
+		}
+	}
+
+inline int getCategory(int difference) // Returns the magnitude category of a lossless JPEG difference value
+	{
+	int magnitude=difference>=0?difference:-difference;
+	int category=0;
+	while(magnitude!=0)
+		{
+		++category;
+		magnitude>>=1;
+		}
+	return category;
+	}
+
+void createHuffmanTable(const unsigned int categoryCounts[17],int bits[17],unsigned char values[17],unsigned short codes[17],int codeSizes[17]) // Creates an optimal Huffman table for the given magnitude category frequencies, following Annex K.2 of the JPEG standard
+	{
+	/* Initialize the frequency table with an additional reserved symbol to prevent all-ones codes: */
+	unsigned int freq[18];
+	int codeSize[18];
+	int others[18];
+	for(int i=0;i<17;++i)
+		freq[i]=categoryCounts[i];
+	freq[17]=1;
+	for(int i=0;i<18;++i)
+		{
+		codeSize[i]=0;
+		others[i]=-1;
+		}
+	
+	/* Merge the two least frequent symbols until only one is left: */
+	while(true)
+		{
+		/* Find the least frequent symbol, preferring larger symbol values: */
+		int v1=-1;
+		for(int i=0;i<18;++i)
+			if(freq[i]>0&&(v1<0||freq[i]<=freq[v1]))
+				v1=i;
+		
+		/* Find the next least frequent symbol: */
+		int v2=-1;
+		for(int i=0;i<18;++i)
+			if(i!=v1&&freq[i]>0&&(v2<0||freq[i]<=freq[v2]))
+				v2=i;
+		if(v2<0)
+			break;
+		
+		/* Merge the two symbols' subtrees: */
+		freq[v1]+=freq[v2];
+		freq[v2]=0;
+		++codeSize[v1];
+		while(others[v1]>=0)
+			{
+			v1=others[v1];
+			++codeSize[v1];
+			}
+		others[v1]=v2;
+		++codeSize[v2];
+		while(others[v2]>=0)
+			{
+			v2=others[v2];
+			++codeSize[v2];
+			}
+		}
+	
+	/* Count the number of codes of each length: */
+	int codeCounts[33];
+	for(int i=0;i<33;++i)
+		codeCounts[i]=0;
+	for(int i=0;i<18;++i)
+		if(codeSize[i]>0)
+			++codeCounts[codeSize[i]];
+	
+	/* Limit the code lengths to 16 bits: */
+	for(int i=32;i>16;--i)
+		while(codeCounts[i]>0)
+			{
+			int j=i-2;
+			while(codeCounts[j]==0)
+				--j;
+			codeCounts[i]-=2;
+			++codeCounts[i-1];
+			codeCounts[j+1]+=2;
+			--codeCounts[j];
+			}
+	
+	/* Remove the reserved symbol's code, which is always one of the longest codes: */
+	int longest=16;
+	while(codeCounts[longest]==0)
+		--longest;
+	--codeCounts[longest];
+	bits[0]=0;
+	for(int i=1;i<=16;++i)
+		bits[i]=codeCounts[i];
+	
+	/* Sort the symbols by code length: */
+	int numValues=0;
+	for(int length=1;length<=32;++length)
+		for(int i=0;i<17;++i)
+			if(codeSize[i]==length)
+				values[numValues++]=(unsigned char)i;
+	
+	/* Assign canonical codes in order of increasing code length: */
+	for(int i=0;i<17;++i)
+		codeSizes[i]=0;
+	unsigned int code=0;
+	int valueIndex=0;
+	for(int length=1;length<=16;++length)
+		{
+		for(int i=0;i<bits[length];++i,++valueIndex,++code)
+			{
+			codes[values[valueIndex]]=(unsigned short)code;
+			codeSizes[values[valueIndex]]=length;
+			}
+		code<<=1;
+		}
+	}
+
+/************************************************************
+Class to write entropy-coded data into a lossless JPEG stream:
+************************************************************/
+
+class BitWriter
+	{
+	/* Elements: */
+	private:
+	std::vector<unsigned char>& stream; // The JPEG stream
+	unsigned int bits; // Buffer of bits not yet written to the stream
+	int numBits; // Number of bits in the buffer
+	
+	/* Constructors and destructors: */
+	public:
+	BitWriter(std::vector<unsigned char>& sStream)
+		:stream(sStream),
+		 bits(0),numBits(0)
+		{
+		}
+	
+	/* Methods: */
+	void writeBits(unsigned int newBits,int numNewBits) // Appends up to 16 bits to the stream
+		{
+		bits=(bits<<numNewBits)|(newBits&((0x1U<<numNewBits)-1U));
+		numBits+=numNewBits;
+		while(numBits>=8)
+			{
+			numBits-=8;
+			unsigned char byte=(unsigned char)((bits>>numBits)&0xffU);
+			stream.push_back(byte);
+			
+			/* Stuff a zero byte after each 0xff byte: */
+			if(byte==0xff)
+				stream.push_back(0x00);
+			}
+		}
+	void flush(void) // Pads the current byte with one bits
+		{
+		if(numBits>0)
+			writeBits(0xffU,8-numBits);
+		}
+	};
+
+inline void writeShort(std::vector<unsigned char>& stream,int value)
+	{
+	/* Write the integer in MSB-first order: */
+	stream.push_back((unsigned char)((value>>8)&0xff));
+	stream.push_back((unsigned char)(value&0xff));
+	}
+
+inline void writeMarker(std::vector<unsigned char>& stream,int marker)
+	{
+	stream.push_back(0xff);
+	stream.push_back((unsigned char)marker);
+	}
+
+void encodeImage(const std::vector<unsigned short>& image,const int imageSize[2],int numComponents,int numBits,int predictor,int restartInRows,std::vector<unsigned char>& stream) // Compresses an image with interleaved components into a lossless JPEG stream
+	{
+	if(numComponents<1||numComponents>4)
+		Misc::throwStdErr("encodeImage: Unsupported number of components %d",numComponents);
+	if(restartInRows<=0||restartInRows>imageSize[1])
+		restartInRows=imageSize[1];
+	if(restartInRows<imageSize[1]&&restartInRows*imageSize[0]>65535)
+		Misc::throwStdErr("encodeImage: Restart interval of %d rows is too long",restartInRows);
+	
+	/* Calculate the differences between all pixel components and their predictions in scan order: */
+	size_t rowLength=size_t(imageSize[0])*size_t(numComponents);
+	std::vector<int> differences(image.size());
+	unsigned int categoryCounts[4][17];
+	memset(categoryCounts,0,sizeof(categoryCounts));
+	int initialValue=1<<(numBits-1);
+	for(int y=0;y<imageSize[1];++y)
+		{
+		const unsigned short* cirPtr=&image[size_t(y)*rowLength];
+		const unsigned short* pirPtr=y>0?cirPtr-rowLength:cirPtr;
+		int* dPtr=&differences[size_t(y)*rowLength];
+		bool firstRow=y%restartInRows==0;
+		for(int x=0;x<imageSize[0];++x)
+			for(int comp=0;comp<numComponents;++comp,++cirPtr,++pirPtr,++dPtr)
+				{
+				/* Predict the pixel component like the decoder does: */
+				int prediction;
+				if(firstRow)
+					prediction=x==0?initialValue:int(cirPtr[-numComponents]);
+				else if(x==0)
+					prediction=int(pirPtr[0]);
+				else
+					prediction=predict(predictor,int(cirPtr[-numComponents]),int(pirPtr[0]),int(pirPtr[-numComponents]));
+				
+				/* Calculate the difference modulo 2^16: */
+				int difference=(int(*cirPtr)-prediction)&0xffff;
+				if(difference>32768)
+					difference-=65536;
+				*dPtr=difference;
+				++categoryCounts[comp][getCategory(difference)];
+				}
+		}
+	
+	/* Create one Huffman table per component: */
+	int bits[4][17];
+	unsigned char values[4][17];
+	unsigned short codes[4][17];
+	int codeSizes[4][17];
+	for(int comp=0;comp<numComponents;++comp)
+		createHuffmanTable(categoryCounts[comp],bits[comp],values[comp],codes[comp],codeSizes[comp]);
+	
+	/* Write the SOI and SOF3 markers: */
+	writeMarker(stream,0xd8);
+	writeMarker(stream,0xc3);
+	writeShort(stream,8+numComponents*3);
+	stream.push_back((unsigned char)numBits);
+	writeShort(stream,imageSize[1]);
+	writeShort(stream,imageSize[0]);
+	stream.push_back((unsigned char)numComponents);
+	for(int comp=0;comp<numComponents;++comp)
+		{
+		stream.push_back((unsigned char)(comp+1));
+		stream.push_back(0x11);
+		stream.push_back(0x00);
+		}
+	
+	/* Write the Huffman tables: */
+	int dhtLength=2;
+	for(int comp=0;comp<numComponents;++comp)
+		{
+		dhtLength+=1+16;
+		for(int i=1;i<=16;++i)
+			dhtLength+=bits[comp][i];
+		}
+	writeMarker(stream,0xc4);
+	writeShort(stream,dhtLength);
+	for(int comp=0;comp<numComponents;++comp)
+		{
+		stream.push_back((unsigned char)comp);
+		int numValues=0;
+		for(int i=1;i<=16;++i)
+			{
+			stream.push_back((unsigned char)bits[comp][i]);
+			numValues+=bits[comp][i];
+			}
+		for(int i=0;i<numValues;++i)
+			stream.push_back(values[comp][i]);
+		}
+	
+	/* Write the restart interval: */
+	if(restartInRows<imageSize[1])
+		{
+		writeMarker(stream,0xdd);
+		writeShort(stream,4);
+		writeShort(stream,restartInRows*imageSize[0]);
+		}
+	
+	/* Write the scan header: */
+	writeMarker(stream,0xda);
+	writeShort(stream,6+numComponents*2);
+	stream.push_back((unsigned char)numComponents);
+	for(int comp=0;comp<numComponents;++comp)
+		{
+		stream.push_back((unsigned char)(comp+1));
+		stream.push_back((unsigned char)(comp<<4));
+		}
+	stream.push_back((unsigned char)predictor);
+	stream.push_back(0x00);
+	stream.push_back(0x00);
+	
+	/* Write the entropy-coded differences: */
+	BitWriter bw(stream);
+	const int* dPtr=&differences[0];
+	for(int y=0;y<imageSize[1];++y)
+		{
+		/* Start a new restart interval: */
+		if(y>0&&y%restartInRows==0)
+			{
+			bw.flush();
+			writeMarker(stream,0xd0+(y/restartInRows-1)%8);
+			}
+		
+		for(int x=0;x<imageSize[0];++x)
+			for(int comp=0;comp<numComponents;++comp,++dPtr)
+				{
+				int category=getCategory(*dPtr);
+				bw.writeBits(codes[comp][category],codeSizes[comp][category]);
+				
+				/* Write the magnitude bits; category 16 has none: */
+				if(category>0&&category<16)
+					bw.writeBits((unsigned int)(*dPtr>=0?*dPtr:*dPtr-1),category);
+				}
+		}
+	bw.flush();
+	
+	/* Write the EOI marker: */
+	writeMarker(stream,0xd9);
+	}
+
+void createImage(const int imageSize[2],int numComponents,int numBits,std::vector<unsigned short>& image) // Creates a smooth image with some noise, similar to a medical image slice
+	{
+	image.resize(size_t(imageSize[0])*size_t(imageSize[1])*size_t(numComponents));
+	double maxValue=double((1<<numBits)-1);
+	unsigned short* iPtr=&image[0];
+	for(int y=0;y<imageSize[1];++y)
+		{
+		double dy=double(y)/double(imageSize[1])-0.5;
+		for(int x=0;x<imageSize[0];++x)
+			{
+			double dx=double(x)/double(imageSize[0])-0.5;
+			for(int comp=0;comp<numComponents;++comp,++iPtr)
+				{
+				double value=0.5+0.3*cos(12.0*sqrt(dx*dx+dy*dy)+double(comp))+0.1*sin(20.0*dx)*sin(14.0*dy);
+				value+=(double(rand())/double(RAND_MAX)-0.5)*0.02;
+				value*=maxValue;
+				*iPtr=(unsigned short)(value<0.0?0.0:value>maxValue?maxValue:value+0.5);
+				}
+			}
+		}
+	}
+
+/**********************************************************
+Class to collect decoded image rows into an in-memory image:
+**********************************************************/
+
+class ImageCollector:public Visualization::Concrete::JPEGImageWriter
+	{
+	/* Elements: */
+	private:
+	size_t rowLength; // Number of pixel components per image row
+	std::vector<unsigned short>& image; // The decoded image
+	
+	/* Constructors and destructors: */
+	public:
+	ImageCollector(std::vector<unsigned short>& sImage)
+		:rowLength(0),image(sImage)
+		{
+		}
+	
+	/* Methods from JPEGImageWriter: */
+	virtual void setImageParameters(const int imageSize[2],int numScanComponents,int numBits)
+		{
+		rowLength=size_t(imageSize[0])*size_t(numScanComponents);
+		image.resize(rowLength*size_t(imageSize[1]));
+		}
+	virtual void writeImageRow(int rowIndex,const short* imageRow)
+		{
+		memcpy(&image[size_t(rowIndex)*rowLength],imageRow,rowLength*sizeof(unsigned short));
+		}
+	};
+
+double decodeImage(const std::vector<unsigned char>& stream,unsigned int numThreads,std::vector<unsigned short>& image) // Decodes a lossless JPEG stream and returns the decoding time in seconds
+	{
+	/* Copy the stream into a memory file: */
+	IO::FixedMemoryFile jpegBuffer(stream.size());
+	jpegBuffer.ref();
+	memcpy(jpegBuffer.getMemory(),&stream[0],stream.size());
+	
+	/* Decode the image: */
+	Misc::Timer t;
+	Visualization::Concrete::JPEGDecompressor dc(jpegBuffer);
+	dc.setNumThreads(numThreads);
+	if(!dc.readScanHeader())
+		Misc::throwStdErr("decodeImage: JPEG stream does not contain a scan");
+	ImageCollector collector(image);
+	dc.readImage(collector);
+	t.elapse();
+	
+	return t.getTime();
+	}
+
+}
+
+int main(int argc,char* argv[])
+	{
+	/* Parse the command line: */
+	int imageSize[2]={512,512};
+	int numComponents=1;
+	int numBits=12;
+	int firstPredictor=1;
+	int lastPredictor=7;
+	int restartInRows=0;
+	unsigned int numThreads=1;
+	int numIterations=20;
+	for(int i=1;i<argc;++i)
+		{
+		if(argv[i][0]=='-')
+			{
+			if(strcasecmp(argv[i]+1,"size")==0&&i+2<argc)
+				{
+				for(int j=0;j<2;++j)
+					imageSize[j]=atoi(argv[i+1+j]);
+				i+=2;
+				}
+			else if(strcasecmp(argv[i]+1,"components")==0&&i+1<argc)
+				numComponents=atoi(argv[++i]);
+			else if(strcasecmp(argv[i]+1,"bits")==0&&i+1<argc)
+				numBits=atoi(argv[++i]);
+			else if(strcasecmp(argv[i]+1,"predictor")==0&&i+1<argc)
+				firstPredictor=lastPredictor=atoi(argv[++i]);
+			else if(strcasecmp(argv[i]+1,"restart")==0&&i+1<argc)
+				restartInRows=atoi(argv[++i]);
+			else if(strcasecmp(argv[i]+1,"threads")==0&&i+1<argc)
+				numThreads=(unsigned int)(atoi(argv[++i]));
+			else if(strcasecmp(argv[i]+1,"iterations")==0&&i+1<argc)
+				numIterations=atoi(argv[++i]);
+			else
+				std::cerr<<"Ignoring unrecognized option "<<argv[i]<<std::endl;
+			}
+		else
+			std::cerr<<"Ignoring command line argument "<<argv[i]<<std::endl;
+		}
+	if(imageSize[0]<=0||imageSize[1]<=0||numComponents<1||numComponents>4||numBits<2||numBits>16||firstPredictor<1||lastPredictor>7||numIterations<1)
+		{
+		std::cerr<<"Usage: "<<argv[0]<<" [-size <width> <height>] [-components <1-4>] [-bits <2-16>] [-predictor <1-7>] [-restart <rows>] [-threads <num threads>] [-iterations <num iterations>]"<<std::endl;
+		return 1;
+		}
+	
+	/* Create the test image: */
+	std::vector<unsigned short> image;
+	createImage(imageSize,numComponents,numBits,image);
+	double numPixels=double(imageSize[0])*double(imageSize[1]);
+	std::cout<<"Image size "<<imageSize[0]<<"x"<<imageSize[1]<<", "<<numComponents<<" component(s), "<<numBits<<" bits, ";
+	if(restartInRows>0&&restartInRows<imageSize[1])
+		std::cout<<"restart interval "<<restartInRows<<" rows, ";
+	std::cout<<numThreads<<" decoding thread(s)"<<std::endl;
+	
+	bool allPassed=true;
+	for(int predictor=firstPredictor;predictor<=lastPredictor;++predictor)
+		{
+		try
+			{
+			/* Compress the test image: */
+			std::vector<unsigned char> stream;
+			encodeImage(image,imageSize,numComponents,numBits,predictor,restartInRows,stream);
+			
+			/* Decode the image once and compare it to the original: */
+			std::vector<unsigned short> decodedImage;
+			decodeImage(stream,numThreads,decodedImage);
+			size_t numMismatches=0;
+			unsigned short mask=(unsigned short)((1<<numBits)-1);
+			for(size_t i=0;i<image.size();++i)
+				if((decodedImage[i]&mask)!=image[i])
+					++numMismatches;
+			
+			/* Measure the decoding throughput: */
+			double minTime=0.0;
+			double totalTime=0.0;
+			for(int iteration=0;iteration<numIterations;++iteration)
+				{
+				double time=decodeImage(stream,numThreads,decodedImage);
+				if(iteration==0||minTime>time)
+					minTime=time;
+				totalTime+=time;
+				}
+			
+			std::cout<<"Predictor "<<predictor<<": compressed "<<stream.size()<<" bytes ("<<double(stream.size())*8.0/(numPixels*double(numComponents))<<" bits/sample), ";
+			std::cout<<"decode "<<numPixels*1.0e-6/(totalTime/double(numIterations))<<" MPixels/s average, "<<numPixels*1.0e-6/minTime<<" MPixels/s best";
+			if(numMismatches==0)
+				std::cout<<", round trip OK"<<std::endl;
+			else
+				{
+				std::cout<<", round trip FAILED ("<<numMismatches<<" mismatched samples)"<<std::endl;
+				allPassed=false;
+				}
+			}
+		catch(std::runtime_error err)
+			{
+			std::cerr<<"Caught exception "<<err.what()<<" while testing predictor "<<predictor<<std::endl;
+			allPassed=false;
+			}
+		}
+	
+	return allPassed?0:1;
+	}
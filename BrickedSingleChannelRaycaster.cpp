@@ -0,0 +1,653 @@
+/***********************************************************************
+BrickedSingleChannelRaycaster - Class for volume renderers with a single
+scalar channel whose volume data is too large for a single 3D texture,
+using a bricked voxel store and a texture memory brick cache.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <BrickedSingleChannelRaycaster.h>
+
+#include <string.h>
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include <utility>
+#include <Math/Math.h>
+#include <Geometry/HVector.h>
+#include <GL/gl.h>
+#include <GL/GLContextData.h>
+#include <GL/Extensions/GLARBMultitexture.h>
+#include <GL/Extensions/GLEXTTexture3D.h>
+#include <GL/GLShader.h>
+
+namespace {
+
+/****************
+Helper functions:
+****************/
+
+void downsampleBrick(unsigned int sourceSize,const BrickedVolume::Voxel* source,unsigned int destSize,BrickedVolume::Voxel* dest)
+	{
+	/* Resample the source brick's voxels at the destination brick's grid points using trilinear interpolation: */
+	float scale=float(sourceSize-1)/float(destSize-1);
+	for(unsigned int z=0;z<destSize;++z)
+		{
+		float sz=float(z)*scale;
+		unsigned int z0=(unsigned int)(sz);
+		if(z0>sourceSize-2)
+			z0=sourceSize-2;
+		float wz=sz-float(z0);
+		for(unsigned int y=0;y<destSize;++y)
+			{
+			float sy=float(y)*scale;
+			unsigned int y0=(unsigned int)(sy);
+			if(y0>sourceSize-2)
+				y0=sourceSize-2;
+			float wy=sy-float(y0);
+			for(unsigned int x=0;x<destSize;++x,++dest)
+				{
+				float sx=float(x)*scale;
+				unsigned int x0=(unsigned int)(sx);
+				if(x0>sourceSize-2)
+					x0=sourceSize-2;
+				float wx=sx-float(x0);
+				
+				/* Interpolate between the eight voxels surrounding the grid point: */
+				const BrickedVolume::Voxel* sPtr=source+((size_t(z0)*size_t(sourceSize)+size_t(y0))*size_t(sourceSize)+size_t(x0));
+				size_t dy=sourceSize;
+				size_t dz=size_t(sourceSize)*size_t(sourceSize);
+				float v00=float(sPtr[0])*(1.0f-wx)+float(sPtr[1])*wx;
+				float v01=float(sPtr[dy])*(1.0f-wx)+float(sPtr[dy+1])*wx;
+				float v10=float(sPtr[dz])*(1.0f-wx)+float(sPtr[dz+1])*wx;
+				float v11=float(sPtr[dz+dy])*(1.0f-wx)+float(sPtr[dz+dy+1])*wx;
+				float v0=v00*(1.0f-wy)+v01*wy;
+				float v1=v10*(1.0f-wy)+v11*wy;
+				*dest=BrickedVolume::Voxel(v0*(1.0f-wz)+v1*wz+0.5f);
+				}
+			}
+		}
+	}
+
+void addBrickBorder(unsigned int sourceSize,const BrickedVolume::Voxel* source,BrickedVolume::Voxel* dest)
+	{
+	/* Copy the source brick's voxels into the interior of the destination brick, clamping border voxels to the source brick's boundary: */
+	unsigned int destSize=sourceSize+2;
+	for(unsigned int z=0;z<destSize;++z)
+		{
+		unsigned int sz=z>0?z-1:0;
+		if(sz>sourceSize-1)
+			sz=sourceSize-1;
+		for(unsigned int y=0;y<destSize;++y)
+			{
+			unsigned int sy=y>0?y-1:0;
+			if(sy>sourceSize-1)
+				sy=sourceSize-1;
+			const BrickedVolume::Voxel* sRow=source+(size_t(sz)*size_t(sourceSize)+size_t(sy))*size_t(sourceSize);
+			*dest=sRow[0];
+			++dest;
+			memcpy(dest,sRow,sourceSize*sizeof(BrickedVolume::Voxel));
+			dest+=sourceSize;
+			*dest=sRow[sourceSize-1];
+			++dest;
+			}
+		}
+	}
+
+}
+
+/********************************************************
+Methods of class BrickedSingleChannelRaycaster::DataItem:
+********************************************************/
+
+BrickedSingleChannelRaycaster::DataItem::DataItem(void)
+	:frameNumber(0),volumeVersion(0),
+	 brickTableTextureID(0),brickTable(0),brickTableDirty(true),
+	 brickBuffer(0),coarseBrickBuffer(0),borderBrickBuffer(0),
+	 brickTableSamplerLoc(-1),brickTableScaleLoc(-1),numBricksLoc(-1),
+	 brickStepLoc(-1),subSlotSizeLoc(-1),atlasScaleLoc(-1)
+	{
+	/* Create the brick table texture object: */
+	glGenTextures(1,&brickTableTextureID);
+	}
+
+BrickedSingleChannelRaycaster::DataItem::~DataItem(void)
+	{
+	/* Destroy the brick table texture object: */
+	glDeleteTextures(1,&brickTableTextureID);
+	
+	delete[] brickTable;
+	delete[] brickBuffer;
+	delete[] coarseBrickBuffer;
+	delete[] borderBrickBuffer;
+	}
+
+/**********************************************
+Methods of class BrickedSingleChannelRaycaster:
+**********************************************/
+
+void BrickedSingleChannelRaycaster::initVolumeTexture(SingleChannelRaycaster::DataItem* dataItem) const
+	{
+	/* Get a pointer to the data item: */
+	DataItem* myDataItem=dynamic_cast<DataItem*>(dataItem);
+	
+	/* Split each brick slot into 2x2x2 sub-slots that can each hold one brick at the next coarser resolution level, surrounded by a one-voxel border to keep linear interpolation from reading neighboring sub-slots: */
+	myDataItem->subSlotSize=GLsizei(volume.getLevelSize(1))+2;
+	GLsizei slotSize=myDataItem->subSlotSize*2;
+	
+	/* Determine the initial size of the brick cache texture from the OpenGL texture size limit: */
+	GLint maxTextureSize;
+	glGetIntegerv(GL_MAX_3D_TEXTURE_SIZE_EXT,&maxTextureSize);
+	for(int i=0;i<3;++i)
+		{
+		/* Limit the number of slots by the number of bricks and the size of the brick table entries: */
+		myDataItem->atlasSize[i]=maxTextureSize/slotSize;
+		if(myDataItem->atlasSize[i]>GLsizei(volume.getNumBricks()[i]))
+			myDataItem->atlasSize[i]=GLsizei(volume.getNumBricks()[i]);
+		if(myDataItem->atlasSize[i]>127)
+			myDataItem->atlasSize[i]=127;
+		if(myDataItem->atlasSize[i]<1)
+			myDataItem->atlasSize[i]=1;
+		}
+	
+	/* Create the brick cache texture, shrinking it until it can be allocated: */
+	glBindTexture(GL_TEXTURE_3D,myDataItem->volumeTextureID);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_S,GL_CLAMP);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_T,GL_CLAMP);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_R,GL_CLAMP);
+	while(glGetError()!=GL_NO_ERROR)
+		;
+	while(true)
+		{
+		/* Check the texture size against the implementation's limits, and then try allocating it: */
+		GLsizei textureSize[3];
+		for(int i=0;i<3;++i)
+			textureSize[i]=myDataItem->atlasSize[i]*slotSize;
+		glTexImage3DEXT(GL_PROXY_TEXTURE_3D,0,GL_INTENSITY,textureSize[0],textureSize[1],textureSize[2],0,GL_LUMINANCE,GL_UNSIGNED_BYTE,0);
+		GLint proxyWidth=0;
+		glGetTexLevelParameteriv(GL_PROXY_TEXTURE_3D,0,GL_TEXTURE_WIDTH,&proxyWidth);
+		if(proxyWidth!=0)
+			{
+			glTexImage3DEXT(GL_TEXTURE_3D,0,GL_INTENSITY,textureSize[0],textureSize[1],textureSize[2],0,GL_LUMINANCE,GL_UNSIGNED_BYTE,0);
+			if(glGetError()!=GL_OUT_OF_MEMORY)
+				break;
+			}
+		
+		/* Halve the largest atlas dimension: */
+		int largest=0;
+		for(int i=1;i<3;++i)
+			if(myDataItem->atlasSize[largest]<myDataItem->atlasSize[i])
+				largest=i;
+		if(myDataItem->atlasSize[largest]==1)
+			break;
+		myDataItem->atlasSize[largest]=(myDataItem->atlasSize[largest]+1)/2;
+		}
+	glBindTexture(GL_TEXTURE_3D,0);
+	
+	/* Initialize the brick cache's bookkeeping: */
+	size_t numSubSlots=size_t(myDataItem->atlasSize[0])*size_t(myDataItem->atlasSize[1])*size_t(myDataItem->atlasSize[2])*8;
+	myDataItem->slotBricks.resize(numSubSlots,~0U);
+	myDataItem->slotLastUses.resize(numSubSlots,0);
+	myDataItem->brickSlots.resize(volume.getTotalNumBricks(),-1);
+	myDataItem->brickLevels.resize(volume.getTotalNumBricks(),0);
+	myDataItem->brickBuffer=new BrickedVolume::Voxel[volume.getBrickNumVoxels()];
+	myDataItem->coarseBrickBuffer=new BrickedVolume::Voxel[volume.getLevelNumVoxels(1)];
+	size_t borderBrickSize=size_t(volume.getBrickSize())+2;
+	myDataItem->borderBrickBuffer=new BrickedVolume::Voxel[borderBrickSize*borderBrickSize*borderBrickSize];
+	}
+
+void BrickedSingleChannelRaycaster::initDataItem(Raycaster::DataItem* dataItem) const
+	{
+	/* Call the base class method: */
+	SingleChannelRaycaster::initDataItem(dataItem);
+	
+	/* Get a pointer to the data item: */
+	DataItem* myDataItem=dynamic_cast<DataItem*>(dataItem);
+	
+	/* Transform from model space to voxel index space instead of texture space: */
+	for(int i=0;i<3;++i)
+		{
+		Scalar scale=Scalar(dataSize[i]-1)/domain.getSize(i);
+		myDataItem->mcScale[i]=GLfloat(scale);
+		myDataItem->mcOffset[i]=GLfloat(-domain.min[i]*scale);
+		}
+	
+	/* Calculate the brick table texture's size: */
+	size_t brickTableSize=4;
+	for(int i=0;i<3;++i)
+		{
+		if(myDataItem->hasNPOTDTextures)
+			myDataItem->brickTableTextureSize[i]=GLsizei(volume.getNumBricks()[i]);
+		else
+			for(myDataItem->brickTableTextureSize[i]=1;myDataItem->brickTableTextureSize[i]<GLsizei(volume.getNumBricks()[i]);myDataItem->brickTableTextureSize[i]<<=1)
+				;
+		brickTableSize*=size_t(myDataItem->brickTableTextureSize[i]);
+		}
+	
+	/* Create the brick table with all bricks marked as non-resident: */
+	myDataItem->brickTable=new GLubyte[brickTableSize];
+	memset(myDataItem->brickTable,0,brickTableSize);
+	
+	/* Create the brick table texture: */
+	glBindTexture(GL_TEXTURE_3D,myDataItem->brickTableTextureID);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_R,GL_CLAMP_TO_EDGE);
+	glTexImage3DEXT(GL_TEXTURE_3D,0,GL_RGBA8,myDataItem->brickTableTextureSize[0],myDataItem->brickTableTextureSize[1],myDataItem->brickTableTextureSize[2],0,GL_RGBA,GL_UNSIGNED_BYTE,myDataItem->brickTable);
+	glBindTexture(GL_TEXTURE_3D,0);
+	myDataItem->brickTableDirty=false;
+	}
+
+void BrickedSingleChannelRaycaster::initShader(Raycaster::DataItem* dataItem) const
+	{
+	/* Call the base class method: */
+	SingleChannelRaycaster::initShader(dataItem);
+	
+	/* Get a pointer to the data item: */
+	DataItem* myDataItem=dynamic_cast<DataItem*>(dataItem);
+	
+	/* Get the shader's uniform locations: */
+	myDataItem->brickTableSamplerLoc=myDataItem->shader.getUniformLocation("brickTableSampler");
+	myDataItem->brickTableScaleLoc=myDataItem->shader.getUniformLocation("brickTableScale");
+	myDataItem->numBricksLoc=myDataItem->shader.getUniformLocation("numBricks");
+	myDataItem->brickStepLoc=myDataItem->shader.getUniformLocation("brickStep");
+	myDataItem->subSlotSizeLoc=myDataItem->shader.getUniformLocation("subSlotSize");
+	myDataItem->atlasScaleLoc=myDataItem->shader.getUniformLocation("atlasScale");
+	}
+
+size_t BrickedSingleChannelRaycaster::getBrickTableIndex(const BrickedSingleChannelRaycaster::DataItem* dataItem,unsigned int brickIndex) const
+	{
+	unsigned int origin[3];
+	volume.getBrickOrigin(brickIndex,origin);
+	unsigned int brickStep=volume.getBrickSize()-1;
+	return ((size_t(origin[2]/brickStep)*size_t(dataItem->brickTableTextureSize[1])+size_t(origin[1]/brickStep))*size_t(dataItem->brickTableTextureSize[0])+size_t(origin[0]/brickStep))*4;
+	}
+
+void BrickedSingleChannelRaycaster::evictBrick(BrickedSingleChannelRaycaster::DataItem* dataItem,unsigned int brickIndex) const
+	{
+	/* Release the brick's sub-slots; full-resolution bricks occupy all eight sub-slots of a brick slot: */
+	size_t firstSubSlot=size_t(dataItem->brickSlots[brickIndex]);
+	size_t numSubSlots=dataItem->brickLevels[brickIndex]==0?8:1;
+	for(size_t i=0;i<numSubSlots;++i)
+		dataItem->slotBricks[firstSubSlot+i]=~0U;
+	dataItem->brickSlots[brickIndex]=-1;
+	
+	/* Mark the brick as non-resident in the brick table: */
+	size_t tableIndex=getBrickTableIndex(dataItem,brickIndex);
+	for(int i=0;i<4;++i)
+		dataItem->brickTable[tableIndex+i]=0;
+	dataItem->brickTableDirty=true;
+	}
+
+int BrickedSingleChannelRaycaster::findCacheSlot(const BrickedSingleChannelRaycaster::DataItem* dataItem,bool wholeSlot) const
+	{
+	int result=-1;
+	unsigned int resultLastUse=dataItem->frameNumber;
+	size_t numSubSlots=dataItem->slotBricks.size();
+	if(wholeSlot)
+		{
+		/* Find a free brick slot, or the one whose sub-slots were least recently used and not visible in the current frame: */
+		for(size_t slot=0;slot<numSubSlots;slot+=8)
+			{
+			bool free=true;
+			unsigned int lastUse=0;
+			for(size_t i=slot;i<slot+8;++i)
+				if(dataItem->slotBricks[i]!=~0U)
+					{
+					free=false;
+					if(lastUse<dataItem->slotLastUses[i])
+						lastUse=dataItem->slotLastUses[i];
+					}
+			if(free)
+				return int(slot);
+			if(resultLastUse>lastUse)
+				{
+				result=int(slot);
+				resultLastUse=lastUse;
+				}
+			}
+		}
+	else
+		{
+		/* Find a free sub-slot, preferring partially occupied brick slots to keep whole slots available for full-resolution bricks: */
+		int freeSubSlot=-1;
+		for(size_t slot=0;slot<numSubSlots;slot+=8)
+			{
+			int slotFreeSubSlot=-1;
+			bool slotOccupied=false;
+			for(size_t i=slot;i<slot+8;++i)
+				{
+				if(dataItem->slotBricks[i]==~0U)
+					{
+					if(slotFreeSubSlot<0)
+						slotFreeSubSlot=int(i);
+					}
+				else
+					{
+					slotOccupied=true;
+					
+					/* Track the least-recently-used sub-slot that was not visible in the current frame: */
+					if(resultLastUse>dataItem->slotLastUses[i])
+						{
+						result=int(i);
+						resultLastUse=dataItem->slotLastUses[i];
+						}
+					}
+				}
+			if(slotFreeSubSlot>=0)
+				{
+				if(slotOccupied)
+					return slotFreeSubSlot;
+				if(freeSubSlot<0)
+					freeSubSlot=slotFreeSubSlot;
+				}
+			}
+		if(freeSubSlot>=0)
+			result=freeSubSlot;
+		}
+	
+	return result;
+	}
+
+void BrickedSingleChannelRaycaster::updateBrickCache(const Raycaster::PTransform& pmv,BrickedSingleChannelRaycaster::DataItem* dataItem) const
+	{
+	/* Flush the brick cache if the volume data changed: */
+	if(dataItem->volumeVersion!=volumeVersion)
+		{
+		std::fill(dataItem->brickSlots.begin(),dataItem->brickSlots.end(),-1);
+		std::fill(dataItem->slotBricks.begin(),dataItem->slotBricks.end(),~0U);
+		std::fill(dataItem->slotLastUses.begin(),dataItem->slotLastUses.end(),0U);
+		size_t brickTableSize=size_t(dataItem->brickTableTextureSize[0])*size_t(dataItem->brickTableTextureSize[1])*size_t(dataItem->brickTableTextureSize[2])*4;
+		memset(dataItem->brickTable,0,brickTableSize);
+		dataItem->brickTableDirty=true;
+		dataItem->volumeVersion=volumeVersion;
+		}
+	++dataItem->frameNumber;
+	
+	/* Count the voxel values that are not fully transparent under the current color map: */
+	unsigned int opaqueCounts[257];
+	opaqueCounts[0]=0;
+	const GLColorMap::Color* colors=colorMap->getColors();
+	for(int i=0;i<256;++i)
+		opaqueCounts[i+1]=opaqueCounts[i]+(colors[i][3]>0.0f?1:0);
+	
+	/* Find all bricks that are visible and not empty under the current color map: */
+	unsigned int brickSize=volume.getBrickSize();
+	std::vector<std::pair<Scalar,unsigned int> > visibleBricks;
+	for(unsigned int brickIndex=0;brickIndex<volume.getTotalNumBricks();++brickIndex)
+		{
+		/* Skip bricks whose value range maps to fully transparent colors: */
+		if(opaqueCounts[volume.getBrickMax(brickIndex)+1]==opaqueCounts[volume.getBrickMin(brickIndex)])
+			continue;
+		
+		/* Calculate the brick's bounding box in model space: */
+		unsigned int origin[3];
+		volume.getBrickOrigin(brickIndex,origin);
+		Point min,max;
+		for(int i=0;i<3;++i)
+			{
+			unsigned int end=origin[i]+brickSize-1;
+			if(end>dataSize[i]-1)
+				end=dataSize[i]-1;
+			Scalar voxelSize=domain.getSize(i)/Scalar(dataSize[i]-1);
+			min[i]=domain.min[i]+Scalar(origin[i])*voxelSize;
+			max[i]=domain.min[i]+Scalar(end)*voxelSize;
+			}
+		
+		/* Check the brick's corners against the view frustum: */
+		int outsideMask=0x3f;
+		for(int corner=0;corner<8;++corner)
+			{
+			PTransform::HVector cc=pmv.transform(PTransform::HVector((corner&0x1)?max[0]:min[0],(corner&0x2)?max[1]:min[1],(corner&0x4)?max[2]:min[2],Scalar(1)));
+			int cornerMask=0x0;
+			for(int i=0;i<3;++i)
+				{
+				if(cc[i]<-cc[3])
+					cornerMask|=0x1<<(2*i);
+				if(cc[i]>cc[3])
+					cornerMask|=0x2<<(2*i);
+				}
+			outsideMask&=cornerMask;
+			}
+		if(outsideMask!=0x0)
+			continue;
+		
+		/* Store the brick with its depth along the viewing direction: */
+		PTransform::HVector center=pmv.transform(PTransform::HVector(Math::mid(min[0],max[0]),Math::mid(min[1],max[1]),Math::mid(min[2],max[2]),Scalar(1)));
+		visibleBricks.push_back(std::pair<Scalar,unsigned int>(center[2]/center[3],brickIndex));
+		}
+	std::sort(visibleBricks.begin(),visibleBricks.end());
+	
+	/*********************************************************************
+	Assign cache resolution levels to the visible bricks in front-to-back
+	order. A full-resolution brick occupies a whole brick slot, i.e.,
+	eight sub-slots; if that would not leave at least one sub-slot for
+	each brick behind it, the brick falls back to the next coarser level
+	and occupies a single sub-slot instead.
+	*********************************************************************/
+	
+	bool canCoarsen=volume.getMaxLevel()>=1;
+	size_t numVisibleBricks=visibleBricks.size();
+	size_t numFreeSubSlots=dataItem->slotBricks.size();
+	std::vector<std::pair<unsigned int,unsigned int> > missingBricks;
+	for(size_t vbIndex=0;vbIndex<numVisibleBricks&&numFreeSubSlots>0;++vbIndex)
+		{
+		unsigned int brickIndex=visibleBricks[vbIndex].second;
+		unsigned int level=volume.getBrickLevel(brickIndex);
+		size_t numSubSlots=level==0?8:1;
+		if(level==0&&canCoarsen&&numSubSlots+(numVisibleBricks-vbIndex-1)>numFreeSubSlots)
+			{
+			level=1;
+			numSubSlots=1;
+			}
+		if(numSubSlots>numFreeSubSlots)
+			break;
+		numFreeSubSlots-=numSubSlots;
+		
+		if(dataItem->brickSlots[brickIndex]>=0&&dataItem->brickLevels[brickIndex]==level)
+			{
+			/* Mark the brick's cache sub-slots as used: */
+			for(size_t i=0;i<numSubSlots;++i)
+				dataItem->slotLastUses[dataItem->brickSlots[brickIndex]+i]=dataItem->frameNumber;
+			}
+		else
+			{
+			/* Queue the brick for upload at the assigned level: */
+			missingBricks.push_back(std::pair<unsigned int,unsigned int>(brickIndex,level));
+			}
+		}
+	
+	/* Upload the missing bricks in front-to-back order: */
+	if(missingBricks.size()>maxBrickUploads)
+		missingBricks.resize(maxBrickUploads);
+	glActiveTextureARB(GL_TEXTURE1_ARB);
+	glPixelStorei(GL_UNPACK_ALIGNMENT,1);
+	for(std::vector<std::pair<unsigned int,unsigned int> >::iterator mbIt=missingBricks.begin();mbIt!=missingBricks.end();++mbIt)
+		{
+		unsigned int brickIndex=mbIt->first;
+		unsigned int level=mbIt->second;
+		
+		/* Evict the brick's copy at a different resolution level: */
+		if(dataItem->brickSlots[brickIndex]>=0)
+			evictBrick(dataItem,brickIndex);
+		
+		/* Find a whole brick slot for a full-resolution brick, or fall back to the next coarser level if there is none: */
+		int subSlot=-1;
+		if(level==0)
+			{
+			subSlot=findCacheSlot(dataItem,true);
+			if(subSlot<0&&canCoarsen)
+				level=1;
+			}
+		if(level!=0)
+			subSlot=findCacheSlot(dataItem,false);
+		
+		/* Skip the brick if the brick cache is full of visible bricks: */
+		if(subSlot<0)
+			continue;
+		
+		/* Evict the bricks currently held in the target sub-slots: */
+		size_t numSubSlots=level==0?8:1;
+		for(size_t i=0;i<numSubSlots;++i)
+			if(dataItem->slotBricks[subSlot+i]!=~0U)
+				evictBrick(dataItem,dataItem->slotBricks[subSlot+i]);
+		
+		/* Calculate the sub-slot's position in the brick cache texture: */
+		size_t slot=size_t(subSlot)/8;
+		unsigned int corner=(unsigned int)(subSlot%8);
+		GLsizei subSlotPos[3];
+		for(int i=0;i<3;++i)
+			{
+			subSlotPos[i]=GLsizei(slot%size_t(dataItem->atlasSize[i]))*2+GLsizei((corner>>i)&0x1U);
+			slot/=size_t(dataItem->atlasSize[i]);
+			}
+		
+		/* Upload the brick with its border into the sub-slot, resampling it to the coarser level if necessary: */
+		volume.readBrick(brickIndex,dataItem->brickBuffer);
+		const BrickedVolume::Voxel* voxels=dataItem->brickBuffer;
+		if(level!=volume.getBrickLevel(brickIndex))
+			{
+			downsampleBrick(brickSize,dataItem->brickBuffer,volume.getLevelSize(level),dataItem->coarseBrickBuffer);
+			voxels=dataItem->coarseBrickBuffer;
+			}
+		GLsizei levelSize=GLsizei(volume.getLevelSize(level));
+		addBrickBorder((unsigned int)levelSize,voxels,dataItem->borderBrickBuffer);
+		glTexSubImage3DEXT(GL_TEXTURE_3D,0,subSlotPos[0]*dataItem->subSlotSize,subSlotPos[1]*dataItem->subSlotSize,subSlotPos[2]*dataItem->subSlotSize,levelSize+2,levelSize+2,levelSize+2,GL_LUMINANCE,GL_UNSIGNED_BYTE,dataItem->borderBrickBuffer);
+		dataItem->brickSlots[brickIndex]=subSlot;
+		dataItem->brickLevels[brickIndex]=level;
+		for(size_t i=0;i<numSubSlots;++i)
+			{
+			dataItem->slotBricks[subSlot+i]=brickIndex;
+			dataItem->slotLastUses[subSlot+i]=dataItem->frameNumber;
+			}
+		
+		/* Enter the brick's sub-slot and resolution level into the brick table: */
+		size_t tableIndex=getBrickTableIndex(dataItem,brickIndex);
+		for(int i=0;i<3;++i)
+			dataItem->brickTable[tableIndex+i]=GLubyte(subSlotPos[i]);
+		dataItem->brickTable[tableIndex+3]=GLubyte(255-level);
+		dataItem->brickTableDirty=true;
+		}
+	
+	/* Upload the brick table if it changed: */
+	glActiveTextureARB(GL_TEXTURE4_ARB);
+	glBindTexture(GL_TEXTURE_3D,dataItem->brickTableTextureID);
+	if(dataItem->brickTableDirty)
+		{
+		glTexSubImage3DEXT(GL_TEXTURE_3D,0,0,0,0,dataItem->brickTableTextureSize[0],dataItem->brickTableTextureSize[1],dataItem->brickTableTextureSize[2],GL_RGBA,GL_UNSIGNED_BYTE,dataItem->brickTable);
+		dataItem->brickTableDirty=false;
+		}
+	}
+
+void BrickedSingleChannelRaycaster::bindShader(const Raycaster::PTransform& pmv,const Raycaster::PTransform& mv,Raycaster::DataItem* dataItem) const
+	{
+	/* Call the base class method: */
+	SingleChannelRaycaster::bindShader(pmv,mv,dataItem);
+	
+	/* Get a pointer to the data item: */
+	DataItem* myDataItem=dynamic_cast<DataItem*>(dataItem);
+	
+	/* Bring the brick cache up-to-date and bind the brick table texture: */
+	updateBrickCache(pmv,myDataItem);
+	glUniform1iARB(myDataItem->brickTableSamplerLoc,4);
+	
+	/* Set the brick layout uniforms: */
+	glUniform3fARB(myDataItem->brickTableScaleLoc,1.0f/GLfloat(myDataItem->brickTableTextureSize[0]),1.0f/GLfloat(myDataItem->brickTableTextureSize[1]),1.0f/GLfloat(myDataItem->brickTableTextureSize[2]));
+	glUniform3fARB(myDataItem->numBricksLoc,GLfloat(volume.getNumBricks()[0]),GLfloat(volume.getNumBricks()[1]),GLfloat(volume.getNumBricks()[2]));
+	glUniform1fARB(myDataItem->brickStepLoc,GLfloat(volume.getBrickSize()-1));
+	glUniform1fARB(myDataItem->subSlotSizeLoc,GLfloat(myDataItem->subSlotSize));
+	GLfloat atlasVoxels[3];
+	for(int i=0;i<3;++i)
+		atlasVoxels[i]=GLfloat(myDataItem->atlasSize[i]*myDataItem->subSlotSize*2);
+	glUniform3fARB(myDataItem->atlasScaleLoc,1.0f/atlasVoxels[0],1.0f/atlasVoxels[1],1.0f/atlasVoxels[2]);
+	}
+
+void BrickedSingleChannelRaycaster::unbindShader(Raycaster::DataItem* dataItem) const
+	{
+	/* Unbind the brick table texture: */
+	glActiveTextureARB(GL_TEXTURE4_ARB);
+	glBindTexture(GL_TEXTURE_3D,0);
+	
+	/* Call the base class method: */
+	SingleChannelRaycaster::unbindShader(dataItem);
+	}
+
+BrickedSingleChannelRaycaster::BrickedSingleChannelRaycaster(const unsigned int sDataSize[3],const Raycaster::Box& sDomain,unsigned int sBrickSize,size_t sMaxResidentBricks)
+	:SingleChannelRaycaster(sDataSize,sDomain,0),
+	 volume(sDataSize,sBrickSize,sMaxResidentBricks),volumeVersion(0),
+	 maxBrickUploads(64)
+	{
+	}
+
+void BrickedSingleChannelRaycaster::initContext(GLContextData& contextData) const
+	{
+	/* Create a new data item: */
+	DataItem* dataItem=new DataItem;
+	contextData.addDataItem(this,dataItem);
+	
+	/* Initialize the data item: */
+	initDataItem(dataItem);
+	
+	try
+		{
+		/* Load and compile the vertex program: */
+		std::string vertexShaderName=VISUALIZER_SHADERDIR;
+		vertexShaderName.append("/SingleChannelRaycaster.vs");
+		dataItem->shader.compileVertexShader(vertexShaderName.c_str());
+		std::string fragmentShaderName=VISUALIZER_SHADERDIR;
+		fragmentShaderName.append("/BrickedSingleChannelRaycaster.fs");
+		dataItem->shader.compileFragmentShader(fragmentShaderName.c_str());
+		dataItem->shader.linkShader();
+		
+		/* Initialize the raycasting shader: */
+		initShader(dataItem);
+		}
+	catch(std::runtime_error err)
+		{
+		/* Print an error message, but continue: */
+		std::cerr<<"BrickedSingleChannelRaycaster::initContext: Caught exception "<<err.what()<<std::endl;
+		}
+	}
+
+void BrickedSingleChannelRaycaster::updateData(void)
+	{
+	/* Bump up the bricked volume's version number; the base class' volume texture is not used: */
+	++volumeVersion;
+	}
+
+bool BrickedSingleChannelRaycaster::needsBricking(const unsigned int dataSize[3])
+	{
+	/* Check the volume size against the largest single 3D texture the raycasters allocate: */
+	size_t numVoxels=1;
+	for(int i=0;i<3;++i)
+		{
+		if(dataSize[i]>512U)
+			return true;
+		numVoxels*=size_t(dataSize[i]);
+		}
+	return numVoxels>size_t(512)*size_t(512)*size_t(512);
+	}
+
+void BrickedSingleChannelRaycaster::setMaxBrickUploads(unsigned int newMaxBrickUploads)
+	{
+	maxBrickUploads=newMaxBrickUploads;
+	}
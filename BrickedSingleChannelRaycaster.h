@@ -0,0 +1,109 @@
+/***********************************************************************
+BrickedSingleChannelRaycaster - Class for volume renderers with a single
+scalar channel whose volume data is too large for a single 3D texture,
+using a bricked voxel store and a texture memory brick cache.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef BRICKEDSINGLECHANNELRAYCASTER_INCLUDED
+#define BRICKEDSINGLECHANNELRAYCASTER_INCLUDED
+
+#include <vector>
+#include <GL/gl.h>
+
+#include <SingleChannelRaycaster.h>
+#include <BrickedVolume.h>
+
+class BrickedSingleChannelRaycaster:public SingleChannelRaycaster
+	{
+	/* Embedded classes: */
+	protected:
+	struct DataItem:public SingleChannelRaycaster::DataItem
+		{
+		/* Elements: */
+		public:
+		GLsizei atlasSize[3]; // Number of brick slots in the brick cache texture in each dimension
+		GLsizei subSlotSize; // Number of voxels along each edge of a sub-slot, including a one-voxel border on each side; each brick slot is split into 2x2x2 sub-slots
+		std::vector<int> brickSlots; // Index of the first brick cache sub-slot holding each brick, or -1
+		std::vector<unsigned int> brickLevels; // Resolution level at which each resident brick is held in the brick cache
+		std::vector<unsigned int> slotBricks; // Index of the brick held by each brick cache sub-slot
+		std::vector<unsigned int> slotLastUses; // Frame number in which each brick cache sub-slot was last visible
+		unsigned int frameNumber; // Number of frames rendered by this context
+		unsigned int volumeVersion; // Version number of the bricked volume held in the brick cache
+		
+		GLuint brickTableTextureID; // Texture object ID for the brick table texture
+		GLsizei brickTableTextureSize[3]; // Size of the brick table texture
+		GLubyte* brickTable; // Local copy of the brick table texture
+		bool brickTableDirty; // Flag whether the brick table texture needs to be uploaded
+		BrickedVolume::Voxel* brickBuffer; // Buffer to upload bricks into the brick cache texture
+		BrickedVolume::Voxel* coarseBrickBuffer; // Buffer to upload full-resolution bricks at the next coarser resolution level
+		BrickedVolume::Voxel* borderBrickBuffer; // Buffer to upload bricks surrounded by a one-voxel border replicating their boundary voxels
+		
+		int brickTableSamplerLoc; // Location of the brick table texture sampler
+		int brickTableScaleLoc; // Location of the scale factor from brick indices to brick table texture coordinates
+		int numBricksLoc; // Location of the number of bricks
+		int brickStepLoc; // Location of the distance between brick origins in voxels
+		int subSlotSizeLoc; // Location of the brick cache sub-slot size in voxels
+		int atlasScaleLoc; // Location of the scale factor from brick cache voxel indices to texture coordinates
+		
+		/* Constructors and destructors: */
+		DataItem(void);
+		virtual ~DataItem(void);
+		};
+	
+	/* Elements: */
+	BrickedVolume volume; // The bricked volume dataset
+	unsigned int volumeVersion; // Version number of the bricked volume dataset to track changes
+	unsigned int maxBrickUploads; // Maximum number of bricks uploaded into each context's brick cache per frame
+	
+	/* Protected methods: */
+	virtual void initVolumeTexture(SingleChannelRaycaster::DataItem* dataItem) const;
+	virtual void initDataItem(Raycaster::DataItem* dataItem) const;
+	virtual void initShader(Raycaster::DataItem* dataItem) const;
+	virtual void bindShader(const PTransform& pmv,const PTransform& mv,Raycaster::DataItem* dataItem) const;
+	virtual void unbindShader(Raycaster::DataItem* dataItem) const;
+	size_t getBrickTableIndex(const DataItem* dataItem,unsigned int brickIndex) const; // Returns the index of the given brick's entry in the brick table
+	void evictBrick(DataItem* dataItem,unsigned int brickIndex) const; // Removes the given brick from the context's brick cache
+	int findCacheSlot(const DataItem* dataItem,bool wholeSlot) const; // Returns the first sub-slot of a whole slot or a single sub-slot that is free or was not visible in the current frame, or -1
+	void updateBrickCache(const PTransform& pmv,DataItem* dataItem) const; // Uploads the bricks visible from the current viewpoint into the context's brick cache
+	
+	/* Constructors and destructors: */
+	public:
+	BrickedSingleChannelRaycaster(const unsigned int sDataSize[3],const Box& sDomain,unsigned int sBrickSize =64,size_t sMaxResidentBricks =2048); // Creates a bricked volume renderer with the given brick size and main memory budget in bricks
+	
+	/* Methods from GLObject: */
+	virtual void initContext(GLContextData& contextData) const;
+	
+	/* Methods from SingleChannelRaycaster: */
+	virtual void updateData(void);
+	
+	/* New methods: */
+	static bool needsBricking(const unsigned int dataSize[3]); // Returns true if a volume of the given size is too large for a single 3D texture
+	const BrickedVolume& getVolume(void) const // Returns the bricked volume dataset
+		{
+		return volume;
+		}
+	BrickedVolume& getVolume(void) // Ditto
+		{
+		return volume;
+		}
+	void setMaxBrickUploads(unsigned int newMaxBrickUploads); // Sets the maximum number of bricks uploaded per frame
+	};
+
+#endif
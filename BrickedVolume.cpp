@@ -0,0 +1,189 @@
+/***********************************************************************
+BrickedVolume - Class to store 8-bit volume data too large for main or
+texture memory as a set of fixed-size bricks, with least-recently-used
+main memory residency and a temporary backing file.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <BrickedVolume.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <Misc/ThrowStdErr.h>
+
+/******************************
+Methods of class BrickedVolume:
+******************************/
+
+int BrickedVolume::makeResident(unsigned int brickIndex)
+	{
+	Brick& brick=bricks[brickIndex];
+	++accessCounter;
+	if(brick.cacheSlot>=0)
+		{
+		/* Mark the brick as most recently used: */
+		slotLastUses[brick.cacheSlot]=accessCounter;
+		return brick.cacheSlot;
+		}
+	
+	/* Find a free cache slot, or the least-recently-used one: */
+	size_t slot=0;
+	for(size_t i=0;i<numCacheSlots;++i)
+		{
+		if(slotBricks[i]==~0U)
+			{
+			slot=i;
+			break;
+			}
+		if(slotLastUses[slot]>slotLastUses[i])
+			slot=i;
+		}
+	Voxel* slotVoxels=cache+slot*brickNumVoxels;
+	
+	if(slotBricks[slot]!=~0U)
+		{
+		/* Evict the brick currently held in the slot: */
+		Brick& evicted=bricks[slotBricks[slot]];
+		if(evicted.dirty)
+			{
+			/* Write the evicted brick to the backing file: */
+			off_t offset=off_t(slotBricks[slot])*off_t(brickNumVoxels);
+			size_t numVoxels=getLevelNumVoxels(evicted.level);
+			if(pwrite(backingFd,slotVoxels,numVoxels,offset)!=ssize_t(numVoxels))
+				Misc::throwStdErr("BrickedVolume: Unable to write brick %u to backing file",slotBricks[slot]);
+			evicted.onDisk=true;
+			evicted.dirty=false;
+			}
+		evicted.cacheSlot=-1;
+		}
+	
+	/* Load the brick from the backing file if it has been written before: */
+	if(brick.onDisk)
+		{
+		off_t offset=off_t(brickIndex)*off_t(brickNumVoxels);
+		size_t numVoxels=getLevelNumVoxels(brick.level);
+		if(pread(backingFd,slotVoxels,numVoxels,offset)!=ssize_t(numVoxels))
+			Misc::throwStdErr("BrickedVolume: Unable to read brick %u from backing file",brickIndex);
+		}
+	else
+		memset(slotVoxels,0,brickNumVoxels*sizeof(Voxel));
+	
+	/* Assign the brick to the slot: */
+	brick.cacheSlot=int(slot);
+	slotBricks[slot]=brickIndex;
+	slotLastUses[slot]=accessCounter;
+	
+	return brick.cacheSlot;
+	}
+
+BrickedVolume::BrickedVolume(const unsigned int sDataSize[3],unsigned int sBrickSize,size_t sMaxResidentBricks)
+	:brickSize(sBrickSize),brickNumVoxels(size_t(brickSize)*size_t(brickSize)*size_t(brickSize)),
+	 cache(0),accessCounter(0),backingFd(-1)
+	{
+	/* Calculate the brick layout; neighboring bricks share one layer of voxels for seamless interpolation: */
+	for(int i=0;i<3;++i)
+		{
+		dataSize[i]=sDataSize[i];
+		numBricks[i]=(dataSize[i]-1+brickSize-2)/(brickSize-1);
+		if(numBricks[i]==0)
+			numBricks[i]=1;
+		}
+	bricks.resize(getTotalNumBricks());
+	
+	/* Allocate the brick cache: */
+	numCacheSlots=sMaxResidentBricks;
+	if(numCacheSlots>bricks.size())
+		numCacheSlots=bricks.size();
+	if(numCacheSlots==0)
+		numCacheSlots=1;
+	cache=new Voxel[numCacheSlots*brickNumVoxels];
+	slotBricks.resize(numCacheSlots,~0U);
+	slotLastUses.resize(numCacheSlots,0);
+	
+	if(numCacheSlots<bricks.size())
+		{
+		/* Create an anonymous temporary backing file for non-resident bricks: */
+		char backingFileName[]="/tmp/BrickedVolumeXXXXXX";
+		backingFd=mkstemp(backingFileName);
+		if(backingFd<0)
+			{
+			delete[] cache;
+			Misc::throwStdErr("BrickedVolume: Unable to create backing file");
+			}
+		unlink(backingFileName);
+		}
+	}
+
+BrickedVolume::~BrickedVolume(void)
+	{
+	delete[] cache;
+	if(backingFd>=0)
+		close(backingFd);
+	}
+
+void BrickedVolume::getBrickOrigin(unsigned int brickIndex,unsigned int origin[3]) const
+	{
+	for(int i=0;i<3;++i)
+		{
+		origin[i]=(brickIndex%numBricks[i])*(brickSize-1);
+		brickIndex/=numBricks[i];
+		}
+	}
+
+size_t BrickedVolume::getNumStoredVoxels(void) const
+	{
+	size_t result=0;
+	for(std::vector<Brick>::const_iterator bIt=bricks.begin();bIt!=bricks.end();++bIt)
+		result+=getLevelNumVoxels(bIt->level);
+	return result;
+	}
+
+void BrickedVolume::writeBrick(unsigned int brickIndex,const Voxel* voxels,unsigned int level)
+	{
+	Threads::Mutex::Lock brickLock(brickMutex);
+	
+	/* Copy the voxels into the brick's cache slot: */
+	int slot=makeResident(brickIndex);
+	size_t numVoxels=getLevelNumVoxels(level);
+	memcpy(cache+slot*brickNumVoxels,voxels,numVoxels*sizeof(Voxel));
+	
+	/* Update the brick's resolution level and value range: */
+	Brick& brick=bricks[brickIndex];
+	brick.level=level;
+	brick.minValue=voxels[0];
+	brick.maxValue=voxels[0];
+	for(size_t i=1;i<numVoxels;++i)
+		{
+		if(brick.minValue>voxels[i])
+			brick.minValue=voxels[i];
+		if(brick.maxValue<voxels[i])
+			brick.maxValue=voxels[i];
+		}
+	brick.dirty=true;
+	}
+
+void BrickedVolume::readBrick(unsigned int brickIndex,Voxel* voxels)
+	{
+	Threads::Mutex::Lock brickLock(brickMutex);
+	
+	/* Copy the voxels out of the brick's cache slot: */
+	int slot=makeResident(brickIndex);
+	memcpy(voxels,cache+slot*brickNumVoxels,getLevelNumVoxels(bricks[brickIndex].level)*sizeof(Voxel));
+	}
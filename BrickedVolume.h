@@ -0,0 +1,137 @@
+/***********************************************************************
+BrickedVolume - Class to store 8-bit volume data too large for main or
+texture memory as a set of fixed-size bricks, with least-recently-used
+main memory residency and a temporary backing file.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef BRICKEDVOLUME_INCLUDED
+#define BRICKEDVOLUME_INCLUDED
+
+#include <stddef.h>
+#include <vector>
+#include <Threads/Mutex.h>
+#include <GL/gl.h>
+
+class BrickedVolume
+	{
+	/* Embedded classes: */
+	public:
+	typedef GLubyte Voxel; // Type for voxel data
+	
+	private:
+	struct Brick // Structure for brick table entries
+		{
+		/* Elements: */
+		public:
+		Voxel minValue,maxValue; // Range of voxel values inside the brick
+		bool onDisk; // Flag whether the brick has a copy in the backing file
+		bool dirty; // Flag whether the resident copy differs from the backing file
+		unsigned int level; // Resolution level at which the brick is stored; level 0 is full resolution
+		int cacheSlot; // Index of the cache slot holding the brick, or -1 if the brick is not resident
+		
+		/* Constructors and destructors: */
+		Brick(void)
+			:minValue(0),maxValue(0),onDisk(false),dirty(false),level(0),cacheSlot(-1)
+			{
+			}
+		};
+	
+	/* Elements: */
+	unsigned int dataSize[3]; // Size of the entire volume in voxels
+	unsigned int brickSize; // Number of voxels along each brick edge, including one voxel of overlap with the next brick
+	unsigned int numBricks[3]; // Number of bricks in each dimension
+	size_t brickNumVoxels; // Number of voxels in each brick
+	Threads::Mutex brickMutex; // Mutex serializing access to the brick table and the cache
+	std::vector<Brick> bricks; // The brick table
+	size_t numCacheSlots; // Maximum number of bricks resident in main memory
+	Voxel* cache; // Memory block holding resident bricks
+	std::vector<unsigned int> slotBricks; // Index of the brick held by each cache slot
+	std::vector<unsigned int> slotLastUses; // Access counter value of the most recent access to each cache slot
+	unsigned int accessCounter; // Counter to track least-recently-used cache slots
+	int backingFd; // File descriptor of the unlinked temporary file holding non-resident bricks
+	
+	/* Private methods: */
+	int makeResident(unsigned int brickIndex); // Makes the given brick resident and returns its cache slot; evicts the least-recently-used brick if necessary
+	
+	/* Constructors and destructors: */
+	public:
+	BrickedVolume(const unsigned int sDataSize[3],unsigned int sBrickSize,size_t sMaxResidentBricks); // Creates an empty bricked volume of the given size
+	private:
+	BrickedVolume(const BrickedVolume& source); // Prohibit copy constructor
+	BrickedVolume& operator=(const BrickedVolume& source); // Prohibit assignment operator
+	public:
+	~BrickedVolume(void);
+	
+	/* Methods: */
+	const unsigned int* getDataSize(void) const // Returns the volume's size
+		{
+		return dataSize;
+		}
+	unsigned int getBrickSize(void) const // Returns the number of voxels along each brick edge
+		{
+		return brickSize;
+		}
+	const unsigned int* getNumBricks(void) const // Returns the number of bricks in each dimension
+		{
+		return numBricks;
+		}
+	unsigned int getTotalNumBricks(void) const // Returns the total number of bricks
+		{
+		return numBricks[0]*numBricks[1]*numBricks[2];
+		}
+	size_t getBrickNumVoxels(void) const // Returns the number of voxels in each brick
+		{
+		return brickNumVoxels;
+		}
+	unsigned int getMaxLevel(void) const // Returns the coarsest resolution level at which bricks can be stored
+		{
+		unsigned int level;
+		for(level=0;((brickSize-1)>>(level+1))>=1U;++level)
+			;
+		return level;
+		}
+	unsigned int getLevelSize(unsigned int level) const // Returns the number of voxels along each brick edge at the given resolution level
+		{
+		return ((brickSize-1)>>level)+1;
+		}
+	size_t getLevelNumVoxels(unsigned int level) const // Returns the number of voxels in a brick stored at the given resolution level
+		{
+		size_t levelSize=getLevelSize(level);
+		return levelSize*levelSize*levelSize;
+		}
+	void getBrickOrigin(unsigned int brickIndex,unsigned int origin[3]) const; // Returns the index of the given brick's first voxel in the volume
+	Voxel getBrickMin(unsigned int brickIndex) const // Returns the smallest voxel value in the given brick
+		{
+		return bricks[brickIndex].minValue;
+		}
+	Voxel getBrickMax(unsigned int brickIndex) const // Returns the largest voxel value in the given brick
+		{
+		return bricks[brickIndex].maxValue;
+		}
+	unsigned int getBrickLevel(unsigned int brickIndex) const // Returns the resolution level at which the given brick is stored
+		{
+		return bricks[brickIndex].level;
+		}
+	size_t getNumStoredVoxels(void) const; // Returns the total number of voxels stored in all bricks at their resolution levels
+	void writeBrick(unsigned int brickIndex,const Voxel* voxels,unsigned int level =0); // Writes a brick's voxels at the given resolution level in x-fastest order; voxels outside the volume should replicate the nearest boundary voxel
+	void readBrick(unsigned int brickIndex,Voxel* voxels); // Reads a brick's voxels at its resolution level in x-fastest order, loading the brick from the backing file if necessary
+	};
+
+#endif
@@ -0,0 +1,271 @@
+/***********************************************************************
+ASCIINumberSource - Class to read whitespace-separated numbers from
+large ASCII files through a block buffer, as a faster replacement for
+IO::ValueSource in the inner loops of ASCII file readers.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_CONCRETE_ASCIINUMBERSOURCE_INCLUDED
+#define VISUALIZATION_CONCRETE_ASCIINUMBERSOURCE_INCLUDED
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdexcept>
+#include <Misc/SizedTypes.h>
+#include <IO/File.h>
+
+namespace Visualization {
+
+namespace Concrete {
+
+class ASCIINumberSource
+	{
+	/* Embedded classes: */
+	public:
+	class NumberError:public std::runtime_error // Exception class to report malformed numbers
+		{
+		/* Constructors and destructors: */
+		public:
+		NumberError(void)
+			:std::runtime_error("ASCIINumberSource: Malformed number")
+			{
+			}
+		};
+	
+	/* Elements: */
+	private:
+	static const size_t bufferSize=65536; // Size of the block buffer
+	static const size_t maxNumberLength=256; // Maximum length of a number token that is guaranteed to be read across block boundaries
+	IO::FilePtr file; // File from which numbers are read
+	bool newlineIsWhitespace; // Flag whether newlines are skipped like other whitespace; otherwise, they must be skipped via skipLine
+	char* buffer; // Block buffer, with one extra byte for a terminating NUL character after the buffered data
+	const char* bufferPtr; // Pointer to the next unread character in the block buffer
+	const char* bufferEnd; // Pointer behind the last buffered character
+	bool fileEof; // Flag whether the file has been read completely
+	
+	/* Private methods: */
+	void fillBuffer(size_t minData) // Moves unread data to the beginning of the buffer and reads more data until at least the given amount is buffered, or the file is over
+		{
+		size_t unread=bufferEnd-bufferPtr;
+		memmove(buffer,bufferPtr,unread);
+		char* end=buffer+unread;
+		do
+			{
+			size_t readSize=file->readUpTo(end,bufferSize-(end-buffer));
+			if(readSize==0)
+				fileEof=true;
+			end+=readSize;
+			}
+		while(!fileEof&&size_t(end-buffer)<minData);
+		*end='\0';
+		bufferPtr=buffer;
+		bufferEnd=end;
+		}
+	bool isWhitespace(char c) const // Returns true if the given character is skipped as whitespace
+		{
+		return c==' '||c=='\t'||c=='\r'||(c=='\n'&&newlineIsWhitespace);
+		}
+	static bool isDigit(char c) // Returns true if the given character is a decimal digit
+		{
+		return (unsigned int)(c-'0')<10U;
+		}
+	static double getPowerOfTen(int exponent) // Returns 10^exponent for exponents between 0 and 22, which are exactly representable
+		{
+		static const double powers[23]={1.0e0,1.0e1,1.0e2,1.0e3,1.0e4,1.0e5,1.0e6,1.0e7,1.0e8,1.0e9,1.0e10,1.0e11,1.0e12,1.0e13,1.0e14,1.0e15,1.0e16,1.0e17,1.0e18,1.0e19,1.0e20,1.0e21,1.0e22};
+		return powers[exponent];
+		}
+	
+	/* Constructors and destructors: */
+	public:
+	ASCIINumberSource(IO::FilePtr sFile,bool sNewlineIsWhitespace=true) // Reads numbers from the given file, starting at its current read position
+		:file(sFile),newlineIsWhitespace(sNewlineIsWhitespace),
+		 buffer(new char[bufferSize+1]),bufferPtr(buffer),bufferEnd(buffer),
+		 fileEof(false)
+		{
+		*buffer='\0';
+		}
+	private:
+	ASCIINumberSource(const ASCIINumberSource& source); // Prohibit copy constructor
+	ASCIINumberSource& operator=(const ASCIINumberSource& source); // Prohibit assignment operator
+	public:
+	~ASCIINumberSource(void)
+		{
+		delete[] buffer;
+		}
+	
+	/* Methods: */
+	bool eof(void) // Returns true if the entire file has been read
+		{
+		if(bufferPtr==bufferEnd&&!fileEof)
+			fillBuffer(1);
+		return bufferPtr==bufferEnd;
+		}
+	int peekc(void) // Returns the next character without reading it, or -1 at the end of the file
+		{
+		if(bufferPtr==bufferEnd&&!fileEof)
+			fillBuffer(1);
+		return bufferPtr!=bufferEnd?int((unsigned char)(*bufferPtr)):-1;
+		}
+	void skipWs(void) // Skips whitespace
+		{
+		while(true)
+			{
+			/* The terminating NUL character stops the scan at the end of the buffered data: */
+			while(isWhitespace(*bufferPtr))
+				++bufferPtr;
+			if(bufferPtr!=bufferEnd||fileEof)
+				break;
+			fillBuffer(1);
+			}
+		}
+	void skipLine(void) // Skips everything up to and including the next newline
+		{
+		while(true)
+			{
+			const char* newline=static_cast<const char*>(memchr(bufferPtr,'\n',bufferEnd-bufferPtr));
+			if(newline!=0)
+				{
+				bufferPtr=newline+1;
+				break;
+				}
+			bufferPtr=bufferEnd;
+			if(fileEof)
+				break;
+			fillBuffer(1);
+			}
+		}
+	int readInteger(void) // Reads a decimal integer and skips whitespace following it
+		{
+		skipWs();
+		if(size_t(bufferEnd-bufferPtr)<maxNumberLength&&!fileEof)
+			fillBuffer(maxNumberLength);
+		
+		const char* cPtr=bufferPtr;
+		bool negative=*cPtr=='-';
+		if(*cPtr=='-'||*cPtr=='+')
+			++cPtr;
+		if(!isDigit(*cPtr))
+			throw NumberError();
+		int result=0;
+		for(;isDigit(*cPtr);++cPtr)
+			result=result*10+int(*cPtr-'0');
+		bufferPtr=cPtr;
+		
+		skipWs();
+		return negative?-result:result;
+		}
+	double readNumber(void) // Reads a decimal floating-point number and skips whitespace following it
+		{
+		skipWs();
+		if(size_t(bufferEnd-bufferPtr)<maxNumberLength&&!fileEof)
+			fillBuffer(maxNumberLength);
+		
+		/* Accumulate up to 19 significant digits into an integer mantissa: */
+		const char* cPtr=bufferPtr;
+		bool negative=*cPtr=='-';
+		if(*cPtr=='-'||*cPtr=='+')
+			++cPtr;
+		Misc::UInt64 mantissa=0;
+		int numSignificantDigits=0;
+		int exponent=0;
+		bool haveDigits=false;
+		bool exact=true;
+		for(;isDigit(*cPtr);++cPtr)
+			{
+			haveDigits=true;
+			if(numSignificantDigits<19)
+				{
+				mantissa=mantissa*10+Misc::UInt64(*cPtr-'0');
+				if(mantissa!=0)
+					++numSignificantDigits;
+				}
+			else
+				{
+				++exponent;
+				exact=false;
+				}
+			}
+		if(*cPtr=='.')
+			{
+			for(++cPtr;isDigit(*cPtr);++cPtr)
+				{
+				haveDigits=true;
+				if(numSignificantDigits<19)
+					{
+					mantissa=mantissa*10+Misc::UInt64(*cPtr-'0');
+					if(mantissa!=0)
+						++numSignificantDigits;
+					--exponent;
+					}
+				else
+					exact=false;
+				}
+			}
+		if(!haveDigits)
+			throw NumberError();
+		
+		/* Parse an optional exponent: */
+		if(*cPtr=='e'||*cPtr=='E')
+			{
+			const char* ePtr=cPtr+1;
+			bool negativeExponent=*ePtr=='-';
+			if(*ePtr=='-'||*ePtr=='+')
+				++ePtr;
+			if(isDigit(*ePtr))
+				{
+				int e=0;
+				for(;isDigit(*ePtr);++ePtr)
+					if(e<100000)
+						e=e*10+int(*ePtr-'0');
+				exponent+=negativeExponent?-e:e;
+				cPtr=ePtr;
+				}
+			}
+		
+		double result;
+		if(exact&&mantissa<=(Misc::UInt64(1)<<53)&&exponent>=-22&&exponent<=22)
+			{
+			/* Both the mantissa and the power of ten are exact, so a single multiplication or division rounds correctly: */
+			result=double(mantissa);
+			if(exponent<0)
+				result/=getPowerOfTen(-exponent);
+			else
+				result*=getPowerOfTen(exponent);
+			if(negative)
+				result=-result;
+			}
+		else
+			{
+			/* Fall back to the C library for numbers that cannot be converted exactly on the fast path: */
+			char* endPtr;
+			result=strtod(bufferPtr,&endPtr);
+			cPtr=endPtr;
+			}
+		bufferPtr=cPtr;
+		
+		skipWs();
+		return result;
+		}
+	};
+
+}
+
+}
+
+#endif
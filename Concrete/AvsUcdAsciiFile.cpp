@@ -1,7 +1,7 @@
 /***********************************************************************
 AvsUcdAsciiFile - Class reading AVS Unstructured Cell Data files in ASCII
 format.
-Copyright (c) 2011 Oliver Kreylos
+Copyright (c) 2011-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -40,6 +40,11 @@ namespace Concrete {
 Methods of class AvsUcdAsciiFile:
 ********************************/
 
+AvsUcdAsciiFile::DataSet* AvsUcdAsciiFile::createDataSet(const std::vector<std::string>& args) const
+	{
+	return new DataSet;
+	}
+
 AvsUcdAsciiFile::AvsUcdAsciiFile(void)
 	:BaseModule("AvsUcdAsciiFile")
 	{
@@ -50,7 +55,7 @@ Visualization::Abstract::DataSet* AvsUcdAsciiFile::load(const std::vector<std::s
 	bool master=pipe==0||pipe->isMaster();
 	
 	/* Create the result data set: */
-	Misc::SelfDestructPointer<DataSet> result(new DataSet);
+	Misc::SelfDestructPointer<DataSet> result(createDataSet(args));
 	DS& dataSet=result->getDs();
 	
 	/* Open the input file: */
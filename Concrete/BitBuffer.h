@@ -1,7 +1,7 @@
 /***********************************************************************
 BitBuffer - Data structure to extract arbitrary-length integers from a
 stream of bytes.
-Copyright (c) 2005-2011 Oliver Kreylos
+Copyright (c) 2005-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef VISUALIZATION_CONCRETE_BITBUFFER_INCLUDED
 #define VISUALIZATION_CONCRETE_BITBUFFER_INCLUDED
 
+#include <Misc/SizedTypes.h>
 #include <Misc/ThrowStdErr.h>
 #include <IO/File.h>
 
@@ -34,7 +35,7 @@ class BitBuffer
 	{
 	/* Elements: */
 	private:
-	typedef unsigned long BufferType; // This should be the longest integer that can be processed quickly by the CPU
+	typedef Misc::UInt64 BufferType; // Use a 64-bit buffer on all platforms, so each refill grabs at least 57 bits and most lossless JPEG differences are decoded without refilling
 	static const int bufferSize=sizeof(BufferType)*8; // Number of bits in the buffer
 	static const int fillSize=bufferSize-7; // Number of bits to grab from the input stream when a buffer underrun occurs
 	
@@ -2,7 +2,7 @@
 CitcomCUCartesianRawFile - Class reading raw files produced by parallel
 regional CITCOMCU simulations. Raw files are binary files stored on each
 processing node describing the grid and result values.
-Copyright (c) 2008-2011 Oliver Kreylos
+Copyright (c) 2008-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -26,6 +26,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <string.h>
 #include <stdlib.h>
 #include <string>
+#include <vector>
 #include <iostream>
 #include <iomanip>
 #include <Misc/SelfDestructPointer.h>
@@ -37,10 +38,228 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <IO/ValueSource.h>
 #include <Math/Math.h>
 
+#include <Templatized/FTLEComputer.h>
+#include <Concrete/ParallelCpuFileReader.h>
+
 namespace Visualization {
 
 namespace Concrete {
 
+namespace {
+
+/*****************************************************************
+Helper class to report the progress of derived variable computations
+on the console in place of an algorithm's busy function:
+*****************************************************************/
+
+class ConsoleProgress
+	{
+	/* Elements: */
+	private:
+	bool master; // Flag whether this node prints progress
+	
+	/* Constructors and destructors: */
+	public:
+	ConsoleProgress(bool sMaster)
+		:master(sMaster)
+		{
+		}
+	
+	/* Methods: */
+	void callBusyFunction(float completionPercentage) // Prints the given completion percentage
+		{
+		if(master)
+			std::cout<<"\b\b\b\b"<<std::setw(3)<<int(completionPercentage+0.5f)<<"%"<<std::flush;
+		}
+	};
+
+/********************************************************************
+Helper function to map a CPU's file number to its position in the CPU
+grid:
+********************************************************************/
+
+inline void getCpuIndex(int cpuNumber,const DS::Index& numCpus,DS::Index& cpuIndex) // Returns the given CPU's position in the CPU grid
+	{
+	cpuIndex[2]=cpuNumber%numCpus[2];
+	cpuNumber/=numCpus[2];
+	cpuIndex[0]=cpuNumber%numCpus[0];
+	cpuNumber/=numCpus[0];
+	cpuIndex[1]=cpuNumber;
+	}
+
+}
+
+/*************************************************************
+Declaration of class CitcomCUCartesianRawFile::GridFileReader:
+*************************************************************/
+
+class CitcomCUCartesianRawFile::GridFileReader
+	{
+	/* Elements: */
+	private:
+	const CitcomCUCartesianRawFile* module; // Module opening the grid files
+	Cluster::MulticastPipe* pipe; // Pipe to open files in a cluster environment
+	std::string fileNameBase; // Common prefix of all grid file names
+	DS& dataSet; // Data set receiving the grid vertex positions
+	DS::Index numCpus; // Number of CPUs along each grid direction
+	DS::Index cpuNumVertices; // Number of grid vertices per CPU
+	std::vector<IO::FilePtr> files; // Opened x, y, and z grid files of all CPUs whose files have not been parsed yet
+	
+	/* Constructors and destructors: */
+	public:
+	GridFileReader(const CitcomCUCartesianRawFile* sModule,Cluster::MulticastPipe* sPipe,const std::string& sFileNameBase,DS& sDataSet,const DS::Index& sNumCpus,const DS::Index& sCpuNumVertices)
+		:module(sModule),pipe(sPipe),fileNameBase(sFileNameBase),
+		 dataSet(sDataSet),
+		 numCpus(sNumCpus),cpuNumVertices(sCpuNumVertices),
+		 files(numCpus.calcIncrement(-1)*3)
+		{
+		}
+	
+	/* Methods: */
+	void openCpuFiles(int cpu) // Opens the given CPU's three grid files
+		{
+		for(int i=0;i<3;++i)
+			{
+			std::string gridFileName=fileNameBase;
+			gridFileName.push_back('.');
+			gridFileName.push_back('x'+i);
+			gridFileName.push_back('.');
+			gridFileName.append(Misc::ValueCoder<int>::encode(cpu));
+			files[cpu*3+i]=module->openFile(gridFileName,pipe);
+			}
+		}
+	void parseCpuFiles(int cpu) // Reads the given CPU's grid vertex positions
+		{
+		/* Calculate the base grid index for this CPU: */
+		DS::Index cpuIndex;
+		getCpuIndex(cpu,numCpus,cpuIndex);
+		DS::Index cpuBase;
+		for(int i=0;i<3;++i)
+			cpuBase[i]=(cpuNumVertices[i]-1)*cpuIndex[i];
+		int totalCpuNumVertices=cpuNumVertices.calcIncrement(-1);
+		
+		/* Read the grid files into a temporary array, skipping each file's first (bogus) element: */
+		std::vector<float> gridVertices(totalCpuNumVertices*3);
+		for(int i=0;i<3;++i)
+			{
+			IO::FilePtr gridFile=files[cpu*3+i];
+			files[cpu*3+i]=0;
+			gridFile->setEndianness(Misc::LittleEndian);
+			gridFile->skip<float>(1);
+			gridFile->read(&gridVertices[totalCpuNumVertices*i],totalCpuNumVertices);
+			}
+		
+		/* Vertices on a CPU's upper block faces are shared with its neighbors, which store them as if the files were read in order: */
+		DS::Index storeEnd;
+		for(int i=0;i<3;++i)
+			storeEnd[i]=cpuIndex[i]<numCpus[i]-1?cpuNumVertices[i]-1:cpuNumVertices[i];
+		
+		/* Assemble and write the CPU's grid vertices: */
+		DS::Index index;
+		int linearIndex=0;
+		for(index[1]=0;index[1]<cpuNumVertices[1];++index[1])
+			for(index[0]=0;index[0]<cpuNumVertices[0];++index[0])
+				for(index[2]=0;index[2]<cpuNumVertices[2];++index[2],++linearIndex)
+					if(index[0]<storeEnd[0]&&index[1]<storeEnd[1]&&index[2]<storeEnd[2])
+						{
+						/* Get a reference to the vertex in the merged grid: */
+						DS::Point& vertex=dataSet.getVertexPosition(DS::Index(cpuBase[0]+index[0],cpuBase[1]+index[1],cpuBase[2]+index[2]));
+						
+						/* Copy the grid point: */
+						for(int i=0;i<3;++i)
+							vertex[i]=Scalar(gridVertices[totalCpuNumVertices*i+linearIndex]);
+						}
+		}
+	};
+
+/**************************************************************
+Declaration of class CitcomCUCartesianRawFile::ValueFileReader:
+**************************************************************/
+
+class CitcomCUCartesianRawFile::ValueFileReader
+	{
+	/* Elements: */
+	private:
+	const CitcomCUCartesianRawFile* module; // Module opening the data files
+	Cluster::MulticastPipe* pipe; // Pipe to open files in a cluster environment
+	std::string fileNamePrefix; // Common prefix of all data file names
+	std::string fileNameSuffix; // Common suffix of all data file names
+	DS& dataSet; // Data set receiving the data values
+	int sliceIndex; // Index of the first slice receiving the data values
+	bool isVector; // Flag whether the files contain vector values
+	bool logScalar; // Flag whether to store the logarithm of scalar values
+	DS::Index numCpus; // Number of CPUs along each grid direction
+	DS::Index cpuNumVertices; // Number of grid vertices per CPU
+	std::vector<IO::FilePtr> files; // Opened data files of all CPUs whose files have not been parsed yet
+	
+	/* Constructors and destructors: */
+	public:
+	ValueFileReader(const CitcomCUCartesianRawFile* sModule,Cluster::MulticastPipe* sPipe,const std::string& sFileNamePrefix,const std::string& sFileNameSuffix,DS& sDataSet,int sSliceIndex,bool sIsVector,bool sLogScalar,const DS::Index& sNumCpus,const DS::Index& sCpuNumVertices)
+		:module(sModule),pipe(sPipe),fileNamePrefix(sFileNamePrefix),fileNameSuffix(sFileNameSuffix),
+		 dataSet(sDataSet),sliceIndex(sSliceIndex),
+		 isVector(sIsVector),logScalar(sLogScalar),
+		 numCpus(sNumCpus),cpuNumVertices(sCpuNumVertices),
+		 files(numCpus.calcIncrement(-1))
+		{
+		}
+	
+	/* Methods: */
+	void openCpuFiles(int cpu) // Opens the given CPU's data file
+		{
+		std::string dataFileName=fileNamePrefix;
+		dataFileName.append(Misc::ValueCoder<int>::encode(cpu));
+		dataFileName.append(fileNameSuffix);
+		files[cpu]=module->openFile(dataFileName,pipe);
+		}
+	void parseCpuFiles(int cpu) // Reads the given CPU's data values
+		{
+		/* Calculate the base grid index for this CPU: */
+		DS::Index cpuIndex;
+		getCpuIndex(cpu,numCpus,cpuIndex);
+		DS::Index cpuBase;
+		for(int i=0;i<3;++i)
+			cpuBase[i]=(cpuNumVertices[i]-1)*cpuIndex[i];
+		int totalCpuNumVertices=cpuNumVertices.calcIncrement(-1);
+		
+		/* Read the data file into a temporary array, skipping the first (bogus) element: */
+		std::vector<float> dataValues(isVector?totalCpuNumVertices*3:totalCpuNumVertices);
+		IO::FilePtr dataFile=files[cpu];
+		files[cpu]=0;
+		dataFile->setEndianness(Misc::LittleEndian);
+		dataFile->skip<float>(1);
+		dataFile->read(&dataValues[0],dataValues.size());
+		
+		/* Vertices on a CPU's upper block faces are shared with its neighbors, which store them as if the files were read in order: */
+		DS::Index storeEnd;
+		for(int i=0;i<3;++i)
+			storeEnd[i]=cpuIndex[i]<numCpus[i]-1?cpuNumVertices[i]-1:cpuNumVertices[i];
+		
+		/* Write the CPU's data values: */
+		DS::Index index;
+		const float* dvPtr=&dataValues[0];
+		for(index[1]=0;index[1]<cpuNumVertices[1];++index[1])
+			for(index[0]=0;index[0]<cpuNumVertices[0];++index[0])
+				for(index[2]=0;index[2]<cpuNumVertices[2];++index[2],dvPtr+=isVector?3:1)
+					if(index[0]<storeEnd[0]&&index[1]<storeEnd[1]&&index[2]<storeEnd[2])
+						{
+						DS::Index gridIndex(cpuBase[0]+index[0],cpuBase[1]+index[1],cpuBase[2]+index[2]);
+						if(isVector)
+							{
+							/* Store the vector value: */
+							DataValue::VVector vector;
+							for(int i=0;i<3;++i)
+								{
+								vector[i]=VScalar(dvPtr[i]);
+								dataSet.getVertexValue(sliceIndex+i,gridIndex)=vector[i];
+								}
+							dataSet.getVertexValue(sliceIndex+3,gridIndex)=VScalar(Geometry::mag(vector));
+							}
+						else
+							dataSet.getVertexValue(sliceIndex,gridIndex)=logScalar?VScalar(Math::log10(double(*dvPtr))):VScalar(*dvPtr);
+						}
+		}
+	};
+
 /*****************************************
 Methods of class CitcomCUCartesianRawFile:
 *****************************************/
@@ -123,64 +342,17 @@ Visualization::Abstract::DataSet* CitcomCUCartesianRawFile::load(const std::vect
 	DS::Index cpuNumVertices;
 	for(int i=0;i<3;++i)
 		cpuNumVertices[i]=(numVertices[i]-1)/numCpus[i]+1;
-	int totalCpuNumVertices=cpuNumVertices.calcIncrement(-1);
-	
-	/* Create temporary arrays to hold the grid vertex components: */
-	float* gridVertices[3];
-	for(int i=0;i<3;++i)
-		gridVertices[i]=new float[totalCpuNumVertices];
 	
-	/* Read grid and value files from each CPU and merge them into the data set: */
+	/* Read grid files from each CPU and merge them into the data set: */
 	if(master)
 		std::cout<<"Reading grid vertex positions...   0%"<<std::flush;
-	int cpuCounter=0;
-	for(DS::Index cpuIndex(0);cpuIndex[0]<numCpus[0];cpuIndex.preInc(numCpus),++cpuCounter)
-		{
-		/* Calculate the base grid index and linear number for this CPU: */
-		DS::Index cpuBase;
-		for(int i=0;i<3;++i)
-			cpuBase[i]=(cpuNumVertices[i]-1)*cpuIndex[i];
-		int cpuNumber=(cpuIndex[1]*numCpus[0]+cpuIndex[0])*numCpus[2]+cpuIndex[2];
-		
-		/* Read the CPU's grid definition files: */
-		for(int i=0;i<3;++i)
-			{
-			/* Read the grid file into the temporary array, skipping the first (bogus) element: */
-			std::string gridFileName=*argIt;
-			gridFileName.push_back('.');
-			gridFileName.push_back('x'+i);
-			gridFileName.push_back('.');
-			gridFileName.append(Misc::ValueCoder<int>::encode(cpuNumber));
-			IO::FilePtr gridFile(openFile(gridFileName,pipe));
-			gridFile->setEndianness(Misc::LittleEndian);
-			gridFile->skip<float>(1);
-			gridFile->read(gridVertices[i],totalCpuNumVertices);
-			}
-		
-		/* Assemble and write the CPU's grid vertices: */
-		DS::Index index;
-		int linearIndex=0;
-		for(index[1]=0;index[1]<cpuNumVertices[1];++index[1])
-			for(index[0]=0;index[0]<cpuNumVertices[0];++index[0])
-				for(index[2]=0;index[2]<cpuNumVertices[2];++index[2],++linearIndex)
-					{
-					/* Get a reference to the vertex in the merged grid: */
-					DS::Point& vertex=dataSet.getVertexPosition(DS::Index(cpuBase[0]+index[0],cpuBase[1]+index[1],cpuBase[2]+index[2]));
-					
-					/* Copy the grid point: */
-					for(int i=0;i<3;++i)
-						vertex[i]=Scalar(gridVertices[i][linearIndex]);
-					}
-		if(master)
-			std::cout<<"\b\b\b\b"<<std::setw(3)<<((cpuCounter+1)*100)/numCpus.calcIncrement(-1)<<"%"<<std::flush;
-		}
+	{
+	GridFileReader gridFileReader(this,pipe,*argIt,dataSet,numCpus,cpuNumVertices);
+	readCpuFiles(numCpus.calcIncrement(-1),gridFileReader,pipe);
+	}
 	if(master)
 		std::cout<<"\b\b\b\bdone"<<std::endl;
 	
-	/* Delete the grid vertex arrays: */
-	for(int i=0;i<3;++i)
-		delete[] gridVertices[i];
-	
 	/* Finalize the grid structure: */
 	if(master)
 		std::cout<<"Finalizing grid structure..."<<std::flush;
@@ -209,21 +381,33 @@ Visualization::Abstract::DataSet* CitcomCUCartesianRawFile::load(const std::vect
 	/* Read all data components given on the command line: */
 	bool logNextScalar=false;
 	bool nextVector=false;
+	Scalar ftleTime(0);
 	for(++argIt;argIt!=args.end();++argIt)
 		{
 		if(strcasecmp(argIt->c_str(),"-log")==0)
 			logNextScalar=true;
 		else if(strcasecmp(argIt->c_str(),"-vector")==0)
 			nextVector=true;
+		else if(strcasecmp(argIt->c_str(),"-ftle")==0)
+			{
+			/* Read the integration time for the FTLE field of the next vector variable (a load-time option of this module only; the FTLE field is computed once and added as a scalar variable): */
+			++argIt;
+			if(argIt==args.end())
+				Misc::throwStdErr("CitcomCUCartesianRawFile::load: missing integration time after -ftle");
+			ftleTime=Scalar(atof(argIt->c_str()));
+			if(ftleTime==Scalar(0))
+				Misc::throwStdErr("CitcomCUCartesianRawFile::load: invalid integration time %s after -ftle",argIt->c_str());
+			}
 		else
 			{
 			/* Remember the (base) slice index for this variable: */
 			int sliceIndex=dataSet.getNumSlices();
+			int vectorVariableIndex=-1;
 			
 			if(nextVector)
 				{
 				/* Add another vector variable to the data value: */
-				int vectorVariableIndex=dataValue.addVectorVariable(argIt->c_str());
+				vectorVariableIndex=dataValue.addVectorVariable(argIt->c_str());
 				if(master)
 					std::cout<<"Reading vector variable "<<*argIt<<"...   0%"<<std::flush;
 				
@@ -257,66 +441,39 @@ Visualization::Abstract::DataSet* CitcomCUCartesianRawFile::load(const std::vect
 					}
 				}
 			
-			/* Create a temporary array for the data values: */
-			float* dataValues=new float[nextVector?totalCpuNumVertices*3:totalCpuNumVertices];
-			
 			/* Read data files for all CPUs: */
-			cpuCounter=0;
-			for(DS::Index cpuIndex(0);cpuIndex[0]<numCpus[0];cpuIndex.preInc(numCpus),++cpuCounter)
-				{
-				/* Calculate the base grid index and linear number for this CPU: */
-				DS::Index cpuBase;
-				for(int i=0;i<3;++i)
-					cpuBase[i]=(cpuNumVertices[i]-1)*cpuIndex[i];
-				int cpuNumber=(cpuIndex[1]*numCpus[0]+cpuIndex[0])*numCpus[2]+cpuIndex[2];
-				
-				/* Read the data file into the temporary array, skipping the first (bogus) element: */
-				std::string dataFileName=args[0];
-				dataFileName.push_back('.');
-				dataFileName.append(*argIt);
-				dataFileName.push_back('.');
-				dataFileName.append(Misc::ValueCoder<int>::encode(cpuNumber));
-				dataFileName.push_back('.');
-				dataFileName.append(Misc::ValueCoder<int>::encode(timeStepIndex));
-				IO::FilePtr dataFile(openFile(dataFileName,pipe));
-				dataFile->setEndianness(Misc::LittleEndian);
-				dataFile->skip<float>(1);
-				dataFile->read(dataValues,nextVector?totalCpuNumVertices*3:totalCpuNumVertices);
-				
-				/* Write the CPU's data values: */
-				DS::Index index;
-				float* dvPtr=dataValues;
-				for(index[1]=0;index[1]<cpuNumVertices[1];++index[1])
-					for(index[0]=0;index[0]<cpuNumVertices[0];++index[0])
-						for(index[2]=0;index[2]<cpuNumVertices[2];++index[2])
-							{
-							DS::Index gridIndex(cpuBase[0]+index[0],cpuBase[1]+index[1],cpuBase[2]+index[2]);
-							if(nextVector)
-								{
-								/* Store the vector value: */
-								DataValue::VVector vector;
-								for(int i=0;i<3;++i)
-									{
-									vector[i]=VScalar(dvPtr[i]);
-									dataSet.getVertexValue(sliceIndex+i,gridIndex)=vector[i];
-									}
-								dataSet.getVertexValue(sliceIndex+3,gridIndex)=VScalar(Geometry::mag(vector));
-								dvPtr+=3;
-								}
-							else
-								{
-								dataSet.getVertexValue(sliceIndex,gridIndex)=logNextScalar?VScalar(Math::log10(double(*dvPtr))):VScalar(*dvPtr);
-								++dvPtr;
-								}
-							}
-				if(master)
-					std::cout<<"\b\b\b\b"<<std::setw(3)<<((cpuCounter+1)*100)/numCpus.calcIncrement(-1)<<"%"<<std::flush;
-				}
+			{
+			std::string dataFileNamePrefix=args[0];
+			dataFileNamePrefix.push_back('.');
+			dataFileNamePrefix.append(*argIt);
+			dataFileNamePrefix.push_back('.');
+			std::string dataFileNameSuffix=".";
+			dataFileNameSuffix.append(Misc::ValueCoder<int>::encode(timeStepIndex));
+			ValueFileReader valueFileReader(this,pipe,dataFileNamePrefix,dataFileNameSuffix,dataSet,sliceIndex,nextVector,logNextScalar,numCpus,cpuNumVertices);
+			readCpuFiles(numCpus.calcIncrement(-1),valueFileReader,pipe);
+			}
 			if(master)
 				std::cout<<"\b\b\b\bdone"<<std::endl;
 			
-			/* Delete the temporary array: */
-			delete[] dataValues;
+			if(nextVector&&ftleTime!=Scalar(0))
+				{
+				/* Compute the vector variable's FTLE field as an additional scalar variable: */
+				std::string ftleName="FTLE(";
+				ftleName.append(*argIt);
+				ftleName.push_back(')');
+				if(master)
+					std::cout<<"Computing scalar variable "<<ftleName<<"...   0%"<<std::flush;
+				Visualization::Templatized::FTLEComputer<DS,DataValue::VE> ftleComputer(&dataSet,dataValue.getVectorExtractor(vectorVariableIndex));
+				ftleComputer.setIntegrationTime(ftleTime);
+				std::vector<VScalar> ftleValues(numVertices.calcIncrement(-1));
+				ConsoleProgress progress(master);
+				ftleComputer.computeFTLE(&ftleValues[0],&progress);
+				dataSet.addSlice(&ftleValues[0]);
+				dataValue.addScalarVariable(ftleName.c_str());
+				if(master)
+					std::cout<<"\b\b\b\bdone"<<std::endl;
+				ftleTime=Scalar(0);
+				}
 			
 			if(nextVector)
 				nextVector=false;
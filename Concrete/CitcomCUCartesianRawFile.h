@@ -2,7 +2,7 @@
 CitcomCUCartesianRawFile - Class reading raw files produced by parallel
 regional CITCOMCU simulations. Raw files are binary files stored on each
 processing node describing the grid and result values.
-Copyright (c) 2008-2011 Oliver Kreylos
+Copyright (c) 2008-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -46,6 +46,13 @@ typedef Visualization::Wrappers::Module<DS,DataValue> BaseModule; // Module base
 
 class CitcomCUCartesianRawFile:public BaseModule
 	{
+	/* Embedded classes: */
+	private:
+	class GridFileReader; // Class to read the per-CPU grid files
+	friend class GridFileReader;
+	class ValueFileReader; // Class to read the per-CPU data files of one variable
+	friend class ValueFileReader;
+	
 	/* Constructors and destructors: */
 	public:
 	CitcomCUCartesianRawFile(void); // Default constructor
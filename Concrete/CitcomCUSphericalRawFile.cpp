@@ -2,7 +2,7 @@
 CitcomCUSphericalRawFile - Class reading raw files produced by parallel
 regional CITCOMCU simulations. Raw files are binary files stored on each
 processing node describing the grid and result values.
-Copyright (c) 2008-2011 Oliver Kreylos
+Copyright (c) 2008-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -25,8 +25,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <string.h>
 #include <stdio.h>
+#include <string>
+#include <vector>
 #include <iostream>
-#include <iomanip>
 #include <Misc/SelfDestructPointer.h>
 #include <Misc/ThrowStdErr.h>
 #include <Misc/StandardValueCoders.h>
@@ -38,11 +39,239 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <Concrete/SphericalCoordinateTransformer.h>
 #include <Concrete/EarthDataSet.h>
+#include <Concrete/ParallelCpuFileReader.h>
 
 namespace Visualization {
 
 namespace Concrete {
 
+namespace {
+
+/********************************************************************
+Helper function to map a CPU's file number to its position in the CPU
+grid:
+********************************************************************/
+
+inline void getCpuIndex(int cpuNumber,const DS::Index& numCpus,DS::Index& cpuIndex) // Returns the given CPU's position in the CPU grid
+	{
+	cpuIndex[2]=cpuNumber%numCpus[2];
+	cpuNumber/=numCpus[2];
+	cpuIndex[0]=cpuNumber%numCpus[0];
+	cpuNumber/=numCpus[0];
+	cpuIndex[1]=cpuNumber;
+	}
+
+}
+
+/*************************************************************
+Declaration of class CitcomCUSphericalRawFile::GridFileReader:
+*************************************************************/
+
+class CitcomCUSphericalRawFile::GridFileReader
+	{
+	/* Elements: */
+	private:
+	const CitcomCUSphericalRawFile* module; // Module opening the grid files
+	Cluster::MulticastPipe* pipe; // Pipe to open files in a cluster environment
+	std::string fileNameBase; // Common prefix of all grid file names
+	DS& dataSet; // Data set receiving the grid vertex positions
+	bool storeSphericals; // Flag whether to store the vertices' spherical coordinates as scalar slices
+	DS::Index numCpus; // Number of CPUs along each grid direction
+	DS::Index cpuNumVertices; // Number of grid vertices per CPU
+	std::vector<IO::FilePtr> files; // Opened x, y, and z grid files of all CPUs whose files have not been parsed yet
+	
+	/* Constructors and destructors: */
+	public:
+	GridFileReader(const CitcomCUSphericalRawFile* sModule,Cluster::MulticastPipe* sPipe,const std::string& sFileNameBase,DS& sDataSet,bool sStoreSphericals,const DS::Index& sNumCpus,const DS::Index& sCpuNumVertices)
+		:module(sModule),pipe(sPipe),fileNameBase(sFileNameBase),
+		 dataSet(sDataSet),storeSphericals(sStoreSphericals),
+		 numCpus(sNumCpus),cpuNumVertices(sCpuNumVertices),
+		 files(numCpus.calcIncrement(-1)*3)
+		{
+		}
+	
+	/* Methods: */
+	void openCpuFiles(int cpu) // Opens the given CPU's three grid files
+		{
+		for(int i=0;i<3;++i)
+			{
+			std::string gridFileName=fileNameBase;
+			gridFileName.push_back('.');
+			gridFileName.push_back('x'+i);
+			gridFileName.push_back('.');
+			gridFileName.append(Misc::ValueCoder<int>::encode(cpu));
+			files[cpu*3+i]=module->openFile(gridFileName,pipe);
+			}
+		}
+	void parseCpuFiles(int cpu) // Reads the given CPU's grid vertex positions
+		{
+		/* Calculate the base grid index for this CPU: */
+		DS::Index cpuIndex;
+		getCpuIndex(cpu,numCpus,cpuIndex);
+		DS::Index cpuBase;
+		for(int i=0;i<3;++i)
+			cpuBase[i]=(cpuNumVertices[i]-1)*cpuIndex[i];
+		int totalCpuNumVertices=cpuNumVertices.calcIncrement(-1);
+		
+		/* Read the grid files into a temporary array, skipping each file's first (bogus) element: */
+		std::vector<float> gridVertices(totalCpuNumVertices*3);
+		for(int i=0;i<3;++i)
+			{
+			IO::FilePtr gridFile=files[cpu*3+i];
+			files[cpu*3+i]=0;
+			gridFile->setEndianness(Misc::LittleEndian);
+			gridFile->skip<float>(1);
+			gridFile->read(&gridVertices[totalCpuNumVertices*i],totalCpuNumVertices);
+			}
+		
+		/* Vertices on a CPU's upper block faces are shared with its neighbors, which store them as if the files were read in order: */
+		DS::Index storeEnd;
+		for(int i=0;i<3;++i)
+			storeEnd[i]=cpuIndex[i]<numCpus[i]-1?cpuNumVertices[i]-1:cpuNumVertices[i];
+		
+		/* Prepare the spherical-to-Cartesian formula: */
+		const double a=6378.14e3; // Equatorial radius in m
+		// const double f=1.0/298.247; // Geoid flattening factor (not used, since there could be vector values)
+		const double scaleFactor=1.0e-3; // Scale factor for Cartesian coordinates
+		
+		/* Assemble and write the CPU's grid vertices: */
+		const float* colatitudes=&gridVertices[0];
+		const float* longitudes=&gridVertices[totalCpuNumVertices];
+		const float* radii=&gridVertices[totalCpuNumVertices*2];
+		DS::Index index;
+		int linearIndex=0;
+		for(index[1]=0;index[1]<cpuNumVertices[1];++index[1])
+			for(index[0]=0;index[0]<cpuNumVertices[0];++index[0])
+				for(index[2]=0;index[2]<cpuNumVertices[2];++index[2],++linearIndex)
+					if(index[0]<storeEnd[0]&&index[1]<storeEnd[1]&&index[2]<storeEnd[2])
+						{
+						/* Get a reference to the vertex in the merged grid: */
+						DS::Index gIndex=cpuBase+index;
+						DS::Point& vertex=dataSet.getVertexPosition(gIndex);
+						
+						/* Convert the input grid point from spherical to Cartesian coordinates: */
+						double latitude=Math::rad(90.0)-double(colatitudes[linearIndex]);
+						double s0=Math::sin(latitude);
+						double c0=Math::cos(latitude);
+						double longitude=double(longitudes[linearIndex]);
+						double s1=Math::sin(longitude);
+						double c1=Math::cos(longitude);
+						double r=double(radii[linearIndex])*a*scaleFactor;
+						double xy=r*c0;
+						vertex[0]=Scalar(xy*c1);
+						vertex[1]=Scalar(xy*s1);
+						vertex[2]=Scalar(r*s0);
+						
+						if(storeSphericals)
+							{
+							dataSet.getVertexValue(0,gIndex)=Scalar(Math::deg(double(colatitudes[linearIndex])));
+							dataSet.getVertexValue(1,gIndex)=Scalar(Math::deg(longitude));
+							dataSet.getVertexValue(2,gIndex)=Scalar(r);
+							}
+						}
+		}
+	};
+
+/**************************************************************
+Declaration of class CitcomCUSphericalRawFile::ValueFileReader:
+**************************************************************/
+
+class CitcomCUSphericalRawFile::ValueFileReader
+	{
+	/* Elements: */
+	private:
+	const CitcomCUSphericalRawFile* module; // Module opening the data files
+	Cluster::MulticastPipe* pipe; // Pipe to open files in a cluster environment
+	std::string fileNamePrefix; // Common prefix of all data file names
+	std::string fileNameSuffix; // Common suffix of all data file names
+	DS& dataSet; // Data set receiving the data values
+	int sliceIndex; // Index of the first slice receiving the data values
+	bool isVector; // Flag whether the files contain vector values
+	bool logScalar; // Flag whether to store the logarithm of scalar values
+	DS::Index numCpus; // Number of CPUs along each grid direction
+	DS::Index cpuNumVertices; // Number of grid vertices per CPU
+	std::vector<IO::FilePtr> files; // Opened data files of all CPUs whose files have not been parsed yet
+	
+	/* Constructors and destructors: */
+	public:
+	ValueFileReader(const CitcomCUSphericalRawFile* sModule,Cluster::MulticastPipe* sPipe,const std::string& sFileNamePrefix,const std::string& sFileNameSuffix,DS& sDataSet,int sSliceIndex,bool sIsVector,bool sLogScalar,const DS::Index& sNumCpus,const DS::Index& sCpuNumVertices)
+		:module(sModule),pipe(sPipe),fileNamePrefix(sFileNamePrefix),fileNameSuffix(sFileNameSuffix),
+		 dataSet(sDataSet),sliceIndex(sSliceIndex),
+		 isVector(sIsVector),logScalar(sLogScalar),
+		 numCpus(sNumCpus),cpuNumVertices(sCpuNumVertices),
+		 files(numCpus.calcIncrement(-1))
+		{
+		}
+	
+	/* Methods: */
+	void openCpuFiles(int cpu) // Opens the given CPU's data file
+		{
+		std::string dataFileName=fileNamePrefix;
+		dataFileName.append(Misc::ValueCoder<int>::encode(cpu));
+		dataFileName.append(fileNameSuffix);
+		files[cpu]=module->openFile(dataFileName,pipe);
+		}
+	void parseCpuFiles(int cpu) // Reads the given CPU's data values
+		{
+		/* Calculate the base grid index for this CPU: */
+		DS::Index cpuIndex;
+		getCpuIndex(cpu,numCpus,cpuIndex);
+		DS::Index cpuBase;
+		for(int i=0;i<3;++i)
+			cpuBase[i]=(cpuNumVertices[i]-1)*cpuIndex[i];
+		int totalCpuNumVertices=cpuNumVertices.calcIncrement(-1);
+		
+		/* Read the data file into a temporary array, skipping the first (bogus) element: */
+		std::vector<float> dataValues(isVector?totalCpuNumVertices*3:totalCpuNumVertices);
+		IO::FilePtr dataFile=files[cpu];
+		files[cpu]=0;
+		dataFile->setEndianness(Misc::LittleEndian);
+		dataFile->skip<float>(1);
+		dataFile->read(&dataValues[0],dataValues.size());
+		
+		/* Vertices on a CPU's upper block faces are shared with its neighbors, which store them as if the files were read in order: */
+		DS::Index storeEnd;
+		for(int i=0;i<3;++i)
+			storeEnd[i]=cpuIndex[i]<numCpus[i]-1?cpuNumVertices[i]-1:cpuNumVertices[i];
+		
+		/* Write the CPU's data values: */
+		DS::Index index;
+		const float* dvPtr=&dataValues[0];
+		for(index[1]=0;index[1]<cpuNumVertices[1];++index[1])
+			for(index[0]=0;index[0]<cpuNumVertices[0];++index[0])
+				for(index[2]=0;index[2]<cpuNumVertices[2];++index[2],dvPtr+=isVector?3:1)
+					if(index[0]<storeEnd[0]&&index[1]<storeEnd[1]&&index[2]<storeEnd[2])
+						{
+						DS::Index gridIndex(cpuBase[0]+index[0],cpuBase[1]+index[1],cpuBase[2]+index[2]);
+						if(isVector)
+							{
+							/* Convert the vector from spherical to Cartesian coordinates: */
+							const DS::Point& p=dataSet.getVertexPosition(gridIndex);
+							double xy=Math::sqr(double(p[0]))+Math::sqr(double(p[1]));
+							double r=xy+Math::sqr(double(p[2]));
+							xy=Math::sqrt(xy);
+							r=Math::sqrt(r);
+							double s0=double(p[2])/r;
+							double c0=xy/r;
+							double s1=double(p[1])/xy;
+							double c1=double(p[0])/xy;
+							DataValue::VVector vector;
+							vector[0]=VScalar(c1*(c0*double(dvPtr[2])+s0*double(dvPtr[0]))-s1*double(dvPtr[1]));
+							vector[1]=VScalar(s1*(c0*double(dvPtr[2])+s0*double(dvPtr[0]))+c1*double(dvPtr[1]));
+							vector[2]=VScalar(s0*dvPtr[2]-c0*dvPtr[0]);
+							dataSet.getVertexValue(sliceIndex+0,gridIndex)=VScalar(dvPtr[0]);
+							dataSet.getVertexValue(sliceIndex+1,gridIndex)=VScalar(dvPtr[1]);
+							dataSet.getVertexValue(sliceIndex+2,gridIndex)=VScalar(dvPtr[2]);
+							for(int i=0;i<3;++i)
+								dataSet.getVertexValue(sliceIndex+3+i,gridIndex)=vector[i];
+							dataSet.getVertexValue(sliceIndex+6,gridIndex)=VScalar(Geometry::mag(vector));
+							}
+						else
+							dataSet.getVertexValue(sliceIndex,gridIndex)=logScalar?VScalar(Math::log10(double(*dvPtr))):VScalar(*dvPtr);
+						}
+		}
+	};
+
 /*****************************************
 Methods of class CitcomCUSphericalRawFile:
 *****************************************/
@@ -152,85 +381,16 @@ Visualization::Abstract::DataSet* CitcomCUSphericalRawFile::load(const std::vect
 	DS::Index cpuNumVertices;
 	for(int i=0;i<3;++i)
 		cpuNumVertices[i]=(numVertices[i]-1)/numCpus[i]+1;
-	int totalCpuNumVertices=cpuNumVertices.calcIncrement(-1);
-	
-	/* Create temporary arrays to hold the grid vertex components: */
-	float* gridVertices[3];
-	for(int i=0;i<3;++i)
-		gridVertices[i]=new float[totalCpuNumVertices];
 	
-	/* Read grid and value files from each CPU and merge them into the data set: */
+	/* Read grid files from each CPU and merge them into the data set: */
 	if(master)
 		std::cout<<"Reading grid vertex positions...   0%"<<std::flush;
-	int cpuCounter=0;
-	for(DS::Index cpuIndex(0);cpuIndex[0]<numCpus[0];cpuIndex.preInc(numCpus),++cpuCounter)
-		{
-		/* Calculate the base grid index and linear number for this CPU: */
-		DS::Index cpuBase;
-		for(int i=0;i<3;++i)
-			cpuBase[i]=(cpuNumVertices[i]-1)*cpuIndex[i];
-		int cpuNumber=(cpuIndex[1]*numCpus[0]+cpuIndex[0])*numCpus[2]+cpuIndex[2];
-		
-		/* Read the CPU's grid definition files: */
-		for(int i=0;i<3;++i)
-			{
-			/* Read the grid file into the temporary array, skipping the first (bogus) element: */
-			std::string gridFileName=*argIt;
-			gridFileName.push_back('.');
-			gridFileName.push_back('x'+i);
-			gridFileName.push_back('.');
-			gridFileName.append(Misc::ValueCoder<int>::encode(cpuNumber));
-			IO::FilePtr gridFile(openFile(gridFileName,pipe));
-			gridFile->setEndianness(Misc::LittleEndian);
-			gridFile->skip<float>(1);
-			gridFile->read(gridVertices[i],totalCpuNumVertices);
-			}
-		
-		/* Prepare the spherical-to-Cartesian formula: */
-		const double a=6378.14e3; // Equatorial radius in m
-		// const double f=1.0/298.247; // Geoid flattening factor (not used, since there could be vector values)
-		const double scaleFactor=1.0e-3; // Scale factor for Cartesian coordinates
-		
-		/* Assemble and write the CPU's grid vertices: */
-		DS::Index index;
-		int linearIndex=0;
-		for(index[1]=0;index[1]<cpuNumVertices[1];++index[1])
-			for(index[0]=0;index[0]<cpuNumVertices[0];++index[0])
-				for(index[2]=0;index[2]<cpuNumVertices[2];++index[2],++linearIndex)
-					{
-					/* Get a reference to the vertex in the merged grid: */
-					DS::Index gIndex=cpuBase+index;
-					DS::Point& vertex=dataSet.getVertexPosition(gIndex);
-					
-					/* Convert the input grid point from spherical to Cartesian coordinates: */
-					double latitude=Math::rad(90.0)-double(gridVertices[0][linearIndex]);
-					double s0=Math::sin(latitude);
-					double c0=Math::cos(latitude);
-					double longitude=double(gridVertices[1][linearIndex]);
-					double s1=Math::sin(longitude);
-					double c1=Math::cos(longitude);
-					double r=double(gridVertices[2][linearIndex])*a*scaleFactor;
-					double xy=r*c0;
-					vertex[0]=Scalar(xy*c1);
-					vertex[1]=Scalar(xy*s1);
-					vertex[2]=Scalar(r*s0);
-					
-					if(storeSphericals)
-						{
-						dataSet.getVertexValue(0,gIndex)=Scalar(Math::deg(double(gridVertices[0][linearIndex])));
-						dataSet.getVertexValue(1,gIndex)=Scalar(Math::deg(longitude));
-						dataSet.getVertexValue(2,gIndex)=Scalar(r);
-						}
-					}
-		if(master)
-			std::cout<<"\b\b\b\b"<<std::setw(3)<<((cpuCounter+1)*100)/numCpus.calcIncrement(-1)<<"%"<<std::flush;
-		}
+	{
+	GridFileReader gridFileReader(this,pipe,*argIt,dataSet,storeSphericals,numCpus,cpuNumVertices);
+	readCpuFiles(numCpus.calcIncrement(-1),gridFileReader,pipe);
+	}
 	if(master)
 		std::cout<<"\b\b\b\bdone"<<std::endl;
-
-	/* Delete the grid vertex arrays: */
-	for(int i=0;i<3;++i)
-		delete[] gridVertices[i];
 	
 	/* Finalize the grid structure: */
 	if(master)
@@ -307,79 +467,20 @@ Visualization::Abstract::DataSet* CitcomCUSphericalRawFile::load(const std::vect
 					}
 				}
 			
-			/* Create a temporary array for the data values: */
-			float* dataValues=new float[nextVector?totalCpuNumVertices*3:totalCpuNumVertices];
-			
 			/* Read data files for all CPUs: */
-			cpuCounter=0;
-			for(DS::Index cpuIndex(0);cpuIndex[0]<numCpus[0];cpuIndex.preInc(numCpus),++cpuCounter)
-				{
-				/* Calculate the base grid index and linear number for this CPU: */
-				DS::Index cpuBase;
-				for(int i=0;i<3;++i)
-					cpuBase[i]=(cpuNumVertices[i]-1)*cpuIndex[i];
-				int cpuNumber=(cpuIndex[1]*numCpus[0]+cpuIndex[0])*numCpus[2]+cpuIndex[2];
-				
-				/* Read the data file into the temporary array, skipping the first (bogus) element: */
-				std::string dataFileName=args[0];
-				dataFileName.push_back('.');
-				dataFileName.append(*argIt);
-				dataFileName.push_back('.');
-				dataFileName.append(Misc::ValueCoder<int>::encode(cpuNumber));
-				dataFileName.push_back('.');
-				dataFileName.append(Misc::ValueCoder<int>::encode(timeStepIndex));
-				IO::FilePtr dataFile(openFile(dataFileName,pipe));
-				dataFile->setEndianness(Misc::LittleEndian);
-				dataFile->skip<float>(1);
-				dataFile->read(dataValues,nextVector?totalCpuNumVertices*3:totalCpuNumVertices);
-				
-				/* Write the CPU's data values: */
-				DS::Index index;
-				float* dvPtr=dataValues;
-				for(index[1]=0;index[1]<cpuNumVertices[1];++index[1])
-					for(index[0]=0;index[0]<cpuNumVertices[0];++index[0])
-						for(index[2]=0;index[2]<cpuNumVertices[2];++index[2])
-							{
-							DS::Index gridIndex(cpuBase[0]+index[0],cpuBase[1]+index[1],cpuBase[2]+index[2]);
-							if(nextVector)
-								{
-								/* Convert the vector from spherical to Cartesian coordinates: */
-								const DS::Point& p=dataSet.getVertexPosition(gridIndex);
-								double xy=Math::sqr(double(p[0]))+Math::sqr(double(p[1]));
-								double r=xy+Math::sqr(double(p[2]));
-								xy=Math::sqrt(xy);
-								r=Math::sqrt(r);
-								double s0=double(p[2])/r;
-								double c0=xy/r;
-								double s1=double(p[1])/xy;
-								double c1=double(p[0])/xy;
-								DataValue::VVector vector;
-								vector[0]=VScalar(c1*(c0*double(dvPtr[2])+s0*double(dvPtr[0]))-s1*double(dvPtr[1]));
-								vector[1]=VScalar(s1*(c0*double(dvPtr[2])+s0*double(dvPtr[0]))+c1*double(dvPtr[1]));
-								vector[2]=VScalar(s0*dvPtr[2]-c0*dvPtr[0]);
-								dataSet.getVertexValue(sliceIndex+0,gridIndex)=VScalar(dvPtr[0]);
-								dataSet.getVertexValue(sliceIndex+1,gridIndex)=VScalar(dvPtr[1]);
-								dataSet.getVertexValue(sliceIndex+2,gridIndex)=VScalar(dvPtr[2]);
-								for(int i=0;i<3;++i)
-									dataSet.getVertexValue(sliceIndex+3+i,gridIndex)=vector[i];
-								dataSet.getVertexValue(sliceIndex+6,gridIndex)=VScalar(Geometry::mag(vector));
-								dvPtr+=3;
-								}
-							else
-								{
-								dataSet.getVertexValue(sliceIndex,gridIndex)=logNextScalar?VScalar(Math::log10(double(*dvPtr))):VScalar(*dvPtr);
-								++dvPtr;
-								}
-							}
-				if(master)
-					std::cout<<"\b\b\b\b"<<std::setw(3)<<((cpuCounter+1)*100)/numCpus.calcIncrement(-1)<<"%"<<std::flush;
-				}
+			{
+			std::string dataFileNamePrefix=args[0];
+			dataFileNamePrefix.push_back('.');
+			dataFileNamePrefix.append(*argIt);
+			dataFileNamePrefix.push_back('.');
+			std::string dataFileNameSuffix=".";
+			dataFileNameSuffix.append(Misc::ValueCoder<int>::encode(timeStepIndex));
+			ValueFileReader valueFileReader(this,pipe,dataFileNamePrefix,dataFileNameSuffix,dataSet,sliceIndex,nextVector,logNextScalar,numCpus,cpuNumVertices);
+			readCpuFiles(numCpus.calcIncrement(-1),valueFileReader,pipe);
+			}
 			if(master)
 				std::cout<<"\b\b\b\bdone"<<std::endl;
 			
-			/* Delete the temporary array: */
-			delete[] dataValues;
-			
 			if(nextVector)
 				nextVector=false;
 			else
@@ -2,7 +2,7 @@
 CitcomSRegionalASCIIFile - Class reading ASCII files produced by
 parallel regional CitcomS simulations. These are the uncombined files
 produced by each CPU in a parallel run.
-Copyright (c) 2008-2012 Oliver Kreylos
+Copyright (c) 2008-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -24,116 +24,94 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Concrete/CitcomSRegionalASCIIFile.h>
 
 #include <string>
+#include <vector>
 #include <iostream>
-#include <iomanip>
+#include <Misc/SizedTypes.h>
 #include <Misc/SelfDestructPointer.h>
 #include <Misc/ThrowStdErr.h>
 #include <Misc/StandardValueCoders.h>
 #include <Plugins/FactoryManager.h>
 #include <IO/OpenFile.h>
-#include <IO/ValueSource.h>
 #include <Cluster/MulticastPipe.h>
 #include <Math/Math.h>
 #include <Math/Constants.h>
 
 #include <Concrete/SphericalCoordinateTransformer.h>
 #include <Concrete/EarthDataSet.h>
+#include <Concrete/ASCIINumberSource.h>
 #include <Concrete/CitcomSCfgFileParser.h>
+#include <Concrete/ParallelCpuFileReader.h>
 
 namespace Visualization {
 
 namespace Concrete {
 
-/*****************************************
-Methods of class CitcomSRegionalASCIIFile:
-*****************************************/
+namespace {
 
-CitcomSRegionalASCIIFile::CitcomSRegionalASCIIFile(void)
-	:BaseModule("CitcomSRegionalASCIIFile")
+/********************************************************************
+Helper function to map a CPU's file number to its position in the CPU
+grid:
+********************************************************************/
+
+inline void getCpuIndex(int cpuNumber,const DS::Index& numCpus,DS::Index& cpuIndex) // Returns the given CPU's position in the CPU grid
 	{
+	cpuIndex[2]=cpuNumber%numCpus[2];
+	cpuNumber/=numCpus[2];
+	cpuIndex[0]=cpuNumber%numCpus[0];
+	cpuNumber/=numCpus[0];
+	cpuIndex[1]=cpuNumber;
 	}
 
-Visualization::Abstract::DataSet* CitcomSRegionalASCIIFile::load(const std::vector<std::string>& args,Cluster::MulticastPipe* pipe) const
+}
+
+/**************************************************************
+Declaration of class CitcomSRegionalASCIIFile::CoordFileReader:
+**************************************************************/
+
+class CitcomSRegionalASCIIFile::CoordFileReader
 	{
-	bool master=pipe==0||pipe->isMaster();
-	
-	/* Create the result data set: */
-	Misc::SelfDestructPointer<EarthDataSet<DataSet> > result(new EarthDataSet<DataSet>(args));
-	result->setFlatteningFactor(0.0);
-	result->getSphericalCoordinateTransformer()->setColatitude(true);
+	/* Elements: */
+	private:
+	const CitcomSRegionalASCIIFile* module; // Module opening the coordinate files
+	Cluster::MulticastPipe* pipe; // Pipe to open files in a cluster environment
+	std::string fileNameBase; // Common prefix of all coordinate file names
+	DS& dataSet; // Data set receiving the grid vertex positions
+	bool storeSphericals; // Flag whether to store the vertices' spherical coordinates as scalar slices
+	DS::Index numCpus; // Number of CPUs along each grid direction
+	DS::Index cpuNumVertices; // Number of grid vertices per CPU
+	std::vector<std::string> fileNames; // Names of all CPUs' coordinate files
+	std::vector<IO::FilePtr> files; // Opened coordinate files of all CPUs whose files have not been parsed yet
 	
-	/* Parse command line parameters related to the grid definition file: */
-	std::vector<std::string>::const_iterator argIt=args.begin();
-	bool storeSphericals=false;
-	while((*argIt)[0]=='-')
+	/* Constructors and destructors: */
+	public:
+	CoordFileReader(const CitcomSRegionalASCIIFile* sModule,Cluster::MulticastPipe* sPipe,const std::string& sFileNameBase,DS& sDataSet,bool sStoreSphericals,const DS::Index& sNumCpus,const DS::Index& sCpuNumVertices,int numCpuFiles)
+		:module(sModule),pipe(sPipe),fileNameBase(sFileNameBase),
+		 dataSet(sDataSet),storeSphericals(sStoreSphericals),
+		 numCpus(sNumCpus),cpuNumVertices(sCpuNumVertices),
+		 fileNames(numCpuFiles),files(numCpuFiles)
 		{
-		/* Parse the command line parameter: */
-		if(*argIt=="-storeCoords")
-			storeSphericals=true;
-		
-		++argIt;
 		}
 	
-	/* Parse the run's configuration file: */
-	std::string fullCfgName=getFullPath(*argIt);
-	IO::FilePtr cfgFile(openFile(fullCfgName,pipe));
-	std::string dataDir;
-	std::string dataFileName;
-	int numSurfaces=0;
-	DS::Index numCpus(0,0,0);
-	DS::Index numVertices(0,0,0);
-	parseCitcomSCfgFile(fullCfgName,cfgFile,dataDir,dataFileName,numSurfaces,numCpus,numVertices);
-	if(numSurfaces==0||numCpus.calcIncrement(-1)==0||numVertices.calcIncrement(-1)==0)
-		Misc::throwStdErr("CitcomSRegionalASCIIFile::load: %s is not a valid CitcomS configuration file",fullCfgName.c_str());
-	
-	/* Check if it's really a regional model: */
-	if(numSurfaces!=1)
-		Misc::throwStdErr("CitcomSRegionalASCIIFile::load: configuration file %s does not describe a regional model; use CitcomSGlobalASCIIFile instead",fullCfgName.c_str());
-	
-	/* Initialize the data set: */
-	DS& dataSet=result->getDs();
-	dataSet.setGrid(numVertices);
-	
-	/* Initialize the result data set's data value: */
-	DataValue& dataValue=result->getDataValue();
-	dataValue.initialize(&dataSet,0);
-	
-	if(storeSphericals)
+	/* Methods: */
+	void openCpuFiles(int cpu) // Opens the given CPU's coordinate file
 		{
-		/* Add three slices to the data set: */
-		static const char* coordSliceNames[3]={"Colatitude","Longitude","Radius"};
-		for(int i=0;i<3;++i)
-			{
-			dataSet.addSlice();
-			dataValue.addScalarVariable(coordSliceNames[i]);
-			}
+		fileNames[cpu]=fileNameBase;
+		fileNames[cpu].append(Misc::ValueCoder<int>::encode(cpu));
+		files[cpu]=module->openFile(fileNames[cpu],pipe);
 		}
-	
-	/* Compute the number of nodes per CPU: */
-	DS::Index cpuNumVertices;
-	for(int i=0;i<3;++i)
-		cpuNumVertices[i]=(numVertices[i]-1)/numCpus[i]+1;
-	int totalCpuNumVertices=cpuNumVertices.calcIncrement(-1);
-	
-	/* Prepare the spherical-to-Cartesian formula: */
-	const double a=6378.14e3; // Equatorial radius in m
-	// const double f=1.0/298.247; // Geoid flattening factor (not used, since there could be vector values)
-	const double scaleFactor=1.0e-3; // Scale factor for Cartesian coordinates
-	
-	/* Read the grid coordinate files for all CPUs: */
-	if(master)
-		std::cout<<"Reading grid vertex positions...   0%"<<std::flush;
-	int cpuCounter=0;
-	DS::GridArray& grid=dataSet.getGrid();
-	for(DS::Index cpuIndex(0);cpuIndex[0]<numCpus[0];cpuIndex.preInc(numCpus),++cpuCounter)
+	void parseCpuFiles(int cpu) // Reads the given CPU's grid vertex positions
 		{
-		/* Open the CPU's coordinate file: */
-		int cpuLinearIndex=(cpuIndex[1]*numCpus[0]+cpuIndex[0])*numCpus[2]+cpuIndex[2];
-		std::string coordFileName=dataDir;
-		coordFileName.append(dataFileName);
-		coordFileName.append(".coord.");
-		coordFileName.append(Misc::ValueCoder<int>::encode(cpuLinearIndex));
-		IO::ValueSource coordReader(openFile(coordFileName,pipe));
+		/* Prepare the spherical-to-Cartesian formula: */
+		const double a=6378.14e3; // Equatorial radius in m
+		// const double f=1.0/298.247; // Geoid flattening factor (not used, since there could be vector values)
+		const double scaleFactor=1.0e-3; // Scale factor for Cartesian coordinates
+		
+		DS::Index cpuIndex;
+		getCpuIndex(cpu,numCpus,cpuIndex);
+		DS::GridArray& grid=dataSet.getGrid();
+		const std::string& coordFileName=fileNames[cpu];
+		ASCIINumberSource coordReader(files[cpu]);
+		files[cpu]=0;
 		coordReader.skipWs();
 		
 		/* Read and check the header line: */
@@ -143,10 +121,10 @@ Visualization::Abstract::DataSet* CitcomSRegionalASCIIFile::load(const std::vect
 			coordReader.readInteger();
 			
 			/* Read the number of vertices: */
-			if(coordReader.readInteger()!=totalCpuNumVertices)
+			if(coordReader.readInteger()!=cpuNumVertices.calcIncrement(-1))
 				Misc::throwStdErr("CitcomSRegionalASCIIFile::load: Mismatching grid size in coordinate file %s",coordFileName.c_str());
 			}
-		catch(IO::ValueSource::NumberError err)
+		catch(ASCIINumberSource::NumberError err)
 			{
 			Misc::throwStdErr("CitcomSRegionalASCIIFile::load: Invalid header line in coordinate file %s",coordFileName.c_str());
 			}
@@ -156,6 +134,11 @@ Visualization::Abstract::DataSet* CitcomSRegionalASCIIFile::load(const std::vect
 		for(int i=0;i<3;++i)
 			cpuBaseIndex[i]=(cpuNumVertices[i]-1)*cpuIndex[i];
 		
+		/* Vertices on a CPU's upper block faces are shared with its neighbors, which store them as if the files were read in order: */
+		DS::Index storeEnd;
+		for(int i=0;i<3;++i)
+			storeEnd[i]=cpuIndex[i]<numCpus[i]-1?cpuNumVertices[i]-1:cpuNumVertices[i];
+		
 		/* Read the grid vertices: */
 		DS::Index gridIndex;
 		for(gridIndex[1]=0;gridIndex[1]<cpuNumVertices[1];++gridIndex[1])
@@ -168,6 +151,8 @@ Visualization::Abstract::DataSet* CitcomSRegionalASCIIFile::load(const std::vect
 						double colatitude=coordReader.readNumber();
 						double longitude=coordReader.readNumber();
 						double radius=coordReader.readNumber();
+						if(gridIndex[0]>=storeEnd[0]||gridIndex[1]>=storeEnd[1]||gridIndex[2]>=storeEnd[2])
+							continue;
 						
 						/* Convert the vertex to Cartesian coordinates: */
 						double latitude=Math::rad(90.0)-colatitude;
@@ -191,14 +176,292 @@ Visualization::Abstract::DataSet* CitcomSRegionalASCIIFile::load(const std::vect
 							dataSet.getVertexValue(2,gIndex)=Scalar(r);
 							}
 						}
-					catch(IO::ValueSource::NumberError err)
+					catch(ASCIINumberSource::NumberError err)
 						{
 						Misc::throwStdErr("CitcomSRegionalASCIIFile::load: Invalid vertex definition in coordinate file %s",coordFileName.c_str());
 						}
 					}
+		}
+	};
+
+/**************************************************************
+Declaration of class CitcomSRegionalASCIIFile::ValueFileReader:
+**************************************************************/
+
+class CitcomSRegionalASCIIFile::ValueFileReader:public DataValue::SliceLoader
+	{
+	/* Elements: */
+	private:
+	const CitcomSRegionalASCIIFile* module; // Module opening the data value files
+	Cluster::MulticastPipe* pipe; // Pipe to open files in a cluster environment
+	std::string fileNamePrefix; // Common prefix of all data value file names
+	std::string fileNameSuffix; // Common suffix of all data value file names
+	DS& dataSet; // Data set receiving the data values
+	int sliceIndex; // Index of the first slice receiving the data values
+	bool isVeloFile; // Flag whether the files are the special-case velo two-variable files
+	bool isVector; // Flag whether the files contain vector values
+	bool logScalar; // Flag whether to store the logarithm of scalar values
+	DS::Index numCpus; // Number of CPUs along each grid direction
+	DS::Index cpuNumVertices; // Number of grid vertices per CPU
+	std::vector<std::string> fileNames; // Names of all CPUs' data value files
+	std::vector<IO::FilePtr> files; // Opened data value files of all CPUs whose files have not been parsed yet
+	std::string variableDescription; // Description of the variable for progress messages
+	
+	/* Constructors and destructors: */
+	public:
+	ValueFileReader(const CitcomSRegionalASCIIFile* sModule,Cluster::MulticastPipe* sPipe,const std::string& sFileNamePrefix,const std::string& sFileNameSuffix,DS& sDataSet,int sSliceIndex,bool sIsVeloFile,bool sIsVector,bool sLogScalar,const DS::Index& sNumCpus,const DS::Index& sCpuNumVertices,int numCpuFiles,const std::string& sVariableDescription)
+		:module(sModule),pipe(sPipe),fileNamePrefix(sFileNamePrefix),fileNameSuffix(sFileNameSuffix),
+		 dataSet(sDataSet),sliceIndex(sSliceIndex),
+		 isVeloFile(sIsVeloFile),isVector(sIsVector),logScalar(sLogScalar),
+		 numCpus(sNumCpus),cpuNumVertices(sCpuNumVertices),
+		 fileNames(numCpuFiles),files(numCpuFiles),
+		 variableDescription(sVariableDescription)
+		{
+		}
+	
+	/* Methods: */
+	std::string getFileName(int cpu) const // Returns the name of the given CPU's data value file
+		{
+		std::string result=fileNamePrefix;
+		result.append(Misc::ValueCoder<int>::encode(cpu));
+		result.append(fileNameSuffix);
+		return result;
+		}
+	void readHeader(ASCIINumberSource& dataValueReader,const std::string& dataValueFileName) const // Reads and checks the header line(s) of a data value file
+		{
+		int totalCpuNumVertices=cpuNumVertices.calcIncrement(-1);
+		try
+			{
+			int dataValueFileNumVertices1=totalCpuNumVertices;
+			if(isVeloFile)
+				{
+				/* Read the first header line only found in velo files: */
+				dataValueReader.readInteger();
+				dataValueFileNumVertices1=dataValueReader.readInteger();
+				dataValueReader.readNumber();
+				}
+			
+			/* Read the common header line: */
+			dataValueReader.readInteger();
+			int dataValueFileNumVertices2=dataValueReader.readInteger();
+			
+			/* Check for consistency: */
+			if(dataValueFileNumVertices1!=totalCpuNumVertices||dataValueFileNumVertices2!=totalCpuNumVertices)
+				Misc::throwStdErr("CitcomSRegionalASCIIFile::load: Mismatching grid size in data value file %s",dataValueFileName.c_str());
+			}
+		catch(ASCIINumberSource::NumberError err)
+			{
+			Misc::throwStdErr("CitcomSRegionalASCIIFile::load: Invalid header line in data value file %s",dataValueFileName.c_str());
+			}
+		}
+	void validateCpuFiles(void) // Checks the sizes and header lines of all CPUs' data value files without reading their values
+		{
+		/* Each vertex needs at least two characters per value: */
+		int numVertexValues=isVeloFile?4:(isVector?3:1);
+		Misc::UInt64 minFileSize=Misc::UInt64(cpuNumVertices.calcIncrement(-1))*Misc::UInt64(numVertexValues)*2U;
+		for(int cpu=0;cpu<int(files.size());++cpu)
+			{
+			std::string dataValueFileName=getFileName(cpu);
+			module->checkFileSize(dataValueFileName,minFileSize);
+			ASCIINumberSource dataValueReader(module->openFile(dataValueFileName,pipe));
+			dataValueReader.skipWs();
+			readHeader(dataValueReader,dataValueFileName);
+			}
+		}
+	void openCpuFiles(int cpu) // Opens the given CPU's data value file
+		{
+		fileNames[cpu]=getFileName(cpu);
+		files[cpu]=module->openFile(fileNames[cpu],pipe);
+		}
+	void parseCpuFiles(int cpu) // Reads the given CPU's data values
+		{
+		DS::Index cpuIndex;
+		getCpuIndex(cpu,numCpus,cpuIndex);
+		const DS::GridArray& grid=dataSet.getGrid();
+		const std::string& dataValueFileName=fileNames[cpu];
+		ASCIINumberSource dataValueReader(files[cpu]);
+		files[cpu]=0;
+		dataValueReader.skipWs();
+		
+		/* Read and check the header line(s) in the data value file: */
+		readHeader(dataValueReader,dataValueFileName);
+		
+		/* Compute the CPU's base index in the surface's grid: */
+		DS::Index cpuBaseIndex;
+		for(int i=0;i<3;++i)
+			cpuBaseIndex[i]=(cpuNumVertices[i]-1)*cpuIndex[i];
+		
+		/* Vertices on a CPU's upper block faces are shared with its neighbors, which store them as if the files were read in order: */
+		DS::Index storeEnd;
+		for(int i=0;i<3;++i)
+			storeEnd[i]=cpuIndex[i]<numCpus[i]-1?cpuNumVertices[i]-1:cpuNumVertices[i];
+		
+		/* Read the grid vertices: */
+		DS::Index gridIndex;
+		for(gridIndex[1]=0;gridIndex[1]<cpuNumVertices[1];++gridIndex[1])
+			for(gridIndex[0]=0;gridIndex[0]<cpuNumVertices[0];++gridIndex[0])
+				for(gridIndex[2]=0;gridIndex[2]<cpuNumVertices[2];++gridIndex[2])
+					{
+					/* Read the next vertex' value: */
+					DS::Index index=cpuBaseIndex+gridIndex;
+					bool store=gridIndex[0]<storeEnd[0]&&gridIndex[1]<storeEnd[1]&&gridIndex[2]<storeEnd[2];
+					
+					try
+						{
+						if(isVeloFile||isVector)
+							{
+							/* Read the vector components: */
+							double colatitude=dataValueReader.readNumber();
+							double longitude=dataValueReader.readNumber();
+							double radius=dataValueReader.readNumber();
+							
+							if(store)
+								{
+								/* Convert the vector from spherical to Cartesian coordinates: */
+								const DS::Point& p=grid(index);
+								double xy=Math::sqr(double(p[0]))+Math::sqr(double(p[1]));
+								double r=xy+Math::sqr(double(p[2]));
+								xy=Math::sqrt(xy);
+								r=Math::sqrt(r);
+								double s0=double(p[2])/r;
+								double c0=xy/r;
+								double s1=double(p[1])/xy;
+								double c1=double(p[0])/xy;
+								DataValue::VVector vector;
+								vector[0]=VScalar(c1*(c0*radius+s0*colatitude)-s1*longitude);
+								vector[1]=VScalar(s1*(c0*radius+s0*colatitude)+c1*longitude);
+								vector[2]=VScalar(s0*radius-c0*colatitude);
+								dataSet.getVertexValue(sliceIndex+0,index)=VScalar(colatitude);
+								dataSet.getVertexValue(sliceIndex+1,index)=VScalar(longitude);
+								dataSet.getVertexValue(sliceIndex+2,index)=VScalar(radius);
+								for(int i=0;i<3;++i)
+									dataSet.getVertexValue(sliceIndex+3+i,index)=vector[i];
+								dataSet.getVertexValue(sliceIndex+6,index)=VScalar(Geometry::mag(vector));
+								}
+							
+							if(isVeloFile)
+								{
+								/* Read the temperature value: */
+								double temp=dataValueReader.readNumber();
+								if(store)
+									dataSet.getVertexValue(sliceIndex+7,index)=logScalar?VScalar(Math::log10(temp)):VScalar(temp);
+								}
+							}
+						else
+							{
+							/* Read the scalar value: */
+							double value=dataValueReader.readNumber();
+							if(store)
+								dataSet.getVertexValue(sliceIndex,index)=logScalar?VScalar(Math::log10(value)):VScalar(value);
+							}
+						}
+					catch(ASCIINumberSource::NumberError err)
+						{
+						Misc::throwStdErr("CitcomSRegionalASCIIFile::load: Invalid vertex value definition in data value file %s",dataValueFileName.c_str());
+						}
+					}
+		}
+	
+	/* Methods from DataValue::SliceLoader: */
+	virtual void loadSlices(void) // Reads the data value files of all CPUs
+		{
+		bool master=pipe==0||pipe->isMaster();
+		if(master)
+			std::cout<<"Reading "<<variableDescription<<"...   0%"<<std::flush;
+		readCpuFiles(int(files.size()),*this,pipe);
 		if(master)
-			std::cout<<"\b\b\b\b"<<std::setw(3)<<((cpuCounter+1)*100)/numCpus.calcIncrement(-1)<<"%"<<std::flush;
+			std::cout<<"\b\b\b\bdone"<<std::endl;
 		}
+	};
+
+/*****************************************
+Methods of class CitcomSRegionalASCIIFile:
+*****************************************/
+
+CitcomSRegionalASCIIFile::DataSet* CitcomSRegionalASCIIFile::createDataSet(const std::vector<std::string>& args) const
+	{
+	/* Create an Earth data set using colatitude coordinates on a perfect sphere: */
+	EarthDataSet<DataSet>* result=new EarthDataSet<DataSet>(args);
+	result->setFlatteningFactor(0.0);
+	result->getSphericalCoordinateTransformer()->setColatitude(true);
+	return result;
+	}
+
+CitcomSRegionalASCIIFile::CitcomSRegionalASCIIFile(void)
+	:BaseModule("CitcomSRegionalASCIIFile")
+	{
+	}
+
+Visualization::Abstract::DataSet* CitcomSRegionalASCIIFile::load(const std::vector<std::string>& args,Cluster::MulticastPipe* pipe) const
+	{
+	bool master=pipe==0||pipe->isMaster();
+	
+	/* Create the result data set: */
+	Misc::SelfDestructPointer<DataSet> result(createDataSet(args));
+	
+	/* Parse command line parameters related to the grid definition file: */
+	std::vector<std::string>::const_iterator argIt=args.begin();
+	bool storeSphericals=false;
+	while((*argIt)[0]=='-')
+		{
+		/* Parse the command line parameter: */
+		if(*argIt=="-storeCoords")
+			storeSphericals=true;
+		
+		++argIt;
+		}
+	
+	/* Parse the run's configuration file: */
+	std::string fullCfgName=getFullPath(*argIt);
+	IO::FilePtr cfgFile(openFile(fullCfgName,pipe));
+	std::string dataDir;
+	std::string dataFileName;
+	int numSurfaces=0;
+	DS::Index numCpus(0,0,0);
+	DS::Index numVertices(0,0,0);
+	parseCitcomSCfgFile(fullCfgName,cfgFile,dataDir,dataFileName,numSurfaces,numCpus,numVertices);
+	if(numSurfaces==0||numCpus.calcIncrement(-1)==0||numVertices.calcIncrement(-1)==0)
+		Misc::throwStdErr("CitcomSRegionalASCIIFile::load: %s is not a valid CitcomS configuration file",fullCfgName.c_str());
+	
+	/* Check if it's really a regional model: */
+	if(numSurfaces!=1)
+		Misc::throwStdErr("CitcomSRegionalASCIIFile::load: configuration file %s does not describe a regional model; use CitcomSGlobalASCIIFile instead",fullCfgName.c_str());
+	
+	/* Initialize the data set: */
+	DS& dataSet=result->getDs();
+	dataSet.setGrid(numVertices);
+	
+	/* Initialize the result data set's data value: */
+	DataValue& dataValue=result->getDataValue();
+	dataValue.initialize(&dataSet,0);
+	
+	if(storeSphericals)
+		{
+		/* Add three slices to the data set: */
+		static const char* coordSliceNames[3]={"Colatitude","Longitude","Radius"};
+		for(int i=0;i<3;++i)
+			{
+			dataSet.addSlice();
+			dataValue.addScalarVariable(coordSliceNames[i]);
+			}
+		}
+	
+	/* Compute the number of nodes per CPU: */
+	DS::Index cpuNumVertices;
+	for(int i=0;i<3;++i)
+		cpuNumVertices[i]=(numVertices[i]-1)/numCpus[i]+1;
+	int numCpuFiles=numCpus.calcIncrement(-1);
+	
+	/* Read the grid coordinate files for all CPUs: */
+	if(master)
+		std::cout<<"Reading grid vertex positions...   0%"<<std::flush;
+	{
+	std::string coordFileNameBase=dataDir;
+	coordFileNameBase.append(dataFileName);
+	coordFileNameBase.append(".coord.");
+	CoordFileReader coordFileReader(this,pipe,coordFileNameBase,dataSet,storeSphericals,numCpus,cpuNumVertices,numCpuFiles);
+	readCpuFiles(numCpuFiles,coordFileReader,pipe);
+	}
 	if(master)
 		std::cout<<"\b\b\b\bdone"<<std::endl;
 	
@@ -236,6 +499,7 @@ Visualization::Abstract::DataSet* CitcomSRegionalASCIIFile::load(const std::vect
 			{
 			/* Remember the (base) slice index for this variable: */
 			int sliceIndex=dataSet.getNumSlices();
+			std::string variableDescription;
 			
 			/* Check if it's the special-case velo two-variable file (bleargh): */
 			bool isVeloFile=*argIt=="velo";
@@ -243,8 +507,8 @@ Visualization::Abstract::DataSet* CitcomSRegionalASCIIFile::load(const std::vect
 				{
 				/* Add another vector variable to the data value: */
 				int vectorVariableIndex=dataValue.addVectorVariable(argIt->c_str());
-				if(master)
-					std::cout<<"Reading vector variable "<<*argIt<<"...   0%"<<std::flush;
+				variableDescription="vector variable ";
+				variableDescription.append(*argIt);
 				
 				/* Add seven new slices to the data set (3 components spherical and Cartesian each plus Cartesian magnitude): */
 				static const char* componentNames[7]={" Colatitude"," Longitude"," Radius"," X"," Y"," Z"," Magnitude"};
@@ -279,128 +543,39 @@ Visualization::Abstract::DataSet* CitcomSRegionalASCIIFile::load(const std::vect
 					scalarName.append(*argIt);
 					scalarName.push_back(')');
 					dataValue.addScalarVariable(scalarName.c_str());
-					if(master)
-						std::cout<<"Reading scalar variable "<<scalarName<<"...   0%"<<std::flush;
+					variableDescription="scalar variable ";
+					variableDescription.append(scalarName);
 					}
 				else
 					{
 					dataValue.addScalarVariable(argIt->c_str());
-					if(master)
-						std::cout<<"Reading scalar variable "<<*argIt<<"...   0%"<<std::flush;
+					variableDescription="scalar variable ";
+					variableDescription.append(*argIt);
 					}
 				}
 			
 			/* Read data files for all CPUs: */
-			cpuCounter=0;
-			DS::GridArray& grid=dataSet.getGrid();
-			for(DS::Index cpuIndex(0);cpuIndex[0]<numCpus[0];cpuIndex.preInc(numCpus),++cpuCounter)
+			{
+			std::string dataValueFileNamePrefix=dataDir;
+			dataValueFileNamePrefix.append(dataFileName);
+			dataValueFileNamePrefix.push_back('.');
+			dataValueFileNamePrefix.append(*argIt);
+			dataValueFileNamePrefix.push_back('.');
+			std::string dataValueFileNameSuffix=".";
+			dataValueFileNameSuffix.append(Misc::ValueCoder<int>::encode(timeStepIndex));
+			Misc::SelfDestructPointer<ValueFileReader> reader(new ValueFileReader(this,pipe,dataValueFileNamePrefix,dataValueFileNameSuffix,dataSet,sliceIndex,isVeloFile,nextVector,logNextScalar,numCpus,cpuNumVertices,numCpuFiles,variableDescription));
+			if(pipe==0)
 				{
-				/* Open the CPU's data value file: */
-				int cpuLinearIndex=(cpuIndex[1]*numCpus[0]+cpuIndex[0])*numCpus[2]+cpuIndex[2];
-				std::string dataValueFileName=dataDir;
-				dataValueFileName.append(dataFileName);
-				dataValueFileName.push_back('.');
-				dataValueFileName.append(*argIt);
-				dataValueFileName.push_back('.');
-				dataValueFileName.append(Misc::ValueCoder<int>::encode(cpuLinearIndex));
-				dataValueFileName.push_back('.');
-				dataValueFileName.append(Misc::ValueCoder<int>::encode(timeStepIndex));
-				IO::ValueSource dataValueReader(openFile(dataValueFileName,pipe));
-				dataValueReader.skipWs();
-				
-				/* Read and check the header line(s) in the data value file: */
-				try
-					{
-					int dataValueFileNumVertices1=totalCpuNumVertices;
-					if(isVeloFile)
-						{
-						/* Read the first header line only found in velo files: */
-						dataValueReader.readInteger();
-						dataValueFileNumVertices1=dataValueReader.readInteger();
-						dataValueReader.readNumber();
-						}
-					
-					/* Read the common header line: */
-					dataValueReader.readInteger();
-					int dataValueFileNumVertices2=dataValueReader.readInteger();
-					
-					/* Check for consistency: */
-					if(dataValueFileNumVertices1!=totalCpuNumVertices||dataValueFileNumVertices2!=totalCpuNumVertices)
-						Misc::throwStdErr("CitcomSRegionalASCIIFile::load: Mismatching grid size in data value file %s",dataValueFileName.c_str());
-					}
-				catch(IO::ValueSource::NumberError err)
-					{
-					Misc::throwStdErr("CitcomSRegionalASCIIFile::load: Invalid header line in data value file %s",dataValueFileName.c_str());
-					}
-				
-				/* Compute the CPU's base index in the surface's grid: */
-				DS::Index cpuBaseIndex;
-				for(int i=0;i<3;++i)
-					cpuBaseIndex[i]=(cpuNumVertices[i]-1)*cpuIndex[i];
-				
-				/* Read the grid vertices: */
-				DS::Index gridIndex;
-				for(gridIndex[1]=0;gridIndex[1]<cpuNumVertices[1];++gridIndex[1])
-					for(gridIndex[0]=0;gridIndex[0]<cpuNumVertices[0];++gridIndex[0])
-						for(gridIndex[2]=0;gridIndex[2]<cpuNumVertices[2];++gridIndex[2])
-							{
-							/* Read the next vertex' value: */
-							DS::Index index=cpuBaseIndex+gridIndex;
-							
-							try
-								{
-								if(isVeloFile||nextVector)
-									{
-									/* Read the vector components: */
-									double colatitude=dataValueReader.readNumber();
-									double longitude=dataValueReader.readNumber();
-									double radius=dataValueReader.readNumber();
-									
-									/* Convert the vector from spherical to Cartesian coordinates: */
-									const DS::Point& p=grid(index);
-									double xy=Math::sqr(double(p[0]))+Math::sqr(double(p[1]));
-									double r=xy+Math::sqr(double(p[2]));
-									xy=Math::sqrt(xy);
-									r=Math::sqrt(r);
-									double s0=double(p[2])/r;
-									double c0=xy/r;
-									double s1=double(p[1])/xy;
-									double c1=double(p[0])/xy;
-									DataValue::VVector vector;
-									vector[0]=VScalar(c1*(c0*radius+s0*colatitude)-s1*longitude);
-									vector[1]=VScalar(s1*(c0*radius+s0*colatitude)+c1*longitude);
-									vector[2]=VScalar(s0*radius-c0*colatitude);
-									dataSet.getVertexValue(sliceIndex+0,index)=VScalar(colatitude);
-									dataSet.getVertexValue(sliceIndex+1,index)=VScalar(longitude);
-									dataSet.getVertexValue(sliceIndex+2,index)=VScalar(radius);
-									for(int i=0;i<3;++i)
-										dataSet.getVertexValue(sliceIndex+3+i,index)=vector[i];
-									dataSet.getVertexValue(sliceIndex+6,index)=VScalar(Geometry::mag(vector));
-									
-									if(isVeloFile)
-										{
-										/* Read the temperature value: */
-										double temp=dataValueReader.readNumber();
-										dataSet.getVertexValue(sliceIndex+7,index)=logNextScalar?VScalar(Math::log10(temp)):VScalar(temp);
-										}
-									}
-								else
-									{
-									/* Read the scalar value: */
-									double value=dataValueReader.readNumber();
-									dataSet.getVertexValue(sliceIndex,index)=logNextScalar?VScalar(Math::log10(value)):VScalar(value);
-									}
-								}
-							catch(IO::ValueSource::NumberError err)
-								{
-								Misc::throwStdErr("CitcomSRegionalASCIIFile::load: Invalid vertex value definition in data value file %s",dataValueFileName.c_str());
-								}
-							}
-				if(master)
-					std::cout<<"\b\b\b\b"<<std::setw(3)<<((cpuCounter+1)*100)/numCpus.calcIncrement(-1)<<"%"<<std::flush;
+				/* Check the data value files' sizes and headers now, but defer reading their values until one of the variable's slices is first used: */
+				reader->validateCpuFiles();
+				dataValue.setSliceLoader(sliceIndex,dataSet.getNumSlices()-sliceIndex,reader.releaseTarget());
 				}
-			if(master)
-				std::cout<<"\b\b\b\bdone"<<std::endl;
+			else
+				{
+				/* Data value files on a cluster stream through multicast pipes, which all nodes must consume in lockstep, so read them right away: */
+				reader->loadSlices();
+				}
+			}
 			
 			if(nextVector)
 				nextVector=false;
@@ -2,7 +2,7 @@
 CitcomSRegionalASCIIFile - Class reading ASCII files produced by
 parallel regional CitcomS simulations. These are the uncombined files
 produced by each CPU in a parallel run.
-Copyright (c) 2008-2012 Oliver Kreylos
+Copyright (c) 2008-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -46,6 +46,17 @@ typedef Visualization::Wrappers::Module<DS,DataValue> BaseModule; // Module base
 
 class CitcomSRegionalASCIIFile:public BaseModule
 	{
+	/* Embedded classes: */
+	private:
+	class CoordFileReader; // Class to read the per-CPU grid coordinate files
+	friend class CoordFileReader;
+	class ValueFileReader; // Class to read the per-CPU data value files of one variable, possibly deferred until first use
+	friend class ValueFileReader;
+	
+	/* Protected methods from BaseModule: */
+	protected:
+	virtual DataSet* createDataSet(const std::vector<std::string>& args) const;
+	
 	/* Constructors and destructors: */
 	public:
 	CitcomSRegionalASCIIFile(void); // Default constructor
@@ -1,7 +1,7 @@
 /***********************************************************************
 DicomFile - Class to represent and extract images from DICOM interchange
 files.
-Copyright (c) 2005-2011 Oliver Kreylos
+Copyright (c) 2005-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -1275,7 +1275,7 @@ DicomFile::ImageStackDescriptor* DicomFile::readImageStackDescriptor(IO::Directo
 	}
 
 template <class DestPixelTypeParam>
-void DicomFile::readImage(const DicomFile::ImageDescriptor& id,DestPixelTypeParam* imageBuffer,const ptrdiff_t imageBufferStrides[2])
+void DicomFile::readImage(const DicomFile::ImageDescriptor& id,DestPixelTypeParam* imageBuffer,const ptrdiff_t imageBufferStrides[2],unsigned int numDecodeThreads)
 	{
 	/* Process depending on the image type: */
 	if(imageMode==IMAGE_RAW)
@@ -1332,6 +1332,7 @@ void DicomFile::readImage(const DicomFile::ImageDescriptor& id,DestPixelTypePara
 		
 		/* Create a JPEG decompressor: */
 		JPEGDecompressor dc(jpegBuffer);
+		dc.setNumThreads(numDecodeThreads);
 		
 		/* Read the first scan: */
 		if(dc.readScanHeader())
@@ -1567,10 +1568,10 @@ DicomFile::Directory* DicomFile::readDirectory(void)
 Force instantiations of standard readImage methods:
 **************************************************/
 
-template void DicomFile::readImage<signed char>(const ImageDescriptor& id,signed char* imageBuffer,const ptrdiff_t imageBufferStrides[2]);
-template void DicomFile::readImage<unsigned char>(const ImageDescriptor& id,unsigned char* imageBuffer,const ptrdiff_t imageBufferStrides[2]);
-template void DicomFile::readImage<signed short>(const ImageDescriptor& id,signed short* imageBuffer,const ptrdiff_t imageBufferStrides[2]);
-template void DicomFile::readImage<unsigned short>(const ImageDescriptor& id,unsigned short* imageBuffer,const ptrdiff_t imageBufferStrides[2]);
+template void DicomFile::readImage<signed char>(const ImageDescriptor& id,signed char* imageBuffer,const ptrdiff_t imageBufferStrides[2],unsigned int numDecodeThreads);
+template void DicomFile::readImage<unsigned char>(const ImageDescriptor& id,unsigned char* imageBuffer,const ptrdiff_t imageBufferStrides[2],unsigned int numDecodeThreads);
+template void DicomFile::readImage<signed short>(const ImageDescriptor& id,signed short* imageBuffer,const ptrdiff_t imageBufferStrides[2],unsigned int numDecodeThreads);
+template void DicomFile::readImage<unsigned short>(const ImageDescriptor& id,unsigned short* imageBuffer,const ptrdiff_t imageBufferStrides[2],unsigned int numDecodeThreads);
 
 }
 
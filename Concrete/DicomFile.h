@@ -1,7 +1,7 @@
 /***********************************************************************
 DicomFile - Class to represent and extract images from DICOM interchange
 files.
-Copyright (c) 2005-2011 Oliver Kreylos
+Copyright (c) 2005-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -228,7 +228,7 @@ class DicomFile
 	ImageDescriptor* readImageDescriptor(void); // Returns image descriptor for a DICOM image file
 	static ImageStackDescriptor* readImageStackDescriptor(IO::DirectoryPtr directory); // Assembles image stack descriptor for all DICOM image files in the given directory, or 0 if the images are inconsistent
 	template <class DestPixelTypeParam>
-	void readImage(const ImageDescriptor& id,DestPixelTypeParam* imageBuffer,const ptrdiff_t imageBufferStrides[2]); // Reads the image described in an image descriptor into a 2D array
+	void readImage(const ImageDescriptor& id,DestPixelTypeParam* imageBuffer,const ptrdiff_t imageBufferStrides[2],unsigned int numDecodeThreads =1); // Reads the image described in an image descriptor into a 2D array, using up to the given number of threads to decode compressed images
 	Directory* readDirectory(void); // Returns the directory structure of a DICOM directory file
 	};
 
@@ -2,7 +2,7 @@
 DicomImageStack - Class to encapsulate operations on scalar-valued
 cartesian data sets stored in stacks of DICOM medical interchange
 images.
-Copyright (c) 2005-2011 Oliver Kreylos
+Copyright (c) 2005-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -27,18 +27,64 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <dirent.h>
 #include <stdexcept>
 #include <iostream>
+#include <iomanip>
 #include <vector>
 #include <Misc/SelfDestructPointer.h>
 #include <Misc/FileTests.h>
+#include <Misc/Timer.h>
 #include <Plugins/FactoryManager.h>
 #include <Cluster/OpenFile.h>
 
 #include <Concrete/DicomFile.h>
 
+#include <ParallelFor.h>
+
 namespace Visualization {
 
 namespace Concrete {
 
+/**************************************************
+Declaration of class DicomImageStack::SliceReader:
+**************************************************/
+
+class DicomImageStack::SliceReader
+	{
+	/* Elements: */
+	private:
+	Cluster::MulticastPipe* pipe; // Pipe to open files in a cluster environment
+	const DicomFile::ImageStackDescriptor* isd; // Descriptor of the image stack
+	DS::Array* vertices; // Vertex array receiving the decoded slices
+	bool flip; // Flag whether to store slices in reverse order
+	unsigned int numDecodeThreads; // Number of threads to decode each compressed slice
+	int batchBase; // Index of the slice corresponding to work item zero
+	
+	/* Constructors and destructors: */
+	public:
+	SliceReader(Cluster::MulticastPipe* sPipe,const DicomFile::ImageStackDescriptor& sIsd,DS::Array& sVertices,bool sFlip,unsigned int sNumDecodeThreads,int sBatchBase)
+		:pipe(sPipe),isd(&sIsd),vertices(&sVertices),flip(sFlip),numDecodeThreads(sNumDecodeThreads),batchBase(sBatchBase)
+		{
+		}
+	
+	/* Methods: */
+	void operator()(size_t item) // Reads and decodes one slice into its plane of the vertex array
+		{
+		int sliceIndex=batchBase+int(item);
+		
+		/* Open the slice DICOM file: */
+		DicomFile dcm(isd->imageFileNames[sliceIndex],Cluster::openFile(pipe!=0?pipe->getMultiplexer():0,isd->imageFileNames[sliceIndex]));
+		
+		/* Read the slice image descriptor: */
+		Misc::SelfDestructPointer<DicomFile::ImageDescriptor> id(dcm.readImageDescriptor());
+		
+		/* Read the slice image; lossless JPEG slices are decoded by a decompressor private to this call, which can decode restart intervals in parallel: */
+		ptrdiff_t increments[2];
+		increments[0]=vertices->getIncrement(2);
+		increments[1]=vertices->getIncrement(1);
+		Value* sliceBase=vertices->getAddress(flip?isd->numImages-sliceIndex-1:sliceIndex,0,0);
+		dcm.readImage(*id,sliceBase,increments,numDecodeThreads);
+		}
+	};
+
 /********************************
 Methods of class DicomImageStack:
 ********************************/
@@ -110,22 +156,35 @@ Visualization::Abstract::DataSet* DicomImageStack::load(const std::vector<std::s
 	DS::Size cellSize(isd->sliceThickness,isd->pixelSize[1],isd->pixelSize[0]);
 	result->getDs().setData(numVertices,cellSize);
 	
-	/* Read each slice: */
-	ptrdiff_t increments[2];
-	increments[0]=result->getDs().getVertices().getIncrement(2);
-	increments[1]=result->getDs().getVertices().getIncrement(1);
-	for(int i=0;i<isd->numImages;++i)
+	/* Read all slices: */
+	bool master=pipe==0||pipe->isMaster();
+	if(master)
+		std::cout<<"Reading DICOM image slices...   0%"<<std::flush;
+	Misc::Timer loadTimer;
+	
+	/* Slice files opened on a cluster each stream through their own multicast pipe, which all nodes must consume in the same order, so cluster nodes read slices on the calling thread: */
+	unsigned int numThreads=pipe!=0?1U:getNumParallelThreads();
+	if(isd->numImages>0&&numThreads>(unsigned int)(isd->numImages))
+		numThreads=(unsigned int)(isd->numImages);
+	
+	/* Use the remaining threads to decode the restart intervals of each compressed slice in parallel: */
+	unsigned int numDecodeThreads=getNumParallelThreads()/numThreads;
+	if(numDecodeThreads<1)
+		numDecodeThreads=1;
+	
+	/* Read slices in batches to report progress: */
+	int batchSize=int(numThreads)*4;
+	for(int batchBase=0;batchBase<isd->numImages;batchBase+=batchSize)
 		{
-		/* Open the slice DICOM file: */
-		DicomFile dcm(isd->imageFileNames[i],Cluster::openFile(pipe!=0?pipe->getMultiplexer():0,isd->imageFileNames[i]));
-		
-		/* Read the slice image descriptor: */
-		Misc::SelfDestructPointer<DicomFile::ImageDescriptor> id(dcm.readImageDescriptor());
+		int batchEnd=batchBase+batchSize<isd->numImages?batchBase+batchSize:isd->numImages;
+		parallelFor(size_t(batchEnd-batchBase),SliceReader(pipe,*isd,result->getDs().getVertices(),flip,numDecodeThreads,batchBase),numThreads);
 		
-		/* Read the slice image: */
-		Value* sliceBase=result->getDs().getVertices().getAddress(flip?isd->numImages-i-1:i,0,0);
-		dcm.readImage(*id,sliceBase,increments);
+		if(master)
+			std::cout<<"\b\b\b\b"<<std::setw(3)<<(batchEnd*100)/isd->numImages<<"%"<<std::flush;
 		}
+	loadTimer.elapse();
+	if(master)
+		std::cout<<"\b\b\b\bdone in "<<loadTimer.getTime()*1000.0<<" ms"<<std::endl;
 	
 	return result.releaseTarget();
 	}
@@ -2,7 +2,7 @@
 DicomImageStack - Class to encapsulate operations on scalar-valued
 cartesian data sets stored in stacks of DICOM medical interchange
 images.
-Copyright (c) 2005-2011 Oliver Kreylos
+Copyright (c) 2005-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -47,6 +47,11 @@ typedef Visualization::Wrappers::Module<DS,DataValue> BaseModule; // Module base
 
 class DicomImageStack:public BaseModule
 	{
+	/* Embedded classes: */
+	private:
+	class SliceReader; // Functor class to read DICOM image slices in parallel
+	friend class SliceReader;
+	
 	/* Constructors and destructors: */
 	public:
 	DicomImageStack(void); // Default constructor
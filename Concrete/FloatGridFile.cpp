@@ -1,7 +1,7 @@
 /***********************************************************************
 FloatGridFile - Class to encapsulate operations on curvilinear data sets
 storing a single floating-point scalar value.
-Copyright (c) 2006-2007 Oliver Kreylos
+Copyright (c) 2006-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -55,13 +55,21 @@ Visualization::Abstract::DataSet* FloatGridFile::load(const std::vector<std::str
 	DataSet* result=new DataSet;
 	result->getDs().setData(numVertices);
 	
-	/* Read the vertex positions from file: */
+	/* Read the vertex positions from file in blocks: */
 	DS::Array& vertices=result->getDs().getVertices();
-	for(DS::Index index(0);index[0]<numVertices[0];index.preInc(numVertices))
+	size_t totalNumVertices=size_t(vertices.getNumElements());
+	const size_t blockSize=65536;
+	float* block=new float[blockSize*3];
+	DS::Array::iterator vIt=vertices.begin();
+	for(size_t blockBase=0;blockBase<totalNumVertices;blockBase+=blockSize)
 		{
-		DS::Point p;
-		gridFile.read<DS::Scalar>(p.getComponents(),3);
-		vertices(index).pos=p;
+		size_t numBlockVertices=totalNumVertices-blockBase;
+		if(numBlockVertices>blockSize)
+			numBlockVertices=blockSize;
+		gridFile.read<float>(block,numBlockVertices*3);
+		const float* bPtr=block;
+		for(size_t i=0;i<numBlockVertices;++i,++vIt,bPtr+=3)
+			vIt->pos=DS::Point(bPtr[0],bPtr[1],bPtr[2]);
 		}
 	
 	/* Construct data file name: */
@@ -77,9 +85,19 @@ Visualization::Abstract::DataSet* FloatGridFile::load(const std::vector<std::str
 	if(numVertices[0]!=numDataVertices[0]||numVertices[1]!=numDataVertices[1]||numVertices[2]!=numDataVertices[2])
 		Misc::throwStdErr("FloatGridFile::load: Size of data file %s does not match grid file %s",dataFilename,gridFilename);
 	
-	/* Read the vertex values from file: */
-	for(DS::Index index(0);index[0]<numVertices[0];index.preInc(numVertices))
-		vertices(index).value=dataFile.read<float>();
+	/* Read the vertex values from file in blocks: */
+	vIt=vertices.begin();
+	for(size_t blockBase=0;blockBase<totalNumVertices;blockBase+=blockSize)
+		{
+		size_t numBlockVertices=totalNumVertices-blockBase;
+		if(numBlockVertices>blockSize)
+			numBlockVertices=blockSize;
+		dataFile.read<float>(block,numBlockVertices);
+		const float* bPtr=block;
+		for(size_t i=0;i<numBlockVertices;++i,++vIt,++bPtr)
+			vIt->value=*bPtr;
+		}
+	delete[] block;
 	
 	/* Finalize the grid structure: */
 	result->getDs().finalizeGrid();
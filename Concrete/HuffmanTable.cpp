@@ -1,7 +1,7 @@
 /***********************************************************************
 HuffmanTable - Class representing a table for Huffman compression/
 decompression.
-Copyright (c) 2005-2011 Oliver Kreylos
+Copyright (c) 2005-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -87,21 +87,40 @@ HuffmanTable::HuffmanTable(int sBits[17],unsigned char sValues[256])
 		}
 	maxcode[17]=0xfffff;
 	
-	/* Build look-up table from numBits to value to quickly identify short Huffman codes: */
-	for(p=0;p<256;++p)
-		numBits[p]=0;
+	/* Build look-up table to quickly decode short Huffman codes: */
+	for(p=0;p<(1<<lookupBits);++p)
+		{
+		lookup[p].codeBits=0;
+		lookup[p].totalBits=0;
+		}
 	for(p=0;p<lastP;++p)
 		{
 		int size=huffmanSizes[p];
-		if(size<=8)
+		if(size<=lookupBits)
 			{
-			/* Calculate the range of bytes that start with the short Huffman code: */
-			int ll=int(huffmanCodes[p])<<(8-size);
-			int ul=ll|((0x1<<(8-size))-1);
+			/* Calculate the range of prefixes that start with the short Huffman code: */
+			int ll=int(huffmanCodes[p])<<(lookupBits-size);
+			int ul=ll|((0x1<<(lookupBits-size))-1);
+			int s=values[p];
 			for(int i=ll;i<=ul;++i)
 				{
-				numBits[i]=size;
-				value[i]=values[p];
+				lookup[i].codeBits=(unsigned char)size;
+				lookup[i].value=values[p];
+				
+				/* Check if the code's lossless JPEG difference magnitude bits fit into the prefix as well: */
+				if(s<16&&size+s<=lookupBits)
+					{
+					/* Extract and sign-extend the magnitude bits: */
+					int difference=0;
+					if(s>0)
+						{
+						difference=(i>>(lookupBits-size-s))&((0x1<<s)-1);
+						if(difference<(0x1<<(s-1)))
+							difference+=((-1)<<s)+1;
+						}
+					lookup[i].totalBits=(unsigned char)(size+s);
+					lookup[i].difference=short(difference);
+					}
 				}
 			}
 		}
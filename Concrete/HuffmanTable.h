@@ -1,7 +1,7 @@
 /***********************************************************************
 HuffmanTable - Class representing a table for Huffman compression/
 decompression.
-Copyright (c) 2005-2011 Oliver Kreylos
+Copyright (c) 2005-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -33,8 +33,21 @@ namespace Concrete {
 
 class HuffmanTable
 	{
-	/* Elements: */
+	/* Embedded classes: */
 	private:
+	static const int lookupBits=11; // Number of bits looked up at once to decode short codes
+	
+	struct LookupEntry // Structure describing the decoding of a lookupBits-bit prefix of the bit stream
+		{
+		/* Elements: */
+		public:
+		unsigned char codeBits; // Length of the Huffman code starting the prefix, or 0 if the code is longer than the prefix
+		unsigned char value; // Value of the Huffman code starting the prefix
+		unsigned char totalBits; // Length of the Huffman code plus the lossless JPEG difference magnitude bits following it, or 0 if they do not fit into the prefix
+		short difference; // Lossless JPEG difference value encoded by the code and the following magnitude bits if totalBits!=0
+		};
+	
+	/* Elements: */
 	int bits[17];
 	unsigned char values[256];
 	bool tableSent; // Used during compression; set to true when table has been emitted to file
@@ -43,8 +56,27 @@ class HuffmanTable
 	int mincode[17];
 	int maxcode[18];
 	int valPtr[17];
-	int numBits[256];
-	int value[256];
+	LookupEntry lookup[1<<lookupBits]; // Look-up table to quickly decode short Huffman codes and small lossless JPEG differences
+	
+	/* Private methods: */
+	int decodeLong(BitBuffer& bb,int code) const // Decodes a code longer than lookupBits bits, given the next lookupBits bits in the buffer
+		{
+		/* Keep adding more bits to the code until it is valid: */
+		int codeBits=lookupBits;
+		bb.flushBits(lookupBits);
+		while(code>maxcode[codeBits])
+			{
+			code=(code<<1)|bb.getBit();
+			++codeBits;
+			}
+		
+		/* Check for error condition: */
+		if(codeBits>16)
+			Misc::throwStdErr("HuffmanTable::decode: Corrupted JPEG stream");
+		
+		/* Return the decoded value: */
+		return values[valPtr[codeBits]+(code-mincode[codeBits])];
+		}
 	
 	/* Constructors and destructors: */
 	public:
@@ -53,34 +85,51 @@ class HuffmanTable
 	
 	int decode(BitBuffer& bb) const // Decodes a bit sequence
 		{
-		/* Peek at the next eight bits in the buffer to determine whether the next code is a short code: */
-		int code=bb.peekBits(8);
-		if(numBits[code]!=0)
+		/* Peek at the next bits in the buffer to determine whether the next code is a short code: */
+		int code=bb.peekBits(lookupBits);
+		const LookupEntry& le=lookup[code];
+		if(le.codeBits!=0)
 			{
 			/* Remove the short code from the bit buffer: */
-			bb.flushBits(numBits[code]);
+			bb.flushBits(le.codeBits);
 			
 			/* Return the decoded value: */
-			return value[code];
+			return le.value;
 			}
 		else
+			return decodeLong(bb,code);
+		}
+	int decodeDifference(BitBuffer& bb) const // Decodes a lossless JPEG difference value, i.e., a magnitude category code followed by magnitude bits
+		{
+		/* Peek at the next bits in the buffer to determine whether the next code and its magnitude bits are in the look-up table: */
+		int code=bb.peekBits(lookupBits);
+		const LookupEntry& le=lookup[code];
+		if(le.totalBits!=0)
 			{
-			/* Keep adding more bits to the code until it is valid: */
-			int codeBits=8;
-			bb.flushBits(8);
-			while(code>maxcode[codeBits])
-				{
-				code=(code<<1)|bb.getBit();
-				++codeBits;
-				}
+			/* Remove the code and magnitude bits from the bit buffer: */
+			bb.flushBits(le.totalBits);
 			
-			/* Check for error condition: */
-			if(codeBits>16)
-				Misc::throwStdErr("HuffmanTable::decode: Corrupted JPEG stream");
-			
-			/* Return the decoded value: */
-			return values[valPtr[codeBits]+(code-mincode[codeBits])];
+			/* Return the decoded difference: */
+			return le.difference;
 			}
+		
+		/* Decode the magnitude category: */
+		int s;
+		if(le.codeBits!=0)
+			{
+			bb.flushBits(le.codeBits);
+			s=le.value;
+			}
+		else
+			s=decodeLong(bb,code);
+		
+		/* Read the magnitude bits; category 16 has no magnitude bits and always encodes 32768: */
+		if(s==0)
+			return 0;
+		else if(s<16)
+			return bb.getSignedBits(s);
+		else
+			return 32768;
 		}
 	};
 
@@ -1,7 +1,7 @@
 /***********************************************************************
 ImageStack - Class to represent scalar-valued Cartesian data sets stored
 as stacks of color or greyscale images.
-Copyright (c) 2005-2011 Oliver Kreylos
+Copyright (c) 2005-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -27,6 +27,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <iostream>
 #include <iomanip>
 #include <Misc/ThrowStdErr.h>
+#include <Misc/Timer.h>
 #include <Plugins/FactoryManager.h>
 #include <IO/OpenFile.h>
 #include <IO/ValueSource.h>
@@ -35,6 +36,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Images/RGBImage.h>
 #include <Images/ReadImageFile.h>
 
+#include <ParallelFor.h>
+
 namespace Visualization {
 
 namespace Concrete {
@@ -217,6 +220,65 @@ void sphereFilter(Misc::Array<unsigned char,3>& data,int sphereRadius,unsigned c
 
 #endif
 
+/*********************************************
+Declaration of class ImageStack::SliceLoader:
+*********************************************/
+
+class ImageStack::SliceLoader
+	{
+	/* Elements: */
+	private:
+	const ImageStack* module; // Module opening the slice files
+	Cluster::MulticastPipe* pipe; // Pipe to open files in a cluster environment
+	const std::string* sliceDirectory; // Directory containing the slice files
+	const std::string* sliceFileNameTemplate; // printf-style template for slice file names
+	int sliceIndexStart,sliceIndexFactor; // Mapping from slice indices to slice file indices
+	const int* regionOrigin; // Origin of the loaded region in each slice image
+	DS::Array* vertices; // Vertex array receiving the slices' greyscale pixels
+	int batchBase; // Index of the slice corresponding to work item zero
+	
+	/* Constructors and destructors: */
+	public:
+	SliceLoader(const ImageStack* sModule,Cluster::MulticastPipe* sPipe,const std::string& sSliceDirectory,const std::string& sSliceFileNameTemplate,int sSliceIndexStart,int sSliceIndexFactor,const int sRegionOrigin[2],DS::Array& sVertices,int sBatchBase)
+		:module(sModule),pipe(sPipe),
+		 sliceDirectory(&sSliceDirectory),sliceFileNameTemplate(&sSliceFileNameTemplate),
+		 sliceIndexStart(sSliceIndexStart),sliceIndexFactor(sSliceIndexFactor),
+		 regionOrigin(sRegionOrigin),vertices(&sVertices),batchBase(sBatchBase)
+		{
+		}
+	
+	/* Methods: */
+	void operator()(size_t item) // Loads one image slice into its plane of the vertex array
+		{
+		int sliceIndex=batchBase+int(item);
+		
+		/* Generate the slice file name: */
+		std::string fullSliceFileName=*sliceDirectory;
+		char sliceFileName[1024];
+		snprintf(sliceFileName,sizeof(sliceFileName),sliceFileNameTemplate->c_str(),sliceIndex*sliceIndexFactor+sliceIndexStart);
+		fullSliceFileName.append(sliceFileName);
+		fullSliceFileName=module->getFullPath(fullSliceFileName);
+		
+		/* Load the slice as an RGB image: */
+		Images::RGBImage slice=Images::readImageFile(fullSliceFileName.c_str(),module->openFile(fullSliceFileName,pipe));
+		
+		/* Check if the slice conforms: */
+		const DS::Index& numVertices=vertices->getSize();
+		if(slice.getSize(0)<(unsigned int)(regionOrigin[0]+numVertices[2])||slice.getSize(1)<(unsigned int)(regionOrigin[1]+numVertices[1]))
+			Misc::throwStdErr("ImageStack::load: Size of slice file \"%s\" does not match image stack size",fullSliceFileName.c_str());
+		
+		/* Convert the slice's pixels to greyscale and copy them into the slice's plane of the data set: */
+		unsigned char* vertexPtr=vertices->getAddress(sliceIndex,0,0);
+		for(int y=regionOrigin[1];y<regionOrigin[1]+numVertices[1];++y)
+			for(int x=regionOrigin[0];x<regionOrigin[0]+numVertices[2];++x,++vertexPtr)
+				{
+				const Images::RGBImage::Color& pixel=slice.getPixel(x,y);
+				float value=float(pixel[0])*0.299f+float(pixel[1])*0.587+float(pixel[2])*0.114f;
+				*vertexPtr=(unsigned char)(Math::floor(value+0.5f));
+				}
+		}
+	};
+
 /***************************
 Methods of class ImageStack:
 ***************************/
@@ -318,37 +380,25 @@ Visualization::Abstract::DataSet* ImageStack::load(const std::vector<std::string
 	/* Load all image slices: */
 	if(master)
 		std::cout<<"Reading image slices...   0%"<<std::flush;
+	Misc::Timer loadTimer;
 	DataSet::DS::Array& vertices=result->getDs().getVertices();
-	unsigned char* vertexPtr=vertices.getArray();
-	for(int i=0;i<numVertices[0];++i)
+	
+	/* Slice files opened on a cluster each stream through their own multicast pipe, which all nodes must consume in the same order, so cluster nodes decode slices on the calling thread: */
+	unsigned int numThreads=pipe!=0?1U:getNumParallelThreads();
+	
+	/* Decode slices in batches to report progress; each thread holds at most one decoded image at a time: */
+	int batchSize=int(numThreads)*4;
+	for(int batchBase=0;batchBase<numVertices[0];batchBase+=batchSize)
 		{
-		/* Generate the slice file name: */
-		std::string fullSliceFileName=sliceDirectory;
-		char sliceFileName[1024];
-		snprintf(sliceFileName,sizeof(sliceFileName),sliceFileNameTemplate.c_str(),i*sliceIndexFactor+sliceIndexStart);
-		fullSliceFileName.append(sliceFileName);
-		fullSliceFileName=getFullPath(fullSliceFileName);
-		
-		/* Load the slice as an RGB image: */
-		Images::RGBImage slice=Images::readImageFile(fullSliceFileName.c_str(),openFile(fullSliceFileName,pipe));
+		int batchEnd=batchBase+batchSize<numVertices[0]?batchBase+batchSize:numVertices[0];
+		parallelFor(size_t(batchEnd-batchBase),SliceLoader(this,pipe,sliceDirectory,sliceFileNameTemplate,sliceIndexStart,sliceIndexFactor,regionOrigin,vertices,batchBase),numThreads);
 		
-		/* Check if the slice conforms: */
-		if(slice.getSize(0)<(unsigned int)(regionOrigin[0]+numVertices[2])||slice.getSize(1)<(unsigned int)(regionOrigin[1]+numVertices[1]))
-			Misc::throwStdErr("ImageStack::load: Size of slice file \"%s\" does not match image stack size",fullSliceFileName.c_str());
-		
-		/* Convert the slice's pixels to greyscale and copy them into the data set: */
-		for(int y=regionOrigin[1];y<regionOrigin[1]+numVertices[1];++y)
-			for(int x=regionOrigin[0];x<regionOrigin[0]+numVertices[2];++x,++vertexPtr)
-				{
-				const Images::RGBImage::Color& pixel=slice.getPixel(x,y);
-				float value=float(pixel[0])*0.299f+float(pixel[1])*0.587+float(pixel[2])*0.114f;
-				*vertexPtr=(unsigned char)(Math::floor(value+0.5f));
-				}
 		if(master)
-			std::cout<<"\b\b\b\b"<<std::setw(3)<<((i+1)*100)/numVertices[0]<<"%"<<std::flush;
+			std::cout<<"\b\b\b\b"<<std::setw(3)<<(batchEnd*100)/numVertices[0]<<"%"<<std::flush;
 		}
+	loadTimer.elapse();
 	if(master)
-		std::cout<<"\b\b\b\bdone"<<std::endl;
+		std::cout<<"\b\b\b\bdone in "<<loadTimer.getTime()*1000.0<<" ms"<<std::endl;
 	
 	if(medianFilter||lowpassFilter)
 		{
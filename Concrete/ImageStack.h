@@ -1,7 +1,7 @@
 /***********************************************************************
 ImageStack - Class to represent scalar-valued Cartesian data sets stored
 as stacks of color or greyscale images.
-Copyright (c) 2005-2011 Oliver Kreylos
+Copyright (c) 2005-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -46,6 +46,11 @@ typedef Visualization::Wrappers::Module<DS,DataValue> BaseModule; // Module base
 
 class ImageStack:public BaseModule
 	{
+	/* Embedded classes: */
+	private:
+	class SliceLoader; // Functor class to load image slices in parallel
+	friend class SliceLoader;
+	
 	/* Constructors and destructors: */
 	public:
 	ImageStack(void); // Default constructor
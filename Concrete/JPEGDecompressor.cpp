@@ -1,6 +1,6 @@
 /***********************************************************************
 JPEGDecompressor - Class to decompress lossless JPEG images.
-Copyright (c) 2005-2011 Oliver Kreylos
+Copyright (c) 2005-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -21,12 +21,16 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <Concrete/JPEGDecompressor.h>
 
+#include <string.h>
 #include <Misc/ThrowStdErr.h>
+#include <IO/FixedMemoryFile.h>
 
 #include <Concrete/BitBuffer.h>
 #include <Concrete/HuffmanTable.h>
 #include <Concrete/JPEGImageWriter.h>
 
+#include <ParallelFor.h>
+
 namespace Visualization {
 
 namespace Concrete {
@@ -88,6 +92,187 @@ inline void skipVariable(IO::File& source)
 	source.skip<char>(length);
 	}
 
+/*******************************************************************
+Helper classes implementing the lossless JPEG predictors; cirPtr
+points to the current pixel component in the current image row, and
+pirPtr to the same pixel component in the previous image row.
+Predictors that halve a value read pixel components as unsigned to
+work correctly for 16-bit images:
+*******************************************************************/
+
+struct Predictor0 // No prediction
+	{
+	static int predict(const short* cirPtr,const short* pirPtr,int numScanComponents)
+		{
+		return 0;
+		}
+	};
+
+struct Predictor1 // Predicts from left neighbor
+	{
+	static int predict(const short* cirPtr,const short* pirPtr,int numScanComponents)
+		{
+		return int(cirPtr[-numScanComponents]);
+		}
+	};
+
+struct Predictor2 // Predicts from upper neighbor
+	{
+	static int predict(const short* cirPtr,const short* pirPtr,int numScanComponents)
+		{
+		return int(pirPtr[0]);
+		}
+	};
+
+struct Predictor3 // Predicts from upper-left neighbor
+	{
+	static int predict(const short* cirPtr,const short* pirPtr,int numScanComponents)
+		{
+		return int(pirPtr[-numScanComponents]);
+		}
+	};
+
+struct Predictor4 // Predicts from left and upper gradient
+	{
+	static int predict(const short* cirPtr,const short* pirPtr,int numScanComponents)
+		{
+		return int(cirPtr[-numScanComponents])+(int(pirPtr[0])-int(pirPtr[-numScanComponents]));
+		}
+	};
+
+struct Predictor5 // Predicts from left neighbor and half the upper gradient
+	{
+	static int predict(const short* cirPtr,const short* pirPtr,int numScanComponents)
+		{
+		return int((unsigned short)(cirPtr[-numScanComponents]))+((int((unsigned short)(pirPtr[0]))-int((unsigned short)(pirPtr[-numScanComponents])))>>1);
+		}
+	};
+
+struct Predictor6 // Predicts from upper neighbor and half the left gradient
+	{
+	static int predict(const short* cirPtr,const short* pirPtr,int numScanComponents)
+		{
+		return int((unsigned short)(pirPtr[0]))+((int((unsigned short)(cirPtr[-numScanComponents]))-int((unsigned short)(pirPtr[-numScanComponents])))>>1);
+		}
+	};
+
+struct Predictor7 // Predicts from average of left and upper neighbors
+	{
+	static int predict(const short* cirPtr,const short* pirPtr,int numScanComponents)
+		{
+		return (int((unsigned short)(cirPtr[-numScanComponents]))+int((unsigned short)(pirPtr[0])))>>1;
+		}
+	};
+
+/****************
+Helper functions:
+****************/
+
+void decodeFirstRow(BitBuffer& bb,HuffmanTable* const scanTables[4],int numScanComponents,int rowSize,int initialValue,short* cirPtr)
+	{
+	/* Decode the first column: */
+	for(int comp=0;comp<numScanComponents;++comp,++cirPtr)
+		*cirPtr=short(initialValue+scanTables[comp]->decodeDifference(bb));
+	
+	/* Predict the rest of the columns from their left neighbors: */
+	for(int col=1;col<rowSize;++col)
+		for(int comp=0;comp<numScanComponents;++comp,++cirPtr)
+			*cirPtr=short(int(cirPtr[-numScanComponents])+scanTables[comp]->decodeDifference(bb));
+	}
+
+template <class PredictorParam>
+void decodePredictedRow(BitBuffer& bb,HuffmanTable* const scanTables[4],int numScanComponents,int rowSize,short* cirPtr,const short* pirPtr)
+	{
+	/* Predict the first column from upper neighbors: */
+	for(int comp=0;comp<numScanComponents;++comp,++pirPtr,++cirPtr)
+		*cirPtr=short(int(*pirPtr)+scanTables[comp]->decodeDifference(bb));
+	
+	/* Predict the rest of the columns using the predictor selected for the scan: */
+	for(int col=1;col<rowSize;++col)
+		for(int comp=0;comp<numScanComponents;++comp,++pirPtr,++cirPtr)
+			{
+			int diff=scanTables[comp]->decodeDifference(bb);
+			*cirPtr=short(PredictorParam::predict(cirPtr,pirPtr,numScanComponents)+diff);
+			}
+	}
+
+typedef void (*PredictedRowDecoder)(BitBuffer&,HuffmanTable* const[4],int,int,short*,const short*); // Type for row decoding functions specialized for a predictor
+
+void decodeRows(BitBuffer& bb,HuffmanTable* const scanTables[4],int numScanComponents,int rowSize,int initialValue,PredictedRowDecoder decodeRow,int firstRow,int lastRow,short* imageRows[2],JPEGImageWriter& imageWriter) // Decodes the rows of one restart interval
+	{
+	/* The first row of each restart interval is predicted from the left, starting from the initial value: */
+	decodeFirstRow(bb,scanTables,numScanComponents,rowSize,initialValue,imageRows[0]);
+	imageWriter.writeImageRow(firstRow,imageRows[0]);
+	
+	/* Decode the remaining rows using the scan's predictor: */
+	for(int row=firstRow+1;row<lastRow;++row)
+		{
+		short* tempRow=imageRows[0];
+		imageRows[0]=imageRows[1];
+		imageRows[1]=tempRow;
+		decodeRow(bb,scanTables,numScanComponents,rowSize,imageRows[0],imageRows[1]);
+		imageWriter.writeImageRow(row,imageRows[0]);
+		}
+	}
+
+/***************************************************************
+Functor class to decode the restart intervals of a scan in
+parallel:
+***************************************************************/
+
+class IntervalDecoder
+	{
+	/* Elements: */
+	private:
+	const std::vector<unsigned char>* scanData; // Entropy-coded data of the entire scan with restart markers removed
+	const std::vector<size_t>* intervalOffsets; // Offsets of the restart intervals' data in the scan data, plus end offset
+	HuffmanTable* const* scanTables; // Huffman tables for the scan's components
+	int numScanComponents; // Number of components in the scan
+	int rowSize; // Number of pixels per image row
+	int numRows; // Number of image rows
+	int restartInRows; // Number of image rows per restart interval
+	int initialValue; // Prediction value for the first pixel of each restart interval
+	PredictedRowDecoder decodeRow; // Row decoder for the scan's predictor
+	JPEGImageWriter* imageWriter; // Receiver of decoded image rows
+	std::vector<short> rowBuffer; // This thread's buffer for two rows of pixels for predictor calculation
+	
+	/* Constructors and destructors: */
+	public:
+	IntervalDecoder(const std::vector<unsigned char>& sScanData,const std::vector<size_t>& sIntervalOffsets,HuffmanTable* const sScanTables[4],int sNumScanComponents,int sRowSize,int sNumRows,int sRestartInRows,int sInitialValue,PredictedRowDecoder sDecodeRow,JPEGImageWriter& sImageWriter)
+		:scanData(&sScanData),intervalOffsets(&sIntervalOffsets),scanTables(sScanTables),
+		 numScanComponents(sNumScanComponents),rowSize(sRowSize),numRows(sNumRows),restartInRows(sRestartInRows),
+		 initialValue(sInitialValue),decodeRow(sDecodeRow),imageWriter(&sImageWriter)
+		{
+		}
+	
+	/* Methods: */
+	void operator()(size_t item) // Decodes one restart interval
+		{
+		/* Copy the interval's data into a memory file, terminated by an EOI marker to stop the bit buffer: */
+		size_t dataSize=(*intervalOffsets)[item+1]-(*intervalOffsets)[item];
+		IO::FixedMemoryFile intervalFile(dataSize+2);
+		intervalFile.ref();
+		unsigned char* memory=static_cast<unsigned char*>(intervalFile.getMemory());
+		if(dataSize>0)
+			memcpy(memory,&(*scanData)[(*intervalOffsets)[item]],dataSize);
+		memory[dataSize]=0xff;
+		memory[dataSize+1]=0xd9;
+		
+		/* Allocate this thread's row buffers on first use: */
+		if(rowBuffer.empty())
+			rowBuffer.resize(size_t(numScanComponents)*size_t(rowSize)*2);
+		short* imageRows[2];
+		imageRows[0]=&rowBuffer[0];
+		imageRows[1]=&rowBuffer[size_t(numScanComponents)*size_t(rowSize)];
+		
+		/* Decode the interval: */
+		BitBuffer bb(intervalFile);
+		int firstRow=int(item)*restartInRows;
+		int lastRow=firstRow+restartInRows<numRows?firstRow+restartInRows:numRows;
+		decodeRows(bb,scanTables,numScanComponents,rowSize,initialValue,decodeRow,firstRow,lastRow,imageRows,*imageWriter);
+		}
+	};
+
 }
 
 /*********************************
@@ -287,6 +472,48 @@ int JPEGDecompressor::processTables(void)
 	return 0;
 	}
 
+void JPEGDecompressor::readScanData(std::vector<unsigned char>& scanData,std::vector<size_t>& intervalOffsets)
+	{
+	/* Read entropy-coded data until a marker other than a restart marker is found: */
+	intervalOffsets.push_back(0);
+	while(true)
+		{
+		int c=source.getChar();
+		if(c!=0xff)
+			{
+			scanData.push_back((unsigned char)c);
+			continue;
+			}
+		
+		/* Skip fill bytes: */
+		int d;
+		while((d=source.getChar())==0xff)
+			;
+		
+		if(d==0)
+			{
+			/* Keep the stuffed 0xff byte for the bit buffer to unstuff: */
+			scanData.push_back(0xff);
+			scanData.push_back(0x00);
+			}
+		else if(d>=RST0&&d<=RST7)
+			{
+			/* Check for the proper marker number and start a new restart interval: */
+			if(d!=RST0+int((intervalOffsets.size()-1)%8))
+				Misc::throwStdErr("JPEGDecompressor::readScanData: wrong number in restart marker");
+			intervalOffsets.push_back(scanData.size());
+			}
+		else
+			{
+			/* Put the marker back into the input stream for later processing: */
+			source.ungetChar(d);
+			source.ungetChar(c);
+			break;
+			}
+		}
+	intervalOffsets.push_back(scanData.size());
+	}
+
 void JPEGDecompressor::processRestart(short nextMarkerNumber)
 	{
 	/* Scan for the next JPEG marker: */
@@ -315,7 +542,8 @@ JPEGDecompressor::JPEGDecompressor(IO::File& sSource)
 	 components(0),
 	 numScanComponents(0),
 	 restartInterval(0),
-	 ss(0),pt(0)
+	 ss(0),pt(0),
+	 numThreads(1)
 	{
 	/* Clear the current components: */
 	for(int i=0;i<4;++i)
@@ -389,148 +617,96 @@ void JPEGDecompressor::readImage(JPEGImageWriter& imageWriter)
 	/* Initialize the image writer: */
 	imageWriter.setImageParameters(imageSize,numScanComponents,numBits);
 	
-	/* Create buffers for two rows of pixels for predictor calculation: */
-	short* imageRows[2];
-	for(int i=0;i<2;++i)
-		imageRows[i]=new short[numScanComponents*imageSize[0]];
-	
-	/* Initialize the restart interval counters: */
-	int restartInRows=restartInterval/imageSize[0];
-	int restartRowsToGo=restartInRows;
-	short nextRestartNumber=0;
-	
-	/* Create a bit buffer: */
-	BitBuffer bb(source);
-	
 	/* Create a shortcut to Huffman tables for this scan: */
 	HuffmanTable* scanTables[4];
 	for(int comp=0;comp<numScanComponents;++comp)
 		scanTables[comp]=huffmanTables[scanComponents[comp]->huffmanTableIndex];
 	
-	/* Decode all image rows: */
-	for(int row=0;row<imageSize[1];++row)
+	/* Select the row decoder for the scan's predictor once: */
+	PredictedRowDecoder decodeRow;
+	switch(ss)
+		{
+		case 0:
+			decodeRow=decodePredictedRow<Predictor0>;
+			break;
+		
+		case 1:
+			decodeRow=decodePredictedRow<Predictor1>;
+			break;
+		
+		case 2:
+			decodeRow=decodePredictedRow<Predictor2>;
+			break;
+		
+		case 3:
+			decodeRow=decodePredictedRow<Predictor3>;
+			break;
+		
+		case 4:
+			decodeRow=decodePredictedRow<Predictor4>;
+			break;
+		
+		case 5:
+			decodeRow=decodePredictedRow<Predictor5>;
+			break;
+		
+		case 6:
+			decodeRow=decodePredictedRow<Predictor6>;
+			break;
+		
+		default:
+			decodeRow=decodePredictedRow<Predictor7>;
+		}
+	
+	/* Determine the number of image rows per restart interval: */
+	int restartInRows=imageSize[1];
+	if(restartInterval!=0)
+		{
+		if(restartInterval%imageSize[0]!=0)
+			Misc::throwStdErr("JPEGDecompressor::readImage: Restart intervals not aligned with image rows are not supported");
+		restartInRows=restartInterval/imageSize[0];
+		}
+	int numIntervals=(imageSize[1]+restartInRows-1)/restartInRows;
+	int initialValue=1<<(numBits-pt-1);
+	
+	if(numIntervals>1&&numThreads>1)
+		{
+		/* Read the scan's entropy-coded data and split it at the restart markers: */
+		std::vector<unsigned char> scanData;
+		std::vector<size_t> intervalOffsets;
+		readScanData(scanData,intervalOffsets);
+		if(intervalOffsets.size()!=size_t(numIntervals)+1)
+			Misc::throwStdErr("JPEGDecompressor::readImage: Wrong number of restart intervals in scan");
+		
+		/* Decode the independent restart intervals in parallel: */
+		parallelFor(numIntervals,IntervalDecoder(scanData,intervalOffsets,scanTables,numScanComponents,imageSize[0],imageSize[1],restartInRows,initialValue,decodeRow,imageWriter),numThreads);
+		}
+	else
 		{
-		short* cirPtr=imageRows[0];
-		short* pirPtr=imageRows[1];
+		/* Create buffers for two rows of pixels for predictor calculation: */
+		std::vector<short> rowBuffer(size_t(numScanComponents)*size_t(imageSize[0])*2);
+		short* imageRows[2];
+		imageRows[0]=&rowBuffer[0];
+		imageRows[1]=&rowBuffer[size_t(numScanComponents)*size_t(imageSize[0])];
 		
-		/* Check if the current restart interval is over: */
-		if(restartRowsToGo==0)
+		/* Decode all restart intervals directly from the source: */
+		BitBuffer bb(source);
+		for(int interval=0;interval<numIntervals;++interval)
 			{
-			if(restartInRows!=0)
+			if(interval>0)
 				{
-				/* Process the restart marker: */
-				processRestart(nextRestartNumber);
-				
-				/* Reset the restart interval: */
-				restartRowsToGo=restartInRows-1;
-				nextRestartNumber=(nextRestartNumber+1)%7;
+				/* Process the restart marker preceding the interval; marker numbers cycle through RST0-RST7: */
+				processRestart(short((interval-1)%8));
 				
 				/* Clear the bit buffer: */
 				bb.clear();
 				}
-			else
-				restartRowsToGo=imageSize[1];
-			
-			/* Decode the first column: */
-			for(int comp=0;comp<numScanComponents;++comp,++pirPtr,++cirPtr)
-				{
-				/* Decode the difference: */
-				int s=scanTables[comp]->decode(bb);
-				int diff=s!=0?bb.getSignedBits(s):0;
-				
-				/* Set the pixel value: */
-				*cirPtr=short((1<<(numBits-pt-1))+diff);
-				}
-			
-			/* Predict the rest of the columns: */
-			for(int col=1;col<imageSize[0];++col)
-				{
-				for(int comp=0;comp<numScanComponents;++comp,++pirPtr,++cirPtr)
-					{
-					/* Decode the difference: */
-					int s=scanTables[comp]->decode(bb);
-					int diff=s!=0?bb.getSignedBits(s):0;
-					
-					/* Set the pixel value: */
-					*cirPtr=short(int(cirPtr[-numScanComponents])+diff);
-					}
-				}
-			}
-		else
-			{
-			/* Predict the first column from upper neighbors: */
-			for(int comp=0;comp<numScanComponents;++comp,++pirPtr,++cirPtr)
-				{
-				/* Decode the difference: */
-				int s=scanTables[comp]->decode(bb);
-				int diff=s!=0?bb.getSignedBits(s):0;
-				
-				/* Set the pixel value: */
-				*cirPtr=short(int(*pirPtr)+diff);
-				}
-			
-			/* Predict the rest of the columns based on PSV: */
-			for(int col=1;col<imageSize[0];++col)
-				{
-				for(int comp=0;comp<numScanComponents;++comp,++pirPtr,++cirPtr)
-					{
-					/* Decode the difference: */
-					int s=scanTables[comp]->decode(bb);
-					int diff=s!=0?bb.getSignedBits(s):0;
-						
-					/* Calculate the predictor value: */
-					int predicted=0;
-					switch(ss)
-						{
-						case 0:
-							predicted=0;
-							break;
-						
-						case 1:
-							predicted=int(cirPtr[-numScanComponents]);
-							break;
-
-						case 2:
-							predicted=int(pirPtr[0]);
-							break;
-						
-						case 3:
-							predicted=int(pirPtr[-numScanComponents]);
-							break;
-						
-						case 4:
-							predicted=int(cirPtr[-numScanComponents])+(int(pirPtr[0])-int(pirPtr[-numScanComponents]));
-							break;
-						
-						case 5:
-							predicted=int(cirPtr[-numScanComponents])+((int(pirPtr[0])-int(pirPtr[-numScanComponents]))>>1);
-							break;
-						
-						case 6:
-							predicted=int(pirPtr[0])+((int(cirPtr[-numScanComponents])-int(pirPtr[-numScanComponents]))>>1);
-							break;
-
-						case 7:
-							predicted=(int(cirPtr[-numScanComponents])+int(pirPtr[0]))>>1;
-							break;
-						}
-					*cirPtr=short(predicted+diff);
-					}
-				}
 			
-			--restartRowsToGo;
+			int firstRow=interval*restartInRows;
+			int lastRow=firstRow+restartInRows<imageSize[1]?firstRow+restartInRows:imageSize[1];
+			decodeRows(bb,scanTables,numScanComponents,imageSize[0],initialValue,decodeRow,firstRow,lastRow,imageRows,imageWriter);
 			}
-		
-		/* Save the current image row: */
-		imageWriter.writeImageRow(row,imageRows[0]);
-		short* tempRow=imageRows[0];
-		imageRows[0]=imageRows[1];
-		imageRows[1]=tempRow;
 		}
-	
-	/* Clean up: */
-	for(int i=0;i<2;++i)
-		delete[] imageRows[i];
 	}
 
 }
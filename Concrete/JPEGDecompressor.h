@@ -1,6 +1,6 @@
 /***********************************************************************
 JPEGDecompressor - Class to decompress lossless JPEG images.
-Copyright (c) 2005-2011 Oliver Kreylos
+Copyright (c) 2005-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -22,6 +22,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef VISUALIZATION_CONCRETE_JPEGDECOMPRESSOR_INCLUDED
 #define VISUALIZATION_CONCRETE_JPEGDECOMPRESSOR_INCLUDED
 
+#include <stddef.h>
+#include <vector>
 #include <IO/File.h>
 
 /* Forward declarations: */
@@ -79,6 +81,7 @@ class JPEGDecompressor
 	HuffmanTable* huffmanTables[4]; // Pointer to up to four Huffman tables
 	int restartInterval; // Number of MCUs per restart interval, 0 = no restart
 	int ss,pt; // Point transformation parameters
+	unsigned int numThreads; // Maximum number of threads to decode the restart intervals of a scan in parallel
 	
 	/* Private methods: */
 	void processSoi(void); // Processes an SOI marker
@@ -87,6 +90,7 @@ class JPEGDecompressor
 	void processSof(int sofMarker); // Processes an SOF marker
 	void processSos(void); // Processes an SOS marker
 	int processTables(void); // Processes the tables section of a JPEG stream; returns marker that ended tables
+	void readScanData(std::vector<unsigned char>& scanData,std::vector<size_t>& intervalOffsets); // Reads the entropy-coded data of the current scan with restart markers removed, and the offsets of all restart intervals plus the end offset
 	void processRestart(short nextMarkerNumber); // Processes a restart marker inside a stream
 	
 	/* Constructors and destructors: */
@@ -95,6 +99,10 @@ class JPEGDecompressor
 	~JPEGDecompressor(void); // Destroys the decompressor after use
 	
 	/* Methods: */
+	void setNumThreads(unsigned int newNumThreads) // Sets the maximum number of threads to decode scans with multiple restart intervals
+		{
+		numThreads=newNumThreads;
+		};
 	bool readScanHeader(void); // Prepares for decompressing an image scan by reading the scan header; returns true if an image scan follows
 	const int* getImageSize(void) const // Returns the image size as an array
 		{
@@ -1,7 +1,7 @@
 /***********************************************************************
 JPEGImageWriter - Base class to receive decompressed image data from a
 JPEG decompressor object.
-Copyright (c) 2010 Oliver Kreylos
+Copyright (c) 2010-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -37,7 +37,7 @@ class JPEGImageWriter
 	
 	/* Methods: */
 	virtual void setImageParameters(const int imageSize[2],int numScanComponents,int numBits) =0; // Changes the format of the decompressed image
-	virtual void writeImageRow(int rowIndex,const short* imageRow) =0; // Writes a complete image row
+	virtual void writeImageRow(int rowIndex,const short* imageRow) =0; // Writes a complete image row; can be called concurrently for different rows when restart intervals are decoded in parallel
 	};
 
 }
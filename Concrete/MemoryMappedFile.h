@@ -0,0 +1,116 @@
+/***********************************************************************
+MemoryMappedFile - Class to map the contents of binary files into
+memory, to let data sets use raw data arrays in place when the files'
+layout matches the in-memory representation.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_CONCRETE_MEMORYMAPPEDFILE_INCLUDED
+#define VISUALIZATION_CONCRETE_MEMORYMAPPEDFILE_INCLUDED
+
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <Misc/ThrowStdErr.h>
+
+namespace Visualization {
+
+namespace Concrete {
+
+class MemoryMappedFile
+	{
+	/* Elements: */
+	private:
+	void* data; // Pointer to the mapped file contents
+	size_t size; // Size of the mapped file in bytes
+	
+	/* Constructors and destructors: */
+	public:
+	MemoryMappedFile(const char* fileName) // Maps the entire file of the given name; pages are shared with the page cache and copied on write
+		:data(0),size(0)
+		{
+		/* Open the file and determine its size: */
+		int fd=open(fileName,O_RDONLY);
+		if(fd<0)
+			Misc::throwStdErr("MemoryMappedFile: Unable to open file %s due to error %s",fileName,strerror(errno));
+		struct stat fileStats;
+		if(fstat(fd,&fileStats)<0)
+			{
+			int error=errno;
+			close(fd);
+			Misc::throwStdErr("MemoryMappedFile: Unable to query size of file %s due to error %s",fileName,strerror(error));
+			}
+		size=size_t(fileStats.st_size);
+		
+		if(size>0)
+			{
+			/* Map the file privately, so that changes to the data set never reach the file: */
+			data=mmap(0,size,PROT_READ|PROT_WRITE,MAP_PRIVATE,fd,0);
+			if(data==MAP_FAILED)
+				{
+				int error=errno;
+				close(fd);
+				data=0;
+				Misc::throwStdErr("MemoryMappedFile: Unable to map file %s due to error %s",fileName,strerror(error));
+				}
+			}
+		
+		/* The mapping remains valid after the file is closed: */
+		close(fd);
+		}
+	private:
+	MemoryMappedFile(const MemoryMappedFile& source); // Prohibit copy constructor
+	MemoryMappedFile& operator=(const MemoryMappedFile& source); // Prohibit assignment operator
+	public:
+	~MemoryMappedFile(void)
+		{
+		if(data!=0)
+			munmap(data,size);
+		}
+	
+	/* Methods: */
+	static bool isHostLittleEndian(void) // Returns true if the host stores multi-byte values in little-endian order
+		{
+		unsigned int test=1U;
+		return *reinterpret_cast<unsigned char*>(&test)==1U;
+		}
+	size_t getSize(void) const // Returns the size of the mapped file in bytes
+		{
+		return size;
+		}
+	void* getData(void) // Returns the mapped file contents
+		{
+		return data;
+		}
+	const void* getData(void) const // Ditto
+		{
+		return data;
+		}
+	};
+
+}
+
+}
+
+#endif
@@ -2,7 +2,7 @@
 MultiChannelImageStack - Class to represent multivariate scalaar-valued
 Cartesian data sets stored as multiple matching stacks of color or
 greyscale images.
-Copyright (c) 2009-2011 Oliver Kreylos
+Copyright (c) 2009-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -41,6 +41,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Images/RGBImage.h>
 #include <Images/ReadImageFile.h>
 
+#include <ParallelFor.h>
+
 namespace Visualization {
 
 namespace Concrete {
@@ -201,82 +203,147 @@ void loadGreyscaleImage(StackDescriptor& sd,Value* slicePtr,const char* imageFil
 		}
 	}
 
-void loadGreyscaleImageStack(StackDescriptor& sd,int newSliceIndex,const char* imageFileNameTemplate)
+class GreyscaleImageLoader // Functor class to load the images of a greyscale image stack in parallel
 	{
+	/* Elements: */
+	private:
+	StackDescriptor* sd; // Descriptor of the loaded image stack
+	Value* slicePtr; // Pointer to the first image's plane in the data set's slice
+	const char* imageFileNameTemplate; // printf-style template for image file names
 	#ifdef IMAGES_HAVE_TIFF
-	/* Check if the image file name template matches TIFF images: */
-	const char* ext=Misc::getExtension(imageFileNameTemplate);
-	bool isTiff=strcasecmp(ext,".tif")==0||strcasecmp(ext,".tiff")==0;
+	bool isTiff; // Flag whether the image files are TIFF images
 	#endif
+	int batchBase; // Index of the image corresponding to work item zero
 	
-	/* Get a pointer to the slice: */
-	Value* slicePtr=sd.dataSet.getSliceArray(newSliceIndex);
-	if(sd.master)
-		std::cout<<"Reading greyscale image stack "<<imageFileNameTemplate<<"...   0%"<<std::flush;
-	Misc::Timer loadTimer;
-	for(int imageIndex=0;imageIndex<sd.numVertices[2];++imageIndex,slicePtr+=sd.dataSet.getVertexStride(2))
+	/* Constructors and destructors: */
+	public:
+	GreyscaleImageLoader(StackDescriptor& sSd,Value* sSlicePtr,const char* sImageFileNameTemplate,int sBatchBase)
+		:sd(&sSd),slicePtr(sSlicePtr),imageFileNameTemplate(sImageFileNameTemplate),batchBase(sBatchBase)
 		{
+		#ifdef IMAGES_HAVE_TIFF
+		/* Check if the image file name template matches TIFF images: */
+		const char* ext=Misc::getExtension(imageFileNameTemplate);
+		isTiff=strcasecmp(ext,".tif")==0||strcasecmp(ext,".tiff")==0;
+		#endif
+		}
+	
+	/* Methods: */
+	void operator()(size_t item) // Loads one image into its plane of the data set's slice
+		{
+		int imageIndex=batchBase+int(item);
+		
 		/* Generate the image file name: */
 		char imageFileNameBuffer[1024];
-		snprintf(imageFileNameBuffer,sizeof(imageFileNameBuffer),imageFileNameTemplate,imageIndex*sd.imageIndexStep+sd.imageIndexStart);
-		std::string imageFileName=sd.imageDirectory;
+		snprintf(imageFileNameBuffer,sizeof(imageFileNameBuffer),imageFileNameTemplate,imageIndex*sd->imageIndexStep+sd->imageIndexStart);
+		std::string imageFileName=sd->imageDirectory;
 		imageFileName.append(imageFileNameBuffer);
 		
 		/* Load the image: */
+		Value* imagePtr=slicePtr+ptrdiff_t(imageIndex)*sd->dataSet.getVertexStride(2);
 		#ifdef IMAGES_HAVE_TIFF
 		if(isTiff)
-			loadGreyscaleTiffImage(sd,slicePtr,imageFileName.c_str());
+			loadGreyscaleTiffImage(*sd,imagePtr,imageFileName.c_str());
 		else
-			loadGreyscaleImage(sd,slicePtr,imageFileName.c_str());
+			loadGreyscaleImage(*sd,imagePtr,imageFileName.c_str());
 		#else
-		loadGreyscaleImage(sd,slicePtr,imageFileName.c_str());
+		loadGreyscaleImage(*sd,imagePtr,imageFileName.c_str());
 		#endif
-		
-		if(sd.master)
-			std::cout<<"\b\b\b\b"<<std::setw(3)<<((imageIndex+1)*100)/sd.numVertices[2]<<"%"<<std::flush;
 		}
-	loadTimer.elapse();
-	if(sd.master)
-		std::cout<<"\b\b\b\bdone in "<<loadTimer.getTime()*1000.0<<" ms"<<std::endl;
-	}
+	};
 
-void loadColorImageStack(StackDescriptor& sd,const int newSliceIndices[3],const char* imageFileNameTemplate)
+class ColorImageLoader // Functor class to load the images of a color image stack in parallel
 	{
-	/* Get a pointer to the slice: */
-	Value* slices[3];
-	for(int i=0;i<3;++i)
-		slices[i]=sd.dataSet.getSliceArray(newSliceIndices[i]);
-	ptrdiff_t sliceIndex=0;
-	if(sd.master)
-		std::cout<<"Reading color image stack "<<imageFileNameTemplate<<"...   0%"<<std::flush;
-	Misc::Timer loadTimer;
-	for(int imageIndex=0;imageIndex<sd.numVertices[2];++imageIndex,sliceIndex+=sd.dataSet.getVertexStride(2))
+	/* Elements: */
+	private:
+	StackDescriptor* sd; // Descriptor of the loaded image stack
+	Value* slices[3]; // Pointers to the data set's red, green, and blue slices
+	const char* imageFileNameTemplate; // printf-style template for image file names
+	int batchBase; // Index of the image corresponding to work item zero
+	
+	/* Constructors and destructors: */
+	public:
+	ColorImageLoader(StackDescriptor& sSd,Value* const sSlices[3],const char* sImageFileNameTemplate,int sBatchBase)
+		:sd(&sSd),imageFileNameTemplate(sImageFileNameTemplate),batchBase(sBatchBase)
 		{
+		for(int i=0;i<3;++i)
+			slices[i]=sSlices[i];
+		}
+	
+	/* Methods: */
+	void operator()(size_t item) // Loads one image into its planes of the data set's slices
+		{
+		int imageIndex=batchBase+int(item);
+		
 		/* Generate the image file name: */
 		char imageFileName[1024];
-		snprintf(imageFileName,sizeof(imageFileName),imageFileNameTemplate,imageIndex*sd.imageIndexStep+sd.imageIndexStart);
+		snprintf(imageFileName,sizeof(imageFileName),imageFileNameTemplate,imageIndex*sd->imageIndexStep+sd->imageIndexStart);
 		
 		/* Load the image: */
-		Images::RGBImage image=Images::readImageFile(sd.imageDirectory.empty()?imageFileName:(sd.imageDirectory+imageFileName).c_str());
+		Images::RGBImage image=Images::readImageFile(sd->imageDirectory.empty()?imageFileName:(sd->imageDirectory+imageFileName).c_str());
 		
 		/* Check if the image conforms: */
-		if(image.getSize(0)<(unsigned int)(sd.regionOrigin[0]+sd.numVertices[0])||image.getSize(1)<(unsigned int)(sd.regionOrigin[1]+sd.numVertices[1]))
+		if(image.getSize(0)<(unsigned int)(sd->regionOrigin[0]+sd->numVertices[0])||image.getSize(1)<(unsigned int)(sd->regionOrigin[1]+sd->numVertices[1]))
 			Misc::throwStdErr("MultiChannelImageStack::load: Size of image file \"%s\" does not match image stack size",imageFileName);
 		
 		/* Copy the image's pixels into the data set: */
-		ptrdiff_t rowIndex=sliceIndex;
-		for(int y=sd.regionOrigin[1];y<sd.regionOrigin[1]+sd.numVertices[1];++y,rowIndex+=sd.dataSet.getVertexStride(1))
+		ptrdiff_t rowIndex=ptrdiff_t(imageIndex)*sd->dataSet.getVertexStride(2);
+		for(int y=sd->regionOrigin[1];y<sd->regionOrigin[1]+sd->numVertices[1];++y,rowIndex+=sd->dataSet.getVertexStride(1))
 			{
 			ptrdiff_t vIndex=rowIndex;
-			for(int x=sd.regionOrigin[0];x<sd.regionOrigin[0]+sd.numVertices[0];++x,vIndex+=sd.dataSet.getVertexStride(0))
+			for(int x=sd->regionOrigin[0];x<sd->regionOrigin[0]+sd->numVertices[0];++x,vIndex+=sd->dataSet.getVertexStride(0))
 				{
 				const Images::RGBImage::Color& pixel=image.getPixel(x,y);
 				for(int i=0;i<3;++i)
 					slices[i][vIndex]=Value(pixel[i]);
 				}
 			}
+		}
+	};
+
+void loadGreyscaleImageStack(StackDescriptor& sd,int newSliceIndex,const char* imageFileNameTemplate)
+	{
+	/* Get a pointer to the slice: */
+	Value* slicePtr=sd.dataSet.getSliceArray(newSliceIndex);
+	if(sd.master)
+		std::cout<<"Reading greyscale image stack "<<imageFileNameTemplate<<"...   0%"<<std::flush;
+	Misc::Timer loadTimer;
+	
+	/* Decode images in batches to report progress; each thread holds at most one decoded image at a time: */
+	unsigned int numThreads=getNumParallelThreads();
+	int batchSize=int(numThreads)*4;
+	for(int batchBase=0;batchBase<sd.numVertices[2];batchBase+=batchSize)
+		{
+		int batchEnd=batchBase+batchSize<sd.numVertices[2]?batchBase+batchSize:sd.numVertices[2];
+		parallelFor(size_t(batchEnd-batchBase),GreyscaleImageLoader(sd,slicePtr,imageFileNameTemplate,batchBase),numThreads);
+		
+		if(sd.master)
+			std::cout<<"\b\b\b\b"<<std::setw(3)<<(batchEnd*100)/sd.numVertices[2]<<"%"<<std::flush;
+		}
+	loadTimer.elapse();
+	if(sd.master)
+		std::cout<<"\b\b\b\bdone in "<<loadTimer.getTime()*1000.0<<" ms"<<std::endl;
+	}
+
+void loadColorImageStack(StackDescriptor& sd,const int newSliceIndices[3],const char* imageFileNameTemplate)
+	{
+	/* Get pointers to the slices: */
+	Value* slices[3];
+	for(int i=0;i<3;++i)
+		slices[i]=sd.dataSet.getSliceArray(newSliceIndices[i]);
+	if(sd.master)
+		std::cout<<"Reading color image stack "<<imageFileNameTemplate<<"...   0%"<<std::flush;
+	Misc::Timer loadTimer;
+	
+	/* Decode images in batches to report progress; each thread holds at most one decoded image at a time: */
+	unsigned int numThreads=getNumParallelThreads();
+	int batchSize=int(numThreads)*4;
+	for(int batchBase=0;batchBase<sd.numVertices[2];batchBase+=batchSize)
+		{
+		int batchEnd=batchBase+batchSize<sd.numVertices[2]?batchBase+batchSize:sd.numVertices[2];
+		parallelFor(size_t(batchEnd-batchBase),ColorImageLoader(sd,slices,imageFileNameTemplate,batchBase),numThreads);
+		
 		if(sd.master)
-			std::cout<<"\b\b\b\b"<<std::setw(3)<<((imageIndex+1)*100)/sd.numVertices[2]<<"%"<<std::flush;
+			std::cout<<"\b\b\b\b"<<std::setw(3)<<(batchEnd*100)/sd.numVertices[2]<<"%"<<std::flush;
 		}
 	loadTimer.elapse();
 	if(sd.master)
@@ -1,7 +1,7 @@
 /***********************************************************************
 MultiVolFile - Class to represent multivariate scalar-valued Cartesian
 data sets stored as multiple matching volume files.
-Copyright (c) 2010 Oliver Kreylos
+Copyright (c) 2010-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -28,16 +28,53 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Plugins/FactoryManager.h>
 #include <Geometry/Point.h>
 
+#include <Concrete/MemoryMappedFile.h>
+
 namespace Visualization {
 
 namespace Concrete {
 
 namespace {
 
+/**************
+Helper classes:
+**************/
+
+class MappedVolFile:public DS::SliceStorage // Class for memory-mapped vol files whose data is used in place as a data set slice
+	{
+	/* Elements: */
+	public:
+	MemoryMappedFile file; // The mapped vol file
+	
+	/* Constructors and destructors: */
+	MappedVolFile(const char* fileName)
+		:file(fileName)
+		{
+		}
+	};
+
 /**************
 Helper methods:
 **************/
 
+int mapVolFile(const char* volFileName,DS& dataSet) // Adds a slice using a vol file's float data in place; returns -1 if the file does not match the data set
+	{
+	/* Vol files store little-endian values after a 40-byte header: */
+	const size_t headerSize=3*sizeof(int)+6*sizeof(float)+sizeof(unsigned int);
+	if(!MemoryMappedFile::isHostLittleEndian())
+		return -1;
+	
+	/* Map the vol file and check that it contains all slice values: */
+	Misc::SelfDestructPointer<MappedVolFile> volFile(new MappedVolFile(volFileName));
+	size_t totalNumVertices=size_t(dataSet.getNumVertices().calcIncrement(-1));
+	if(volFile->file.getSize()<headerSize+totalNumVertices*sizeof(Value))
+		return -1;
+	
+	/* Let the data set adopt the mapped file: */
+	Value* sliceValues=reinterpret_cast<Value*>(static_cast<char*>(volFile->file.getData())+headerSize);
+	return dataSet.addSlice(sliceValues,volFile.releaseTarget());
+	}
+
 template <class ValueParam>
 inline
 void readVolFile(Misc::File& volFile,DS& dataSet,int sliceIndex)
@@ -130,21 +167,29 @@ Visualization::Abstract::DataSet* MultiVolFile::load(const std::vector<std::stri
 			unsigned int volTypeSize=volFile.read<unsigned int>();
 			if(volTypeSize==1||volTypeSize==2||volTypeSize==4||volTypeSize==8)
 				{
-				/* Add a new slice to the data set: */
-				int newSliceIndex=dataSet.addSlice();
+				/* Use float vol files in place if their layout matches the data set's slices: */
+				int newSliceIndex=-1;
+				if(volTypeSize==sizeof(Value))
+					newSliceIndex=mapVolFile(args[argc+1].c_str(),dataSet);
+				
+				if(newSliceIndex<0)
+					{
+					/* Add a new slice to the data set: */
+					newSliceIndex=dataSet.addSlice();
+					
+					/* Read the vol file: */
+					if(volTypeSize==1)
+						readVolFile<unsigned char>(volFile,dataSet,newSliceIndex);
+					else if(volTypeSize==2)
+						readVolFile<signed short int>(volFile,dataSet,newSliceIndex);
+					else if(volTypeSize==4)
+						readVolFile<float>(volFile,dataSet,newSliceIndex);
+					else
+						readVolFile<double>(volFile,dataSet,newSliceIndex);
+					}
 				
 				/* Add a new scalar variable to the data value: */
 				dataValue.addScalarVariable(args[argc].c_str());
-				
-				/* Read the vol file: */
-				if(volTypeSize==1)
-					readVolFile<unsigned char>(volFile,dataSet,newSliceIndex);
-				else if(volTypeSize==2)
-					readVolFile<signed short int>(volFile,dataSet,newSliceIndex);
-				else if(volTypeSize==4)
-					readVolFile<float>(volFile,dataSet,newSliceIndex);
-				else
-					readVolFile<double>(volFile,dataSet,newSliceIndex);
 				}
 			else
 				std::cout<<"Vol file "<<args[argc+1]<<" has unknown data type; skipping"<<std::endl;
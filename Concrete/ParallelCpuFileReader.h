@@ -0,0 +1,128 @@
+/***********************************************************************
+ParallelCpuFileReader - Helper function to read the per-CPU files
+written by parallel simulation runs concurrently on a bounded number of
+threads.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_CONCRETE_PARALLELCPUFILEREADER_INCLUDED
+#define VISUALIZATION_CONCRETE_PARALLELCPUFILEREADER_INCLUDED
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+#include <Cluster/MulticastPipe.h>
+
+#include <ParallelFor.h>
+
+namespace Visualization {
+
+namespace Concrete {
+
+/**********************************************************************
+Functor class to parse the previously opened files of a batch of CPUs
+in parallel:
+**********************************************************************/
+
+template <class CpuFileReaderParam>
+class CpuFileBatchParser
+	{
+	/* Elements: */
+	private:
+	CpuFileReaderParam* reader; // Reader parsing the CPUs' files
+	int batchBase; // Index of the CPU corresponding to work item zero
+	const std::vector<std::string>* openErrors; // Errors that occurred while opening each CPU's files, or empty strings
+	
+	/* Constructors and destructors: */
+	public:
+	CpuFileBatchParser(CpuFileReaderParam* sReader,int sBatchBase,const std::vector<std::string>* sOpenErrors)
+		:reader(sReader),batchBase(sBatchBase),openErrors(sOpenErrors)
+		{
+		}
+	
+	/* Methods: */
+	void operator()(size_t item) // Parses the files of one CPU
+		{
+		/* Report a deferred open error in place of the CPU's parse errors: */
+		if(!(*openErrors)[item].empty())
+			throw std::runtime_error((*openErrors)[item]);
+		
+		reader->parseCpuFiles(batchBase+int(item));
+		}
+	};
+
+/**********************************************************************
+Function to read the files of the given number of CPUs using the given
+reader, which has to provide methods void openCpuFiles(int cpu), called
+on the calling thread in increasing CPU order, and void
+parseCpuFiles(int cpu), called concurrently for different CPUs, which
+must release the CPU's files when done. Errors are reported for the
+lowest-numbered failing CPU, as if the files had been read in order.
+Prints completion percentages on the master node.
+**********************************************************************/
+
+template <class CpuFileReaderParam>
+inline
+void
+readCpuFiles(
+	int numCpus,
+	CpuFileReaderParam& reader,
+	Cluster::MulticastPipe* pipe)
+	{
+	bool master=pipe==0||pipe->isMaster();
+	
+	/* Files opened on a cluster each stream through their own multicast pipe, which all nodes must consume in the same order, so cluster nodes parse on the calling thread: */
+	unsigned int numThreads=pipe!=0?1U:getNumParallelThreads();
+	
+	/* Open files in batches to bound the number of simultaneously open files: */
+	int batchSize=int(numThreads)*4;
+	std::vector<std::string> openErrors(batchSize);
+	for(int batchBase=0;batchBase<numCpus;batchBase+=batchSize)
+		{
+		int batchEnd=batchBase+batchSize<numCpus?batchBase+batchSize:numCpus;
+		
+		/* Open the batch's files in CPU order, deferring errors until the CPUs are parsed: */
+		for(int cpu=batchBase;cpu<batchEnd;++cpu)
+			{
+			openErrors[cpu-batchBase].clear();
+			try
+				{
+				reader.openCpuFiles(cpu);
+				}
+			catch(std::runtime_error err)
+				{
+				openErrors[cpu-batchBase]=err.what();
+				}
+			}
+		
+		/* Parse the batch's files: */
+		parallelFor(size_t(batchEnd-batchBase),CpuFileBatchParser<CpuFileReaderParam>(&reader,batchBase,&openErrors),numThreads);
+		
+		if(master)
+			std::cout<<"\b\b\b\b"<<std::setw(3)<<(batchEnd*100)/numCpus<<"%"<<std::flush;
+		}
+	}
+
+}
+
+}
+
+#endif
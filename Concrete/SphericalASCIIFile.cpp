@@ -1,7 +1,7 @@
 /***********************************************************************
 SphericalASCIIFile - Class to read multivariate scalar data in spherical
 coordinates from simple ASCII files.
-Copyright (c) 2008-2011 Oliver Kreylos
+Copyright (c) 2008-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -34,12 +34,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Plugins/FactoryManager.h>
 #include <IO/File.h>
 #include <IO/OpenFile.h>
-#include <IO/ValueSource.h>
 #include <Cluster/MulticastPipe.h>
 #include <Math/Math.h>
 #include <Math/Constants.h>
 
 #include <Concrete/SphericalCoordinateTransformer.h>
+#include <Concrete/ASCIINumberSource.h>
 #include <Concrete/EarthDataSet.h>
 
 namespace Visualization {
@@ -207,9 +207,8 @@ Visualization::Abstract::DataSet* SphericalASCIIFile::load(const std::vector<std
 	if(numDataSlices==0)
 		Misc::throwStdErr("SphericalASCIIFile::load: No scalar or vector data values specified");
 	
-	/* Open the data file: */
-	IO::ValueSource reader(openFile(dataFileName,pipe));
-	reader.setPunctuation('\n',true);
+	/* Open the data file, treating newlines as line terminators: */
+	ASCIINumberSource reader(openFile(dataFileName,pipe),false);
 	
 	/* Skip the data file header: */
 	for(int i=0;i<numHeaderLines;++i)
@@ -299,7 +298,7 @@ Visualization::Abstract::DataSet* SphericalASCIIFile::load(const std::vector<std
 					reader.skipWs();
 					++lineNumber;
 					}
-				catch(IO::ValueSource::NumberError err)
+				catch(ASCIINumberSource::NumberError err)
 					{
 					Misc::throwStdErr("SphericalASCIIFile::load: Number format error in line %u",lineNumber);
 					}
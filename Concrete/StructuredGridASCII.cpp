@@ -2,7 +2,7 @@
 StructuredGridASCII - Class defining lowest-common-denominator ASCII
 file format for curvilinear grids in Cartesian or spherical coordinates.
 Vertex positions and attributes are stored in separate files.
-Copyright (c) 2008-2011 Oliver Kreylos
+Copyright (c) 2008-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -29,6 +29,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <string>
 #include <iostream>
 #include <iomanip>
+#include <Misc/SizedTypes.h>
 #include <Misc/SelfDestructPointer.h>
 #include <Misc/ThrowStdErr.h>
 #include <Plugins/FactoryManager.h>
@@ -37,14 +38,171 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Cluster/MulticastPipe.h>
 #include <Math/Math.h>
 
+#include <Concrete/ASCIINumberSource.h>
+
 namespace Visualization {
 
 namespace Concrete {
 
+/*********************************************************
+Declaration of class StructuredGridASCII::SliceFileReader:
+*********************************************************/
+
+class StructuredGridASCII::SliceFileReader:public DataValue::SliceLoader
+	{
+	/* Elements: */
+	private:
+	std::string sliceFileName; // Name of the slice file
+	IO::FilePtr sliceFile; // The slice file, positioned behind its header; released when reading starts
+	unsigned int firstLineIndex; // Index of the first line behind the slice file's header
+	DS& dataSet; // Data set receiving the vertex attributes
+	int sliceIndex; // Index of the first slice receiving the vertex attributes
+	bool vectorValue; // Flag whether the slice file contains vector attributes
+	bool sphericalCoordinates; // Flag whether vector attributes are defined in spherical coordinates
+	bool logScalar; // Flag whether to store the logarithm of scalar attributes
+	bool master; // Flag whether to print progress messages
+	
+	/* Constructors and destructors: */
+	public:
+	SliceFileReader(const std::string& sSliceFileName,IO::FilePtr sSliceFile,unsigned int sFirstLineIndex,DS& sDataSet,int sSliceIndex,bool sVectorValue,bool sSphericalCoordinates,bool sLogScalar,bool sMaster)
+		:sliceFileName(sSliceFileName),sliceFile(sSliceFile),firstLineIndex(sFirstLineIndex),
+		 dataSet(sDataSet),sliceIndex(sSliceIndex),
+		 vectorValue(sVectorValue),sphericalCoordinates(sSphericalCoordinates),logScalar(sLogScalar),
+		 master(sMaster)
+		{
+		}
+	
+	/* Methods from DataValue::SliceLoader: */
+	virtual void loadSlices(void)
+		{
+		/* The slice file can only be read once; it is released even if reading fails: */
+		if(sliceFile==0)
+			Misc::throwStdErr("StructuredGridASCII: Slice file %s could not be read",sliceFileName.c_str());
+		ASCIINumberSource sliceReader(sliceFile,false);
+		sliceFile=0;
+		
+		/* Read all vertex attributes from the rest of the slice file: */
+		if(master)
+			std::cout<<"Reading slice file "<<sliceFileName<<"...   0%"<<std::flush;
+		const DS::Index& numVertices=dataSet.getNumVertices();
+		unsigned int lineIndex=firstLineIndex;
+		DS::Index index(0);
+		while(index[2]<numVertices[2])
+			{
+			/* Check if the file is already over: */
+			if(sliceReader.eof())
+				Misc::throwStdErr("StructuredGridASCII::load: early end-of-file in slice file %s",sliceFileName.c_str());
+			
+			/* Check for empty or comment lines: */
+			if(sliceReader.peekc()!='\n'&&sliceReader.peekc()!='#')
+				{
+				/* Parse the line: */
+				if(vectorValue)
+					{
+					DataValue::VVector vector;
+					if(sphericalCoordinates)
+						{
+						try
+							{
+							/* Read the vector attribute in spherical coordinates: */
+							double longitude=sliceReader.readNumber();
+							double latitude=sliceReader.readNumber();
+							double radius=sliceReader.readNumber();
+							
+							/* Convert the vector to Cartesian coordinates: */
+							const DS::Point& p=dataSet.getVertexPosition(index);
+							double xy=Math::sqr(double(p[0]))+Math::sqr(double(p[1]));
+							double r=xy+Math::sqr(double(p[2]));
+							xy=Math::sqrt(xy);
+							r=Math::sqrt(r);
+							double s0=double(p[2])/r;
+							double c0=xy/r;
+							double s1=double(p[1])/xy;
+							double c1=double(p[0])/xy;
+							vector[0]=Scalar(c1*(c0*radius-s0*latitude)-s1*longitude);
+							vector[1]=Scalar(s1*(c0*radius-s0*latitude)+c1*longitude);
+							vector[2]=Scalar(c0*latitude+s0*radius);
+							}
+						catch(ASCIINumberSource::NumberError err)
+							{
+							Misc::throwStdErr("StructuredGridASCII::load: Invalid spherical vector attribute in line %u in slice file %s",lineIndex,sliceFileName.c_str());
+							}
+						}
+					else
+						{
+						try
+							{
+							/* Read the vector attribute in Cartesian coordinates: */
+							for(int i=0;i<3;++i)
+								vector[i]=DataValue::VVector::Scalar(sliceReader.readNumber());
+							}
+						catch(ASCIINumberSource::NumberError err)
+							{
+							Misc::throwStdErr("StructuredGridASCII::load: Invalid Cartesian vector attribute in line %u in slice file %s",lineIndex,sliceFileName.c_str());
+							}
+						}
+					
+					/* Store the vector's components and magnitude: */
+					for(int i=0;i<3;++i)
+						dataSet.getVertexValue(sliceIndex+i,index)=vector[i];
+					dataSet.getVertexValue(sliceIndex+3,index)=Scalar(Geometry::mag(vector));
+					}
+				else
+					{
+					/* Read the scalar attribute: */
+					if(logScalar)
+						{
+						try
+							{
+							double value=sliceReader.readNumber();
+							dataSet.getVertexValue(sliceIndex,index)=Scalar(Math::log10(value));
+							}
+						catch(ASCIINumberSource::NumberError err)
+							{
+							Misc::throwStdErr("StructuredGridASCII::load: Invalid logarithmic scalar vertex attribute in line %u in slice file %s",lineIndex,sliceFileName.c_str());
+							}
+						}
+					else
+						{
+						try
+							{
+							dataSet.getVertexValue(sliceIndex,index)=Scalar(sliceReader.readNumber());
+							}
+						catch(ASCIINumberSource::NumberError err)
+							{
+							Misc::throwStdErr("StructuredGridASCII::load: Invalid scalar vertex attribute in line %u in slice file %s",lineIndex,sliceFileName.c_str());
+							}
+						}
+					}
+				
+				/* Go to the next vertex: */
+				int incDim;
+				for(incDim=0;incDim<2&&index[incDim]==numVertices[incDim]-1;++incDim)
+					index[incDim]=0;
+				++index[incDim];
+				if(incDim==2&&master)
+					std::cout<<"\b\b\b\b"<<std::setw(3)<<(index[2]*100)/numVertices[2]<<"%"<<std::flush;
+				}
+			
+			/* Go to the next line: */
+			sliceReader.skipLine();
+			sliceReader.skipWs();
+			++lineIndex;
+			}
+		if(master)
+			std::cout<<"\b\b\b\bdone"<<std::endl;
+		}
+	};
+
 /************************************
 Methods of class StructuredGridASCII:
 ************************************/
 
+StructuredGridASCII::DataSet* StructuredGridASCII::createDataSet(const std::vector<std::string>& args) const
+	{
+	return new DataSet;
+	}
+
 StructuredGridASCII::StructuredGridASCII(void)
 	:BaseModule("StructuredGridASCII")
 	{
@@ -55,7 +213,7 @@ Visualization::Abstract::DataSet* StructuredGridASCII::load(const std::vector<st
 	bool master=pipe==0||pipe->isMaster();
 	
 	/* Create the result data set: */
-	Misc::SelfDestructPointer<DataSet> result(new DataSet);
+	Misc::SelfDestructPointer<DataSet> result(createDataSet(args));
 	
 	/* Parse command line parameters related to the grid definition file: */
 	std::vector<std::string>::const_iterator argIt=args.begin();
@@ -72,15 +230,17 @@ Visualization::Abstract::DataSet* StructuredGridASCII::load(const std::vector<st
 	/* Open the grid definition file: */
 	if(master)
 		std::cout<<"Reading grid file "<<*argIt<<"..."<<std::flush;
-	IO::ValueSource gridReader(openFile(*argIt,pipe));
-	gridReader.setPunctuation("#\n");
-	gridReader.skipWs();
+	IO::FilePtr gridFile(openFile(*argIt,pipe));
 	
 	/* Parse the grid file header: */
 	DS::Index numVertices(-1,-1,-1);
 	bool sphericalCoordinates=false;
 	unsigned int lineIndex=1;
 	int parsedHeaderLines=0;
+	{
+	IO::ValueSource gridReader(gridFile);
+	gridReader.setPunctuation("#\n");
+	gridReader.skipWs();
 	while(parsedHeaderLines<2)
 		{
 		/* Check if the file is already over: */
@@ -125,6 +285,7 @@ Visualization::Abstract::DataSet* StructuredGridASCII::load(const std::vector<st
 		gridReader.skipWs();
 		++lineIndex;
 		}
+	}
 	
 	/* Initialize the data set: */
 	DS& dataSet=result->getDs();
@@ -150,7 +311,8 @@ Visualization::Abstract::DataSet* StructuredGridASCII::load(const std::vector<st
 	// const double f=1.0/298.247; // Geoid flattening factor (not used, since there could be vector values)
 	const double scaleFactor=1.0e-3; // Scale factor for Cartesian coordinates
 	
-	/* Read all vertex positions: */
+	/* Read all vertex positions from the rest of the grid file: */
+	ASCIINumberSource gridReader(gridFile,false);
 	if(master)
 		std::cout<<"   0%"<<std::flush;
 	DS::Index index(0);
@@ -193,7 +355,7 @@ Visualization::Abstract::DataSet* StructuredGridASCII::load(const std::vector<st
 						dataSet.getVertexValue(2,index)=Scalar(r);
 						}
 					}
-				catch(IO::ValueSource::NumberError err)
+				catch(ASCIINumberSource::NumberError err)
 					{
 					Misc::throwStdErr("StructuredGridASCII::load: Invalid spherical vertex coordinate in line %u in grid file %s",lineIndex,argIt->c_str());
 					}
@@ -205,7 +367,7 @@ Visualization::Abstract::DataSet* StructuredGridASCII::load(const std::vector<st
 					for(int i=0;i<3;++i)
 						vertex[i]=DS::Scalar(gridReader.readNumber());
 					}
-				catch(IO::ValueSource::NumberError err)
+				catch(ASCIINumberSource::NumberError err)
 					{
 					Misc::throwStdErr("StructuredGridASCII::load: Invalid Cartesian vertex coordinate in line %u in grid file %s",lineIndex,argIt->c_str());
 					}
@@ -244,17 +406,17 @@ Visualization::Abstract::DataSet* StructuredGridASCII::load(const std::vector<st
 		else
 			{
 			/* Open the slice file: */
-			if(master)
-				std::cout<<"Reading slice file "<<*argIt<<"..."<<std::flush;
-			IO::ValueSource sliceReader(openFile(*argIt,pipe));
-			sliceReader.setPunctuation("#\n");
-			sliceReader.skipWs();
+			IO::FilePtr sliceFile(openFile(*argIt,pipe));
 			
 			/* Parse the slice file header: */
 			bool vectorValue=false;
 			int sliceIndex=dataSet.getNumSlices();
 			lineIndex=0;
 			parsedHeaderLines=0;
+			{
+			IO::ValueSource sliceReader(sliceFile);
+			sliceReader.setPunctuation("#\n");
+			sliceReader.skipWs();
 			while(parsedHeaderLines<2)
 				{
 				/* Check if the file is already over: */
@@ -309,6 +471,7 @@ Visualization::Abstract::DataSet* StructuredGridASCII::load(const std::vector<st
 					if(!vectorName.empty()&&vectorName!="\n")
 						{
 						/* Add another vector variable to the data value: */
+						vectorValue=true;
 						int vectorVariableIndex=dataValue.addVectorVariable(vectorName.c_str());
 						
 						/* Add four new slices to the data set (three components plus magnitude): */
@@ -333,115 +496,24 @@ Visualization::Abstract::DataSet* StructuredGridASCII::load(const std::vector<st
 				sliceReader.skipWs();
 				++lineIndex;
 				}
+			}
 			
-			/* Read all vertex attributes: */
-			if(master)
-				std::cout<<"   0%"<<std::flush;
-			DS::Index index(0);
-			while(index[2]<numVertices[2])
+			/* Read all vertex attributes from the rest of the slice file: */
+			Misc::SelfDestructPointer<SliceFileReader> reader(new SliceFileReader(*argIt,sliceFile,lineIndex,dataSet,sliceIndex,vectorValue,sphericalCoordinates,logNextScalar,master));
+			if(pipe==0)
 				{
-				/* Check if the file is already over: */
-				if(sliceReader.eof())
-					Misc::throwStdErr("StructuredGridASCII::load: early end-of-file in slice file %s",argIt->c_str());
-				
-				/* Check for empty or comment lines: */
-				if(sliceReader.peekc()!='\n'&&sliceReader.peekc()!='#')
-					{
-					/* Parse the line: */
-					if(vectorValue)
-						{
-						DataValue::VVector vector;
-						if(sphericalCoordinates)
-							{
-							try
-								{
-								/* Read the vector attribute in spherical coordinates: */
-								double longitude=sliceReader.readNumber();
-								double latitude=sliceReader.readNumber();
-								double radius=sliceReader.readNumber();
-								
-								/* Convert the vector to Cartesian coordinates: */
-								const DS::Point& p=dataSet.getVertexPosition(index);
-								double xy=Math::sqr(double(p[0]))+Math::sqr(double(p[1]));
-								double r=xy+Math::sqr(double(p[2]));
-								xy=Math::sqrt(xy);
-								r=Math::sqrt(r);
-								double s0=double(p[2])/r;
-								double c0=xy/r;
-								double s1=double(p[1])/xy;
-								double c1=double(p[0])/xy;
-								vector[0]=Scalar(c1*(c0*radius-s0*latitude)-s1*longitude);
-								vector[1]=Scalar(s1*(c0*radius-s0*latitude)+c1*longitude);
-								vector[2]=Scalar(c0*latitude+s0*radius);
-								}
-							catch(IO::ValueSource::NumberError err)
-								{
-								Misc::throwStdErr("StructuredGridASCII::load: Invalid spherical vector attribute in line %u in slice file %s",lineIndex,argIt->c_str());
-								}
-							}
-						else
-							{
-							try
-								{
-								/* Read the vector attribute in Cartesian coordinates: */
-								for(int i=0;i<3;++i)
-									vector[i]=DataValue::VVector::Scalar(sliceReader.readNumber());
-								}
-							catch(IO::ValueSource::NumberError err)
-								{
-								Misc::throwStdErr("StructuredGridASCII::load: Invalid Cartesian vector attribute in line %u in slice file %s",lineIndex,argIt->c_str());
-								}
-							}
-						
-						/* Store the vector's components and magnitude: */
-						for(int i=0;i<3;++i)
-							dataSet.getVertexValue(sliceIndex+i,index)=vector[i];
-						dataSet.getVertexValue(sliceIndex+3,index)=Scalar(Geometry::mag(vector));
-						}
-					else
-						{
-						/* Read the scalar attribute: */
-						if(logNextScalar)
-							{
-							try
-								{
-								double value=sliceReader.readNumber();
-								dataSet.getVertexValue(sliceIndex,index)=Scalar(Math::log10(value));
-								}
-							catch(IO::ValueSource::NumberError err)
-								{
-								Misc::throwStdErr("StructuredGridASCII::load: Invalid logarithmic scalar vertex attribute in line %u in slice file %s",lineIndex,argIt->c_str());
-								}
-							}
-						else
-							{
-							try
-								{
-								dataSet.getVertexValue(sliceIndex,index)=Scalar(sliceReader.readNumber());
-								}
-							catch(IO::ValueSource::NumberError err)
-								{
-								Misc::throwStdErr("StructuredGridASCII::load: Invalid scalar vertex attribute in line %u in slice file %s",lineIndex,argIt->c_str());
-								}
-							}
-						}
-
-					/* Go to the next vertex: */
-					int incDim;
-					for(incDim=0;incDim<2&&index[incDim]==numVertices[incDim]-1;++incDim)
-						index[incDim]=0;
-					++index[incDim];
-					if(incDim==2&&master)
-						std::cout<<"\b\b\b\b"<<std::setw(3)<<(index[2]*100)/numVertices[2]<<"%"<<std::flush;
-					}
+				/* Check that the slice file is long enough to hold an attribute for every grid vertex, at two characters per number: */
+				Misc::UInt64 numValues=Misc::UInt64(numVertices.calcIncrement(-1))*(vectorValue?3U:1U);
+				checkFileSize(*argIt,numValues*2U);
 				
-				/* Go to the next line: */
-				sliceReader.skipLine();
-				sliceReader.skipWs();
-				++lineIndex;
+				/* Defer reading the vertex attributes until one of the slice file's variables is first used: */
+				dataValue.setSliceLoader(sliceIndex,dataSet.getNumSlices()-sliceIndex,reader.releaseTarget());
+				}
+			else
+				{
+				/* Slice files on a cluster stream through multicast pipes, which all nodes must consume in lockstep, so read them right away: */
+				reader->loadSlices();
 				}
-			if(master)
-				std::cout<<"\b\b\b\bdone"<<std::endl;
 			}
 		}
 	
@@ -2,7 +2,7 @@
 StructuredGridASCII - Class defining lowest-common-denominator ASCII
 file format for curvilinear grids in Cartesian or spherical coordinates.
 Vertex positions and attributes are stored in separate files.
-Copyright (c) 2008-2011 Oliver Kreylos
+Copyright (c) 2008-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -46,6 +46,15 @@ typedef Visualization::Wrappers::Module<DS,DataValue> BaseModule; // Module base
 
 class StructuredGridASCII:public BaseModule
 	{
+	/* Embedded classes: */
+	private:
+	class SliceFileReader; // Class to read the vertex attributes of a slice file, possibly deferred until first use
+	friend class SliceFileReader;
+	
+	/* Protected methods from BaseModule: */
+	protected:
+	virtual DataSet* createDataSet(const std::vector<std::string>& args) const;
+	
 	/* Constructors and destructors: */
 	public:
 	StructuredGridASCII(void); // Default constructor
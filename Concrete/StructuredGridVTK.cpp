@@ -1,7 +1,7 @@
 /***********************************************************************
 StructuredGridVTK - Class reading curvilinear grids from files in legacy
 VTK format.
-Copyright (c) 2008-2011 Oliver Kreylos
+Copyright (c) 2008-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -22,12 +22,16 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <Concrete/StructuredGridVTK.h>
 
+#include <stddef.h>
 #include <string>
+#include <vector>
 #include <iostream>
 #include <iomanip>
 #include <Misc/SizedTypes.h>
 #include <Misc/SelfDestructPointer.h>
 #include <Misc/ThrowStdErr.h>
+#include <Misc/Timer.h>
+#include <Misc/Endianness.h>
 #include <Plugins/FactoryManager.h>
 #include <IO/OpenFile.h>
 #include <IO/ValueSource.h>
@@ -43,6 +47,13 @@ namespace {
 Helper functions:
 ****************/
 
+int getRowsPerBlock(int numRowValues)
+	{
+	/* Read about one million file values per block, but at least one complete grid row: */
+	int result=(1<<20)/numRowValues;
+	return result>0?result:1;
+	}
+
 template <class FileValueParam>
 inline
 void
@@ -54,23 +65,40 @@ readVertexPositions(
 	typedef FileValueParam FileValue;
 	
 	const DS::Index& size=dataSet.getNumVertices();
-	DS::Index index;
 	if(master)
 		std::cout<<"Reading grid vertices...   0%"<<std::flush;
-	for(index[2]=0;index[2]<size[2];++index[2])
+	Misc::Timer readTimer;
+	
+	/* Read blocks of complete grid rows, which run along the first grid dimension in the file: */
+	int numRows=size[1]*size[2];
+	int rowsPerBlock=getRowsPerBlock(size[0]*3);
+	std::vector<FileValue> buffer(size_t(rowsPerBlock<numRows?rowsPerBlock:numRows)*size_t(size[0])*3);
+	DS::Point* vertices=dataSet.getGrid().getArray();
+	ptrdiff_t rowStride=size.calcIncrement(0);
+	for(int rowBase=0;rowBase<numRows;rowBase+=rowsPerBlock)
 		{
-		for(index[1]=0;index[1]<size[1];++index[1])
-			for(index[0]=0;index[0]<size[0];++index[0])
-				{
-				DS::Point& vertex=dataSet.getVertexPosition(index);
+		int rowEnd=rowBase+rowsPerBlock<numRows?rowBase+rowsPerBlock:numRows;
+		
+		/* Read and byte-swap the entire block at once: */
+		file.read<FileValue>(&buffer[0],size_t(rowEnd-rowBase)*size_t(size[0])*3);
+		
+		/* Convert the block's vertex positions: */
+		const FileValue* bPtr=&buffer[0];
+		for(int row=rowBase;row<rowEnd;++row)
+			{
+			DS::Point* vPtr=vertices+size.calcOffset(DS::Index(0,row%size[1],row/size[1]));
+			for(int x=0;x<size[0];++x,vPtr+=rowStride,bPtr+=3)
 				for(int i=0;i<3;++i)
-					vertex[i]=DS::Scalar(file.read<FileValue>());
-				}
+					(*vPtr)[i]=DS::Scalar(bPtr[i]);
+			}
+		
 		if(master)
-			std::cout<<"\b\b\b\b"<<std::setw(3)<<((index[2]+1)*100+size[2]/2)/size[2]<<"%"<<std::flush;
+			std::cout<<"\b\b\b\b"<<std::setw(3)<<int((Misc::UInt64(rowEnd)*100+numRows/2)/numRows)<<"%"<<std::flush;
 		}
+	
+	readTimer.elapse();
 	if(master)
-		std::cout<<"\b\b\b\bdone"<<std::endl;
+		std::cout<<"\b\b\b\bdone in "<<readTimer.getTime()*1000.0<<" ms"<<std::endl;
 	}
 
 template <class FileValueParam>
@@ -86,34 +114,56 @@ readVectorAttributes(
 	typedef FileValueParam FileValue;
 	
 	const DS::Index& size=dataSet.getNumVertices();
-	DS::Index index;
 	if(master)
 		std::cout<<"Reading vector attribute "<<attributeName<<"...   0%"<<std::flush;
+	Misc::Timer readTimer;
 	Math::Interval<DataValue::VScalar> range[3];
 	for(int i=0;i<3;++i)
 		range[i]=Math::Interval<DataValue::VScalar>::empty;
-	for(index[2]=0;index[2]<size[2];++index[2])
+	
+	/* Read blocks of complete grid rows, which run along the first grid dimension in the file: */
+	int numRows=size[1]*size[2];
+	int rowsPerBlock=getRowsPerBlock(size[0]*3);
+	std::vector<FileValue> buffer(size_t(rowsPerBlock<numRows?rowsPerBlock:numRows)*size_t(size[0])*3);
+	DS::ValueScalar* slices[4];
+	for(int i=0;i<4;++i)
+		slices[i]=dataSet.getSliceArray(sliceIndex+i);
+	ptrdiff_t rowStride=size.calcIncrement(0);
+	for(int rowBase=0;rowBase<numRows;rowBase+=rowsPerBlock)
 		{
-		for(index[1]=0;index[1]<size[1];++index[1])
-			for(index[0]=0;index[0]<size[0];++index[0])
+		int rowEnd=rowBase+rowsPerBlock<numRows?rowBase+rowsPerBlock:numRows;
+		
+		/* Read and byte-swap the entire block at once: */
+		file.read<FileValue>(&buffer[0],size_t(rowEnd-rowBase)*size_t(size[0])*3);
+		
+		/* Convert the block's vectors: */
+		const FileValue* bPtr=&buffer[0];
+		for(int row=rowBase;row<rowEnd;++row)
+			{
+			ptrdiff_t offset=size.calcOffset(DS::Index(0,row%size[1],row/size[1]));
+			for(int x=0;x<size[0];++x,offset+=rowStride,bPtr+=3)
 				{
 				DataValue::VVector vector;
 				for(int i=0;i<3;++i)
 					{
-					vector[i]=DataValue::VVector::Scalar(file.read<FileValue>());
+					vector[i]=DataValue::VVector::Scalar(bPtr[i]);
 					range[i].addValue(vector[i]);
 					}
 				
 				/* Store the vector's components and magnitude: */
 				for(int i=0;i<3;++i)
-					dataSet.getVertexValue(sliceIndex+i,index)=vector[i];
-				dataSet.getVertexValue(sliceIndex+3,index)=DataValue::VScalar(Geometry::mag(vector));
+					slices[i][offset]=vector[i];
+				slices[3][offset]=DataValue::VScalar(Geometry::mag(vector));
 				}
+			}
+		
 		if(master)
-			std::cout<<"\b\b\b\b"<<std::setw(3)<<((index[2]+1)*100+size[2]/2)/size[2]<<"%"<<std::flush;
+			std::cout<<"\b\b\b\b"<<std::setw(3)<<int((Misc::UInt64(rowEnd)*100+numRows/2)/numRows)<<"%"<<std::flush;
 		}
+	
+	readTimer.elapse();
 	if(master)
-		std::cout<<"\b\b\b\bdone"<<std::endl;
+		std::cout<<"\b\b\b\bdone in "<<readTimer.getTime()*1000.0<<" ms"<<std::endl;
 	
 	for(int i=0;i<3;++i)
 		std::cout<<range[i].getMin()<<" - "<<range[i].getMax()<<std::endl;
@@ -133,23 +183,39 @@ readScalarAttributes(
 	typedef FileValueParam FileValue;
 	
 	const DS::Index& size=dataSet.getNumVertices();
-	DS::Index index;
 	if(master)
 		std::cout<<"Reading "<<attributeNumScalars<<"-component scalar attribute "<<attributeName<<"...   0%"<<std::flush;
-	for(index[2]=0;index[2]<size[2];++index[2])
+	Misc::Timer readTimer;
+	
+	/* Read blocks of complete grid rows, which run along the first grid dimension in the file: */
+	int numRows=size[1]*size[2];
+	int rowsPerBlock=getRowsPerBlock(size[0]*attributeNumScalars);
+	std::vector<FileValue> buffer(size_t(rowsPerBlock<numRows?rowsPerBlock:numRows)*size_t(size[0])*size_t(attributeNumScalars));
+	DS::ValueScalar* slice=dataSet.getSliceArray(sliceIndex);
+	ptrdiff_t rowStride=size.calcIncrement(0);
+	for(int rowBase=0;rowBase<numRows;rowBase+=rowsPerBlock)
 		{
-		for(index[1]=0;index[1]<size[1];++index[1])
-			for(index[0]=0;index[0]<size[0];++index[0])
-				{
-				/* Reand and store the next scalar attribute: */
-				dataSet.getVertexValue(sliceIndex,index)=DS::ValueScalar(file.read<FileValue>());
-				file.skip<FileValue>(attributeNumScalars-1);
-				}
+		int rowEnd=rowBase+rowsPerBlock<numRows?rowBase+rowsPerBlock:numRows;
+		
+		/* Read and byte-swap the entire block at once: */
+		file.read<FileValue>(&buffer[0],size_t(rowEnd-rowBase)*size_t(size[0])*size_t(attributeNumScalars));
+		
+		/* Convert the first component of each of the block's attributes: */
+		const FileValue* bPtr=&buffer[0];
+		for(int row=rowBase;row<rowEnd;++row)
+			{
+			DS::ValueScalar* sPtr=slice+size.calcOffset(DS::Index(0,row%size[1],row/size[1]));
+			for(int x=0;x<size[0];++x,sPtr+=rowStride,bPtr+=attributeNumScalars)
+				*sPtr=DS::ValueScalar(*bPtr);
+			}
+		
 		if(master)
-			std::cout<<"\b\b\b\b"<<std::setw(3)<<((index[2]+1)*100+size[2]/2)/size[2]<<"%"<<std::flush;
+			std::cout<<"\b\b\b\b"<<std::setw(3)<<int((Misc::UInt64(rowEnd)*100+numRows/2)/numRows)<<"%"<<std::flush;
 		}
+	
+	readTimer.elapse();
 	if(master)
-		std::cout<<"\b\b\b\bdone"<<std::endl;
+		std::cout<<"\b\b\b\bdone in "<<readTimer.getTime()*1000.0<<" ms"<<std::endl;
 	}
 
 }
@@ -158,6 +224,11 @@ readScalarAttributes(
 Methods of class StructuredGridVTK:
 **********************************/
 
+StructuredGridVTK::DataSet* StructuredGridVTK::createDataSet(const std::vector<std::string>& args) const
+	{
+	return new DataSet;
+	}
+
 StructuredGridVTK::StructuredGridVTK(void)
 	:BaseModule("StructuredGridVTK")
 	{
@@ -168,7 +239,7 @@ Visualization::Abstract::DataSet* StructuredGridVTK::load(const std::vector<std:
 	bool master=pipe==0||pipe->isMaster();
 	
 	/* Create the result data set: */
-	Misc::SelfDestructPointer<DataSet> result(new DataSet);
+	Misc::SelfDestructPointer<DataSet> result(createDataSet(args));
 	DS& dataSet=result->getDs();
 	
 	/* Open the input file: */
@@ -242,6 +313,10 @@ Visualization::Abstract::DataSet* StructuredGridVTK::load(const std::vector<std:
 		Misc::throwStdErr("StructuredGridVTK::load: VTK data file %s has malformed grid point definition",args[0].c_str());
 	}
 	
+	/* Legacy VTK files store binary data in big-endian byte order: */
+	if(binary)
+		file->setEndianness(Misc::BigEndian);
+	
 	/* Initialize the data set: */
 	dataSet.setGrid(numVertices);
 	
@@ -1,7 +1,7 @@
 /***********************************************************************
 StructuredHexahedralTecplotASCIIFile - Class reading structured
 hexahedral multi-block Tecplot files in ASCII format.
-Copyright (c) 2009-2011 Oliver Kreylos
+Copyright (c) 2009-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -45,6 +45,11 @@ namespace Concrete {
 Methods of class StructuredHexahedralTecplotASCIIFile:
 *****************************************************/
 
+StructuredHexahedralTecplotASCIIFile::DataSet* StructuredHexahedralTecplotASCIIFile::createDataSet(const std::vector<std::string>& args) const
+	{
+	return new DataSet;
+	}
+
 StructuredHexahedralTecplotASCIIFile::StructuredHexahedralTecplotASCIIFile(void)
 	:BaseModule("StructuredHexahedralTecplotASCIIFile")
 	{
@@ -55,7 +60,7 @@ Visualization::Abstract::DataSet* StructuredHexahedralTecplotASCIIFile::load(con
 	bool master=pipe==0||pipe->isMaster();
 	
 	/* Create the result data set: */
-	Misc::SelfDestructPointer<DataSet> result(new DataSet);
+	Misc::SelfDestructPointer<DataSet> result(createDataSet(args));
 	DS& dataSet=result->getDs();
 	
 	/* Parse the arguments: */
@@ -1,7 +1,7 @@
 /***********************************************************************
 UnstructuredHexahedralTecplotASCIIFile - Class reading unstructured
 hexahedral Tecplot files in ASCII format.
-Copyright (c) 2009-2011 Oliver Kreylos
+Copyright (c) 2009-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -44,6 +44,11 @@ namespace Concrete {
 Methods of class UnstructuredHexahedralTecplotASCIIFile:
 *******************************************************/
 
+UnstructuredHexahedralTecplotASCIIFile::DataSet* UnstructuredHexahedralTecplotASCIIFile::createDataSet(const std::vector<std::string>& args) const
+	{
+	return new DataSet;
+	}
+
 UnstructuredHexahedralTecplotASCIIFile::UnstructuredHexahedralTecplotASCIIFile(void)
 	:BaseModule("UnstructuredHexahedralTecplotASCIIFile")
 	{
@@ -54,7 +59,7 @@ Visualization::Abstract::DataSet* UnstructuredHexahedralTecplotASCIIFile::load(c
 	bool master=pipe==0||pipe->isMaster();
 	
 	/* Create the result data set: */
-	Misc::SelfDestructPointer<DataSet> result(new DataSet);
+	Misc::SelfDestructPointer<DataSet> result(createDataSet(args));
 	DS& dataSet=result->getDs();
 	
 	/* Parse the arguments: */
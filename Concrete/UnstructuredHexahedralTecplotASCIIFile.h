@@ -1,7 +1,7 @@
 /***********************************************************************
 UnstructuredHexahedralTecplotASCIIFile - Class reading unstructured
 hexahedral Tecplot files in ASCII format.
-Copyright (c) 2009-2011 Oliver Kreylos
+Copyright (c) 2009-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -45,6 +45,10 @@ typedef Visualization::Wrappers::Module<DS,DataValue> BaseModule; // Module base
 
 class UnstructuredHexahedralTecplotASCIIFile:public BaseModule
 	{
+	/* Protected methods from BaseModule: */
+	protected:
+	virtual DataSet* createDataSet(const std::vector<std::string>& args) const;
+	
 	/* Constructors and destructors: */
 	public:
 	UnstructuredHexahedralTecplotASCIIFile(void); // Default constructor
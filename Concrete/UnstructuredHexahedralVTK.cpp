@@ -1,7 +1,7 @@
 /***********************************************************************
 UnstructuredHexahedralVTK - Class reading unstructured hexahedral data
 sets from files in legacy VTK format.
-Copyright (c) 2016 Oliver Kreylos
+Copyright (c) 2016-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -22,12 +22,16 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <Concrete/UnstructuredHexahedralVTK.h>
 
+#include <stddef.h>
 #include <string>
+#include <vector>
 #include <iostream>
 #include <iomanip>
 #include <Misc/SizedTypes.h>
 #include <Misc/SelfDestructPointer.h>
 #include <Misc/ThrowStdErr.h>
+#include <Misc/Timer.h>
+#include <Misc/Endianness.h>
 #include <Plugins/FactoryManager.h>
 #include <IO/OpenFile.h>
 #include <IO/ValueSource.h>
@@ -43,6 +47,13 @@ namespace {
 Helper functions:
 ****************/
 
+size_t getItemsPerBlock(size_t numItemValues)
+	{
+	/* Read about one million file values per block, but at least one complete item: */
+	size_t result=size_t(1<<20)/numItemValues;
+	return result>0?result:1;
+	}
+
 template <class FileValueParam>
 inline
 void
@@ -54,23 +65,35 @@ readVertexPositions(
 	{
 	typedef FileValueParam FileValue;
 	
-	DS::VertexIndex index=0;
-	for(int percentRead=1;percentRead<=100;++percentRead)
+	Misc::Timer readTimer;
+	
+	/* Read blocks of vertex positions: */
+	size_t verticesPerBlock=getItemsPerBlock(3);
+	std::vector<FileValue> buffer((verticesPerBlock<numGridPoints?verticesPerBlock:numGridPoints)*3);
+	for(DS::VertexIndex blockBase=0;blockBase<numGridPoints;blockBase+=verticesPerBlock)
 		{
-		DS::VertexIndex indexEnd=(numGridPoints*percentRead+50)/100;
-		for(;index<indexEnd;++index)
+		DS::VertexIndex blockEnd=blockBase+verticesPerBlock<numGridPoints?blockBase+verticesPerBlock:numGridPoints;
+		
+		/* Read and byte-swap the entire block at once: */
+		file.read<FileValue>(&buffer[0],(blockEnd-blockBase)*3);
+		
+		/* Convert and add the block's vertices: */
+		const FileValue* bPtr=&buffer[0];
+		for(DS::VertexIndex index=blockBase;index<blockEnd;++index,bPtr+=3)
 			{
-			/* Read the next vertex: */
-			gridSource.skipWs();
 			DS::Point vertexPosition;
 			for(int i=0;i<3;++i)
-				vertexPosition[i]=DS::Scalar(file.read<FileValue>());
+				vertexPosition[i]=DS::Scalar(bPtr[i]);
 			dataSet.addVertex(vertexPosition);
 			}
 		
 		if(master)
-			std::cout<<"\b\b\b\b"<<std::setw(3)<<percentRead<<"%"<<std::flush;
+			std::cout<<"\b\b\b\b"<<std::setw(3)<<int((Misc::UInt64(blockEnd)*100+numGridPoints/2)/numGridPoints)<<"%"<<std::flush;
 		}
+	
+	readTimer.elapse();
+	if(master)
+		std::cout<<"\b\b\b\bdone in "<<readTimer.getTime()*1000.0<<" ms"<<std::endl;
 	}
 
 template <class FileValueParam>
@@ -85,38 +108,44 @@ readVectorAttributes(
 	{
 	typedef FileValueParam FileValue;
 	
-	const DS::Index& size=dataSet.getNumVertices();
-	DS::Index index;
+	DS::VertexIndex numVertices=dataSet.getTotalNumVertices();
 	if(master)
 		std::cout<<"Reading vector attribute "<<attributeName<<"...   0%"<<std::flush;
-	Math::Interval<DataValue::VScalar> range[3];
-	for(int i=0;i<3;++i)
-		range[i]=Math::Interval<DataValue::VScalar>::empty;
-	for(index[2]=0;index[2]<size[2];++index[2])
+	Misc::Timer readTimer;
+	
+	/* Read blocks of vectors: */
+	size_t verticesPerBlock=getItemsPerBlock(3);
+	std::vector<FileValue> buffer((verticesPerBlock<numVertices?verticesPerBlock:numVertices)*3);
+	DS::ValueScalar* slices[4];
+	for(int i=0;i<4;++i)
+		slices[i]=dataSet.getSliceArray(sliceIndex+i);
+	for(DS::VertexIndex blockBase=0;blockBase<numVertices;blockBase+=verticesPerBlock)
 		{
-		for(index[1]=0;index[1]<size[1];++index[1])
-			for(index[0]=0;index[0]<size[0];++index[0])
+		DS::VertexIndex blockEnd=blockBase+verticesPerBlock<numVertices?blockBase+verticesPerBlock:numVertices;
+		
+		/* Read and byte-swap the entire block at once: */
+		file.read<FileValue>(&buffer[0],(blockEnd-blockBase)*3);
+		
+		/* Store the block's vector components and magnitudes: */
+		const FileValue* bPtr=&buffer[0];
+		for(DS::VertexIndex index=blockBase;index<blockEnd;++index,bPtr+=3)
+			{
+			DataValue::VVector vector;
+			for(int i=0;i<3;++i)
 				{
-				DataValue::VVector vector;
-				for(int i=0;i<3;++i)
-					{
-					vector[i]=DataValue::VVector::Scalar(file.read<FileValue>());
-					range[i].addValue(vector[i]);
-					}
-				
-				/* Store the vector's components and magnitude: */
-				for(int i=0;i<3;++i)
-					dataSet.getVertexValue(sliceIndex+i,index)=vector[i];
-				dataSet.getVertexValue(sliceIndex+3,index)=DataValue::VScalar(Geometry::mag(vector));
+				vector[i]=DataValue::VVector::Scalar(bPtr[i]);
+				slices[i][index]=vector[i];
 				}
+			slices[3][index]=DataValue::VScalar(Geometry::mag(vector));
+			}
+		
 		if(master)
-			std::cout<<"\b\b\b\b"<<std::setw(3)<<((index[2]+1)*100+size[2]/2)/size[2]<<"%"<<std::flush;
+			std::cout<<"\b\b\b\b"<<std::setw(3)<<int((Misc::UInt64(blockEnd)*100+numVertices/2)/numVertices)<<"%"<<std::flush;
 		}
-	if(master)
-		std::cout<<"\b\b\b\bdone"<<std::endl;
 	
-	for(int i=0;i<3;++i)
-		std::cout<<range[i].getMin()<<" - "<<range[i].getMax()<<std::endl;
+	readTimer.elapse();
+	if(master)
+		std::cout<<"\b\b\b\bdone in "<<readTimer.getTime()*1000.0<<" ms"<<std::endl;
 	}
 
 template <class FileValueParam>
@@ -132,24 +161,44 @@ readScalarAttributes(
 	{
 	typedef FileValueParam FileValue;
 	
-	const DS::Index& size=dataSet.getNumVertices();
-	DS::Index index;
+	DS::VertexIndex numVertices=dataSet.getTotalNumVertices();
 	if(master)
 		std::cout<<"Reading "<<attributeNumScalars<<"-component scalar attribute "<<attributeName<<"...   0%"<<std::flush;
-	for(index[2]=0;index[2]<size[2];++index[2])
+	Misc::Timer readTimer;
+	
+	/* Read blocks of scalar attributes: */
+	size_t verticesPerBlock=getItemsPerBlock(attributeNumScalars);
+	std::vector<FileValue> buffer((verticesPerBlock<numVertices?verticesPerBlock:numVertices)*attributeNumScalars);
+	DS::ValueScalar* slice=dataSet.getSliceArray(sliceIndex);
+	for(DS::VertexIndex blockBase=0;blockBase<numVertices;blockBase+=verticesPerBlock)
 		{
-		for(index[1]=0;index[1]<size[1];++index[1])
-			for(index[0]=0;index[0]<size[0];++index[0])
-				{
-				/* Reand and store the next scalar attribute: */
-				dataSet.getVertexValue(sliceIndex,index)=DS::ValueScalar(file.read<FileValue>());
-				file.skip<FileValue>(attributeNumScalars-1);
-				}
+		DS::VertexIndex blockEnd=blockBase+verticesPerBlock<numVertices?blockBase+verticesPerBlock:numVertices;
+		
+		/* Read and byte-swap the entire block at once: */
+		file.read<FileValue>(&buffer[0],(blockEnd-blockBase)*attributeNumScalars);
+		
+		/* Convert the first component of each of the block's attributes: */
+		DS::ValueScalar* sPtr=slice+blockBase;
+		DS::VertexIndex blockSize=blockEnd-blockBase;
+		if(attributeNumScalars==1)
+			{
+			for(DS::VertexIndex i=0;i<blockSize;++i)
+				sPtr[i]=DS::ValueScalar(buffer[i]);
+			}
+		else
+			{
+			const FileValue* bPtr=&buffer[0];
+			for(DS::VertexIndex i=0;i<blockSize;++i,bPtr+=attributeNumScalars)
+				sPtr[i]=DS::ValueScalar(*bPtr);
+			}
+		
 		if(master)
-			std::cout<<"\b\b\b\b"<<std::setw(3)<<((index[2]+1)*100+size[2]/2)/size[2]<<"%"<<std::flush;
+			std::cout<<"\b\b\b\b"<<std::setw(3)<<int((Misc::UInt64(blockEnd)*100+numVertices/2)/numVertices)<<"%"<<std::flush;
 		}
+	
+	readTimer.elapse();
 	if(master)
-		std::cout<<"\b\b\b\bdone"<<std::endl;
+		std::cout<<"\b\b\b\bdone in "<<readTimer.getTime()*1000.0<<" ms"<<std::endl;
 	}
 
 }
@@ -158,6 +207,11 @@ readScalarAttributes(
 Methods of class UnstructuredHexahedralVTK:
 ******************************************/
 
+UnstructuredHexahedralVTK::DataSet* UnstructuredHexahedralVTK::createDataSet(const std::vector<std::string>& args) const
+	{
+	return new DataSet;
+	}
+
 UnstructuredHexahedralVTK::UnstructuredHexahedralVTK(void)
 	:BaseModule("UnstructuredHexahedralVTK")
 	{
@@ -168,7 +222,7 @@ Visualization::Abstract::DataSet* UnstructuredHexahedralVTK::load(const std::vec
 	bool master=pipe==0||pipe->isMaster();
 	
 	/* Create the result data set: */
-	Misc::SelfDestructPointer<DataSet> result(new DataSet);
+	Misc::SelfDestructPointer<DataSet> result(createDataSet(args));
 	DS& dataSet=result->getDs();
 	
 	/* Open the input file: */
@@ -227,6 +281,10 @@ Visualization::Abstract::DataSet* UnstructuredHexahedralVTK::load(const std::vec
 		Misc::throwStdErr("UnstructuredHexahedralVTK::load: VTK data file %s has malformed grid point definition",args[0].c_str());
 	}
 	
+	/* Legacy VTK files store binary data in big-endian byte order: */
+	if(binary)
+		file->setEndianness(Misc::BigEndian);
+	
 	/* Read the grid points: */
 	dataSet.reserveVertices(numGridPoints);
 	if(master)
@@ -281,9 +339,9 @@ Visualization::Abstract::DataSet* UnstructuredHexahedralVTK::load(const std::vec
 			if(master)
 				std::cout<<"\b\b\b\b"<<std::setw(3)<<percentRead<<"%"<<std::flush;
 			}
+		if(master)
+			std::cout<<"\b\b\b\bdone"<<std::endl;
 		}
-	if(master)
-		std::cout<<"\b\b\b\bdone"<<std::endl;
 	
 	/* Attach a value source to the file to read the grid cell header: */
 	DS::CellIndex numGridCells=0;
@@ -309,32 +367,40 @@ Visualization::Abstract::DataSet* UnstructuredHexahedralVTK::load(const std::vec
 	static const int vertexOrder[8]={0,1,3,2,4,5,7,6}; // VTK's cube vertex counting order
 	if(binary)
 		{
-		DS::CellIndex index=0;
-		for(int percentRead=1;percentRead<=100;++percentRead)
+		Misc::Timer readTimer;
+		
+		/* Read blocks of cells, each consisting of the number of vertices followed by the vertex indices: */
+		size_t cellsPerBlock=getItemsPerBlock(9);
+		std::vector<Misc::SInt32> buffer((cellsPerBlock<numGridCells?cellsPerBlock:numGridCells)*9);
+		for(DS::CellIndex blockBase=0;blockBase<numGridCells;blockBase+=cellsPerBlock)
 			{
-			DS::CellIndex indexEnd=(numGridCells*percentRead+50)/100;
-			for(;index<indexEnd;++index)
+			DS::CellIndex blockEnd=blockBase+cellsPerBlock<numGridCells?blockBase+cellsPerBlock:numGridCells;
+			
+			/* Read and byte-swap the entire block at once: */
+			file->read<Misc::SInt32>(&buffer[0],(blockEnd-blockBase)*9);
+			
+			const Misc::SInt32* bPtr=&buffer[0];
+			for(DS::CellIndex index=blockBase;index<blockEnd;++index,bPtr+=9)
 				{
-				/* Read the next cell's number of vertices and vertex indices: */
-				Misc::UInt32 indices[9];
-				file->read(indices,9);
-				if(indices[0]!=8)
+				if(bPtr[0]!=8)
 					Misc::throwStdErr("UnstructuredHexahedralVTK::load: Non-hexahedral grid cell in VTK data file %s",args[0].c_str());
 				
 				/* Unswizzle the cell's vertex indices: */
 				DS::VertexID cellVertices[8];
 				for(int i=0;i<8;++i)
-					cellVertices[vertexOrder[i]]=DS::VertexID(indices[i]+1);
-				if(gridSource.getChar()!='\n')
-					Misc::throwStdErr("UnstructuredHexahedralVTK::load: Invalid grid cell in VTK data file %s",args[0].c_str());
+					cellVertices[vertexOrder[i]]=DS::VertexID(bPtr[1+i]);
 				
 				/* Add the cell to the data set: */
-				dataSet.addCel(cellVertices);
+				dataSet.addCell(cellVertices);
 				}
 			
 			if(master)
-				std::cout<<"\b\b\b\b"<<std::setw(3)<<percentRead<<"%"<<std::flush;
+				std::cout<<"\b\b\b\b"<<std::setw(3)<<int((Misc::UInt64(blockEnd)*100+numGridCells/2)/numGridCells)<<"%"<<std::flush;
 			}
+		
+		readTimer.elapse();
+		if(master)
+			std::cout<<"\b\b\b\bdone in "<<readTimer.getTime()*1000.0<<" ms"<<std::endl;
 		}
 	else
 		{
@@ -362,15 +428,15 @@ Visualization::Abstract::DataSet* UnstructuredHexahedralVTK::load(const std::vec
 					Misc::throwStdErr("UnstructuredHexahedralVTK::load: Invalid grid cell in VTK data file %s",args[0].c_str());
 				
 				/* Add the cell to the data set: */
-				dataSet.addCel(cellVertices);
+				dataSet.addCell(cellVertices);
 				}
 			
 			if(master)
 				std::cout<<"\b\b\b\b"<<std::setw(3)<<percentRead<<"%"<<std::flush;
 			}
+		if(master)
+			std::cout<<"\b\b\b\bdone"<<std::endl;
 		}
-	if(master)
-		std::cout<<"\b\b\b\bdone"<<std::endl;
 	
 	/* Attach a value source to the file to read the grid cell type header: */
 	{
@@ -389,20 +455,28 @@ Visualization::Abstract::DataSet* UnstructuredHexahedralVTK::load(const std::vec
 		std::cout<<"Checking grid cell types...   0%"<<std::flush;
 	if(binary)
 		{
-		DS::CellIndex index=0;
-		for(int percentRead=1;percentRead<=100;++percentRead)
+		Misc::Timer readTimer;
+		
+		/* Read blocks of cell types: */
+		size_t cellsPerBlock=getItemsPerBlock(1);
+		std::vector<Misc::SInt32> buffer(cellsPerBlock<numGridCells?cellsPerBlock:numGridCells);
+		for(DS::CellIndex blockBase=0;blockBase<numGridCells;blockBase+=cellsPerBlock)
 			{
-			DS::CellIndex indexEnd=(numGridCells*percentRead+50)/100;
-			for(;index<indexEnd;++index)
-				{
-				/* Check the next cell's type: */
-				if(file->read<Misc::SInt32>()!=12) // VTK code for hexahedra
+			DS::CellIndex blockEnd=blockBase+cellsPerBlock<numGridCells?blockBase+cellsPerBlock:numGridCells;
+			file->read<Misc::SInt32>(&buffer[0],blockEnd-blockBase);
+			
+			/* Check the block's cell types: */
+			for(DS::CellIndex i=0;i<blockEnd-blockBase;++i)
+				if(buffer[i]!=12) // VTK code for hexahedra
 					Misc::throwStdErr("UnstructuredHexahedralVTK::load: Non-hexahedral grid cell in VTK data file %s",args[0].c_str());
-				}
 			
 			if(master)
-				std::cout<<"\b\b\b\b"<<std::setw(3)<<percentRead<<"%"<<std::flush;
+				std::cout<<"\b\b\b\b"<<std::setw(3)<<int((Misc::UInt64(blockEnd)*100+numGridCells/2)/numGridCells)<<"%"<<std::flush;
 			}
+		
+		readTimer.elapse();
+		if(master)
+			std::cout<<"\b\b\b\bdone in "<<readTimer.getTime()*1000.0<<" ms"<<std::endl;
 		}
 	else
 		{
@@ -426,9 +500,9 @@ Visualization::Abstract::DataSet* UnstructuredHexahedralVTK::load(const std::vec
 			if(master)
 				std::cout<<"\b\b\b\b"<<std::setw(3)<<percentRead<<"%"<<std::flush;
 			}
+		if(master)
+			std::cout<<"\b\b\b\bdone"<<std::endl;
 		}
-	if(master)
-		std::cout<<"\b\b\b\bdone"<<std::endl;
 	
 	/* Finalize the grid structure: */
 	if(master)
@@ -564,47 +638,41 @@ Visualization::Abstract::DataSet* UnstructuredHexahedralVTK::load(const std::vec
 			
 			if(master)
 				std::cout<<"Reading "<<attributeName<<" point attributes...   0%"<<std::flush;
-			DS::Index index;
-			for(index[2]=0;index[2]<numVertices[2];++index[2])
+			DS::VertexIndex index=0;
+			for(int percentRead=1;percentRead<=100;++percentRead)
 				{
-				if(attributeVectors)
+				DS::VertexIndex indexEnd=(numGridPoints*percentRead+50)/100;
+				for(;index<indexEnd;++index)
 					{
-					for(index[1]=0;index[1]<numVertices[1];++index[1])
-						for(index[0]=0;index[0]<numVertices[0];++index[0])
-							{
-							/* Read the next attribute: */
-							attributeSource.skipWs();
-							
-							/* Read the vector value in Cartesian coordinates: */
-							DataValue::VVector vector;
-							for(int i=0;i<3;++i)
-								vector[i]=DataValue::VVector::Scalar(attributeSource.readNumber());
-							if(attributeSource.getChar()!='\n')
-								Misc::throwStdErr("UnstructuredHexahedralVTK::load: Invalid vector attribute in in VTK data file %s",args[0].c_str());
-							
-							/* Store the vector's components and magnitude: */
-							for(int i=0;i<3;++i)
-								dataSet.getVertexValue(sliceIndex+i,index)=vector[i];
-							dataSet.getVertexValue(sliceIndex+3,index)=DataValue::VScalar(Geometry::mag(vector));
-							}
-					}
-				else
-					{
-					for(index[1]=0;index[1]<numVertices[1];++index[1])
-						for(index[0]=0;index[0]<numVertices[0];++index[0])
-							{
-							/* Read the next attribute: */
-							attributeSource.skipWs();
-							
-							/* Read the first scalar attribute from the line: */
-							dataSet.getVertexValue(sliceIndex,index)=DS::ValueScalar(attributeSource.readNumber());
-							
-							/* Skip the rest of the line: */
-							attributeSource.skipLine();
-							}
+					/* Read the next attribute: */
+					attributeSource.skipWs();
+					
+					if(attributeVectors)
+						{
+						/* Read the vector value in Cartesian coordinates: */
+						DataValue::VVector vector;
+						for(int i=0;i<3;++i)
+							vector[i]=DataValue::VVector::Scalar(attributeSource.readNumber());
+						if(attributeSource.getChar()!='\n')
+							Misc::throwStdErr("UnstructuredHexahedralVTK::load: Invalid vector attribute in in VTK data file %s",args[0].c_str());
+						
+						/* Store the vector's components and magnitude: */
+						for(int i=0;i<3;++i)
+							dataSet.getSliceArray(sliceIndex+i)[index]=vector[i];
+						dataSet.getSliceArray(sliceIndex+3)[index]=DataValue::VScalar(Geometry::mag(vector));
+						}
+					else
+						{
+						/* Read the first scalar attribute from the line: */
+						dataSet.getSliceArray(sliceIndex)[index]=DS::ValueScalar(attributeSource.readNumber());
+						
+						/* Skip the rest of the line: */
+						attributeSource.skipLine();
+						}
 					}
+				
 				if(master)
-					std::cout<<"\b\b\b\b"<<std::setw(3)<<((index[2]+1)*100+numVertices[2]/2)/numVertices[2]<<"%"<<std::flush;
+					std::cout<<"\b\b\b\b"<<std::setw(3)<<percentRead<<"%"<<std::flush;
 				}
 			if(master)
 				std::cout<<"\b\b\b\bdone"<<std::endl;
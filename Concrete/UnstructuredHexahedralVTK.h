@@ -1,7 +1,7 @@
 /***********************************************************************
 UnstructuredHexahedralVTK - Class reading unstructured hexahedral data
 sets from files in legacy VTK format.
-Copyright (c) 2016 Oliver Kreylos
+Copyright (c) 2016-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -45,6 +45,10 @@ typedef Visualization::Wrappers::Module<DS,DataValue> BaseModule; // Module base
 
 class UnstructuredHexahedralVTK:public BaseModule
 	{
+	/* Protected methods from BaseModule: */
+	protected:
+	virtual DataSet* createDataSet(const std::vector<std::string>& args) const;
+	
 	/* Constructors and destructors: */
 	public:
 	UnstructuredHexahedralVTK(void); // Default constructor
@@ -1,7 +1,7 @@
 /***********************************************************************
 VecVolFile - Class to encapsulate operations on vector-valued data sets
 stored in .vecvol files.
-Copyright (c) 2007 Oliver Kreylos
+Copyright (c) 2007-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -21,29 +21,32 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 ***********************************************************************/
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <Misc/ThrowStdErr.h>
 #include <Misc/File.h>
 #include <Plugins/FactoryManager.h>
 #include <Math/Math.h>
 
+#include <Wrappers/PathlineExtractor.h>
+
 #include <Concrete/VecVolFile.h>
 
 namespace Visualization {
 
 namespace Concrete {
 
-/***************************
-Methods of class VecVolFile:
-***************************/
+namespace {
 
-VecVolFile::VecVolFile(void)
-	:BaseModule("VecVolFile")
-	{
-	}
+/****************
+Helper functions:
+****************/
 
-Visualization::Abstract::DataSet* VecVolFile::load(const std::vector<std::string>& args,Cluster::MulticastPipe* pipe) const
+void readVecVolFile(const char* fileName,DS& ds)
 	{
 	/* Open the volume file: */
-	Misc::File file(args[0].c_str(),"rb",Misc::File::BigEndian);
+	Misc::File file(fileName,"rb",Misc::File::BigEndian);
 	
 	/* Read the volume file header: */
 	int volSize[3];
@@ -52,7 +55,7 @@ Visualization::Abstract::DataSet* VecVolFile::load(const std::vector<std::string
 	float domainSize[3];
 	file.read(domainSize,3);
 	
-	/* Create the data set: */
+	/* Initialize the data set: */
 	DS::Index numVertices;
 	DS::Size cellSize;
 	for(int i=0;i<3;++i)
@@ -60,24 +63,170 @@ Visualization::Abstract::DataSet* VecVolFile::load(const std::vector<std::string
 		numVertices[i]=volSize[i]+2*borderSize;
 		cellSize[i]=float(domainSize[i])/float(numVertices[i]-1);
 		}
-	DataSet* result=new DataSet;
-	result->getDs().setData(numVertices,cellSize);
+	ds.setData(numVertices,cellSize);
 	
-	/* Set the data value's name: */
-	result->getDataValue().setVectorVariableName("Velocity");
+	/* Read the vertex values from file in blocks: */
+	DS::Array& vertices=ds.getVertices();
+	const size_t blockSize=65536;
+	float* block=new float[blockSize*3];
+	DS::Array::iterator vIt=vertices.begin();
+	try
+		{
+		for(size_t blockBase=0;blockBase<size_t(vertices.getNumElements());blockBase+=blockSize)
+			{
+			size_t numBlockVertices=size_t(vertices.getNumElements())-blockBase;
+			if(numBlockVertices>blockSize)
+				numBlockVertices=blockSize;
+			file.read(block,numBlockVertices*3);
+			const float* bPtr=block;
+			for(size_t i=0;i<numBlockVertices;++i,++vIt,bPtr+=3)
+				*vIt=DS::Value(bPtr[0],bPtr[1],bPtr[2]);
+			}
+		}
+	catch(...)
+		{
+		delete[] block;
+		throw;
+		}
+	delete[] block;
+	}
+
+/*************************************************************
+Helper class to load time steps from a series of .vecvol files:
+*************************************************************/
+
+class VecVolFileLoader:public TimeVaryingDataSet::Loader
+	{
+	/* Elements: */
+	private:
+	std::vector<std::string> fileNames; // Names of the .vecvol files containing the time steps
+	
+	/* Constructors and destructors: */
+	public:
+	VecVolFileLoader(const std::vector<std::string>& sFileNames)
+		:fileNames(sFileNames)
+		{
+		}
+	
+	/* Methods from TimeVaryingDataSet::Loader: */
+	virtual DS* loadTimeStep(unsigned int timeStepIndex) const
+		{
+		DS* result=new DS;
+		try
+			{
+			readVecVolFile(fileNames[timeStepIndex].c_str(),*result);
+			}
+		catch(...)
+			{
+			delete result;
+			throw;
+			}
+		return result;
+		}
+	};
+
+}
+
+/***************************
+Methods of class VecVolFile:
+***************************/
+
+VecVolFile::VecVolFile(void)
+	:BaseModule("VecVolFile")
+	{
+	}
+
+Visualization::Abstract::DataSet* VecVolFile::load(const std::vector<std::string>& args,Cluster::MulticastPipe* pipe) const
+	{
+	/* Parse the module command line: */
+	std::vector<std::string> fileNames;
+	float startTime=0.0f;
+	float timeStep=1.0f;
+	for(unsigned int i=0;i<args.size();++i)
+		{
+		if(args[i][0]=='-')
+			{
+			if(strcasecmp(args[i].c_str()+1,"startTime")==0)
+				{
+				++i;
+				if(i<args.size())
+					startTime=float(atof(args[i].c_str()));
+				}
+			else if(strcasecmp(args[i].c_str()+1,"timeStep")==0)
+				{
+				++i;
+				if(i<args.size())
+					timeStep=float(atof(args[i].c_str()));
+				}
+			}
+		else
+			fileNames.push_back(args[i]);
+		}
+	if(fileNames.empty())
+		Misc::throwStdErr("VecVolFile::load: No input file name provided");
+	
+	/* Create the data set: */
+	DataSet* result;
+	if(fileNames.size()==1)
+		{
+		/* Load a single vector volume: */
+		result=new DataSet;
+		}
+	else
+		{
+		/* Load a time series of vector volumes, one file per time step: */
+		std::vector<DS::Scalar> times;
+		for(unsigned int i=0;i<fileNames.size();++i)
+			times.push_back(startTime+timeStep*float(i));
+		result=new TimeVaryingDataSet(new VecVolFileLoader(fileNames),times);
+		}
 	
-	/* Read the vertex values from file: */
-	DS::Array& vertices=result->getDs().getVertices();
-	for(DS::Array::iterator vIt=vertices.begin();vIt!=vertices.end();++vIt)
+	try
 		{
-		float vec[3];
-		file.read(vec,3);
-		*vIt=DS::Value(vec[0],vec[1],vec[2]);
+		/* Read the first time step into the data set, used by all visualization algorithms except pathlines: */
+		readVecVolFile(fileNames[0].c_str(),result->getDs());
 		}
+	catch(...)
+		{
+		delete result;
+		throw;
+		}
+	
+	/* Set the data value's name: */
+	result->getDataValue().setVectorVariableName("Velocity");
 	
 	return result;
 	}
 
+int VecVolFile::getNumVectorAlgorithms(void) const
+	{
+	return BaseModule::getNumVectorAlgorithms()+1;
+	}
+
+const char* VecVolFile::getVectorAlgorithmName(int vectorAlgorithmIndex) const
+	{
+	/* Delegate the standard vector algorithms to the base class: */
+	if(vectorAlgorithmIndex<BaseModule::getNumVectorAlgorithms())
+		return BaseModule::getVectorAlgorithmName(vectorAlgorithmIndex);
+	if(vectorAlgorithmIndex>BaseModule::getNumVectorAlgorithms())
+		Misc::throwStdErr("VecVolFile::getVectorAlgorithmName: invalid algorithm index %d",vectorAlgorithmIndex);
+	
+	/* Return the pathline extractor: */
+	return Visualization::Wrappers::PathlineExtractor<DataSet>::getClassName();
+	}
+
+Visualization::Abstract::Algorithm* VecVolFile::getVectorAlgorithm(int vectorAlgorithmIndex,Visualization::Abstract::VariableManager* variableManager,Cluster::MulticastPipe* pipe) const
+	{
+	/* Delegate the standard vector algorithms to the base class: */
+	if(vectorAlgorithmIndex<BaseModule::getNumVectorAlgorithms())
+		return BaseModule::getVectorAlgorithm(vectorAlgorithmIndex,variableManager,pipe);
+	if(vectorAlgorithmIndex>BaseModule::getNumVectorAlgorithms())
+		Misc::throwStdErr("VecVolFile::getVectorAlgorithm: invalid algorithm index %d",vectorAlgorithmIndex);
+	
+	/* Return the pathline extractor: */
+	return new Visualization::Wrappers::PathlineExtractor<DataSet>(variableManager,pipe);
+	}
+
 }
 
 }
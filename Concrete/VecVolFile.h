@@ -1,7 +1,7 @@
 /***********************************************************************
 VecVolFile - Class to encapsulate operations on vector-valued data sets
 stored in .vecvol files.
-Copyright (c) 2007 Oliver Kreylos
+Copyright (c) 2007-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -28,6 +28,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Wrappers/SingleVectorValue.h>
 
 #include <Wrappers/Module.h>
+#include <Wrappers/TimeVaryingDataSet.h>
 
 namespace Visualization {
 
@@ -42,6 +43,7 @@ typedef Geometry::Vector<float,3> Value; // Memory representation of data set va
 typedef Visualization::Templatized::Cartesian<Scalar,3,Value> DS; // Templatized data set type
 typedef Visualization::Wrappers::SingleVectorValue<DS,VScalar> DataValue; // Type of data value descriptor
 typedef Visualization::Wrappers::Module<DS,DataValue> BaseModule; // Module base class type
+typedef Visualization::Wrappers::TimeVaryingDataSet<BaseModule::DataSet> TimeVaryingDataSet; // Data set type for time series of vector volume files
 
 }
 
@@ -54,6 +56,9 @@ class VecVolFile:public BaseModule
 	/* Methods: */
 	public:
 	virtual Visualization::Abstract::DataSet* load(const std::vector<std::string>& args,Cluster::MulticastPipe* pipe) const;
+	virtual int getNumVectorAlgorithms(void) const;
+	virtual const char* getVectorAlgorithmName(int vectorAlgorithmIndex) const;
+	virtual Visualization::Abstract::Algorithm* getVectorAlgorithm(int vectorAlgorithmIndex,Visualization::Abstract::VariableManager* variableManager,Cluster::MulticastPipe* pipe) const;
 	};
 
 }
@@ -0,0 +1,203 @@
+/***********************************************************************
+ParallelFor - Helper functions to distribute independent work items
+across a set of worker threads.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef PARALLELFOR_INCLUDED
+#define PARALLELFOR_INCLUDED
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include <new>
+#include <stdexcept>
+#include <Threads/Mutex.h>
+#include <Threads/Thread.h>
+
+/**************************************************************
+Function to query the number of worker threads to use by default:
+**************************************************************/
+
+inline unsigned int getNumParallelThreads(void)
+	{
+	/* Check for an explicit override from the environment: */
+	const char* numThreadsEnv=getenv("VISUALIZER_NUMTHREADS");
+	if(numThreadsEnv!=0&&atoi(numThreadsEnv)>0)
+		return (unsigned int)(atoi(numThreadsEnv));
+	
+	/* Use one thread per online CPU: */
+	long numCpus=sysconf(_SC_NPROCESSORS_ONLN);
+	return numCpus>1?(unsigned int)(numCpus):1U;
+	}
+
+/********************************************************************
+Class to hand out work items to a set of worker threads; each worker
+thread operates on its own copy of the work item functor, so functors
+can carry per-thread state such as data set locators:
+********************************************************************/
+
+template <class FunctorParam>
+class ParallelFor
+	{
+	/* Embedded classes: */
+	private:
+	struct Worker // Structure holding the state of a single worker thread
+		{
+		/* Elements: */
+		public:
+		ParallelFor* owner; // Pointer to the work distributor
+		FunctorParam functor; // The worker's private copy of the work item functor
+		
+		/* Constructors and destructors: */
+		Worker(ParallelFor* sOwner,const FunctorParam& sFunctor)
+			:owner(sOwner),functor(sFunctor)
+			{
+			}
+		
+		/* Methods: */
+		void* threadMethod(void) // Processes work items until all are done
+			{
+			owner->work(functor);
+			return 0;
+			}
+		};
+	
+	/* Elements: */
+	Threads::Mutex itemMutex; // Mutex serializing access to the work item counter and error state
+	size_t numItems; // Total number of work items
+	size_t nextItem; // Index of the next unprocessed work item
+	bool haveError; // Flag whether any work item failed
+	size_t errorItem; // Index of the lowest work item that failed
+	std::string errorMessage; // Error message of the lowest work item that failed
+	bool errorIsBadAlloc; // Flag whether the lowest work item that failed ran out of memory
+	
+	/* Private methods: */
+	void recordError(size_t item,const char* message,bool badAlloc) // Remembers the error of the lowest failing work item to keep error reporting deterministic
+		{
+		Threads::Mutex::Lock itemLock(itemMutex);
+		if(!haveError||errorItem>item)
+			{
+			haveError=true;
+			errorItem=item;
+			errorMessage=message;
+			errorIsBadAlloc=badAlloc;
+			}
+		}
+	void work(FunctorParam& functor)
+		{
+		while(true)
+			{
+			/* Grab the next work item: */
+			size_t item;
+			{
+			Threads::Mutex::Lock itemLock(itemMutex);
+			if(nextItem>=numItems||haveError)
+				break;
+			item=nextItem;
+			++nextItem;
+			}
+			
+			try
+				{
+				/* Process the work item: */
+				functor(item);
+				}
+			catch(const std::bad_alloc& err)
+				{
+				recordError(item,err.what(),true);
+				}
+			catch(const std::exception& err)
+				{
+				recordError(item,err.what(),false);
+				}
+			catch(...)
+				{
+				/* Don't let unknown exceptions escape from a worker thread, which would terminate the program: */
+				recordError(item,"ParallelFor: Unknown exception in work item",false);
+				}
+			}
+		}
+	
+	/* Constructors and destructors: */
+	public:
+	ParallelFor(size_t sNumItems)
+		:numItems(sNumItems),nextItem(0),
+		 haveError(false),errorItem(0),errorIsBadAlloc(false)
+		{
+		}
+	
+	/* Methods: */
+	void run(const FunctorParam& functor,unsigned int numThreads) // Processes all work items using the given number of threads, including the calling thread; throws the lowest-indexed work item's error as std::bad_alloc if it ran out of memory, or as std::runtime_error otherwise
+		{
+		/* Don't create more threads than there are work items: */
+		if(numThreads==0)
+			numThreads=getNumParallelThreads();
+		if(size_t(numThreads)>numItems)
+			numThreads=numItems>0?(unsigned int)(numItems):1U;
+		
+		/* Start the additional worker threads: */
+		std::vector<Worker*> workers;
+		Threads::Thread* threads=0;
+		if(numThreads>1)
+			{
+			threads=new Threads::Thread[numThreads-1];
+			for(unsigned int i=0;i<numThreads-1;++i)
+				{
+				workers.push_back(new Worker(this,functor));
+				threads[i].start(workers[i],&Worker::threadMethod);
+				}
+			}
+		
+		/* Process work items on the calling thread as well: */
+		Worker mainWorker(this,functor);
+		mainWorker.threadMethod();
+		
+		/* Wait for all worker threads to finish: */
+		for(unsigned int i=0;i+1<numThreads;++i)
+			{
+			threads[i].join();
+			delete workers[i];
+			}
+		delete[] threads;
+		
+		/* Forward any error to the caller: */
+		if(haveError)
+			{
+			if(errorIsBadAlloc)
+				throw std::bad_alloc();
+			throw std::runtime_error(errorMessage);
+			}
+		}
+	};
+
+/*************************************************************
+Convenience function to process work items [0, numItems) using a
+functor with signature void operator()(size_t itemIndex):
+*************************************************************/
+
+template <class FunctorParam>
+inline void parallelFor(size_t numItems,const FunctorParam& functor,unsigned int numThreads =0)
+	{
+	ParallelFor<FunctorParam> pf(numItems);
+	pf.run(functor,numThreads);
+	}
+
+#endif
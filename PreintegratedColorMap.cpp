@@ -0,0 +1,226 @@
+/***********************************************************************
+PreintegratedColorMap - Class to calculate two-dimensional pre-integrated
+transfer function tables from one-dimensional color maps for raycasting
+volume renderers.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <PreintegratedColorMap.h>
+
+#include <Math/Math.h>
+
+#include <ParallelFor.h>
+
+namespace {
+
+/****************
+Helper functions:
+****************/
+
+inline bool equal(const PreintegratedColorMap::Color& c1,const PreintegratedColorMap::Color& c2)
+	{
+	return c1[0]==c2[0]&&c1[1]==c2[1]&&c1[2]==c2[2]&&c1[3]==c2[3];
+	}
+
+inline double extinction(const PreintegratedColorMap::Color& c)
+	{
+	/* Convert the color's opacity per unit step to an extinction coefficient: */
+	double alpha=c[3]<0.0f?0.0:c[3]>0.999f?0.999:double(c[3]);
+	return -Math::log(1.0-alpha);
+	}
+
+}
+
+/*******************************************************
+Declaration of struct PreintegratedColorMap::RowUpdater:
+*******************************************************/
+
+struct PreintegratedColorMap::RowUpdater
+	{
+	/* Elements: */
+	public:
+	PreintegratedColorMap* pcm; // The pre-integrated color map whose table is updated
+	GLsizei changedMin,changedMax; // Range of color map entries that changed since the last update
+	
+	/* Constructors and destructors: */
+	RowUpdater(PreintegratedColorMap* sPcm,GLsizei sChangedMin,GLsizei sChangedMax)
+		:pcm(sPcm),changedMin(sChangedMin),changedMax(sChangedMax)
+		{
+		}
+	
+	/* Methods: */
+	void operator()(size_t row)
+		{
+		GLsizei back=GLsizei(row);
+		for(GLsizei front=0;front<pcm->numEntries;++front)
+			{
+			/* Only recalculate entries whose integration interval overlaps the changed range: */
+			GLsizei i0=front<back?front:back;
+			GLsizei i1=front<back?back:front;
+			if(i0<=changedMax&&i1>=changedMin)
+				pcm->calcTableEntry(front,back);
+			}
+		}
+	};
+
+/**************************************
+Methods of class PreintegratedColorMap:
+**************************************/
+
+void PreintegratedColorMap::calcTableEntry(GLsizei front,GLsizei back)
+	{
+	/* Calculate the average extinction coefficient and extinction-weighted color along the segment: */
+	double avg[4];
+	if(front!=back)
+		{
+		const double* i0=integrals+front*4;
+		const double* i1=integrals+back*4;
+		double invLength=1.0/double(back-front);
+		for(int i=0;i<4;++i)
+			avg[i]=(i1[i]-i0[i])*invLength;
+		}
+	else
+		{
+		/* Use the color map entry itself for zero-length segments: */
+		const Color& c=sourceColors[front];
+		avg[3]=extinction(c);
+		for(int i=0;i<3;++i)
+			avg[i]=double(c[i])*avg[3];
+		}
+	
+	/* Calculate the segment's opacity and pre-multiplied color: */
+	Color& entry=table[back*numEntries+front];
+	if(avg[3]>0.0)
+		{
+		double alpha=1.0-Math::exp(-double(opacityScale)*avg[3]);
+		for(int i=0;i<3;++i)
+			entry[i]=GLfloat(avg[i]*alpha/avg[3]);
+		entry[3]=GLfloat(alpha);
+		}
+	else
+		{
+		for(int i=0;i<4;++i)
+			entry[i]=0.0f;
+		}
+	}
+
+PreintegratedColorMap::PreintegratedColorMap(void)
+	:numEntries(0),sourceColors(0),opacityScale(0.0f),
+	 integrals(0),table(0),
+	 version(0)
+	{
+	}
+
+PreintegratedColorMap::~PreintegratedColorMap(void)
+	{
+	delete[] sourceColors;
+	delete[] integrals;
+	delete[] table;
+	}
+
+bool PreintegratedColorMap::update(const GLColorMap& colorMap,GLfloat newOpacityScale)
+	{
+	/* Find the range of color map entries that changed since the last update: */
+	GLsizei changedMin,changedMax;
+	const Color* colors=colorMap.getColors();
+	if(numEntries!=colorMap.getNumEntries()||opacityScale!=newOpacityScale)
+		{
+		/* Re-allocate the table if the color map size changed: */
+		if(numEntries!=colorMap.getNumEntries())
+			{
+			delete[] sourceColors;
+			delete[] integrals;
+			delete[] table;
+			numEntries=colorMap.getNumEntries();
+			sourceColors=new Color[numEntries];
+			integrals=new double[numEntries*4];
+			table=new Color[numEntries*numEntries];
+			}
+		opacityScale=newOpacityScale;
+		
+		/* Recalculate the entire table: */
+		changedMin=0;
+		changedMax=numEntries-1;
+		}
+	else
+		{
+		for(changedMin=0;changedMin<numEntries&&equal(sourceColors[changedMin],colors[changedMin]);++changedMin)
+			;
+		if(changedMin==numEntries)
+			{
+			/* Nothing changed: */
+			return false;
+			}
+		for(changedMax=numEntries-1;changedMax>changedMin&&equal(sourceColors[changedMax],colors[changedMax]);--changedMax)
+			;
+		}
+	
+	/* Copy the changed color map entries: */
+	for(GLsizei i=changedMin;i<=changedMax;++i)
+		sourceColors[i]=colors[i];
+	
+	/* Update the running integrals from the first changed entry onwards using the trapezoid rule: */
+	double prev[4];
+	for(GLsizei i=changedMin>0?changedMin-1:0;i<numEntries;++i)
+		{
+		/* Calculate the entry's extinction coefficient and extinction-weighted color: */
+		const Color& c=sourceColors[i];
+		double cur[4];
+		cur[3]=extinction(c);
+		for(int j=0;j<3;++j)
+			cur[j]=double(c[j])*cur[3];
+		
+		double* integral=integrals+i*4;
+		if(i==0)
+			{
+			for(int j=0;j<4;++j)
+				integral[j]=0.0;
+			}
+		else if(i>=changedMin)
+			{
+			const double* prevIntegral=integral-4;
+			for(int j=0;j<4;++j)
+				integral[j]=prevIntegral[j]+(prev[j]+cur[j])*0.5;
+			}
+		
+		for(int j=0;j<4;++j)
+			prev[j]=cur[j];
+		}
+	
+	/* Recalculate all affected table rows in parallel: */
+	parallelFor(numEntries,RowUpdater(this,changedMin,changedMax));
+	
+	++version;
+	return true;
+	}
+
+void PreintegratedColorMap::glUploadTable(const GLColorMap& colorMap,GLfloat newOpacityScale,unsigned int& textureVersion,GLint internalFormat)
+	{
+	Threads::Mutex::Lock tableLock(tableMutex);
+	
+	/* Bring the table up-to-date: */
+	update(colorMap,newOpacityScale);
+	
+	/* Upload the table if the texture is outdated: */
+	if(textureVersion!=version)
+		{
+		glTexImage2D(GL_TEXTURE_2D,0,internalFormat,numEntries,numEntries,0,GL_RGBA,GL_FLOAT,table);
+		textureVersion=version;
+		}
+	}
@@ -0,0 +1,67 @@
+/***********************************************************************
+PreintegratedColorMap - Class to calculate two-dimensional pre-integrated
+transfer function tables from one-dimensional color maps for raycasting
+volume renderers.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef PREINTEGRATEDCOLORMAP_INCLUDED
+#define PREINTEGRATEDCOLORMAP_INCLUDED
+
+#include <Threads/Mutex.h>
+#include <GL/gl.h>
+#include <GL/GLColorMap.h>
+
+class PreintegratedColorMap
+	{
+	/* Embedded classes: */
+	public:
+	typedef GLColorMap::Color Color; // Type for color map and table entries
+	
+	private:
+	struct RowUpdater; // Functor class to recalculate rows of the pre-integrated table in parallel
+	friend struct RowUpdater;
+	
+	/* Elements: */
+	Threads::Mutex tableMutex; // Mutex serializing table updates and uploads from multiple rendering threads
+	GLsizei numEntries; // Number of entries in the source color map, and size of the table in each dimension
+	Color* sourceColors; // Copy of the color map entries from which the current table was calculated
+	GLfloat opacityScale; // Ray segment length factor from which the current table was calculated
+	double* integrals; // Running integrals of extinction coefficient and extinction-weighted color across the color map
+	Color* table; // The pre-integrated table, indexed by back sample value in rows and front sample value in columns
+	unsigned int version; // Version number of the pre-integrated table
+	
+	/* Private methods: */
+	void calcTableEntry(GLsizei front,GLsizei back); // Calculates a single entry of the pre-integrated table
+	
+	/* Constructors and destructors: */
+	public:
+	PreintegratedColorMap(void); // Creates an uninitialized pre-integrated table
+	private:
+	PreintegratedColorMap(const PreintegratedColorMap& source); // Prohibit copy constructor
+	PreintegratedColorMap& operator=(const PreintegratedColorMap& source); // Prohibit assignment operator
+	public:
+	~PreintegratedColorMap(void);
+	
+	/* Methods: */
+	bool update(const GLColorMap& colorMap,GLfloat newOpacityScale); // Updates the table for the given color map and ray segment length factor; only recalculates entries affected by changes; returns true if the table changed
+	void glUploadTable(const GLColorMap& colorMap,GLfloat newOpacityScale,unsigned int& textureVersion,GLint internalFormat); // Updates the table and uploads it into the currently bound 2D texture if the given texture version is outdated
+	};
+
+#endif
@@ -1,7 +1,7 @@
 /***********************************************************************
 ScalarEvaluationLocator - Class for locators evaluating scalar
 properties of data sets.
-Copyright (c) 2008-2010 Oliver Kreylos
+Copyright (c) 2008-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include "ScalarEvaluationLocator.h"
 
+#include <Misc/ThrowStdErr.h>
 #include <Misc/StandardValueCoders.h>
 #include <Misc/ConfigurationFile.h>
 #include <Geometry/OrthogonalTransformation.h>
@@ -56,7 +57,10 @@ ScalarEvaluationLocator::ScalarEvaluationLocator(Vrui::LocatorTool* sLocatorTool
 		/* Read the scalar variable from the configuration file: */
 		std::string scalarVariableName=vm->getScalarVariableName(vm->getCurrentScalarVariable());
 		scalarVariableName=cfg->retrieveValue<std::string>("./scalarVariableName",scalarVariableName);
-		scalarExtractor=vm->getScalarExtractor(vm->getScalarVariable(scalarVariableName.c_str()));
+		int scalarVariableIndex=vm->getScalarVariable(scalarVariableName.c_str());
+		if(scalarVariableIndex<0)
+			Misc::throwStdErr("ScalarEvaluationLocator::ScalarEvaluationLocator: Unknown scalar variable %s",scalarVariableName.c_str());
+		scalarExtractor=vm->getScalarExtractor(scalarVariableIndex);
 		}
 	else
 		{
@@ -2,7 +2,7 @@
 SharedVisualizationClient - Client for collaborative data exploration in
 spatially distributed VR environments, implemented as a plug-in of the
 Vrui remote collaboration infrastructure.
-Copyright (c) 2009-2012 Oliver Kreylos
+Copyright (c) 2009-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -24,6 +24,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include "SharedVisualizationClient.h"
 
 #include <string>
+#include <stdexcept>
 #include <iostream>
 #include <Comm/NetPipe.h>
 #include <Cluster/MulticastPipe.h>
@@ -109,7 +110,17 @@ void SharedVisualizationClient::receiveRemoteLocator(SharedVisualizationClient::
 	
 	/* Create an extractor for the given algorithm name: */
 	Cluster::MulticastPipe* algorithmPipe=Vrui::openPipe();
-	Algorithm* algorithm=application->module->getAlgorithm(algorithmName.c_str(),application->variableManager,algorithmPipe);
+	Algorithm* algorithm=0;
+	try
+		{
+		algorithm=application->module->getAlgorithm(algorithmName.c_str(),application->variableManager,algorithmPipe);
+		}
+	catch(const std::exception& err)
+		{
+		/* Print a warning message, but carry on otherwise; the failed extractor already closed its pipe: */
+		std::cout<<"SharedVisualizationClient::receiveRemoteLocator: Could not create locator of type "<<algorithmName<<" due to exception "<<err.what()<<std::endl;
+		return;
+		}
 	if(algorithm!=0)
 		{
 		/* Create a new remote locator and add it to the client's hash table: */
@@ -39,7 +39,9 @@ SingleChannelRaycaster::DataItem::DataItem(void)
 	:haveFloatTextures(GLARBTextureFloat::isSupported()),
 	 volumeTextureID(0),volumeTextureVersion(0),
 	 colorMapTextureID(0),
-	 volumeSamplerLoc(-1),colorMapSamplerLoc(-1)
+	 preintegratedTextureID(0),preintegratedTextureVersion(0),
+	 volumeSamplerLoc(-1),colorMapSamplerLoc(-1),
+	 preintegratedLoc(-1),preintegratedSamplerLoc(-1)
 	{
 	/* Initialize all required OpenGL extensions: */
 	GLARBMultitexture::initExtension();
@@ -52,6 +54,9 @@ SingleChannelRaycaster::DataItem::DataItem(void)
 	
 	/* Create the color map texture object: */
 	glGenTextures(1,&colorMapTextureID);
+	
+	/* Create the pre-integrated color map texture object: */
+	glGenTextures(1,&preintegratedTextureID);
 	}
 
 SingleChannelRaycaster::DataItem::~DataItem(void)
@@ -61,12 +66,28 @@ SingleChannelRaycaster::DataItem::~DataItem(void)
 	
 	/* Destroy the color map texture object: */
 	glDeleteTextures(1,&colorMapTextureID);
+	
+	/* Destroy the pre-integrated color map texture object: */
+	glDeleteTextures(1,&preintegratedTextureID);
 	}
 
 /***************************************
 Methods of class SingleChannelRaycaster:
 ***************************************/
 
+void SingleChannelRaycaster::initVolumeTexture(SingleChannelRaycaster::DataItem* dataItem) const
+	{
+	/* Create the data volume texture: */
+	glBindTexture(GL_TEXTURE_3D,dataItem->volumeTextureID);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_S,GL_CLAMP);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_T,GL_CLAMP);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_R,GL_CLAMP);
+	glTexImage3DEXT(GL_TEXTURE_3D,0,GL_INTENSITY,dataItem->textureSize[0],dataItem->textureSize[1],dataItem->textureSize[2],0,GL_LUMINANCE,GL_UNSIGNED_BYTE,0);
+	glBindTexture(GL_TEXTURE_3D,0);
+	}
+
 void SingleChannelRaycaster::initDataItem(Raycaster::DataItem* dataItem) const
 	{
 	/* Call the base class method: */
@@ -76,14 +97,7 @@ void SingleChannelRaycaster::initDataItem(Raycaster::DataItem* dataItem) const
 	DataItem* myDataItem=dynamic_cast<DataItem*>(dataItem);
 	
 	/* Create the data volume texture: */
-	glBindTexture(GL_TEXTURE_3D,myDataItem->volumeTextureID);
-	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_S,GL_CLAMP);
-	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_T,GL_CLAMP);
-	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_R,GL_CLAMP);
-	glTexImage3DEXT(GL_TEXTURE_3D,0,GL_INTENSITY,myDataItem->textureSize[0],myDataItem->textureSize[1],myDataItem->textureSize[2],0,GL_LUMINANCE,GL_UNSIGNED_BYTE,0);
-	glBindTexture(GL_TEXTURE_3D,0);
+	initVolumeTexture(myDataItem);
 	
 	/* Create the color map texture: */
 	glBindTexture(GL_TEXTURE_1D,myDataItem->colorMapTextureID);
@@ -91,6 +105,14 @@ void SingleChannelRaycaster::initDataItem(Raycaster::DataItem* dataItem) const
 	glTexParameteri(GL_TEXTURE_1D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_1D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
 	glBindTexture(GL_TEXTURE_1D,0);
+	
+	/* Create the pre-integrated color map texture: */
+	glBindTexture(GL_TEXTURE_2D,myDataItem->preintegratedTextureID);
+	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D,0);
 	}
 
 void SingleChannelRaycaster::initShader(Raycaster::DataItem* dataItem) const
@@ -104,6 +126,8 @@ void SingleChannelRaycaster::initShader(Raycaster::DataItem* dataItem) const
 	/* Get the shader's uniform locations: */
 	myDataItem->volumeSamplerLoc=myDataItem->shader.getUniformLocation("volumeSampler");
 	myDataItem->colorMapSamplerLoc=myDataItem->shader.getUniformLocation("colorMapSampler");
+	myDataItem->preintegratedLoc=myDataItem->shader.getUniformLocation("preintegrated");
+	myDataItem->preintegratedSamplerLoc=myDataItem->shader.getUniformLocation("preintegratedSampler");
 	}
 
 void SingleChannelRaycaster::bindShader(const Raycaster::PTransform& pmv,const Raycaster::PTransform& mv,Raycaster::DataItem* dataItem) const
@@ -134,15 +158,34 @@ void SingleChannelRaycaster::bindShader(const Raycaster::PTransform& pmv,const R
 	glBindTexture(GL_TEXTURE_1D,myDataItem->colorMapTextureID);
 	glUniform1iARB(myDataItem->colorMapSamplerLoc,2);
 	
-	/* Create the stepsize-adjusted colormap with pre-multiplied alpha: */
-	GLColorMap adjustedColorMap(*colorMap);
-	adjustedColorMap.changeTransparency(stepSize*transparencyGamma);
-	adjustedColorMap.premultiplyAlpha();
-	glTexImage1D(GL_TEXTURE_1D,0,myDataItem->haveFloatTextures?GL_RGBA32F_ARB:GL_RGBA,256,0,GL_RGBA,GL_FLOAT,adjustedColorMap.getColors());
+	if(!preintegrated)
+		{
+		/* Create the stepsize-adjusted colormap with pre-multiplied alpha: */
+		GLColorMap adjustedColorMap(*colorMap);
+		adjustedColorMap.changeTransparency(stepSize*transparencyGamma);
+		adjustedColorMap.premultiplyAlpha();
+		glTexImage1D(GL_TEXTURE_1D,0,myDataItem->haveFloatTextures?GL_RGBA32F_ARB:GL_RGBA,256,0,GL_RGBA,GL_FLOAT,adjustedColorMap.getColors());
+		}
+	
+	/* Bind the pre-integrated color map texture: */
+	glActiveTextureARB(GL_TEXTURE3_ARB);
+	glBindTexture(GL_TEXTURE_2D,myDataItem->preintegratedTextureID);
+	glUniform1iARB(myDataItem->preintegratedSamplerLoc,3);
+	glUniform1iARB(myDataItem->preintegratedLoc,preintegrated?1:0);
+	
+	if(preintegrated)
+		{
+		/* Update the pre-integrated colormap if the color map, step size, or opacity adjustment changed: */
+		preintegratedColorMap.glUploadTable(*colorMap,stepSize*transparencyGamma,myDataItem->preintegratedTextureVersion,myDataItem->haveFloatTextures?GL_RGBA32F_ARB:GL_RGBA);
+		}
 	}
 
 void SingleChannelRaycaster::unbindShader(Raycaster::DataItem* dataItem) const
 	{
+	/* Unbind the pre-integrated color map texture: */
+	glActiveTextureARB(GL_TEXTURE3_ARB);
+	glBindTexture(GL_TEXTURE_2D,0);
+	
 	/* Unbind the color map texture: */
 	glActiveTextureARB(GL_TEXTURE2_ARB);
 	glBindTexture(GL_TEXTURE_1D,0);
@@ -155,10 +198,19 @@ void SingleChannelRaycaster::unbindShader(Raycaster::DataItem* dataItem) const
 	Raycaster::unbindShader(dataItem);
 	}
 
+SingleChannelRaycaster::SingleChannelRaycaster(const unsigned int sDataSize[3],const Raycaster::Box& sDomain,SingleChannelRaycaster::Voxel* sData)
+	:Raycaster(sDataSize,sDomain),
+	 data(sData),dataVersion(0),
+	 colorMap(0),transparencyGamma(1.0f),
+	 preintegrated(false)
+	{
+	}
+
 SingleChannelRaycaster::SingleChannelRaycaster(const unsigned int sDataSize[3],const Raycaster::Box& sDomain)
 	:Raycaster(sDataSize,sDomain),
 	 data(new Voxel[dataSize[0]*dataSize[1]*dataSize[2]]),dataVersion(0),
-	 colorMap(0),transparencyGamma(1.0f)
+	 colorMap(0),transparencyGamma(1.0f),
+	 preintegrated(false)
 	{
 	}
 
@@ -219,3 +271,8 @@ void SingleChannelRaycaster::setTransparencyGamma(GLfloat newTransparencyGamma)
 	{
 	transparencyGamma=newTransparencyGamma;
 	}
+
+void SingleChannelRaycaster::setPreintegrated(bool newPreintegrated)
+	{
+	preintegrated=newPreintegrated;
+	}
@@ -27,6 +27,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <GL/GLColorMap.h>
 
 #include <Raycaster.h>
+#include <PreintegratedColorMap.h>
 
 class SingleChannelRaycaster:public Raycaster
 	{
@@ -43,9 +44,13 @@ class SingleChannelRaycaster:public Raycaster
 		GLuint volumeTextureID; // Texture object ID for volume data texture
 		unsigned int volumeTextureVersion; // Version number of volume data texture
 		GLuint colorMapTextureID; // Texture object ID for stepsize-adjusted color map texture
+		GLuint preintegratedTextureID; // Texture object ID for pre-integrated color map texture
+		unsigned int preintegratedTextureVersion; // Version number of pre-integrated color map texture
 		
 		int volumeSamplerLoc; // Location of the volume data texture sampler
 		int colorMapSamplerLoc; // Location of the color map texture sampler
+		int preintegratedLoc; // Location of the pre-integration enable flag
+		int preintegratedSamplerLoc; // Location of the pre-integrated color map texture sampler
 		
 		/* Constructors and destructors: */
 		DataItem(void);
@@ -58,15 +63,20 @@ class SingleChannelRaycaster:public Raycaster
 	unsigned int dataVersion; // Version number of the volume dataset to track changes
 	const GLColorMap* colorMap; // Pointer to the color map
 	GLfloat transparencyGamma; // Adjustment factor for color map's overall opacity
+	bool preintegrated; // Flag whether to use pre-integrated ray segments instead of point samples
+	mutable PreintegratedColorMap preintegratedColorMap; // Pre-integrated version of the stepsize-adjusted color map
 	
 	/* Protected methods: */
 	protected:
+	virtual void initVolumeTexture(DataItem* dataItem) const; // Creates the volume data texture in the given context data item
 	virtual void initDataItem(Raycaster::DataItem* dataItem) const;
 	virtual void initShader(Raycaster::DataItem* dataItem) const;
 	virtual void bindShader(const PTransform& pmv,const PTransform& mv,Raycaster::DataItem* dataItem) const;
 	virtual void unbindShader(Raycaster::DataItem* dataItem) const;
 	
 	/* Constructors and destructors: */
+	protected:
+	SingleChannelRaycaster(const unsigned int sDataSize[3],const Box& sDomain,Voxel* sData); // Creates a volume renderer using the given voxel array, which is adopted by the raycaster; used by derived classes with their own data storage
 	public:
 	SingleChannelRaycaster(const unsigned int sDataSize[3],const Box& sDomain); // Creates a volume renderer
 	virtual ~SingleChannelRaycaster(void); // Destroys the raycaster
@@ -97,6 +107,11 @@ class SingleChannelRaycaster:public Raycaster
 		return transparencyGamma;
 		}
 	void setTransparencyGamma(GLfloat newTransparencyGamma); // Sets the opacity adjustment factor
+	bool getPreintegrated(void) const // Returns true if the raycaster uses pre-integrated ray segments
+		{
+		return preintegrated;
+		}
+	void setPreintegrated(bool newPreintegrated); // Enables or disables pre-integrated ray segments
 	};
 
 #endif
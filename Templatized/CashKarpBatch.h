@@ -0,0 +1,100 @@
+/***********************************************************************
+CashKarpBatch - Generic class to advance a batch of particles through a
+vector field in lock-step using an embedded adaptive-step size Runge-
+Kutta method with Cash-Karp coefficients and per-particle step sizes,
+which may be negative to integrate backwards.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_TEMPLATIZED_CASHKARPBATCH_INCLUDED
+#define VISUALIZATION_TEMPLATIZED_CASHKARPBATCH_INCLUDED
+
+namespace Visualization {
+
+namespace Templatized {
+
+template <class DataSetParam,class VectorExtractorParam,int numLanesParam =8>
+class CashKarpBatch
+	{
+	/* Embedded classes: */
+	public:
+	typedef DataSetParam DataSet; // Type of the data set through which particles are advanced
+	typedef typename DataSet::Scalar Scalar; // Scalar type of the data set's domain
+	static const int dimension=DataSet::dimension; // Dimension of the data set's domain
+	typedef typename DataSet::Point Point; // Type for points in the data set's domain
+	typedef typename DataSet::Vector Vector; // Type for vectors in the data set's domain
+	typedef typename DataSet::Locator Locator; // Type of data set locators
+	typedef VectorExtractorParam VectorExtractor; // Type to extract vector values from a data set
+	static const int numLanes=numLanesParam; // Number of particles advanced in lock-step
+	
+	/* Elements: */
+	private:
+	Locator* locators[numLanes]; // Pointers to the locators following each lane's particle (owned by caller)
+	bool active[numLanes]; // Flags whether each lane holds a particle
+	Scalar positions[dimension][numLanes]; // Current particle positions, one array per component
+	Scalar velocities[dimension][numLanes]; // Vector field values at the current particle positions
+	Scalar stepSizes[numLanes]; // Step sizes for the next integration step
+	Scalar trialStepSizes[numLanes]; // Step sizes of the current trial step
+	Scalar errorScales[dimension][numLanes]; // Error scaling factors for the current integration step
+	Scalar stages[6][dimension][numLanes]; // Vector field values at the six Cash-Karp evaluation points
+	Scalar trialPositions[dimension][numLanes]; // Evaluation points of the current Cash-Karp stage
+	Scalar steps[dimension][numLanes]; // Step vectors of the current trial step
+	Scalar errorMaxs[numLanes]; // Relative error of the current trial step
+	bool pending[numLanes]; // Flags whether each lane still needs to take a trial step
+	
+	/* Private methods: */
+	void evaluateStage(int stage,const VectorExtractor& vectorExtractor); // Evaluates the vector field at the current trial positions of all pending lanes
+	void trialStep(const VectorExtractor& vectorExtractor); // Performs a Cash-Karp trial step for all pending lanes
+	
+	/* Constructors and destructors: */
+	public:
+	CashKarpBatch(void); // Creates an empty batch
+	
+	/* Methods: */
+	void setLane(int lane,const Point& position,const Vector& velocity,Scalar stepSize,Locator& locator); // Places a particle with the given vector field value, step size, and locator into the given lane
+	void clearLane(int lane) // Removes the particle from the given lane
+		{
+		active[lane]=false;
+		}
+	void clear(void); // Removes all particles from the batch
+	bool isActive(int lane) const // Returns true if the given lane holds a particle
+		{
+		return active[lane];
+		}
+	Point getPosition(int lane) const; // Returns the current position of the particle in the given lane
+	Scalar getStepSize(int lane) const // Returns the step size for the next integration step of the particle in the given lane
+		{
+		return stepSizes[lane];
+		}
+	Scalar getLastStepSize(int lane) const // Returns the step size of the last integration step taken by the particle in the given lane
+		{
+		return trialStepSizes[lane];
+		}
+	void step(const VectorExtractor& vectorExtractor,Scalar epsilon); // Advances all active lanes by one step that meets the given per-step accuracy threshold
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_TEMPLATIZED_CASHKARPBATCH_IMPLEMENTATION
+#include <Templatized/CashKarpBatch.icpp>
+#endif
+
+#endif
@@ -0,0 +1,192 @@
+/***********************************************************************
+EvenlySpacedStreamlineExtractor - Generic class to fill a data set's
+domain with evenly-spaced streamlines, using an occupancy grid to
+terminate streamlines that come too close to each other and to place
+new seed points.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_TEMPLATIZED_EVENLYSPACEDSTREAMLINEEXTRACTOR_INCLUDED
+#define VISUALIZATION_TEMPLATIZED_EVENLYSPACEDSTREAMLINEEXTRACTOR_INCLUDED
+
+#include <deque>
+#include <vector>
+
+/* Forward declarations: */
+namespace Visualization {
+namespace Abstract {
+class Algorithm;
+}
+}
+
+namespace Visualization {
+
+namespace Templatized {
+
+template <class DataSetParam,class VectorExtractorParam,class ScalarExtractorParam,class MultiStreamlineParam>
+class EvenlySpacedStreamlineExtractor
+	{
+	/* Embedded classes: */
+	public:
+	typedef DataSetParam DataSet; // Type of the data set the streamline extractor works on
+	typedef typename DataSet::Scalar Scalar; // Scalar type of the data set's domain
+	static const int dimension=DataSet::dimension; // Dimension of the data set's domain
+	typedef typename DataSet::Point Point; // Type for points in the data set's domain
+	typedef typename DataSet::Vector Vector; // Type for vectors in the data set's domain
+	typedef typename DataSet::Box Box; // Type for bounding boxes in the data set's domain
+	typedef typename DataSet::Locator Locator; // Type of data set locators
+	typedef VectorExtractorParam VectorExtractor; // Type to extract vector values from a data set (to trace the streamlines)
+	typedef ScalarExtractorParam ScalarExtractor; // Type to extract scalar values from a data set (to color the streamlines)
+	typedef typename ScalarExtractor::Scalar VScalar; // Value type of scalar extractor
+	typedef MultiStreamlineParam MultiStreamline; // Type of multi-streamline representation
+	
+	private:
+	typedef typename MultiStreamline::Vertex Vertex; // Type of vertices stored in streamlines
+	
+	class OccupancyGrid // Class to find streamline vertices close to a query point
+		{
+		/* Embedded classes: */
+		private:
+		struct Sample // Structure for streamline vertices stored in the grid
+			{
+			/* Elements: */
+			public:
+			Point position; // Position of the vertex
+			unsigned int streamlineIndex; // Index of the streamline containing the vertex
+			};
+		
+		/* Elements: */
+		Point origin; // Lower corner of the grid
+		Scalar cellSize; // Edge length of the grid's cubic cells
+		int numCells[dimension]; // Number of grid cells in each dimension
+		std::vector<std::vector<Sample> > cells; // Streamline vertices contained in each grid cell
+		
+		/* Private methods: */
+		size_t getCellIndex(const Point& position,int cellIndex[dimension]) const; // Returns the linear index of the cell containing the given position, clamped to the grid
+		
+		/* Constructors and destructors: */
+		public:
+		OccupancyGrid(const Box& domain,Scalar minCellSize); // Creates an empty grid covering the given domain
+		
+		/* Methods: */
+		bool isFree(const Point& position,Scalar distance) const; // Returns true if no streamline vertex is closer than the given distance, which must not exceed the minimum cell size
+		void insert(const Point& position,unsigned int streamlineIndex); // Adds a streamline vertex to the grid
+		};
+	
+	struct Streamline // Structure for traced streamlines
+		{
+		/* Elements: */
+		public:
+		std::vector<Vertex> vertices; // Streamline vertices in order
+		size_t seedIndex; // Index of the seed vertex
+		};
+	
+	class StreamlineTracer; // Functor class to trace a round of streamlines in parallel
+	friend class StreamlineTracer;
+	
+	/* Elements: */
+	const DataSet* dataSet; // Data set the streamline extractor works on
+	VectorExtractor vectorExtractor; // Vector extractor working on data set
+	ScalarExtractor scalarExtractor; // Scalar extractor working on data set
+	Scalar separation; // Minimum distance between a new seed point and any existing streamline
+	Scalar testRatio; // Ratio of the distance at which streamlines are terminated to the separation distance
+	Scalar stepRatio; // Ratio of the integration step size to the separation distance
+	unsigned int maxNumStreamlines; // Maximum number of streamlines to extract
+	size_t maxNumVertices; // Maximum number of vertices per streamline
+	unsigned int numThreads; // Number of threads to trace streamlines in parallel
+	
+	/* Extraction state: */
+	std::vector<Streamline> streamlines; // The extracted streamlines
+	
+	/* Private methods: */
+	bool evaluate(Locator& locator,const Point& position,Vector& direction) const; // Calculates the normalized vector field at the given position; returns false if the position is outside the domain or at a critical point
+	void traceDirection(Locator& locator,const Point& seed,Scalar stepSize,const OccupancyGrid& grid,std::vector<Vertex>& vertices) const; // Traces a streamline from the given seed point in the direction of the given signed step size
+	void traceStreamline(Locator& locator,const Point& seed,const OccupancyGrid& grid,Streamline& streamline) const; // Traces a streamline in both directions from the given seed point
+	void addSeeds(const Streamline& streamline,std::deque<Point>& seeds) const; // Adds candidate seed points at separation distance around the given streamline
+	
+	/* Constructors and destructors: */
+	public:
+	EvenlySpacedStreamlineExtractor(const DataSet* sDataSet,const VectorExtractor& sVectorExtractor,const ScalarExtractor& sScalarExtractor); // Creates a streamline extractor for the given data set and vector and scalar extractors
+	private:
+	EvenlySpacedStreamlineExtractor(const EvenlySpacedStreamlineExtractor& source); // Prohibit copy constructor
+	EvenlySpacedStreamlineExtractor& operator=(const EvenlySpacedStreamlineExtractor& source); // Prohibit assignment operator
+	
+	/* Methods: */
+	public:
+	const DataSet* getDataSet(void) const // Returns the data set
+		{
+		return dataSet;
+		}
+	const VectorExtractor& getVectorExtractor(void) const // Returns the vector extractor
+		{
+		return vectorExtractor;
+		}
+	const ScalarExtractor& getScalarExtractor(void) const // Returns the scalar extractor
+		{
+		return scalarExtractor;
+		}
+	Scalar getSeparation(void) const // Returns the streamline separation distance
+		{
+		return separation;
+		}
+	Scalar getTestRatio(void) const // Returns the ratio of the termination distance to the separation distance
+		{
+		return testRatio;
+		}
+	Scalar getStepRatio(void) const // Returns the ratio of the integration step size to the separation distance
+		{
+		return stepRatio;
+		}
+	unsigned int getMaxNumStreamlines(void) const // Returns the maximum number of extracted streamlines
+		{
+		return maxNumStreamlines;
+		}
+	size_t getMaxNumVertices(void) const // Returns the maximum number of vertices per streamline
+		{
+		return maxNumVertices;
+		}
+	void update(const DataSet* newDataSet,const VectorExtractor& newVectorExtractor,const ScalarExtractor& newScalarExtractor) // Sets a new data set and scalar / vector extractors for subsequent streamline extraction
+		{
+		dataSet=newDataSet;
+		vectorExtractor=newVectorExtractor;
+		scalarExtractor=newScalarExtractor;
+		}
+	void setSeparation(Scalar newSeparation); // Sets the streamline separation distance
+	void setTestRatio(Scalar newTestRatio); // Sets the ratio of the termination distance to the separation distance
+	void setStepRatio(Scalar newStepRatio); // Sets the ratio of the integration step size to the separation distance
+	void setMaxNumStreamlines(unsigned int newMaxNumStreamlines); // Sets the maximum number of extracted streamlines
+	void setMaxNumVertices(size_t newMaxNumVertices); // Sets the maximum number of vertices per streamline
+	void setNumThreads(unsigned int newNumThreads); // Sets the number of threads to trace streamlines; 0 uses one thread per CPU
+	void extractStreamlines(Visualization::Abstract::Algorithm* algorithm); // Fills the data set's domain with evenly-spaced streamlines
+	unsigned int getNumStreamlines(void) const // Returns the number of streamlines found by the last extraction
+		{
+		return (unsigned int)(streamlines.size());
+		}
+	void storeStreamlines(MultiStreamline& multiStreamline); // Stores the extracted streamlines in the given multi-streamline, which must have the right number of polylines, and releases the extraction state
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_TEMPLATIZED_EVENLYSPACEDSTREAMLINEEXTRACTOR_IMPLEMENTATION
+#include <Templatized/EvenlySpacedStreamlineExtractor.icpp>
+#endif
+
+#endif
@@ -0,0 +1,121 @@
+/***********************************************************************
+FTLEComputer - Generic class to compute finite-time Lyapunov exponent
+fields of vector fields defined on structured grids, by advecting
+particles seeded at all grid vertices in parallel and differentiating
+the resulting flow map.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_TEMPLATIZED_FTLECOMPUTER_INCLUDED
+#define VISUALIZATION_TEMPLATIZED_FTLECOMPUTER_INCLUDED
+
+#include <stddef.h>
+
+#include <Templatized/CashKarpBatch.h>
+
+namespace Visualization {
+
+namespace Templatized {
+
+template <class DataSetParam,class VectorExtractorParam>
+class FTLEComputer
+	{
+	/* Embedded classes: */
+	public:
+	typedef DataSetParam DataSet; // Type of the data set the FTLE computer works on
+	typedef typename DataSet::Scalar Scalar; // Scalar type of the data set's domain
+	static const int dimension=DataSet::dimension; // Dimension of the data set's domain
+	typedef typename DataSet::Point Point; // Type for points in the data set's domain
+	typedef typename DataSet::Vector Vector; // Type for vectors in the data set's domain
+	typedef typename DataSet::Index Index; // Type for vertex indices in the data set's grid
+	typedef typename DataSet::Locator Locator; // Type of data set locators
+	typedef VectorExtractorParam VectorExtractor; // Type to extract vector values from a data set
+	
+	private:
+	typedef CashKarpBatch<DataSet,VectorExtractor> Batch; // Type to advect groups of particles in lock-step
+	
+	class FlowMapper; // Functor class to advect the particles seeded along grid rows
+	friend class FlowMapper;
+	template <class ValueScalarParam>
+	class FTLECalculator; // Functor class to calculate FTLE values from the flow map for grid rows
+	template <class ValueScalarParam>
+	friend class FTLECalculator;
+	
+	/* Elements: */
+	const DataSet* dataSet; // Data set the FTLE computer works on
+	VectorExtractor vectorExtractor; // Vector extractor working on data set
+	Scalar integrationTime; // Advection time of the flow map; negative to integrate backwards
+	Scalar epsilon; // The per-step accuracy threshold for particle integration
+	unsigned int maxNumSteps; // Maximum number of integration steps per particle
+	unsigned int numThreads; // Number of threads to advect particles in parallel
+	
+	/* Private methods: */
+	Index getVertexIndex(size_t linearIndex) const; // Returns the grid index of the given linearly-indexed vertex
+	static Scalar calcMaxEigenvalue(Scalar matrix[dimension][dimension]); // Returns the largest eigenvalue of the given symmetric matrix; destroys the matrix
+	
+	/* Constructors and destructors: */
+	public:
+	FTLEComputer(const DataSet* sDataSet,const VectorExtractor& sVectorExtractor); // Creates an FTLE computer for the given data set and vector extractor
+	private:
+	FTLEComputer(const FTLEComputer& source); // Prohibit copy constructor
+	FTLEComputer& operator=(const FTLEComputer& source); // Prohibit assignment operator
+	
+	/* Methods: */
+	public:
+	const DataSet* getDataSet(void) const // Returns the data set
+		{
+		return dataSet;
+		}
+	const VectorExtractor& getVectorExtractor(void) const // Returns the vector extractor
+		{
+		return vectorExtractor;
+		}
+	Scalar getIntegrationTime(void) const // Returns the advection time of the flow map
+		{
+		return integrationTime;
+		}
+	Scalar getEpsilon(void) const // Returns the integration accuracy threshold
+		{
+		return epsilon;
+		}
+	unsigned int getMaxNumSteps(void) const // Returns the maximum number of integration steps per particle
+		{
+		return maxNumSteps;
+		}
+	unsigned int getNumThreads(void) const // Returns the number of threads used to advect particles
+		{
+		return numThreads;
+		}
+	void setIntegrationTime(Scalar newIntegrationTime); // Sets the advection time of the flow map; negative times compute backward FTLE fields
+	void setEpsilon(Scalar newEpsilon); // Sets the integration accuracy threshold
+	void setMaxNumSteps(unsigned int newMaxNumSteps); // Sets the maximum number of integration steps per particle
+	void setNumThreads(unsigned int newNumThreads); // Sets the number of threads to advect particles; 0 uses one thread per CPU
+	template <class ValueScalarParam,class AlgorithmParam>
+	void computeFTLE(ValueScalarParam* ftle,AlgorithmParam* algorithm) const; // Computes FTLE values for all grid vertices into the given array in slice order, and reports progress through the given algorithm's busy function
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_TEMPLATIZED_FTLECOMPUTER_IMPLEMENTATION
+#include <Templatized/FTLEComputer.icpp>
+#endif
+
+#endif
@@ -0,0 +1,99 @@
+/***********************************************************************
+LICGenerator - Generic class to compute line integral convolution
+images of 2D vector fields sampled on regular grids, using fast LIC
+with streamline re-use, processing image tiles in parallel.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_TEMPLATIZED_LICGENERATOR_INCLUDED
+#define VISUALIZATION_TEMPLATIZED_LICGENERATOR_INCLUDED
+
+#include <vector>
+
+namespace Visualization {
+
+namespace Templatized {
+
+template <class ScalarParam>
+class LICGenerator
+	{
+	/* Embedded classes: */
+	public:
+	typedef ScalarParam Scalar; // Scalar type of vector field components
+	
+	private:
+	class TileConvolver; // Functor class to compute the LIC image of one image tile
+	friend class TileConvolver;
+	
+	/* Elements: */
+	int size[2]; // Width and height of the vector field and LIC image in pixels
+	const Scalar* vectors; // Vector field as interleaved pairs of components in row-major pixel order; pixels outside the domain hold (0, 0)
+	const unsigned char* domain; // Domain mask in row-major pixel order; non-zero marks pixels inside the domain
+	std::vector<float> noise; // White noise image convolved along streamlines
+	unsigned int filterLength; // Half length of the box convolution filter in integration steps
+	Scalar stepSize; // Streamline integration step size in pixels
+	unsigned int tileSize; // Width and height of image tiles processed in parallel
+	unsigned int numThreads; // Number of threads to process image tiles in parallel
+	
+	/* Private methods: */
+	bool isInside(Scalar x,Scalar y) const; // Returns true if the given pixel-space position is inside the domain
+	bool getDirection(Scalar x,Scalar y,Scalar direction[2]) const; // Returns the normalized bilinearly-interpolated vector field direction at the given pixel-space position inside the domain; returns false if the vector field vanishes there
+	
+	/* Constructors and destructors: */
+	public:
+	LICGenerator(int width,int height,const Scalar* sVectors,const unsigned char* sDomain); // Creates an LIC generator for the given vector field and domain mask; does not copy the vector field or domain mask
+	private:
+	LICGenerator(const LICGenerator& source); // Prohibit copy constructor
+	LICGenerator& operator=(const LICGenerator& source); // Prohibit assignment operator
+	
+	/* Methods: */
+	public:
+	unsigned int getFilterLength(void) const // Returns the half length of the convolution filter in integration steps
+		{
+		return filterLength;
+		}
+	Scalar getStepSize(void) const // Returns the streamline integration step size in pixels
+		{
+		return stepSize;
+		}
+	unsigned int getTileSize(void) const // Returns the size of image tiles processed in parallel
+		{
+		return tileSize;
+		}
+	unsigned int getNumThreads(void) const // Returns the number of threads used to process image tiles
+		{
+		return numThreads;
+		}
+	void setFilterLength(unsigned int newFilterLength); // Sets the half length of the convolution filter in integration steps
+	void setStepSize(Scalar newStepSize); // Sets the streamline integration step size in pixels
+	void setTileSize(unsigned int newTileSize); // Sets the size of image tiles processed in parallel
+	void setNumThreads(unsigned int newNumThreads); // Sets the number of threads to process image tiles; 0 uses one thread per CPU
+	template <class AlgorithmParam>
+	void computeLIC(float* image,AlgorithmParam* algorithm) const; // Computes the contrast-stretched LIC image into the given row-major array with values in [0, 1], or -1 for pixels outside the domain; reports progress through the given algorithm's busy function
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_TEMPLATIZED_LICGENERATOR_IMPLEMENTATION
+#include <Templatized/LICGenerator.icpp>
+#endif
+
+#endif
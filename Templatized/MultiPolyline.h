@@ -1,6 +1,6 @@
 /***********************************************************************
 MultiPolyline - Class to represent multiple arbitrary-length polylines.
-Copyright (c) 2007-2013 Oliver Kreylos
+Copyright (c) 2007-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef VISUALIZATION_TEMPLATIZED_MULTIPOLYLINE_INCLUDED
 #define VISUALIZATION_TEMPLATIZED_MULTIPOLYLINE_INCLUDED
 
+#include <vector>
 #include <GL/gl.h>
 #include <GL/GLObject.h>
 
@@ -65,7 +66,8 @@ class MultiPolyline:public GLObject
 		size_t numVertices; // Number of vertices currently in the polyline
 		Chunk* head; // Pointer to first vertex chunk used by polyline
 		Chunk* tail; // Pointer to last vertex chunk used by polyline
-		size_t tailNumSentVertices; // Number of vertices in last buffer chunk that were already sent across the pipe
+		Chunk* sendChunk; // Pointer to the first vertex chunk containing vertices that were not yet sent across the pipe
+		size_t sendChunkNumSentVertices; // Number of vertices in that chunk that were already sent across the pipe
 		size_t tailRoomLeft; // Number of vertices still available in the tail chunk
 		Vertex* nextVertex; // Pointer to next available vertex in polyline
 
@@ -73,7 +75,7 @@ class MultiPolyline:public GLObject
 		Polyline(void)
 			:numVertices(0),
 			 head(0),tail(0),
-			 tailNumSentVertices(0),
+			 sendChunk(0),sendChunkNumSentVertices(0),
 			 tailRoomLeft(0),
 			 nextVertex(0)
 			{
@@ -100,11 +102,10 @@ class MultiPolyline:public GLObject
 	unsigned int numPolylines; // Number of individual polylines
 	Cluster::MulticastPipe* pipe; // Pipe to stream polyline data in a cluster environment (owned by caller)
 	unsigned int version; // Version number of the multipolyline (incremented on each clear operation)
-	Polyline* polylines; // Array of individual polylines
-	size_t maxNumVertices; // Maximum number of vertices in any individual polyline
+	Polyline* polylines; // Array of individual polylines; individual polylines can be extended from different threads concurrently
 	
 	/* Private methods: */
-	void addNewChunk(unsigned int polylineIndex); // Adds a new chunk to the vertex buffer of the given polyline
+	void addNewChunk(unsigned int polylineIndex); // Adds a new chunk to the vertex buffer of the given polyline; only touches that polyline's state
 	
 	/* Constructors and destructors: */
 	public:
@@ -131,13 +132,11 @@ class MultiPolyline:public GLObject
 		{
 		/* Increment the vertex count: */
 		++polylines[polylineIndex].numVertices;
-		if(maxNumVertices<polylines[polylineIndex].numVertices)
-			maxNumVertices=polylines[polylineIndex].numVertices;
 		--polylines[polylineIndex].tailRoomLeft;
 		++polylines[polylineIndex].nextVertex;
 		}
 	void receive(void); // Receives multi-polyline data via multicast pipe until next flush() point
-	void flush(void); // Sends pending multi-polyline data across the multicast pipe and terminates receive() method on slaves
+	void flush(void); // Sends pending multi-polyline data across the multicast pipe and terminates receive() method on slaves; must not be called while polylines are being extended
 	unsigned int getNumPolylines(void) const // Returns the number of individual polylines
 		{
 		return numPolylines;
@@ -146,10 +145,8 @@ class MultiPolyline:public GLObject
 		{
 		return polylines[polylineIndex].numVertices;
 		}
-	size_t getMaxNumVertices(void) const // Returns the maximum number of vertices in any polyline
-		{
-		return maxNumVertices;
-		}
+	size_t getMaxNumVertices(void) const; // Returns the maximum number of vertices in any polyline
+	void getVertices(unsigned int polylineIndex,std::vector<Vertex>& vertices) const; // Appends the given polyline's vertices to the given vector, omitting vertices duplicated at chunk boundaries
 	void glRenderAction(GLContextData& contextData) const; // Renders the polyline
 	};
 
@@ -23,6 +23,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef VISUALIZATION_TEMPLATIZED_MULTISTREAMLINEEXTRACTOR_INCLUDED
 #define VISUALIZATION_TEMPLATIZED_MULTISTREAMLINEEXTRACTOR_INCLUDED
 
+#include <Templatized/CashKarpBatch.h>
+
 namespace Visualization {
 
 namespace Templatized {
@@ -56,6 +58,10 @@ class MultiStreamlineExtractor
 	
 	private:
 	typedef typename MultiStreamline::Vertex Vertex; // Type of vertices stored in streamlines
+	typedef CashKarpBatch<DataSet,VectorExtractor> Batch; // Type to integrate groups of streamlines in lock-step
+	
+	class StreamlineStepper; // Functor class to advance groups of streamlines in parallel
+	friend class StreamlineStepper;
 	
 	/* Elements: */
 	private:
@@ -63,6 +69,8 @@ class MultiStreamlineExtractor
 	VectorExtractor vectorExtractor; // Vector extractor working on data set
 	ScalarExtractor scalarExtractor; // Scalar extractor working on data set
 	Scalar epsilon; // The per-step accuracy threshold for streamline integration
+	unsigned int numThreads; // Number of threads to integrate streamlines in parallel
+	unsigned int numBatchSteps; // Number of steps each streamline advances between two checks of the continue functor
 	
 	/* Streamline extraction state: */
 	unsigned int numStreamlines; // Number of individual streamlines reflected in current state variables
@@ -70,8 +78,8 @@ class MultiStreamlineExtractor
 	MultiStreamline* multiStreamline; // Pointer to the multi-streamline representations
 	
 	/* Private methods: */
-	Vector cashKarpStep(unsigned int index,const Vector& vfp1,Scalar trialStepSize,Vector& error); // Computes a trial step vector with Cash-Karp coefficients
-	bool stepStreamline(unsigned int index); // Advances one current streamline position by one step
+	bool addStreamlineVertex(unsigned int index,Vector& vfp1); // Adds one streamline's current position as a new vertex and returns the vector field value there; returns false if the streamline left the domain
+	bool stepStreamlines(void); // Advances all valid streamlines by a batch of steps in parallel; returns true if any streamline is still valid
 	
 	/* Constructors and destructors: */
 	public:
@@ -111,6 +119,14 @@ class MultiStreamlineExtractor
 		{
 		return numStreamlines;
 		}
+	unsigned int getNumThreads(void) const // Returns the number of threads used to integrate streamlines
+		{
+		return numThreads;
+		}
+	unsigned int getNumBatchSteps(void) const // Returns the number of steps per streamline between checks of the continue functor
+		{
+		return numBatchSteps;
+		}
 	void update(const DataSet* newDataSet,const VectorExtractor& newVectorExtractor,const ScalarExtractor& newScalarExtractor) // Sets a new data set and scalar / vector extractors for subsequent multi-streamline extraction
 		{
 		dataSet=newDataSet;
@@ -118,6 +134,8 @@ class MultiStreamlineExtractor
 		scalarExtractor=newScalarExtractor;
 		}
 	void setEpsilon(Scalar newEpsilon); // Sets the integration accuracy threshold
+	void setNumThreads(unsigned int newNumThreads); // Sets the number of threads to integrate streamlines; 0 uses one thread per CPU
+	void setNumBatchSteps(unsigned int newNumBatchSteps); // Sets the number of steps per streamline between checks of the continue functor
 	void setNumStreamlines(unsigned int newNumStreamlines); // Sets number of streamlines without setting the multi-streamline itself
 	void setMultiStreamline(MultiStreamline& newMultiStreamline); // Sets the multi-streamline object
 	void initializeStreamline(unsigned int index,const Point& startPoint,const Locator& startLocator,Scalar startEpsilon); // Initializes one streamline
@@ -1,6 +1,6 @@
 /***********************************************************************
 ParticleAdvector - Generic class to advect particles in data sets.
-Copyright (c) 2009-2011 Oliver Kreylos
+Copyright (c) 2009-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -40,35 +40,77 @@ class ParticleAdvector
 	static const int dimension=DataSet::dimension; // Dimension of the data set's domain
 	typedef typename DataSet::Point Point; // Type for points in the data set's domain
 	typedef typename DataSet::Vector Vector; // Type for vectors in the data set's domain
+	typedef typename DataSet::Box Box; // Type for bounding boxes in the data set's domain
 	typedef typename DataSet::Locator Locator; // Type of data set locators
 	typedef VectorExtractorParam VectorExtractor; // Type to extract vector values from a data set (to trace the streamline)
 	typedef typename VectorExtractor::Vector VVector; // Value type of vector extractor
 	typedef ScalarExtractorParam ScalarExtractor; // Type to extract scalar values from a data set (to color the streamline)
 	typedef typename ScalarExtractor::Scalar VScalar; // Value type of scalar extractor
+	typedef GLVertex<GLfloat,1,void,0,void,GLfloat,3> Vertex; // Data type for graphical representation of particles
 	
 	private:
-	struct Particle // Structure to represent advected particles
+	static const size_t chunkSize=4096; // Number of consecutive particles processed by a thread at a time
+	
+	struct SortKey // Structure to sort particles along a space-filling curve
 		{
 		/* Elements: */
 		public:
-		Point position; // Particle position
-		Locator locator; // Locator to evaluate the data set at the particle's position
-		VScalar value; // Scalar value at particle position
-		Scalar lifeTime; // Remaining life time of the particle
+		unsigned int key; // Morton code of the particle's position
+		size_t index; // Index of the particle before sorting
+		
+		/* Methods: */
+		bool operator<(const SortKey& other) const
+			{
+			return key<other.key;
+			}
 		};
 	
-	typedef GLVertex<GLfloat,1,void,0,void,GLfloat,3> Vertex; // Data type for graphical representation of particles
+	class ChunkLocator; // Functor class to evaluate newly injected particles in parallel
+	class ChunkAdvector; // Functor class to advect particles in parallel
+	class ChunkRenderer; // Functor class to update the particles' graphical representation in parallel
+	friend class ChunkLocator;
+	friend class ChunkAdvector;
+	friend class ChunkRenderer;
 	
 	/* Elements: */
-	private:
 	const DataSet* dataSet; // Data set the streamline extractor works on
 	VectorExtractor vectorExtractor; // Vector extractor working on data set
 	ScalarExtractor scalarExtractor; // Scalar extractor working on data set
 	Scalar stepSize; // The fixed particle advection step size
 	Scalar lifeTime; // The life time for new particles
+	unsigned int numThreads; // Number of threads to advect particles
+	unsigned int sortInterval; // Number of advection steps between spatial re-sorts of the particles; 0 disables sorting
 	
-	/* Particle advection state: */
-	std::vector<Particle> particles; // Vector of currently advected particles
+	/* Particle advection state, stored as one array per particle component: */
+	size_t numParticles; // Number of currently advected particles
+	std::vector<Scalar> positions[dimension]; // Particle positions
+	std::vector<Scalar> velocities[dimension]; // Vector field values at the particle positions
+	std::vector<VScalar> values; // Scalar values at the particle positions
+	std::vector<Scalar> lifeTimes; // Remaining life times of the particles
+	std::vector<unsigned char> valids; // Flags whether particles are still inside the domain after the last operation
+	std::vector<Locator> locators; // Per-particle data set locators, traced from each particle's own previous cell
+	unsigned int numStepsSinceSort; // Number of advection steps since the last spatial re-sort
+	std::vector<Vertex> points; // Graphical representation of the current particles
+	
+	/* Private methods: */
+	Point getPosition(size_t index) const // Returns the position of the given particle
+		{
+		Point result;
+		for(int i=0;i<dimension;++i)
+			result[i]=positions[i][index];
+		return result;
+		}
+	void setPosition(size_t index,const Point& newPosition) // Sets the position of the given particle
+		{
+		for(int i=0;i<dimension;++i)
+			positions[i][index]=newPosition[i];
+		}
+	static bool locate(Locator& locator,const Point& position); // Locates the given position by tracing from the locator's current cell, and falls back to a global search if tracing fails
+	void resize(size_t newNumParticles); // Resizes all particle arrays
+	void retireParticles(size_t firstIndex); // Removes all invalid particles at or after the given index, preserving the order of the remaining ones
+	template <class ValueParam>
+	static void permute(std::vector<ValueParam>& array,const std::vector<SortKey>& keys,size_t numParticles); // Reorders the given particle array according to the given sort keys
+	void updatePoints(void); // Updates the graphical representation of the current particles
 	
 	/* Constructors and destructors: */
 	public:
@@ -80,6 +122,7 @@ class ParticleAdvector
 	~ParticleAdvector(void); // Destroys the particle advector
 	
 	/* Methods: */
+	void update(const DataSet* newDataSet,const VectorExtractor& newVectorExtractor,const ScalarExtractor& newScalarExtractor); // Sets a new data set and vector / scalar extractors for subsequent advection; removes all current particles
 	const DataSet* getDataSet(void) const // Returns the data set
 		{
 		return dataSet;
@@ -108,10 +151,28 @@ class ParticleAdvector
 		{
 		return lifeTime;
 		}
+	unsigned int getSortInterval(void) const // Returns the number of advection steps between spatial re-sorts
+		{
+		return sortInterval;
+		}
 	void setStepSize(Scalar newStepSize); // Sets the advection step size
 	void setLifeTime(Scalar newLifeTime); // Sets the life time for new particles
-	void addParticle(const Point& newPosition,const Locator& newLocator); // Adds a new particle to the advector
-	void advect(void); // Advects all current particles
+	void setNumThreads(unsigned int newNumThreads); // Sets the number of threads to advect particles; 0 uses one thread per CPU
+	void setSortInterval(unsigned int newSortInterval); // Sets the number of advection steps between spatial re-sorts; 0 disables sorting
+	size_t getNumParticles(void) const // Returns the number of currently advected particles
+		{
+		return numParticles;
+		}
+	void addParticle(const Point& newPosition); // Adds a new particle to the advector if it is inside the domain
+	void addParticles(size_t numNewParticles,const Point newPositions[]); // Adds a batch of new particles to the advector; particles outside the domain are dropped
+	void clearParticles(void); // Removes all particles from the advector
+	void sortParticles(void); // Reorders the particles along a space-filling curve to improve locality of point location
+	void advect(void); // Advects all current particles by one step, and retires particles that left the domain or expired
+	const std::vector<Vertex>& getPoints(void) const // Returns the graphical representation of the current particles
+		{
+		return points;
+		}
+	void glRenderAction(void) const; // Renders the current particles as points
 	};
 
 }
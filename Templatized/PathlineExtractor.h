@@ -0,0 +1,125 @@
+/***********************************************************************
+PathlineExtractor - Generic class to extract pathlines and streaklines
+from time-varying vector fields represented as time series, by
+integrating particles through velocities interpolated linearly in time.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_TEMPLATIZED_PATHLINEEXTRACTOR_INCLUDED
+#define VISUALIZATION_TEMPLATIZED_PATHLINEEXTRACTOR_INCLUDED
+
+#include <vector>
+
+#include <Templatized/TimeSeries.h>
+
+namespace Visualization {
+
+namespace Templatized {
+
+template <class DataSetParam,class VectorExtractorParam,class ScalarExtractorParam,class PolylineParam>
+class PathlineExtractor
+	{
+	/* Embedded classes: */
+	public:
+	typedef DataSetParam DataSet; // Type of the data sets representing individual time steps
+	typedef typename DataSet::Scalar Scalar; // Scalar type of the data set's domain, also used for simulation time
+	static const int dimension=DataSet::dimension; // Dimension of the data set's domain
+	typedef typename DataSet::Point Point; // Type for points in the data set's domain
+	typedef typename DataSet::Vector Vector; // Type for vectors in the data set's domain
+	typedef typename DataSet::Locator Locator; // Type of data set locators
+	typedef Visualization::Templatized::TimeSeries<DataSet> TimeSeries; // Type of time series providing the time steps
+	typedef VectorExtractorParam VectorExtractor; // Type to extract vector values from a data set (to trace the pathlines)
+	typedef ScalarExtractorParam ScalarExtractor; // Type to extract scalar values from a data set (to color the pathlines)
+	typedef typename ScalarExtractor::Scalar VScalar; // Value type of scalar extractor
+	typedef PolylineParam Polyline; // Type of polyline representation
+	typedef typename Polyline::Vertex Vertex; // Type of vertices stored in polylines
+	
+	private:
+	struct Particle // Structure for particles advected through a time-varying field
+		{
+		/* Elements: */
+		public:
+		Point position; // Current particle position
+		Vector velocity; // Velocity at the current position and time
+		VScalar value; // Scalar value at the current position and time
+		};
+	
+	/* Elements: */
+	TimeSeries* timeSeries; // The time series providing the vector field's time steps
+	VectorExtractor vectorExtractor; // Vector extractor working on each time step
+	ScalarExtractor scalarExtractor; // Scalar extractor working on each time step
+	Scalar stepSize; // Maximum integration step size in simulation time
+	size_t maxNumVertices; // Maximum number of vertices per extracted pathline or streakline
+	
+	/* Integration state: */
+	unsigned int interval; // Index of the time step starting the current time interval
+	Scalar intervalTimes[2]; // Simulation times bracketing the current time interval
+	Locator locators[2]; // Locators for the data sets bracketing the current time interval
+	
+	/* Private methods: */
+	void setInterval(unsigned int newInterval); // Slides the time series window to the given time interval and creates locators for it
+	bool evaluate(const Point& position,Scalar time,Vector& velocity,VScalar* value =0); // Evaluates the time-interpolated field at the given position and time inside the current interval; returns false if the position is outside the domain
+	bool step(Particle& particle,Scalar time,Scalar h); // Advances the given particle by one fourth-order Runge-Kutta step inside the current interval; returns false if the particle left the domain
+	void storeVertex(const Particle& particle,Polyline& polyline); // Appends the given particle as a vertex to the given polyline
+	
+	/* Constructors and destructors: */
+	public:
+	PathlineExtractor(TimeSeries* sTimeSeries,const VectorExtractor& sVectorExtractor,const ScalarExtractor& sScalarExtractor); // Creates a pathline extractor for the given time series and vector and scalar extractors
+	private:
+	PathlineExtractor(const PathlineExtractor& source); // Prohibit copy constructor
+	PathlineExtractor& operator=(const PathlineExtractor& source); // Prohibit assignment operator
+	
+	/* Methods: */
+	public:
+	TimeSeries* getTimeSeries(void) const // Returns the time series
+		{
+		return timeSeries;
+		}
+	const VectorExtractor& getVectorExtractor(void) const // Returns the vector extractor
+		{
+		return vectorExtractor;
+		}
+	const ScalarExtractor& getScalarExtractor(void) const // Returns the scalar extractor
+		{
+		return scalarExtractor;
+		}
+	Scalar getStepSize(void) const // Returns the maximum integration step size
+		{
+		return stepSize;
+		}
+	size_t getMaxNumVertices(void) const // Returns the maximum number of vertices per pathline or streakline
+		{
+		return maxNumVertices;
+		}
+	void update(const VectorExtractor& newVectorExtractor,const ScalarExtractor& newScalarExtractor); // Sets the vector and scalar extractors working on each time step
+	void setStepSize(Scalar newStepSize); // Sets the maximum integration step size in simulation time
+	void setMaxNumVertices(size_t newMaxNumVertices); // Sets the maximum number of vertices per pathline or streakline
+	void extractPathline(const Point& seed,Scalar startTime,Scalar endTime,Polyline& pathline); // Extracts the path of a particle released at the given seed point and start time until the given end time
+	void extractStreakline(const Point& seed,Scalar startTime,Scalar endTime,Scalar releaseInterval,Polyline& streakline); // Extracts the streakline at the given end time formed by particles released at the given seed point in regular intervals from the given start time on
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_TEMPLATIZED_PATHLINEEXTRACTOR_IMPLEMENTATION
+#include <Templatized/PathlineExtractor.icpp>
+#endif
+
+#endif
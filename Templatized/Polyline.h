@@ -1,6 +1,6 @@
 /***********************************************************************
 Polyline - Class to represent arbitrary-length polylines.
-Copyright (c) 2006-2011 Oliver Kreylos
+Copyright (c) 2006-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef VISUALIZATION_TEMPLATIZED_POLYLINE_INCLUDED
 #define VISUALIZATION_TEMPLATIZED_POLYLINE_INCLUDED
 
+#include <vector>
 #include <GL/gl.h>
 #include <GL/GLObject.h>
 
@@ -119,6 +120,7 @@ class Polyline:public GLObject
 		{
 		return numVertices;
 		}
+	void getVertices(std::vector<Vertex>& vertices) const; // Appends the polyline's vertices to the given vector, omitting vertices duplicated at chunk boundaries
 	void glRenderAction(GLContextData& contextData) const; // Renders the polyline
 	};
 
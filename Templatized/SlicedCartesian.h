@@ -1,7 +1,7 @@
 /***********************************************************************
 SlicedCartesian - Base class for vertex-centered cartesian data sets
 containing multiple scalar-valued slices.
-Copyright (c) 2006-2011 Oliver Kreylos
+Copyright (c) 2006-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -62,6 +62,15 @@ class SlicedCartesian
 	/* Low-level definitions of data set storage: */
 	typedef Misc::ArrayIndex<dimensionParam> Index; // Index type for data set storage
 	
+	class SliceStorage // Abstract base class for owners of slice arrays that were not allocated by the data set, such as memory-mapped files
+		{
+		/* Constructors and destructors: */
+		public:
+		virtual ~SliceStorage(void) // Releases the owned slice array
+			{
+			}
+		};
+	
 	/* Data set interface classes: */
 	typedef LinearIndexID VertexID;
 	
@@ -254,8 +263,10 @@ class SlicedCartesian
 	Box domainBox; // Bounding box of all vertices
 	int numSlices; // Number of scalar value slices in the data set
 	ValueScalar** slices; // Array of vertex value slices
+	SliceStorage** sliceStorages; // Array of owners of externally allocated vertex value slices; null for slices allocated by the data set
 	
 	/* Private methods: */
+	void deleteSlices(void); // Deletes all vertex value slices
 	template <class ScalarExtractorParam>
 	Vector calcVertexGradient(const Index& vertexIndex,const ScalarExtractorParam& extractor) const; // Returns gradient at a vertex based on the given scalar extractor
 	
@@ -268,6 +279,7 @@ class SlicedCartesian
 	/* Data set construction methods: */
 	void setData(const Index& sNumVertices,const Size& sCellSize,int sNumSlices,const ValueScalar* sVertexValues =0); // Sets the number of vertices and cell size of the data set; copies slice-major vertex data if pointer is not null
 	int addSlice(const ValueScalar* sSliceValues =0); // Adds another slice to the data set; copies vertex data if pointer is not null
+	int addSlice(ValueScalar* sSliceValues,SliceStorage* sSliceStorage); // Adds another slice to the data set that uses the given vertex data in place; data set adopts the storage object, which must keep the vertex data valid until it is destroyed, or the vertex data itself, which must then have been allocated with new[], if the storage object is null
 	
 	/* Low-level data access methods: */
 	const Index& getNumVertices(void) const // Returns number of vertices in the data set
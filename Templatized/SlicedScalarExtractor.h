@@ -65,6 +65,10 @@ class ScalarExtractor<ScalarParam,SlicedDataValue<SourceValueScalarParam> >
 		{
 		return sliceIndex;
 		}
+	const SourceValueScalar* getValueArray(void) const // Returns the used slice value array
+		{
+		return valueArray;
+		}
 	DestValue getValue(ptrdiff_t linearIndex) const // Extracts scalar from given linear index in slice value array
 		{
 		return DestValue(valueArray[linearIndex]);
@@ -1,7 +1,7 @@
 /***********************************************************************
 StreamsurfaceExtractor - Class to extract stream surfaces from data
 sets.
-Copyright (c) 2006-2011 Oliver Kreylos
+Copyright (c) 2006-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -23,6 +23,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef VISUALIZATION_TEMPLATIZED_STREAMSURFACEEXTRACTOR_INCLUDED
 #define VISUALIZATION_TEMPLATIZED_STREAMSURFACEEXTRACTOR_INCLUDED
 
+#include <vector>
+
 namespace Visualization {
 
 namespace Templatized {
@@ -46,38 +48,53 @@ class StreamsurfaceExtractor
 	
 	private:
 	typedef typename Streamsurface::Vertex Vertex; // Type of vertices stored in stream surface
+	typedef typename Streamsurface::Index Index; // Type of vertex indices in stream surface
 	
-	struct Streamline // Structure storing the current state of one streamline defining the surface
+	struct Streamline // Structure storing the current state of one streamline defining the surface's front
 		{
 		/* Elements: */
 		public:
-		Point pos0; // Tracing position at beginning of iteration step
+		Point pos; // Current tracing position
 		Locator locator; // Data set locator for current tracing position
-		VScalar scalar0; // Associated scalar value at the initial position
-		Vector vec0; // Vector value at the initial position
-		Point pos1; // Tracing position at end of iteration step
-		Scalar arclength; // Accumulated arc length of the streamline including the initial position
-		typename Streamsurface::Index index; // Index of most recently created vertex
-		Streamline* pred; // Pointer to previous streamline in the surface
-		Streamline* succ; // Pointer to next streamline in the surface
-		bool connectPred; // Flag whether this streamline is connected to the previous one
-		bool connectSucc; // Flag whether this streamline is connected to the next one
+		Vector vec; // Vector value at the current tracing position
+		VScalar scalar; // Auxiliary scalar value at the current tracing position
+		Index index; // Index of most recently created vertex
+		bool valid; // Flag whether the current tracing position is inside the data set's domain
+		bool merge; // Flag whether the streamline is merged into its predecessor during the next step
+		bool connectSucc; // Flag whether this streamline is connected to the next one in the front; for the last streamline, whether the front is closed
 		};
 	
+	class FrontStepper; // Functor class to advance the front's streamlines in parallel
+	friend class FrontStepper;
+	
 	/* Elements: */
-	private:
 	const DataSet* dataSet; // Data set the isosurface extractor works on
 	VectorExtractor vectorExtractor; // Vector extractor working on data set
 	ScalarExtractor scalarExtractor; // Scalar extractor working on data set
 	Scalar stepSize; // Fixed step size for streamline integration
+	Scalar maxDistance; // Distance between neighboring streamlines above which a new streamline is inserted; 0 derives it from the seed spacing
+	Scalar minDistance; // Distance between neighboring streamlines below which streamlines are merged; 0 derives it from the seed spacing
+	size_t maxNumFrontStreamlines; // Maximum number of streamlines in the front
+	unsigned int numThreads; // Number of threads to advance the front in parallel
+	int numStreamlines; // Number of initial streamlines
+	bool closed; // Flag whether the initial streamlines form a closed loop
+	std::vector<Streamline> seeds; // Initial streamlines
 	
 	/* Streamline extraction state: */
-	Streamline* streamlineHead; // Pointer to one of the streamlines defining the surface
 	Streamsurface* streamsurface; // Pointer to the stream surface representation
+	Scalar currentMaxDistance,currentMinDistance; // Refinement thresholds for the current stream surface
+	std::vector<Streamline> front; // Current front of streamlines in order
+	std::vector<Streamline> nextFront; // Front of streamlines under construction
+	std::vector<Index> nextIndices; // Vertex indices of the new front's streamlines, indexed by their position in the old front
 	
 	/* Private methods: */
-	bool stepStreamline(Streamline& s); // Advances the given streamline by one step
-	bool stepStreamsurface(void); // Advances all current streamline positions by one step and adds a new layer to the stream surface
+	bool evaluate(Streamline& s) const; // Calculates the vector and scalar values at the streamline's current position; returns false if the position is outside the domain
+	bool stepStreamline(Streamline& s) const; // Advances the given streamline by one step
+	Index addVertex(const Streamline& s,const Point& predPos,const Point& succPos); // Adds a stream surface vertex for the given streamline and its neighbors' positions
+	size_t findFrontStart(void) const; // Returns the index of the first streamline in the current front following a break in the front
+	void rebuildFront(size_t start); // Replaces the current front by its valid and unmerged streamlines starting at the given index, and adds their vertices to the stream surface
+	void refineFront(void); // Inserts streamlines between diverging neighbors and marks converging streamlines for merging
+	bool stepStreamsurface(void); // Advances the front by one step and adds a new layer to the stream surface; returns false if no connected streamlines are left
 	
 	/* Constructors and destructors: */
 	public:
@@ -109,16 +126,33 @@ class StreamsurfaceExtractor
 		{
 		return scalarExtractor;
 		}
+	void update(const DataSet* newDataSet,const VectorExtractor& newVectorExtractor,const ScalarExtractor& newScalarExtractor) // Sets a new data set and scalar / vector extractors for subsequent stream surface extraction
+		{
+		dataSet=newDataSet;
+		vectorExtractor=newVectorExtractor;
+		scalarExtractor=newScalarExtractor;
+		}
 	Scalar getStepSize(void) const // Returns the integration step size
 		{
 		return stepSize;
 		}
 	void setStepSize(Scalar newStepSize); // Sets the integration step size
-	int getNumStreamlines(void) const // Returns the number of streamlines extracted in parallel
+	Scalar getMaxDistance(void) const // Returns the distance above which new streamlines are inserted
+		{
+		return maxDistance;
+		}
+	Scalar getMinDistance(void) const // Returns the distance below which streamlines are merged
+		{
+		return minDistance;
+		}
+	void setRefinementDistances(Scalar newMinDistance,Scalar newMaxDistance); // Sets the distances at which streamlines are merged and inserted; 0 derives them from the seed spacing
+	void setMaxNumFrontStreamlines(size_t newMaxNumFrontStreamlines); // Sets the maximum number of streamlines in the front
+	void setNumThreads(unsigned int newNumThreads); // Sets the number of threads to advance the front; 0 uses one thread per CPU
+	int getNumStreamlines(void) const // Returns the number of initial streamlines
 		{
 		return numStreamlines;
 		}
-	void setNumStreamlines(int newNumStreamlines); // Sets the number of streamlines extracted in parallel
+	void setNumStreamlines(int newNumStreamlines); // Sets the number of initial streamlines
 	void setClosed(bool newClosed); // Sets if the stream surface is open or a closed tube
 	void initializeStreamline(int index,const Point& startPoint,const Locator& startLocator); // Initializes one streamline
 	void extractStreamsurface(Streamsurface& newStreamsurface); // Extracts stream surface for the previously initialized positions and locators
@@ -0,0 +1,118 @@
+/***********************************************************************
+TimeSeries - Generic class to represent a time-varying data set as a
+sequence of time steps of which only a sliding window is kept in memory,
+with the next time steps being loaded by a background thread.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_TEMPLATIZED_TIMESERIES_INCLUDED
+#define VISUALIZATION_TEMPLATIZED_TIMESERIES_INCLUDED
+
+#include <vector>
+#include <Threads/Mutex.h>
+#include <Threads/Cond.h>
+#include <Threads/Thread.h>
+
+namespace Visualization {
+
+namespace Templatized {
+
+template <class DataSetParam>
+class TimeSeries
+	{
+	/* Embedded classes: */
+	public:
+	typedef DataSetParam DataSet; // Type of the data sets representing individual time steps
+	typedef typename DataSet::Scalar Scalar; // Scalar type of the data set's domain, also used for simulation time
+	
+	class Loader // Abstract base class for objects loading individual time steps
+		{
+		/* Constructors and destructors: */
+		public:
+		virtual ~Loader(void)
+			{
+			}
+		
+		/* Methods: */
+		virtual DataSet* loadTimeStep(unsigned int timeStepIndex) const =0; // Returns a newly allocated data set for the given time step; called concurrently from the background loader threads of all time series sharing the loader
+		};
+	
+	private:
+	struct Slot // Structure for memory-resident time steps
+		{
+		/* Elements: */
+		public:
+		unsigned int timeStepIndex; // Index of the time step held in the slot, or ~0U if the slot is empty
+		DataSet* dataSet; // Data set of the time step, or 0 while the time step is being loaded
+		bool failed; // Flag whether loading the time step failed
+		};
+	
+	/* Elements: */
+	const Loader& loader; // Object loading time steps
+	std::vector<Scalar> times; // Simulation times of all time steps in increasing order
+	std::vector<Slot> slots; // Slots holding the time steps of the sliding window
+	Threads::Mutex windowMutex; // Mutex protecting the sliding window state
+	Threads::Cond windowCond; // Condition variable signalled when the window slides or a time step finished loading
+	unsigned int windowStart; // Index of the first time step of the sliding window
+	bool terminate; // Flag to shut down the background loader thread
+	Threads::Thread loaderThread; // Background thread loading the time steps of the sliding window
+	
+	/* Private methods: */
+	bool isInWindow(unsigned int timeStepIndex) const // Returns true if the given time step is inside the sliding window
+		{
+		return timeStepIndex>=windowStart&&timeStepIndex<windowStart+slots.size()&&timeStepIndex<times.size();
+		}
+	void* loaderThreadMethod(void); // Method loading missing time steps of the sliding window in order
+	
+	/* Constructors and destructors: */
+	public:
+	TimeSeries(const Loader& sLoader,const std::vector<Scalar>& sTimes,unsigned int windowSize =3); // Creates a time series for the given loader and time step times with the given number of memory-resident time steps; loader must outlive the time series
+	private:
+	TimeSeries(const TimeSeries& source); // Prohibit copy constructor
+	TimeSeries& operator=(const TimeSeries& source); // Prohibit assignment operator
+	public:
+	~TimeSeries(void); // Stops loading and destroys all memory-resident time steps
+	
+	/* Methods: */
+	unsigned int getNumTimeSteps(void) const // Returns the number of time steps
+		{
+		return (unsigned int)(times.size());
+		}
+	Scalar getTime(unsigned int timeStepIndex) const // Returns the simulation time of the given time step
+		{
+		return times[timeStepIndex];
+		}
+	unsigned int getWindowSize(void) const // Returns the maximum number of memory-resident time steps
+		{
+		return (unsigned int)(slots.size());
+		}
+	unsigned int findInterval(Scalar time) const; // Returns the index of the time step starting the time interval containing the given time, clamped to the valid intervals
+	void setWindowStart(unsigned int newWindowStart); // Slides the window to start at the given time step; time steps before it are evicted and missing time steps are loaded in the background
+	const DataSet* getTimeStep(unsigned int timeStepIndex); // Returns the given time step, which must be inside the sliding window; blocks until the time step is loaded; the result remains valid until the window slides past it
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_TEMPLATIZED_TIMESERIES_IMPLEMENTATION
+#include <Templatized/TimeSeries.icpp>
+#endif
+
+#endif
@@ -1,7 +1,7 @@
 /***********************************************************************
 VolumeRenderingSampler - Helper class to create shader- or texture-based
 volume renderers for arbitrary data set types.
-Copyright (c) 2009-2011 Oliver Kreylos
+Copyright (c) 2009-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -24,6 +24,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #define VISUALIZATION_TEMPLATIZED_VOLUMERENDERINGSAMPLER_INCLUDED
 
 /* Forward declarations: */
+class BrickedVolume;
 namespace Cluster {
 class MulticastPipe;
 }
@@ -48,24 +49,43 @@ class VolumeRenderingSampler
 	typedef typename DataSet::Box Box; // Type for domain boxes
 	typedef typename Box::Size Size; // Type for domain sizes
 	
-	/* Elements: */
 	private:
+	template <class ScalarExtractorParam,class VoxelParam>
+	class SlabSampler; // Functor class to sample slabs of one or more voxel blocks in parallel
+	template <class ScalarExtractorParam>
+	class BrickSampler; // Functor class to sample groups of bricks of a bricked volume in parallel
+	
+	/* Elements: */
 	const DataSet& dataSet; // The data set from which the sampler samples
-	unsigned int samplerSize[3]; // Optimal size of the resulting Cartesian volume
+	bool adaptive; // Flag whether the sampler adapts the resolution of bricked volumes to the data set's local cell size
+	unsigned int samplerSize[3]; // Optimal size of the resulting Cartesian volume; finest resolution for adaptive sampling
 	Point samplerOrigin; // Origin point of the resulting Cartesian volume
 	Size samplerCellSize; // Cell size of the resulting Cartesian volume
+	Scalar averageCellSize; // The data set's average cell size
+	
+	/* Private methods: */
+	Scalar calcLocalCellSize(typename DataSet::Locator& locator,const Point& position) const; // Returns the size of the smallest edge of the cell containing the given position, or zero if the position is outside the data set
+	unsigned int calcBrickLevel(typename DataSet::Locator& locator,const BrickedVolume& volume,unsigned int brickIndex) const; // Returns the coarsest resolution level that resolves the data set's cells inside the given brick
 	
 	/* Constructors and destructors: */
 	public:
-	VolumeRenderingSampler(const DataSet& sDataSet); // Creates a sampler for the given data set
+	VolumeRenderingSampler(const DataSet& sDataSet,bool sAdaptive =false); // Creates a sampler for the given data set; adaptive samplers choose their resolution from the smallest cells instead of the average cell
 	
 	/* Methods: */
+	bool isAdaptive(void) const // Returns true if the sampler creates multi-resolution bricked volumes
+		{
+		return adaptive;
+		}
 	const unsigned int* getSamplerSize(void) const // Returns the size of the resulting Cartesian volume
 		{
 		return samplerSize;
 		}
 	template <class ScalarExtractorParam,class VoxelParam>
 	void sample(const ScalarExtractorParam& scalarExtractor,typename ScalarExtractorParam::Scalar minValue,typename ScalarExtractorParam::Scalar maxValue,typename ScalarExtractorParam::Scalar outOfDomainValue,VoxelParam* voxels,const ptrdiff_t voxelStrides[3],Cluster::MulticastPipe* pipe,float percentageScale,float percentageOffset,Visualization::Abstract::Algorithm* algorithm) const; // Samples scalar values from the given scalar extractor into the given voxel block
+	template <class ScalarExtractorParam,class VoxelParam>
+	void sampleChannels(int numChannels,const ScalarExtractorParam* const scalarExtractors[],const typename ScalarExtractorParam::Scalar minValues[],const typename ScalarExtractorParam::Scalar maxValues[],const typename ScalarExtractorParam::Scalar outOfDomainValues[],VoxelParam* const voxels[],const ptrdiff_t voxelStrides[3],Cluster::MulticastPipe* pipe,float percentageScale,float percentageOffset,Visualization::Abstract::Algorithm* algorithm) const; // Samples scalar values from several scalar extractors into voxel blocks sharing the same strides, locating each grid point only once
+	template <class ScalarExtractorParam>
+	void sampleBricks(const ScalarExtractorParam& scalarExtractor,typename ScalarExtractorParam::Scalar minValue,typename ScalarExtractorParam::Scalar maxValue,typename ScalarExtractorParam::Scalar outOfDomainValue,BrickedVolume& volume,Cluster::MulticastPipe* pipe,float percentageScale,float percentageOffset,Visualization::Abstract::Algorithm* algorithm) const; // Samples scalar values from the given scalar extractor into the given bricked volume
 	};
 
 }
@@ -26,6 +26,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Templatized/VolumeRenderingSampler.h>
 
 /* Forward declarations: */
+class BrickedVolume;
 namespace Cluster {
 class MulticastPipe;
 }
@@ -63,15 +64,23 @@ class VolumeRenderingSampler<Cartesian<ScalarParam,3,ValueParam> >
 	
 	/* Constructors and destructors: */
 	public:
-	VolumeRenderingSampler(const DataSet& sDataSet); // Creates a sampler for the given data set
+	VolumeRenderingSampler(const DataSet& sDataSet,bool sAdaptive =false); // Creates a sampler for the given data set; Cartesian data sets are always sampled at their native resolution
 	
 	/* Methods: */
+	bool isAdaptive(void) const // Returns true if the sampler creates multi-resolution bricked volumes
+		{
+		return false;
+		}
 	const unsigned int* getSamplerSize(void) const // Returns the size of the Cartesian volume
 		{
 		return samplerSize;
 		}
 	template <class ScalarExtractorParam,class VoxelParam>
 	void sample(const ScalarExtractorParam& scalarExtractor,typename ScalarExtractorParam::Scalar minValue,typename ScalarExtractorParam::Scalar maxValue,typename ScalarExtractorParam::Scalar outOfDomainValue,VoxelParam* voxels,const ptrdiff_t voxelStrides[3],Cluster::MulticastPipe* pipe,float percentageScale,float percentageOffset,Visualization::Abstract::Algorithm* algorithm) const; // Samples scalar values from the given scalar extractor into the given voxel block
+	template <class ScalarExtractorParam,class VoxelParam>
+	void sampleChannels(int numChannels,const ScalarExtractorParam* const scalarExtractors[],const typename ScalarExtractorParam::Scalar minValues[],const typename ScalarExtractorParam::Scalar maxValues[],const typename ScalarExtractorParam::Scalar outOfDomainValues[],VoxelParam* const voxels[],const ptrdiff_t voxelStrides[3],Cluster::MulticastPipe* pipe,float percentageScale,float percentageOffset,Visualization::Abstract::Algorithm* algorithm) const; // Samples scalar values from several scalar extractors into voxel blocks sharing the same strides in a single pass
+	template <class ScalarExtractorParam>
+	void sampleBricks(const ScalarExtractorParam& scalarExtractor,typename ScalarExtractorParam::Scalar minValue,typename ScalarExtractorParam::Scalar maxValue,typename ScalarExtractorParam::Scalar outOfDomainValue,BrickedVolume& volume,Cluster::MulticastPipe* pipe,float percentageScale,float percentageOffset,Visualization::Abstract::Algorithm* algorithm) const; // Samples scalar values from the given scalar extractor into the given bricked volume
 	};
 
 template <class ScalarParam,class ValueScalarParam>
@@ -92,15 +101,23 @@ class VolumeRenderingSampler<SlicedCartesian<ScalarParam,3,ValueScalarParam> >
 	
 	/* Constructors and destructors: */
 	public:
-	VolumeRenderingSampler(const DataSet& sDataSet); // Creates a sampler for the given data set
+	VolumeRenderingSampler(const DataSet& sDataSet,bool sAdaptive =false); // Creates a sampler for the given data set; Cartesian data sets are always sampled at their native resolution
 	
 	/* Methods: */
+	bool isAdaptive(void) const // Returns true if the sampler creates multi-resolution bricked volumes
+		{
+		return false;
+		}
 	const unsigned int* getSamplerSize(void) const // Returns the size of the Cartesian volume
 		{
 		return samplerSize;
 		}
 	template <class ScalarExtractorParam,class VoxelParam>
 	void sample(const ScalarExtractorParam& scalarExtractor,typename ScalarExtractorParam::Scalar minValue,typename ScalarExtractorParam::Scalar maxValue,typename ScalarExtractorParam::Scalar outOfDomainValue,VoxelParam* voxels,const ptrdiff_t voxelStrides[3],Cluster::MulticastPipe* pipe,float percentageScale,float percentageOffset,Visualization::Abstract::Algorithm* algorithm) const; // Samples scalar values from the given scalar extractor into the given voxel block
+	template <class ScalarExtractorParam,class VoxelParam>
+	void sampleChannels(int numChannels,const ScalarExtractorParam* const scalarExtractors[],const typename ScalarExtractorParam::Scalar minValues[],const typename ScalarExtractorParam::Scalar maxValues[],const typename ScalarExtractorParam::Scalar outOfDomainValues[],VoxelParam* const voxels[],const ptrdiff_t voxelStrides[3],Cluster::MulticastPipe* pipe,float percentageScale,float percentageOffset,Visualization::Abstract::Algorithm* algorithm) const; // Samples scalar values from several scalar extractors into voxel blocks sharing the same strides in a single pass
+	template <class ScalarExtractorParam>
+	void sampleBricks(const ScalarExtractorParam& scalarExtractor,typename ScalarExtractorParam::Scalar minValue,typename ScalarExtractorParam::Scalar maxValue,typename ScalarExtractorParam::Scalar outOfDomainValue,BrickedVolume& volume,Cluster::MulticastPipe* pipe,float percentageScale,float percentageOffset,Visualization::Abstract::Algorithm* algorithm) const; // Samples scalar values from the given scalar extractor into the given bricked volume
 	};
 
 }
@@ -0,0 +1,293 @@
+/***********************************************************************
+VoxelConverter - Helper functions to convert arrays of scalar values
+stored in Cartesian order into 8-bit voxel blocks for volume rendering,
+using SIMD instructions where available and multiple threads.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_TEMPLATIZED_VOXELCONVERTER_INCLUDED
+#define VISUALIZATION_TEMPLATIZED_VOXELCONVERTER_INCLUDED
+
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <ParallelFor.h>
+
+namespace Visualization {
+
+namespace Templatized {
+
+/*****************************************************************
+Functions to convert a span of source values to voxels by applying
+value*factor+offset, clamping to [0, 255], and truncating:
+*****************************************************************/
+
+template <class SourceParam,class VoxelParam>
+inline void convertVoxelSpan(const SourceParam* source,size_t numValues,VoxelParam* voxels,float factor,float offset)
+	{
+	for(size_t i=0;i<numValues;++i)
+		{
+		float value=float(source[i])*factor+offset;
+		if(!(value>0.0f)) // Also catches NaN values
+			value=0.0f;
+		if(value>255.0f)
+			value=255.0f;
+		voxels[i]=VoxelParam(value);
+		}
+	}
+
+#ifdef __SSE2__
+
+inline __m128i convertVoxelQuads(__m128 v0,__m128 v1,__m128 v2,__m128 v3,__m128 factor,__m128 offset,__m128 low,__m128 high) // Converts sixteen float values to sixteen packed voxels
+	{
+	/* Scale, offset, and clamp the values; max returns its second operand for NaN values: */
+	__m128i i0=_mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(v0,factor),offset),low),high));
+	__m128i i1=_mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(v1,factor),offset),low),high));
+	__m128i i2=_mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(v2,factor),offset),low),high));
+	__m128i i3=_mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(v3,factor),offset),low),high));
+	
+	/* Pack the 32-bit integers down to 8 bits: */
+	return _mm_packus_epi16(_mm_packs_epi32(i0,i1),_mm_packs_epi32(i2,i3));
+	}
+
+inline void convertVoxelSpan(const float* source,size_t numValues,unsigned char* voxels,float factor,float offset)
+	{
+	__m128 f=_mm_set1_ps(factor);
+	__m128 o=_mm_set1_ps(offset);
+	__m128 low=_mm_setzero_ps();
+	__m128 high=_mm_set1_ps(255.0f);
+	size_t i;
+	for(i=0;i+16<=numValues;i+=16)
+		{
+		__m128i result=convertVoxelQuads(_mm_loadu_ps(source+i),_mm_loadu_ps(source+i+4),_mm_loadu_ps(source+i+8),_mm_loadu_ps(source+i+12),f,o,low,high);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(voxels+i),result);
+		}
+	
+	/* Convert the remaining values: */
+	convertVoxelSpan<float,unsigned char>(source+i,numValues-i,voxels+i,factor,offset);
+	}
+
+inline void convertVoxelSpan(const unsigned short* source,size_t numValues,unsigned char* voxels,float factor,float offset)
+	{
+	__m128 f=_mm_set1_ps(factor);
+	__m128 o=_mm_set1_ps(offset);
+	__m128 low=_mm_setzero_ps();
+	__m128 high=_mm_set1_ps(255.0f);
+	__m128i zero=_mm_setzero_si128();
+	size_t i;
+	for(i=0;i+16<=numValues;i+=16)
+		{
+		/* Widen the 16-bit values to 32-bit floats: */
+		__m128i s0=_mm_loadu_si128(reinterpret_cast<const __m128i*>(source+i));
+		__m128i s1=_mm_loadu_si128(reinterpret_cast<const __m128i*>(source+i+8));
+		__m128 v0=_mm_cvtepi32_ps(_mm_unpacklo_epi16(s0,zero));
+		__m128 v1=_mm_cvtepi32_ps(_mm_unpackhi_epi16(s0,zero));
+		__m128 v2=_mm_cvtepi32_ps(_mm_unpacklo_epi16(s1,zero));
+		__m128 v3=_mm_cvtepi32_ps(_mm_unpackhi_epi16(s1,zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(voxels+i),convertVoxelQuads(v0,v1,v2,v3,f,o,low,high));
+		}
+	
+	/* Convert the remaining values: */
+	convertVoxelSpan<unsigned short,unsigned char>(source+i,numValues-i,voxels+i,factor,offset);
+	}
+
+#endif
+
+inline void convertVoxelSpan(const unsigned char* source,size_t numValues,unsigned char* voxels,float factor,float offset)
+	{
+	if(factor==1.0f&&offset>=0.0f&&offset<1.0f)
+		{
+		/* The conversion is the identity; copy the values: */
+		memcpy(voxels,source,numValues);
+		return;
+		}
+	
+	#ifdef __SSE2__
+	__m128 f=_mm_set1_ps(factor);
+	__m128 o=_mm_set1_ps(offset);
+	__m128 low=_mm_setzero_ps();
+	__m128 high=_mm_set1_ps(255.0f);
+	__m128i zero=_mm_setzero_si128();
+	size_t i;
+	for(i=0;i+16<=numValues;i+=16)
+		{
+		/* Widen the 8-bit values to 32-bit floats: */
+		__m128i s=_mm_loadu_si128(reinterpret_cast<const __m128i*>(source+i));
+		__m128i s0=_mm_unpacklo_epi8(s,zero);
+		__m128i s1=_mm_unpackhi_epi8(s,zero);
+		__m128 v0=_mm_cvtepi32_ps(_mm_unpacklo_epi16(s0,zero));
+		__m128 v1=_mm_cvtepi32_ps(_mm_unpackhi_epi16(s0,zero));
+		__m128 v2=_mm_cvtepi32_ps(_mm_unpacklo_epi16(s1,zero));
+		__m128 v3=_mm_cvtepi32_ps(_mm_unpackhi_epi16(s1,zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(voxels+i),convertVoxelQuads(v0,v1,v2,v3,f,o,low,high));
+		}
+	
+	/* Convert the remaining values: */
+	convertVoxelSpan<unsigned char,unsigned char>(source+i,numValues-i,voxels+i,factor,offset);
+	#else
+	convertVoxelSpan<unsigned char,unsigned char>(source,numValues,voxels,factor,offset);
+	#endif
+	}
+
+/***********************************************************************
+Functor classes to convert one or more Cartesian value arrays, with the
+last index varying fastest, into voxel blocks sharing the same strides
+in parallel:
+***********************************************************************/
+
+template <class SourceParam,class VoxelParam>
+class VoxelRowConverter // Converts entire rows of values for voxel blocks whose last dimension is contiguous
+	{
+	/* Elements: */
+	private:
+	int numChannels; // Number of converted value arrays
+	const SourceParam* const* sources; // Pointers to the first value of the converted slab in each value array
+	size_t rowLength; // Number of values in each row
+	VoxelParam* const* voxels; // Pointers to the first voxel of the converted slab in each voxel block
+	ptrdiff_t rowStride; // Voxel stride between rows
+	const float* factors; // Conversion factors for each value array
+	const float* offsets; // Conversion offsets for each value array
+	
+	/* Constructors and destructors: */
+	public:
+	VoxelRowConverter(int sNumChannels,const SourceParam* const sSources[],size_t sRowLength,VoxelParam* const sVoxels[],ptrdiff_t sRowStride,const float sFactors[],const float sOffsets[])
+		:numChannels(sNumChannels),sources(sSources),rowLength(sRowLength),voxels(sVoxels),rowStride(sRowStride),factors(sFactors),offsets(sOffsets)
+		{
+		}
+	
+	/* Methods: */
+	void operator()(size_t row) const
+		{
+		for(int channel=0;channel<numChannels;++channel)
+			convertVoxelSpan(sources[channel]+row*rowLength,rowLength,voxels[channel]+ptrdiff_t(row)*rowStride,factors[channel],offsets[channel]);
+		}
+	};
+
+template <class SourceParam,class VoxelParam>
+class VoxelTileConverter // Converts short runs of values and scatters them for voxel blocks whose last dimension is not contiguous
+	{
+	/* Embedded classes: */
+	public:
+	static const size_t tileSize=16; // Number of values converted per run
+	
+	/* Elements: */
+	private:
+	int numChannels; // Number of converted value arrays
+	const SourceParam* const* sources; // Pointers to the first value of the converted tile column in each value array
+	const int* numValues; // Size of the value arrays
+	size_t runLength; // Number of values in each run
+	VoxelParam* const* voxels; // Pointers to the first voxel of the converted tile column in each voxel block
+	const ptrdiff_t* voxelStrides; // Voxel block strides
+	const float* factors; // Conversion factors for each value array
+	const float* offsets; // Conversion offsets for each value array
+	
+	/* Constructors and destructors: */
+	public:
+	VoxelTileConverter(int sNumChannels,const SourceParam* const sSources[],const int sNumValues[3],size_t sRunLength,VoxelParam* const sVoxels[],const ptrdiff_t sVoxelStrides[3],const float sFactors[],const float sOffsets[])
+		:numChannels(sNumChannels),sources(sSources),numValues(sNumValues),runLength(sRunLength),voxels(sVoxels),voxelStrides(sVoxelStrides),factors(sFactors),offsets(sOffsets)
+		{
+		}
+	
+	/* Methods: */
+	void operator()(size_t index1) const
+		{
+		/* Convert one run per value of the first index and channel and scatter it into the voxel blocks; interleaved voxel blocks share cache lines between channels: */
+		VoxelParam run[tileSize];
+		for(int index0=0;index0<numValues[0];++index0)
+			{
+			size_t sourceOffset=(size_t(index0)*size_t(numValues[1])+index1)*size_t(numValues[2]);
+			ptrdiff_t voxelOffset=ptrdiff_t(index0)*voxelStrides[0]+ptrdiff_t(index1)*voxelStrides[1];
+			for(int channel=0;channel<numChannels;++channel)
+				{
+				convertVoxelSpan(sources[channel]+sourceOffset,runLength,run,factors[channel],offsets[channel]);
+				VoxelParam* vPtr=voxels[channel]+voxelOffset;
+				for(size_t i=0;i<runLength;++i,vPtr+=voxelStrides[2])
+					*vPtr=run[i];
+				}
+			}
+		}
+	};
+
+/***********************************************************************
+Functions to convert entire Cartesian value arrays, with the last index
+varying fastest, into voxel blocks sharing the same strides; report
+progress after each slab:
+***********************************************************************/
+
+template <class SourceParam,class VoxelParam,class AlgorithmParam>
+inline void convertVoxelChannels(int numChannels,const SourceParam* const sources[],const int numValues[3],const float factors[],const float offsets[],VoxelParam* const voxels[],const ptrdiff_t voxelStrides[3],float percentageScale,float percentageOffset,AlgorithmParam* algorithm)
+	{
+	std::vector<const SourceParam*> slabSources(numChannels);
+	std::vector<VoxelParam*> slabVoxels(numChannels);
+	size_t sliceSize=size_t(numValues[1])*size_t(numValues[2]);
+	if(voxelStrides[2]==1)
+		{
+		/* Convert entire rows directly into the voxel blocks, one slab of the first index at a time: */
+		for(int index0=0;index0<numValues[0];++index0)
+			{
+			for(int channel=0;channel<numChannels;++channel)
+				{
+				slabSources[channel]=sources[channel]+size_t(index0)*sliceSize;
+				slabVoxels[channel]=voxels[channel]+ptrdiff_t(index0)*voxelStrides[0];
+				}
+			VoxelRowConverter<SourceParam,VoxelParam> converter(numChannels,&slabSources[0],size_t(numValues[2]),&slabVoxels[0],voxelStrides[1],factors,offsets);
+			parallelFor(size_t(numValues[1]),converter);
+			
+			/* Update the busy dialog: */
+			algorithm->callBusyFunction(float(index0+1)*percentageScale/float(numValues[0])+percentageOffset);
+			}
+		}
+	else
+		{
+		/* Convert tiles of short runs along the last index, one slab of runs at a time, to keep voxel block writes coherent: */
+		const size_t tileSize=VoxelTileConverter<SourceParam,VoxelParam>::tileSize;
+		for(size_t index2=0;index2<size_t(numValues[2]);index2+=tileSize)
+			{
+			size_t runLength=size_t(numValues[2])-index2;
+			if(runLength>tileSize)
+				runLength=tileSize;
+			for(int channel=0;channel<numChannels;++channel)
+				{
+				slabSources[channel]=sources[channel]+index2;
+				slabVoxels[channel]=voxels[channel]+ptrdiff_t(index2)*voxelStrides[2];
+				}
+			VoxelTileConverter<SourceParam,VoxelParam> converter(numChannels,&slabSources[0],numValues,runLength,&slabVoxels[0],voxelStrides,factors,offsets);
+			parallelFor(size_t(numValues[1]),converter);
+			
+			/* Update the busy dialog: */
+			algorithm->callBusyFunction(float(index2+runLength)*percentageScale/float(numValues[2])+percentageOffset);
+			}
+		}
+	}
+
+template <class SourceParam,class VoxelParam,class AlgorithmParam>
+inline void convertVoxels(const SourceParam* source,const int numValues[3],float factor,float offset,VoxelParam* voxels,const ptrdiff_t voxelStrides[3],float percentageScale,float percentageOffset,AlgorithmParam* algorithm)
+	{
+	convertVoxelChannels(1,&source,numValues,&factor,&offset,&voxels,voxelStrides,percentageScale,percentageOffset,algorithm);
+	}
+
+}
+
+}
+
+#endif
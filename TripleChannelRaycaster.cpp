@@ -38,10 +38,15 @@ Methods of class TripleChannelRaycaster::DataItem:
 TripleChannelRaycaster::DataItem::DataItem(void)
 	:haveFloatTextures(GLARBTextureFloat::isSupported()),
 	 volumeTextureID(0),volumeTextureVersion(0),
-	 volumeSamplerLoc(-1),channelEnabledsLoc(-1),colorMapSamplersLoc(-1)
+	 volumeSamplerLoc(-1),channelEnabledsLoc(-1),colorMapSamplersLoc(-1),
+	 preintegratedLoc(-1),preintegratedSamplersLoc(-1)
 	{
 	for(int channel=0;channel<3;++channel)
+		{
 		colorMapTextureIDs[channel]=0;
+		preintegratedTextureIDs[channel]=0;
+		preintegratedTextureVersions[channel]=0;
+		}
 	
 	/* Initialize all required OpenGL extensions: */
 	GLARBMultitexture::initExtension();
@@ -54,6 +59,9 @@ TripleChannelRaycaster::DataItem::DataItem(void)
 	
 	/* Create the color map texture objects: */
 	glGenTextures(3,colorMapTextureIDs);
+	
+	/* Create the pre-integrated color map texture objects: */
+	glGenTextures(3,preintegratedTextureIDs);
 	}
 
 TripleChannelRaycaster::DataItem::~DataItem(void)
@@ -63,6 +71,9 @@ TripleChannelRaycaster::DataItem::~DataItem(void)
 	
 	/* Destroy the color map texture objects: */
 	glDeleteTextures(3,colorMapTextureIDs);
+	
+	/* Destroy the pre-integrated color map texture objects: */
+	glDeleteTextures(3,preintegratedTextureIDs);
 	}
 
 /***************************************
@@ -96,6 +107,17 @@ void TripleChannelRaycaster::initDataItem(Raycaster::DataItem* dataItem) const
 		glTexParameteri(GL_TEXTURE_1D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
 		}
 	glBindTexture(GL_TEXTURE_1D,0);
+	
+	/* Create the pre-integrated color map textures: */
+	for(int channel=0;channel<3;++channel)
+		{
+		glBindTexture(GL_TEXTURE_2D,myDataItem->preintegratedTextureIDs[channel]);
+		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
+		}
+	glBindTexture(GL_TEXTURE_2D,0);
 	}
 
 void TripleChannelRaycaster::initShader(Raycaster::DataItem* dataItem) const
@@ -110,6 +132,8 @@ void TripleChannelRaycaster::initShader(Raycaster::DataItem* dataItem) const
 	myDataItem->volumeSamplerLoc=myDataItem->shader.getUniformLocation("volumeSampler");
 	myDataItem->channelEnabledsLoc=myDataItem->shader.getUniformLocation("channelEnableds");
 	myDataItem->colorMapSamplersLoc=myDataItem->shader.getUniformLocation("colorMapSamplers");
+	myDataItem->preintegratedLoc=myDataItem->shader.getUniformLocation("preintegrated");
+	myDataItem->preintegratedSamplersLoc=myDataItem->shader.getUniformLocation("preintegratedSamplers");
 	}
 
 void TripleChannelRaycaster::bindShader(const Raycaster::PTransform& pmv,const Raycaster::PTransform& mv,Raycaster::DataItem* dataItem) const
@@ -137,6 +161,7 @@ void TripleChannelRaycaster::bindShader(const Raycaster::PTransform& pmv,const R
 	
 	/* Bind the color map textures: */
 	GLint colorMapSamplers[3];
+	GLint preintegratedSamplers[3];
 	GLint channelEnabledsValues[3];
 	for(int channel=0;channel<3;++channel)
 		{
@@ -145,15 +170,30 @@ void TripleChannelRaycaster::bindShader(const Raycaster::PTransform& pmv,const R
 		glActiveTextureARB(GL_TEXTURE2_ARB+channel);
 		glBindTexture(GL_TEXTURE_1D,myDataItem->colorMapTextureIDs[channel]);
 		colorMapSamplers[channel]=2+channel;
-
-		/* Create the stepsize-adjusted colormap with pre-multiplied alpha: */
-		GLColorMap adjustedColorMap(*colorMaps[channel]);
-		adjustedColorMap.changeTransparency(stepSize*transparencyGammas[channel]);
-		adjustedColorMap.premultiplyAlpha();
-		glTexImage1D(GL_TEXTURE_1D,0,myDataItem->haveFloatTextures?GL_RGBA32F_ARB:GL_RGBA,256,0,GL_RGBA,GL_FLOAT,adjustedColorMap.getColors());
+		
+		glActiveTextureARB(GL_TEXTURE5_ARB+channel);
+		glBindTexture(GL_TEXTURE_2D,myDataItem->preintegratedTextureIDs[channel]);
+		preintegratedSamplers[channel]=5+channel;
+		
+		if(preintegrated)
+			{
+			/* Update the pre-integrated colormap if the color map, step size, or opacity adjustment changed: */
+			preintegratedColorMaps[channel].glUploadTable(*colorMaps[channel],stepSize*transparencyGammas[channel],myDataItem->preintegratedTextureVersions[channel],myDataItem->haveFloatTextures?GL_RGBA32F_ARB:GL_RGBA);
+			}
+		else
+			{
+			/* Create the stepsize-adjusted colormap with pre-multiplied alpha: */
+			glActiveTextureARB(GL_TEXTURE2_ARB+channel);
+			GLColorMap adjustedColorMap(*colorMaps[channel]);
+			adjustedColorMap.changeTransparency(stepSize*transparencyGammas[channel]);
+			adjustedColorMap.premultiplyAlpha();
+			glTexImage1D(GL_TEXTURE_1D,0,myDataItem->haveFloatTextures?GL_RGBA32F_ARB:GL_RGBA,256,0,GL_RGBA,GL_FLOAT,adjustedColorMap.getColors());
+			}
 		}
 	glUniform1ivARB(myDataItem->channelEnabledsLoc,3,channelEnabledsValues);
 	glUniform1ivARB(myDataItem->colorMapSamplersLoc,3,colorMapSamplers);
+	glUniform1iARB(myDataItem->preintegratedLoc,preintegrated?1:0);
+	glUniform1ivARB(myDataItem->preintegratedSamplersLoc,3,preintegratedSamplers);
 	}
 
 void TripleChannelRaycaster::unbindShader(Raycaster::DataItem* dataItem) const
@@ -163,6 +203,8 @@ void TripleChannelRaycaster::unbindShader(Raycaster::DataItem* dataItem) const
 		{
 		glActiveTextureARB(GL_TEXTURE2_ARB+channel);
 		glBindTexture(GL_TEXTURE_1D,0);
+		glActiveTextureARB(GL_TEXTURE5_ARB+channel);
+		glBindTexture(GL_TEXTURE_2D,0);
 		}
 	
 	/* Bind the volume texture: */
@@ -175,7 +217,8 @@ void TripleChannelRaycaster::unbindShader(Raycaster::DataItem* dataItem) const
 
 TripleChannelRaycaster::TripleChannelRaycaster(const unsigned int sDataSize[3],const Raycaster::Box& sDomain)
 	:Raycaster(sDataSize,sDomain),
-	 data(new Voxel[dataSize[0]*dataSize[1]*dataSize[2]*3]),dataVersion(0)
+	 data(new Voxel[dataSize[0]*dataSize[1]*dataSize[2]*3]),dataVersion(0),
+	 preintegrated(false)
 	{
 	/* Multiply the data stride values with the number of channels: */
 	for(int dim=0;dim<3;++dim)
@@ -252,3 +295,8 @@ void TripleChannelRaycaster::setTransparencyGamma(int channel,GLfloat newTranspa
 	{
 	transparencyGammas[channel]=newTransparencyGamma;
 	}
+
+void TripleChannelRaycaster::setPreintegrated(bool newPreintegrated)
+	{
+	preintegrated=newPreintegrated;
+	}
@@ -28,6 +28,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <GL/GLColorMap.h>
 
 #include <Raycaster.h>
+#include <PreintegratedColorMap.h>
 
 class TripleChannelRaycaster:public Raycaster
 	{
@@ -44,10 +45,14 @@ class TripleChannelRaycaster:public Raycaster
 		GLuint volumeTextureID; // Texture object ID for volume data texture
 		unsigned int volumeTextureVersion; // Version number of volume data texture
 		GLuint colorMapTextureIDs[3]; // Texture object IDs for per-channel stepsize-adjusted color map textures
+		GLuint preintegratedTextureIDs[3]; // Texture object IDs for per-channel pre-integrated color map textures
+		unsigned int preintegratedTextureVersions[3]; // Version numbers of per-channel pre-integrated color map textures
 		
 		int volumeSamplerLoc; // Location of the volume data texture sampler
 		int channelEnabledsLoc; // Location of the three channel enable flags
 		int colorMapSamplersLoc; // Location of the three color map texture samplers
+		int preintegratedLoc; // Location of the pre-integration enable flag
+		int preintegratedSamplersLoc; // Location of the three pre-integrated color map texture samplers
 		
 		/* Constructors and destructors: */
 		DataItem(void);
@@ -61,6 +66,8 @@ class TripleChannelRaycaster:public Raycaster
 	bool channelEnableds[3]; // Flags to enable/disable each channel separately
 	const GLColorMap* colorMaps[3]; // Pointers to the three channel color maps
 	GLfloat transparencyGammas[3]; // Adjustment factor for each color map's overall opacity
+	bool preintegrated; // Flag whether to use pre-integrated ray segments instead of point samples
+	mutable PreintegratedColorMap preintegratedColorMaps[3]; // Pre-integrated versions of the three stepsize-adjusted color maps
 	
 	/* Protected methods: */
 	protected:
@@ -105,6 +112,11 @@ class TripleChannelRaycaster:public Raycaster
 		return transparencyGammas[channel];
 		}
 	void setTransparencyGamma(int channel,GLfloat newTransparencyGamma); // Sets the opacity adjustment factor for the given scalar channel
+	bool getPreintegrated(void) const // Returns true if the raycaster uses pre-integrated ray segments
+		{
+		return preintegrated;
+		}
+	void setPreintegrated(bool newPreintegrated); // Enables or disables pre-integrated ray segments
 	};
 
 #endif
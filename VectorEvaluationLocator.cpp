@@ -1,7 +1,7 @@
 /***********************************************************************
 VectorEvaluationLocator - Class for locators evaluating vector
 properties of data sets.
-Copyright (c) 2008-2012 Oliver Kreylos
+Copyright (c) 2008-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include "VectorEvaluationLocator.h"
 
+#include <Misc/ThrowStdErr.h>
 #include <Misc/StandardValueCoders.h>
 #include <Misc/ConfigurationFile.h>
 #include <Math/Math.h>
@@ -68,12 +69,18 @@ VectorEvaluationLocator::VectorEvaluationLocator(Vrui::LocatorTool* sLocatorTool
 		/* Read the vector variable from the configuration file: */
 		std::string vectorVariableName=vm->getVectorVariableName(vm->getCurrentVectorVariable());
 		vectorVariableName=cfg->retrieveValue<std::string>("./vectorVariableName",vectorVariableName);
-		vectorExtractor=vm->getVectorExtractor(vm->getVectorVariable(vectorVariableName.c_str()));
+		int vectorVariableIndex=vm->getVectorVariable(vectorVariableName.c_str());
+		if(vectorVariableIndex<0)
+			Misc::throwStdErr("VectorEvaluationLocator::VectorEvaluationLocator: Unknown vector variable %s",vectorVariableName.c_str());
+		vectorExtractor=vm->getVectorExtractor(vectorVariableIndex);
 		
 		/* Read the scalar variable from the configuration file: */
 		std::string scalarVariableName=vm->getScalarVariableName(vm->getCurrentScalarVariable());
 		scalarVariableName=cfg->retrieveValue<std::string>("./scalarVariableName",scalarVariableName);
-		scalarExtractor=vm->getScalarExtractor(vm->getScalarVariable(scalarVariableName.c_str()));
+		int scalarVariableIndex=vm->getScalarVariable(scalarVariableName.c_str());
+		if(scalarVariableIndex<0)
+			Misc::throwStdErr("VectorEvaluationLocator::VectorEvaluationLocator: Unknown scalar variable %s",scalarVariableName.c_str());
+		scalarExtractor=vm->getScalarExtractor(scalarVariableIndex);
 		}
 	else
 		{
@@ -76,6 +76,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Abstract/Algorithm.h>
 #include <Abstract/Element.h>
 #include <Abstract/Module.h>
+#include <Wrappers/StreamlineCache.h>
 
 #include "CuttingPlane.h"
 #ifdef VISUALIZER_USE_COLLABORATION
@@ -406,7 +407,17 @@ void Visualizer::loadElements(const char* elementFileName,bool ascii)
 				
 				/* Create an extractor for the given name: */
 				Cluster::MulticastPipe* algorithmPipe=Vrui::openPipe();
-				Algorithm* algorithm=module->getAlgorithm(algorithmName.c_str(),variableManager,algorithmPipe);
+				Algorithm* algorithm=0;
+				try
+					{
+					algorithm=module->getAlgorithm(algorithmName.c_str(),variableManager,algorithmPipe);
+					}
+				catch(const std::exception& err)
+					{
+					/* Skip the element; the failed extractor already closed its pipe: */
+					std::cerr<<"Caught exception "<<err.what()<<" while creating "<<algorithmName<<std::endl;
+					algorithmPipe=0;
+					}
 				
 				/* Extract an element using the given extractor: */
 				if(algorithm!=0)
@@ -453,7 +464,7 @@ void Visualizer::loadElements(const char* elementFileName,bool ascii)
 					extractionTimer.elapse();
 					std::cout<<" done in "<<extractionTimer.getTime()*1000.0<<" ms"<<std::endl;
 					}
-				else
+				else if(algorithmPipe!=0)
 					{
 					std::cout<<"Ignoring unknown algorithm "<<algorithmName<<std::endl;
 					delete algorithmPipe;
@@ -481,7 +492,17 @@ void Visualizer::loadElements(const char* elementFileName,bool ascii)
 				
 				/* Create an extractor for the given name: */
 				Cluster::MulticastPipe* algorithmPipe=Vrui::openPipe();
-				Algorithm* algorithm=module->getAlgorithm(algorithmName.c_str(),variableManager,algorithmPipe);
+				Algorithm* algorithm=0;
+				try
+					{
+					algorithm=module->getAlgorithm(algorithmName.c_str(),variableManager,algorithmPipe);
+					}
+				catch(const std::exception& err)
+					{
+					/* Skip the element; the failed extractor already closed its pipe: */
+					std::cerr<<"Caught exception "<<err.what()<<" while creating "<<algorithmName<<std::endl;
+					algorithmPipe=0;
+					}
 				
 				/* Extract an element using the given extractor: */
 				if(algorithm!=0)
@@ -527,7 +548,7 @@ void Visualizer::loadElements(const char* elementFileName,bool ascii)
 					extractionTimer.elapse();
 					std::cout<<" done in "<<extractionTimer.getTime()*1000.0<<" ms"<<std::endl;
 					}
-				else
+				else if(algorithmPipe!=0)
 					{
 					std::cout<<"Ignoring unknown algorithm "<<algorithmName<<std::endl;
 					delete algorithmPipe;
@@ -563,7 +584,17 @@ void Visualizer::loadElements(const char* elementFileName,bool ascii)
 			
 			/* Create an extractor for the given name: */
 			Cluster::MulticastPipe* algorithmPipe=Vrui::openPipe();
-			Algorithm* algorithm=module->getAlgorithm(algorithmName.c_str(),variableManager,algorithmPipe);
+			Algorithm* algorithm=0;
+			try
+				{
+				algorithm=module->getAlgorithm(algorithmName.c_str(),variableManager,algorithmPipe);
+				}
+			catch(const std::exception& err)
+				{
+				/* Skip the element; the failed extractor already closed its pipe: */
+				std::cerr<<"Caught exception "<<err.what()<<" while creating "<<algorithmName<<std::endl;
+				algorithmPipe=0;
+				}
 			
 			/* Extract an element using the given extractor: */
 			if(algorithm!=0)
@@ -815,11 +846,22 @@ Visualizer::Visualizer(int& argc,char**& argv)
 		/* Load a data set: */
 		Misc::Timer t;
 		Cluster::MulticastPipe* pipe=Vrui::openPipe(); // Implicit synchronization point
-		dataSet=module->load(dataSetArgs,pipe);
+		dataSet=module->loadCached(dataSetArgs,pipe);
 		delete pipe; // Implicit synchronization point
 		t.elapse();
 		if(Vrui::isMaster())
 			std::cout<<"Time to load data set: "<<t.getTime()*1000.0<<" ms"<<std::endl;
+		
+		/* Identify the data set to the streamline cache by its module and arguments; the module stamps on-disk entries with the data set's source files: */
+		std::string dataSetId=moduleClassName;
+		dataSetId.push_back('\0');
+		dataSetId.append(baseDirectory);
+		for(std::vector<std::string>::const_iterator daIt=dataSetArgs.begin();daIt!=dataSetArgs.end();++daIt)
+			{
+			dataSetId.push_back('\0');
+			dataSetId.append(*daIt);
+			}
+		Visualization::Wrappers::StreamlineCache::getCache().setDataSet(dataSetId,module);
 		}
 	catch(std::runtime_error err)
 		{
@@ -945,80 +987,98 @@ void Visualizer::toolCreationCallback(Vrui::ToolManager::ToolCreationCallbackDat
 	Vrui::LocatorTool* locatorTool=dynamic_cast<Vrui::LocatorTool*>(cbData->tool);
 	if(locatorTool!=0)
 		{
-		BaseLocator* newLocator;
-		if(cbData->cfg!=0)
+		BaseLocator* newLocator=0;
+		try
 			{
-			/* Determine the algorithm type from the configuration file section: */
-			std::string algorithmName=cbData->cfg->retrieveString("./algorithm");
-			if(algorithmName=="Cutting Plane")
-				{
-				/* Create a cutting plane locator object and associate it with the new tool: */
-				newLocator=new CuttingPlaneLocator(locatorTool,this,cbData->cfg);
-				}
-			else if(algorithmName=="Evaluate Scalars")
+			if(cbData->cfg!=0)
 				{
-				/* Create a scalar evaluation locator object and associate it with the new tool: */
-				newLocator=new ScalarEvaluationLocator(locatorTool,this,cbData->cfg);
-				}
-			else if(algorithmName=="Evaluate Vectors")
-				{
-				/* Create a vector evaluation locator object and associate it with the new tool: */
-				newLocator=new VectorEvaluationLocator(locatorTool,this,cbData->cfg);
+				/* Determine the algorithm type from the configuration file section: */
+				std::string algorithmName=cbData->cfg->retrieveString("./algorithm");
+				if(algorithmName=="Cutting Plane")
+					{
+					/* Create a cutting plane locator object and associate it with the new tool: */
+					newLocator=new CuttingPlaneLocator(locatorTool,this,cbData->cfg);
+					}
+				else if(algorithmName=="Evaluate Scalars")
+					{
+					/* Create a scalar evaluation locator object and associate it with the new tool: */
+					newLocator=new ScalarEvaluationLocator(locatorTool,this,cbData->cfg);
+					}
+				else if(algorithmName=="Evaluate Vectors")
+					{
+					/* Create a vector evaluation locator object and associate it with the new tool: */
+					newLocator=new VectorEvaluationLocator(locatorTool,this,cbData->cfg);
+					}
+				else
+					{
+					/* Create an extractor locator: */
+					Cluster::MulticastPipe* algorithmPipe=Vrui::openPipe();
+					Algorithm* extractor=module->getAlgorithm(algorithmName.c_str(),variableManager,algorithmPipe);
+					if(extractor!=0)
+						{
+						if(cbData->cfg!=0)
+							{
+							/* Read the extractor's parameters from the configuration file section: */
+							try
+								{
+								Visualization::Abstract::ConfigurationFileParametersSource source(variableManager,*cbData->cfg);
+								extractor->readParameters(source);
+								}
+							catch(...)
+								{
+								/* Destroy the extractor, which also closes its pipe: */
+								delete extractor;
+								throw;
+								}
+							}
+						
+						newLocator=new ExtractorLocator(locatorTool,this,extractor,cbData->cfg);
+						}
+					else
+						{
+						newLocator=0;
+						delete algorithmPipe;
+						}
+					}
 				}
 			else
 				{
-				/* Create an extractor locator: */
-				Cluster::MulticastPipe* algorithmPipe=Vrui::openPipe();
-				Algorithm* extractor=module->getAlgorithm(algorithmName.c_str(),variableManager,algorithmPipe);
-				if(extractor!=0)
+				if(algorithm==0)
 					{
-					if(cbData->cfg!=0)
-						{
-						/* Read the extractor's parameters from the configuration file section: */
-						Visualization::Abstract::ConfigurationFileParametersSource source(variableManager,*cbData->cfg);
-						extractor->readParameters(source);
-						}
-					
-					newLocator=new ExtractorLocator(locatorTool,this,extractor,cbData->cfg);
+					/* Create a cutting plane locator object and associate it with the new tool: */
+					newLocator=new CuttingPlaneLocator(locatorTool,this);
+					}
+				else if(algorithm<firstScalarAlgorithmIndex)
+					{
+					/* Create a scalar evaluation locator object and associate it with the new tool: */
+					newLocator=new ScalarEvaluationLocator(locatorTool,this);
+					}
+				else if(algorithm<firstScalarAlgorithmIndex+module->getNumScalarAlgorithms())
+					{
+					/* Create a data locator object and associate it with the new tool: */
+					int algorithmIndex=algorithm-firstScalarAlgorithmIndex;
+					Algorithm* extractor=module->getScalarAlgorithm(algorithmIndex,variableManager,Vrui::openPipe());
+					newLocator=new ExtractorLocator(locatorTool,this,extractor);
+					}
+				else if(algorithm<firstVectorAlgorithmIndex)
+					{
+					/* Create a vector evaluation locator object and associate it with the new tool: */
+					newLocator=new VectorEvaluationLocator(locatorTool,this);
 					}
 				else
 					{
-					newLocator=0;
-					delete algorithmPipe;
+					/* Create a data locator object and associate it with the new tool: */
+					int algorithmIndex=algorithm-firstVectorAlgorithmIndex;
+					Algorithm* extractor=module->getVectorAlgorithm(algorithmIndex,variableManager,Vrui::openPipe());
+					newLocator=new ExtractorLocator(locatorTool,this,extractor);
 					}
 				}
 			}
-		else
+		catch(const std::exception& err)
 			{
-			if(algorithm==0)
-				{
-				/* Create a cutting plane locator object and associate it with the new tool: */
-				newLocator=new CuttingPlaneLocator(locatorTool,this);
-				}
-			else if(algorithm<firstScalarAlgorithmIndex)
-				{
-				/* Create a scalar evaluation locator object and associate it with the new tool: */
-				newLocator=new ScalarEvaluationLocator(locatorTool,this);
-				}
-			else if(algorithm<firstScalarAlgorithmIndex+module->getNumScalarAlgorithms())
-				{
-				/* Create a data locator object and associate it with the new tool: */
-				int algorithmIndex=algorithm-firstScalarAlgorithmIndex;
-				Algorithm* extractor=module->getScalarAlgorithm(algorithmIndex,variableManager,Vrui::openPipe());
-				newLocator=new ExtractorLocator(locatorTool,this,extractor);
-				}
-			else if(algorithm<firstVectorAlgorithmIndex)
-				{
-				/* Create a vector evaluation locator object and associate it with the new tool: */
-				newLocator=new VectorEvaluationLocator(locatorTool,this);
-				}
-			else
-				{
-				/* Create a data locator object and associate it with the new tool: */
-				int algorithmIndex=algorithm-firstVectorAlgorithmIndex;
-				Algorithm* extractor=module->getVectorAlgorithm(algorithmIndex,variableManager,Vrui::openPipe());
-				newLocator=new ExtractorLocator(locatorTool,this,extractor);
-				}
+			/* Leave the tool without a locator; the algorithm could not be created, e.g., because one of its variables could not be read: */
+			std::cerr<<"Caught exception "<<err.what()<<" while creating locator"<<std::endl;
+			newLocator=0;
 			}
 		
 		if(newLocator!=0)
@@ -1,7 +1,7 @@
 /***********************************************************************
 ArrowRakeExtractor - Wrapper class extract rakes of arrows from vector
 fields.
-Copyright (c) 2008-2012 Oliver Kreylos
+Copyright (c) 2008-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef VISUALIZATION_WRAPPERS_ARROWRAKEEXTRACTOR_INCLUDED
 #define VISUALIZATION_WRAPPERS_ARROWRAKEEXTRACTOR_INCLUDED
 
+#include <vector>
 #include <Misc/Autopointer.h>
 #include <GLMotif/TextFieldSlider.h>
 
@@ -123,6 +124,9 @@ class ArrowRakeExtractor:public Visualization::Abstract::Algorithm
 		void update(Visualization::Abstract::VariableManager* variableManager,bool track); // Updates derived parameters after a read operation
 		};
 	
+	class RowEvaluator; // Functor class to evaluate the arrows of rake rows in parallel
+	friend class RowEvaluator;
+	
 	/* Elements: */
 	private:
 	static const char* name; // Identifying name of this algorithm
@@ -131,11 +135,20 @@ class ArrowRakeExtractor:public Visualization::Abstract::Algorithm
 	ArrowRakePointer currentArrowRake; // The currently extracted arrow rake visualization element
 	Parameters* currentParameters; // Pointer to parameter object for current extraction
 	
+	/* State of the most recently evaluated rake, to skip re-evaluating arrows that did not move: */
+	Index cachedRakeSize; // Size of the most recently evaluated rake
+	int cachedVectorVariableIndex; // Vector variable of the most recently evaluated rake
+	int cachedColorScalarVariableIndex; // Color scalar variable of the most recently evaluated rake
+	std::vector<Arrow> cachedArrows; // Arrows of the most recently evaluated rake in rake array order
+	
 	/* UI components: */
 	GLMotif::TextFieldSlider* rakeSizeSliders[2]; // Sliders to adjust the current rake size
 	GLMotif::TextFieldSlider* cellSizeSliders[2]; // Sliders to adjust the current grid size
 	GLMotif::TextFieldSlider* lengthScaleSlider;
 	
+	/* Private methods: */
+	void evaluateArrows(const Parameters* extractParameters,ArrowRake* arrowRake); // Calculates the base points, directions, and scalar values of all arrows in the given arrow rake
+	
 	/* Constructors and destructors: */
 	public:
 	ArrowRakeExtractor(Visualization::Abstract::VariableManager* sVariableManager,Cluster::MulticastPipe* sPipe); // Creates an arrow rake extractor
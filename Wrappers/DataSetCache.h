@@ -0,0 +1,534 @@
+/***********************************************************************
+DataSetCache - Helper functions to write templatized sliced data sets
+and their data value descriptors to binary data set cache files, and to
+recreate them from those files.
+Part of the wrapper layer of the templatized visualization
+components.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_WRAPPERS_DATASETCACHE_INCLUDED
+#define VISUALIZATION_WRAPPERS_DATASETCACHE_INCLUDED
+
+#include <string>
+#include <vector>
+#include <Misc/SizedTypes.h>
+#include <Misc/ThrowStdErr.h>
+#include <IO/File.h>
+
+/* Forward declarations: */
+namespace Visualization {
+namespace Templatized {
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+class SlicedCartesian;
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+class SlicedCurvilinear;
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+class SlicedMultiCurvilinear;
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+class SlicedHypercubic;
+}
+namespace Wrappers {
+template <class DSParam,class VScalarParam>
+class SlicedScalarVectorDataValue;
+}
+}
+
+namespace Visualization {
+
+namespace Wrappers {
+
+/**********************************************************************
+Helper functions to write and check the type signature of a cached data
+set, to reject cache files written for different data set types:
+**********************************************************************/
+
+template <class DSParam>
+inline
+void
+writeCacheSignature(
+	IO::File& file,
+	Misc::UInt32 dataSetType)
+	{
+	file.write<Misc::UInt32>(dataSetType);
+	file.write<Misc::UInt32>(Misc::UInt32(DSParam::dimension));
+	file.write<Misc::UInt32>(Misc::UInt32(sizeof(typename DSParam::Scalar)));
+	file.write<Misc::UInt32>(Misc::UInt32(sizeof(typename DSParam::ValueScalar)));
+	}
+
+template <class DSParam>
+inline
+void
+checkCacheSignature(
+	IO::File& file,
+	Misc::UInt32 dataSetType)
+	{
+	Misc::UInt32 signature[4];
+	file.read<Misc::UInt32>(signature,4);
+	if(signature[0]!=dataSetType||signature[1]!=Misc::UInt32(DSParam::dimension)||signature[2]!=Misc::UInt32(sizeof(typename DSParam::Scalar))||signature[3]!=Misc::UInt32(sizeof(typename DSParam::ValueScalar)))
+		Misc::throwStdErr("checkCacheSignature: Mismatching data set type");
+	}
+
+template <class IndexParam>
+inline
+void
+writeCacheIndex(
+	IO::File& file,
+	const IndexParam& index,
+	int dimension)
+	{
+	for(int i=0;i<dimension;++i)
+		file.write<Misc::SInt32>(Misc::SInt32(index[i]));
+	}
+
+template <class IndexParam>
+inline
+void
+readCacheIndex(
+	IO::File& file,
+	IndexParam& index,
+	int dimension)
+	{
+	for(int i=0;i<dimension;++i)
+		index[i]=file.read<Misc::SInt32>();
+	}
+
+/**********************************************************************
+Generic versions of the data set functions, for data set types that do
+not support caching:
+**********************************************************************/
+
+template <class DSParam>
+inline
+bool
+writeCachedDataSet(
+	IO::File& file,
+	const DSParam& ds)
+	{
+	return false;
+	}
+
+template <class DSParam>
+inline
+void
+readCachedDataSet(
+	IO::File& file,
+	DSParam& ds)
+	{
+	Misc::throwStdErr("readCachedDataSet: Data set type does not support caching");
+	}
+
+/**********************************************************************
+Sliced Cartesian data sets:
+**********************************************************************/
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+bool
+writeCachedDataSet(
+	IO::File& file,
+	const Visualization::Templatized::SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam>& ds)
+	{
+	typedef Visualization::Templatized::SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam> DS;
+	
+	writeCacheSignature<DS>(file,1);
+	writeCacheIndex(file,ds.getNumVertices(),dimensionParam);
+	for(int i=0;i<dimensionParam;++i)
+		file.write<ScalarParam>(ds.getCellSize()[i]);
+	file.write<Misc::SInt32>(Misc::SInt32(ds.getNumSlices()));
+	size_t numVertices=ds.getTotalNumVertices();
+	for(int slice=0;slice<ds.getNumSlices();++slice)
+		file.write<ValueScalarParam>(ds.getSliceArray(slice),numVertices);
+	
+	return true;
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+void
+readCachedDataSet(
+	IO::File& file,
+	Visualization::Templatized::SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam>& ds)
+	{
+	typedef Visualization::Templatized::SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam> DS;
+	
+	checkCacheSignature<DS>(file,1);
+	typename DS::Index numVertices;
+	readCacheIndex(file,numVertices,dimensionParam);
+	typename DS::Size cellSize;
+	for(int i=0;i<dimensionParam;++i)
+		cellSize[i]=file.read<ScalarParam>();
+	int numSlices=file.read<Misc::SInt32>();
+	ds.setData(numVertices,cellSize,numSlices);
+	size_t totalNumVertices=ds.getTotalNumVertices();
+	for(int slice=0;slice<numSlices;++slice)
+		file.read<ValueScalarParam>(ds.getSliceArray(slice),totalNumVertices);
+	}
+
+/**********************************************************************
+Sliced curvilinear data sets:
+**********************************************************************/
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+bool
+writeCachedDataSet(
+	IO::File& file,
+	const Visualization::Templatized::SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>& ds)
+	{
+	typedef Visualization::Templatized::SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam> DS;
+	
+	writeCacheSignature<DS>(file,2);
+	writeCacheIndex(file,ds.getNumVertices(),dimensionParam);
+	size_t numVertices=ds.getTotalNumVertices();
+	if(numVertices>0)
+		file.write<ScalarParam>(ds.getGrid().getArray()[0].getComponents(),numVertices*dimensionParam);
+	file.write<Misc::SInt32>(Misc::SInt32(ds.getNumSlices()));
+	for(int slice=0;slice<ds.getNumSlices();++slice)
+		file.write<ValueScalarParam>(ds.getSliceArray(slice),numVertices);
+	
+	return true;
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+void
+readCachedDataSet(
+	IO::File& file,
+	Visualization::Templatized::SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>& ds)
+	{
+	typedef Visualization::Templatized::SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam> DS;
+	
+	checkCacheSignature<DS>(file,2);
+	typename DS::Index numVertices;
+	readCacheIndex(file,numVertices,dimensionParam);
+	ds.setGrid(numVertices);
+	size_t totalNumVertices=ds.getTotalNumVertices();
+	if(totalNumVertices>0)
+		file.read<ScalarParam>(ds.getGrid().getArray()[0].getComponents(),totalNumVertices*dimensionParam);
+	int numSlices=file.read<Misc::SInt32>();
+	for(int slice=0;slice<numSlices;++slice)
+		{
+		ds.addSlice();
+		file.read<ValueScalarParam>(ds.getSliceArray(slice),totalNumVertices);
+		}
+	
+	/* Rebuild the cell center tree and other derived grid structures: */
+	ds.finalizeGrid();
+	}
+
+/**********************************************************************
+Sliced multi-curvilinear data sets:
+**********************************************************************/
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+bool
+writeCachedDataSet(
+	IO::File& file,
+	const Visualization::Templatized::SlicedMultiCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>& ds)
+	{
+	typedef Visualization::Templatized::SlicedMultiCurvilinear<ScalarParam,dimensionParam,ValueScalarParam> DS;
+	
+	writeCacheSignature<DS>(file,3);
+	file.write<Misc::SInt32>(Misc::SInt32(ds.getNumGrids()));
+	for(int gridIndex=0;gridIndex<ds.getNumGrids();++gridIndex)
+		{
+		const typename DS::Grid& grid=ds.getGrid(gridIndex);
+		writeCacheIndex(file,grid.getNumVertices(),dimensionParam);
+		size_t gridNumVertices=grid.getNumVertices().calcIncrement(-1);
+		if(gridNumVertices>0)
+			file.write<ScalarParam>(grid.getGrid().getArray()[0].getComponents(),gridNumVertices*dimensionParam);
+		}
+	file.write<Misc::SInt32>(Misc::SInt32(ds.getNumSlices()));
+	size_t numVertices=ds.getTotalNumVertices();
+	for(int slice=0;slice<ds.getNumSlices();++slice)
+		file.write<ValueScalarParam>(ds.getSliceArray(slice),numVertices);
+	
+	return true;
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+void
+readCachedDataSet(
+	IO::File& file,
+	Visualization::Templatized::SlicedMultiCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>& ds)
+	{
+	typedef Visualization::Templatized::SlicedMultiCurvilinear<ScalarParam,dimensionParam,ValueScalarParam> DS;
+	
+	checkCacheSignature<DS>(file,3);
+	int numGrids=file.read<Misc::SInt32>();
+	ds.setNumGrids(numGrids);
+	for(int gridIndex=0;gridIndex<numGrids;++gridIndex)
+		{
+		typename DS::Index numVertices;
+		readCacheIndex(file,numVertices,dimensionParam);
+		ds.setGrid(gridIndex,numVertices);
+		size_t gridNumVertices=numVertices.calcIncrement(-1);
+		if(gridNumVertices>0)
+			file.read<ScalarParam>(ds.getGrid(gridIndex).getGrid().getArray()[0].getComponents(),gridNumVertices*dimensionParam);
+		}
+	int numSlices=file.read<Misc::SInt32>();
+	size_t totalNumVertices=ds.getTotalNumVertices();
+	for(int slice=0;slice<numSlices;++slice)
+		{
+		ds.addSlice();
+		file.read<ValueScalarParam>(ds.getSliceArray(slice),totalNumVertices);
+		}
+	
+	/* Rebuild the cell center tree, grid connectivity, and other derived grid structures: */
+	ds.finalizeGrid();
+	}
+
+/**********************************************************************
+Sliced unstructured hypercubic data sets:
+**********************************************************************/
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+bool
+writeCachedDataSet(
+	IO::File& file,
+	const Visualization::Templatized::SlicedHypercubic<ScalarParam,dimensionParam,ValueScalarParam>& ds)
+	{
+	typedef Visualization::Templatized::SlicedHypercubic<ScalarParam,dimensionParam,ValueScalarParam> DS;
+	static const int numCellVertices=DS::CellTopology::numVertices;
+	
+	writeCacheSignature<DS>(file,4);
+	
+	/* Write the vertex positions: */
+	size_t numVertices=ds.getTotalNumVertices();
+	file.write<Misc::UInt64>(Misc::UInt64(numVertices));
+	for(size_t i=0;i<numVertices;++i)
+		file.write<ScalarParam>(ds.getVertexPosition(typename DS::VertexIndex(i)).getComponents(),dimensionParam);
+	
+	/* Write the cells' vertex indices: */
+	file.write<Misc::UInt64>(Misc::UInt64(ds.getTotalNumCells()));
+	for(typename DS::CellIterator cIt=ds.beginCells();cIt!=ds.endCells();++cIt)
+		{
+		Misc::UInt64 cellVertices[numCellVertices];
+		for(int i=0;i<numCellVertices;++i)
+			cellVertices[i]=Misc::UInt64(cIt->getVertexID(i).getIndex());
+		file.write<Misc::UInt64>(cellVertices,numCellVertices);
+		}
+	
+	/* Write the value slices: */
+	file.write<Misc::SInt32>(Misc::SInt32(ds.getNumSlices()));
+	for(int slice=0;slice<ds.getNumSlices();++slice)
+		file.write<ValueScalarParam>(ds.getSliceArray(slice),numVertices);
+	
+	return true;
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+void
+readCachedDataSet(
+	IO::File& file,
+	Visualization::Templatized::SlicedHypercubic<ScalarParam,dimensionParam,ValueScalarParam>& ds)
+	{
+	typedef Visualization::Templatized::SlicedHypercubic<ScalarParam,dimensionParam,ValueScalarParam> DS;
+	static const int numCellVertices=DS::CellTopology::numVertices;
+	
+	checkCacheSignature<DS>(file,4);
+	
+	/* Read the vertex positions: */
+	size_t numVertices=size_t(file.read<Misc::UInt64>());
+	ds.reserveVertices(numVertices);
+	for(size_t i=0;i<numVertices;++i)
+		{
+		typename DS::Point vertexPosition;
+		file.read<ScalarParam>(vertexPosition.getComponents(),dimensionParam);
+		ds.addVertex(vertexPosition);
+		}
+	
+	/* Read the cells, which reconnects them to their neighbours: */
+	size_t numCells=size_t(file.read<Misc::UInt64>());
+	ds.reserveCells(numCells);
+	for(size_t i=0;i<numCells;++i)
+		{
+		Misc::UInt64 cellVertexIndices[numCellVertices];
+		file.read<Misc::UInt64>(cellVertexIndices,numCellVertices);
+		typename DS::VertexID cellVertices[numCellVertices];
+		for(int j=0;j<numCellVertices;++j)
+			{
+			if(cellVertexIndices[j]>=Misc::UInt64(numVertices))
+				Misc::throwStdErr("readCachedDataSet: Invalid vertex index in cell %u",(unsigned int)i);
+			cellVertices[j]=typename DS::VertexID(typename DS::VertexIndex(cellVertexIndices[j]));
+			}
+		ds.addCell(cellVertices);
+		}
+	
+	/* Read the value slices: */
+	int numSlices=file.read<Misc::SInt32>();
+	for(int slice=0;slice<numSlices;++slice)
+		{
+		ds.addSlice();
+		file.read<ValueScalarParam>(ds.getSliceArray(slice),numVertices);
+		}
+	
+	/* Rebuild the cell center tree and other derived grid structures: */
+	ds.finalizeGrid();
+	}
+
+/**********************************************************************
+Generic versions of the data value functions, for data value
+descriptors that do not support caching:
+**********************************************************************/
+
+template <class DataValueParam>
+inline
+void
+loadDeferredDataValue(
+	const DataValueParam& dataValue)
+	{
+	}
+
+template <class DSParam,class DataValueParam>
+inline
+bool
+writeCachedDataValue(
+	IO::File& file,
+	const DSParam& ds,
+	const DataValueParam& dataValue)
+	{
+	return false;
+	}
+
+template <class DSParam,class DataValueParam>
+inline
+void
+readCachedDataValue(
+	IO::File& file,
+	const DSParam& ds,
+	DataValueParam& dataValue)
+	{
+	Misc::throwStdErr("readCachedDataValue: Data value type does not support caching");
+	}
+
+/**********************************************************************
+Data value descriptors for sliced data sets with named scalar and
+vector variables:
+**********************************************************************/
+
+inline
+void
+writeCacheString(
+	IO::File& file,
+	const char* string)
+	{
+	std::string s(string!=0?string:"");
+	file.write<Misc::UInt32>(Misc::UInt32(s.size()));
+	file.write<char>(s.data(),s.size());
+	}
+
+inline
+std::string
+readCacheString(
+	IO::File& file)
+	{
+	Misc::UInt32 length=file.read<Misc::UInt32>();
+	std::string result(length,'\0');
+	if(length>0)
+		file.read<char>(&result[0],length);
+	return result;
+	}
+
+template <class DSParam,class VScalarParam>
+inline
+void
+loadDeferredDataValue(
+	const SlicedScalarVectorDataValue<DSParam,VScalarParam>& dataValue)
+	{
+	/* Read all deferred scalar variables so that the data set's slices are complete: */
+	dataValue.loadAllScalarVariables();
+	}
+
+template <class DSParam,class VScalarParam>
+inline
+bool
+writeCachedDataValue(
+	IO::File& file,
+	const DSParam& ds,
+	const SlicedScalarVectorDataValue<DSParam,VScalarParam>& dataValue)
+	{
+	/* Only data values whose scalar variables map one-to-one to the data set's slices can be recreated: */
+	if(dataValue.getNumScalarVariables()!=ds.getNumSlices())
+		return false;
+	
+	/* Write the scalar variable names: */
+	file.write<Misc::SInt32>(Misc::SInt32(dataValue.getNumScalarVariables()));
+	for(int i=0;i<dataValue.getNumScalarVariables();++i)
+		writeCacheString(file,dataValue.getScalarVariableName(i));
+	
+	/* Write the vector variable names and component slice indices: */
+	file.write<Misc::SInt32>(Misc::SInt32(dataValue.getNumVectorVariables()));
+	for(int i=0;i<dataValue.getNumVectorVariables();++i)
+		{
+		writeCacheString(file,dataValue.getVectorVariableName(i));
+		for(int j=0;j<DSParam::dimension;++j)
+			file.write<Misc::SInt32>(Misc::SInt32(dataValue.getVectorVariableScalarIndex(i,j)));
+		}
+	
+	return true;
+	}
+
+template <class DSParam,class VScalarParam>
+inline
+void
+readCachedDataValue(
+	IO::File& file,
+	const DSParam& ds,
+	SlicedScalarVectorDataValue<DSParam,VScalarParam>& dataValue)
+	{
+	/* Read the scalar variable names: */
+	int numScalarVariables=file.read<Misc::SInt32>();
+	if(numScalarVariables!=ds.getNumSlices())
+		Misc::throwStdErr("readCachedDataValue: Mismatching number of scalar variables");
+	std::vector<std::string> scalarVariableNames;
+	scalarVariableNames.reserve(numScalarVariables);
+	for(int i=0;i<numScalarVariables;++i)
+		scalarVariableNames.push_back(readCacheString(file));
+	
+	/* Initialize the data value and set the scalar variable names: */
+	int numVectorVariables=file.read<Misc::SInt32>();
+	dataValue.initialize(&ds,numVectorVariables);
+	for(int i=0;i<numScalarVariables;++i)
+		dataValue.setScalarVariableName(i,scalarVariableNames[i].c_str());
+	
+	/* Read the vector variable names and component slice indices: */
+	for(int i=0;i<numVectorVariables;++i)
+		{
+		dataValue.setVectorVariableName(i,readCacheString(file).c_str());
+		for(int j=0;j<DSParam::dimension;++j)
+			{
+			int scalarVariableIndex=file.read<Misc::SInt32>();
+			if(scalarVariableIndex<0||scalarVariableIndex>=numScalarVariables)
+				Misc::throwStdErr("readCachedDataValue: Invalid vector component index");
+			dataValue.setVectorVariableScalarIndex(i,j,scalarVariableIndex);
+			}
+		}
+	}
+
+}
+
+}
+
+#endif
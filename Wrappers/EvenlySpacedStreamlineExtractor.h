@@ -0,0 +1,176 @@
+/***********************************************************************
+EvenlySpacedStreamlineExtractor - Wrapper class to map from the
+abstract visualization algorithm interface to a templatized evenly-
+spaced streamline extractor implementation.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_WRAPPERS_EVENLYSPACEDSTREAMLINEEXTRACTOR_INCLUDED
+#define VISUALIZATION_WRAPPERS_EVENLYSPACEDSTREAMLINEEXTRACTOR_INCLUDED
+
+#include <GLMotif/TextFieldSlider.h>
+
+#include <Abstract/DataSet.h>
+#include <Abstract/Parameters.h>
+#include <Abstract/Algorithm.h>
+
+#include <Wrappers/MultiStreamline.h>
+
+/* Forward declarations: */
+namespace Visualization {
+namespace Abstract {
+class VectorExtractor;
+class ScalarExtractor;
+class Element;
+}
+namespace Templatized {
+template <class VectorParam,class SourceValueParam>
+class VectorExtractor;
+template <class ScalarParam,class SourceValueParam>
+class ScalarExtractor;
+template <class DataSetParam,class VectorExtractorParam,class ScalarExtractorParam,class MultiStreamlineParam>
+class EvenlySpacedStreamlineExtractor;
+}
+namespace Wrappers {
+template <class VEParam>
+class VectorExtractor;
+template <class SEParam>
+class ScalarExtractor;
+}
+}
+
+namespace Visualization {
+
+namespace Wrappers {
+
+template <class DataSetWrapperParam>
+class EvenlySpacedStreamlineExtractor:public Visualization::Abstract::Algorithm
+	{
+	/* Embedded classes: */
+	public:
+	typedef Visualization::Abstract::Algorithm Base; // Base class
+	typedef DataSetWrapperParam DataSetWrapper; // Compatible data set type
+	typedef typename DataSetWrapper::DS DS; // Type of templatized data set
+	typedef typename DS::Scalar Scalar; // Scalar type of templatized data set's domain
+	static const int dimension=DS::dimension; // Dimension of data set's domain
+	typedef typename DataSetWrapper::VE VE; // Type of templatized vector extractor
+	typedef typename DataSetWrapper::VectorExtractor VectorExtractor; // Compatible vector extractor wrapper class
+	typedef typename DataSetWrapper::SE SE; // Type of templatized scalar extractor
+	typedef typename DataSetWrapper::ScalarExtractor ScalarExtractor; // Compatible scalar extractor wrapper class
+	typedef Visualization::Wrappers::MultiStreamline<DataSetWrapper> MultiStreamline; // Type of created visualization elements
+	typedef typename MultiStreamline::MultiPolyline MultiPolyline; // Type of low-level multi-streamline representation
+	typedef Visualization::Templatized::EvenlySpacedStreamlineExtractor<DS,VE,SE,MultiPolyline> ESSLE; // Type of templatized evenly-spaced streamline extractor
+	
+	private:
+	class Parameters:public Visualization::Abstract::Parameters // Class to store extraction parameters for evenly-spaced streamlines
+		{
+		friend class EvenlySpacedStreamlineExtractor;
+		
+		/* Elements: */
+		private:
+		int vectorVariableIndex; // Index of the vector variable defining the streamlines
+		int colorScalarVariableIndex; // Index of the scalar variable used to color the streamlines
+		Scalar separation; // Minimum distance between neighboring streamlines
+		unsigned int maxNumStreamlines; // Maximum number of streamlines to be extracted
+		size_t maxNumVertices; // Maximum number of vertices per streamline
+		const DS* ds; // Data set from which to extract streamlines
+		const VE* ve; // Vector extractor for data set
+		const SE* cse; // Color scalar extractor for data set
+		
+		/* Constructors and destructors: */
+		public:
+		Parameters(Visualization::Abstract::VariableManager* variableManager);
+		
+		/* Methods from Abstract::Parameters: */
+		virtual bool isValid(void) const
+			{
+			return true;
+			}
+		virtual Visualization::Abstract::Parameters* clone(void) const
+			{
+			return new Parameters(*this);
+			}
+		virtual void write(Visualization::Abstract::ParametersSink& sink) const;
+		virtual void read(Visualization::Abstract::ParametersSource& source);
+		
+		/* New methods: */
+		void update(Visualization::Abstract::VariableManager* variableManager); // Updates derived parameters after a read operation
+		};
+	
+	/* Elements: */
+	private:
+	static const char* name; // Identifying name of this algorithm
+	Parameters parameters; // The streamline extraction parameters used by this extractor
+	ESSLE essle; // The templatized evenly-spaced streamline extractor
+	
+	/* UI elements: */
+	GLMotif::TextFieldSlider* separationSlider;
+	GLMotif::TextFieldSlider* maxNumStreamlinesSlider;
+	GLMotif::TextFieldSlider* maxNumVerticesSlider;
+	
+	/* Constructors and destructors: */
+	public:
+	EvenlySpacedStreamlineExtractor(Visualization::Abstract::VariableManager* sVariableManager,Cluster::MulticastPipe* sPipe); // Creates an evenly-spaced streamline extractor
+	virtual ~EvenlySpacedStreamlineExtractor(void);
+	
+	/* Methods from Visualization::Abstract::Algorithm: */
+	virtual const char* getName(void) const
+		{
+		return name;
+		}
+	virtual bool hasGlobalCreator(void) const
+		{
+		return true;
+		}
+	virtual GLMotif::Widget* createSettingsDialog(GLMotif::WidgetManager* widgetManager);
+	virtual void readParameters(Visualization::Abstract::ParametersSource& source);
+	virtual Visualization::Abstract::Parameters* cloneParameters(void) const
+		{
+		return new Parameters(parameters);
+		}
+	virtual Visualization::Abstract::Element* createElement(Visualization::Abstract::Parameters* extractParameters);
+	virtual Visualization::Abstract::Element* startSlaveElement(Visualization::Abstract::Parameters* extractParameters);
+	
+	/* New methods: */
+	static const char* getClassName(void) // Returns the algorithm class name
+		{
+		return name;
+		}
+	const ESSLE& getEssle(void) const // Returns the templatized evenly-spaced streamline extractor
+		{
+		return essle;
+		}
+	ESSLE& getEssle(void) // Ditto
+		{
+		return essle;
+		}
+	void separationCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
+	void maxNumStreamlinesCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
+	void maxNumVerticesCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_WRAPPERS_EVENLYSPACEDSTREAMLINEEXTRACTOR_IMPLEMENTATION
+#include <Wrappers/EvenlySpacedStreamlineExtractor.icpp>
+#endif
+
+#endif
@@ -0,0 +1,107 @@
+/***********************************************************************
+LICSlice - Class to represent line integral convolution images on planar
+slices as visualization elements.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_WRAPPERS_LICSLICE_INCLUDED
+#define VISUALIZATION_WRAPPERS_LICSLICE_INCLUDED
+
+#include <vector>
+#include <GL/gl.h>
+#include <GL/GLObject.h>
+
+#include <Abstract/Element.h>
+
+/* Forward declarations: */
+namespace Cluster {
+class MulticastPipe;
+}
+
+namespace Visualization {
+
+namespace Wrappers {
+
+template <class DataSetWrapperParam>
+class LICSlice:public Visualization::Abstract::Element,public GLObject
+	{
+	/* Embedded classes: */
+	public:
+	typedef Visualization::Abstract::Element Base; // Base class
+	typedef DataSetWrapperParam DataSetWrapper; // Compatible data set type
+	typedef typename DataSetWrapper::DS DS; // Type of templatized data set
+	typedef typename DS::Scalar Scalar; // Scalar type of data set's domain
+	static const int dimension=DS::dimension; // Dimension of data set's domain
+	typedef typename DS::Point Point; // Point type in data set's domain
+	typedef typename DS::Vector Vector; // Vector type in data set's domain
+	
+	private:
+	struct DataItem:public GLObject::DataItem
+		{
+		/* Elements: */
+		public:
+		GLuint textureObjectId; // ID of texture object holding the LIC image
+		GLsizei textureSize[2]; // Power-of-two size of the texture object
+		unsigned int version; // Version number of the LIC image in the texture object
+		
+		/* Constructors and destructors: */
+		DataItem(void);
+		virtual ~DataItem(void);
+		};
+	
+	/* Elements: */
+	private:
+	Cluster::MulticastPipe* pipe; // Pipe to stream LIC slice data in a cluster environment (owned by caller)
+	Point origin; // Corner of the slice rectangle corresponding to the first image pixel
+	Vector axes[2]; // Edges of the slice rectangle along image columns and rows
+	int imageSize[2]; // Width and height of the LIC image in pixels
+	std::vector<GLubyte> texels; // Luminance-alpha texels of the LIC image in row-major order; alpha is zero outside the data set's domain
+	unsigned int version; // Version number of the LIC slice
+	
+	/* Constructors and destructors: */
+	public:
+	LICSlice(Visualization::Abstract::VariableManager* sVariableManager,Visualization::Abstract::Parameters* sParameters,Cluster::MulticastPipe* sPipe); // Creates an empty LIC slice for the given parameters
+	private:
+	LICSlice(const LICSlice& source); // Prohibit copy constructor
+	LICSlice& operator=(const LICSlice& source); // Prohibit assignment operator
+	public:
+	virtual ~LICSlice(void);
+	
+	/* Methods from Visualization::Abstract::Element: */
+	virtual std::string getName(void) const;
+	virtual size_t getSize(void) const;
+	virtual void glRenderAction(GLRenderState& renderState) const;
+	
+	/* Methods from GLObject: */
+	virtual void initContext(GLContextData& contextData) const;
+	
+	/* Methods: */
+	void setImage(const Point& newOrigin,const Vector newAxes[2],int width,int height,const float* image); // Sets the slice rectangle and the LIC image with values in [0, 1], or negative outside the data set's domain
+	void update(void); // Synchronizes the LIC slice across a cluster
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_WRAPPERS_LICSLICE_IMPLEMENTATION
+#include <Wrappers/LICSlice.icpp>
+#endif
+
+#endif
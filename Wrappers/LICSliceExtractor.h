@@ -0,0 +1,166 @@
+/***********************************************************************
+LICSliceExtractor - Wrapper class to extract line integral convolution
+images of vector fields on seeded planar slices.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_WRAPPERS_LICSLICEEXTRACTOR_INCLUDED
+#define VISUALIZATION_WRAPPERS_LICSLICEEXTRACTOR_INCLUDED
+
+#include <Misc/Autopointer.h>
+#include <GLMotif/TextFieldSlider.h>
+
+#include <Abstract/DataSet.h>
+#include <Abstract/Parameters.h>
+#include <Abstract/Algorithm.h>
+
+#include <Wrappers/LICSlice.h>
+
+/* Forward declarations: */
+namespace Visualization {
+namespace Abstract {
+class VectorExtractor;
+class Element;
+}
+namespace Templatized {
+template <class VectorParam,class SourceValueParam>
+class VectorExtractor;
+}
+namespace Wrappers {
+template <class VEParam>
+class VectorExtractor;
+}
+}
+
+namespace Visualization {
+
+namespace Wrappers {
+
+template <class DataSetWrapperParam>
+class LICSliceExtractor:public Visualization::Abstract::Algorithm
+	{
+	/* Embedded classes: */
+	public:
+	typedef Visualization::Abstract::Algorithm Base; // Base class
+	typedef DataSetWrapperParam DataSetWrapper; // Compatible data set type
+	typedef typename DataSetWrapper::DS DS; // Type of templatized data set
+	typedef typename DS::Scalar Scalar; // Type for scalars
+	static const int dimension=DS::dimension; // Dimension of data set's domain
+	typedef typename DS::Point Point; // Type for points
+	typedef typename DS::Vector Vector; // Type for vectors
+	typedef typename DataSetWrapper::DSL DSL; // Type of templatized locator
+	typedef typename DataSetWrapper::Locator Locator; // Type of locator wrapper
+	typedef typename DataSetWrapper::VE VE; // Type of templatized vector extractor
+	typedef typename DataSetWrapper::VectorExtractor VectorExtractor; // Compatible vector extractor wrapper class
+	typedef Visualization::Wrappers::LICSlice<DataSetWrapper> LICSlice; // Type of created visualization elements
+	typedef Misc::Autopointer<LICSlice> LICSlicePointer; // Type for pointers to created visualization elements
+	
+	private:
+	class Parameters:public Visualization::Abstract::Parameters // Class to store extraction parameters for LIC slices
+		{
+		friend class LICSliceExtractor;
+		
+		/* Elements: */
+		private:
+		int vectorVariableIndex; // Index of the vector variable defining the LIC slice
+		int resolution; // Number of image pixels along the longer edge of the slice rectangle
+		unsigned int filterLength; // Half length of the convolution filter in integration steps
+		Point seedPoint; // Point from which the slice was seeded
+		Vector frame[2]; // Orthonormal directions of image columns and rows in the slice plane
+		const DS* ds; // Data set from which to extract LIC slices
+		const VE* ve; // Vector extractor for data set
+		DSL dsl; // Templatized data set locator following the seed point
+		bool locatorValid; // Flag if the locator has been properly initialized, and is inside the data set's domain
+		
+		/* Constructors and destructors: */
+		public:
+		Parameters(Visualization::Abstract::VariableManager* variableManager);
+		
+		/* Methods from Abstract::Parameters: */
+		virtual bool isValid(void) const
+			{
+			return locatorValid;
+			}
+		virtual Visualization::Abstract::Parameters* clone(void) const
+			{
+			return new Parameters(*this);
+			}
+		virtual void write(Visualization::Abstract::ParametersSink& sink) const;
+		virtual void read(Visualization::Abstract::ParametersSource& source);
+		
+		/* New methods: */
+		void update(Visualization::Abstract::VariableManager* variableManager,bool track); // Updates derived parameters after a read operation
+		};
+	
+	class RowSampler; // Functor class to sample the vector field along image rows in parallel
+	friend class RowSampler;
+	
+	/* Elements: */
+	private:
+	static const char* name; // Identifying name of this algorithm
+	Parameters parameters; // The LIC slice extraction parameters used by this extractor
+	LICSlicePointer currentLICSlice; // The currently extracted LIC slice visualization element
+	
+	/* UI components: */
+	GLMotif::TextFieldSlider* resolutionSlider; // Slider to adjust the image resolution
+	GLMotif::TextFieldSlider* filterLengthSlider; // Slider to adjust the convolution filter length
+	
+	/* Constructors and destructors: */
+	public:
+	LICSliceExtractor(Visualization::Abstract::VariableManager* sVariableManager,Cluster::MulticastPipe* sPipe); // Creates a LIC slice extractor
+	virtual ~LICSliceExtractor(void);
+	
+	/* Methods from Visualization::Abstract::Algorithm: */
+	virtual const char* getName(void) const
+		{
+		return name;
+		}
+	virtual bool hasSeededCreator(void) const
+		{
+		return true;
+		}
+	virtual GLMotif::Widget* createSettingsDialog(GLMotif::WidgetManager* widgetManager);
+	virtual void readParameters(Visualization::Abstract::ParametersSource& source);
+	virtual Visualization::Abstract::Parameters* cloneParameters(void) const
+		{
+		return new Parameters(parameters);
+		}
+	virtual void setSeedLocator(const Visualization::Abstract::DataSet::Locator* seedLocator);
+	virtual Visualization::Abstract::Element* createElement(Visualization::Abstract::Parameters* extractParameters);
+	virtual Visualization::Abstract::Element* startSlaveElement(Visualization::Abstract::Parameters* extractParameters);
+	virtual void continueSlaveElement(void);
+	
+	/* New methods: */
+	static const char* getClassName(void) // Returns the algorithm class name
+		{
+		return name;
+		}
+	void resolutionCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
+	void filterLengthCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_WRAPPERS_LICSLICEEXTRACTOR_IMPLEMENTATION
+#include <Wrappers/LICSliceExtractor.icpp>
+#endif
+
+#endif
@@ -1,7 +1,7 @@
 /***********************************************************************
 Module - Wrapper class to combine templatized data set representations
 and templatized algorithms into a polymorphic visualization module.
-Copyright (c) 2006-2011 Oliver Kreylos
+Copyright (c) 2006-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -51,7 +51,13 @@ class StreamlineExtractor;
 template <class DataSetWrapperParam>
 class MultiStreamlineExtractor;
 template <class DataSetWrapperParam>
+class EvenlySpacedStreamlineExtractor;
+template <class DataSetWrapperParam>
+class LICSliceExtractor;
+template <class DataSetWrapperParam>
 class StreamsurfaceExtractor;
+template <class DataSetWrapperParam>
+class ParticleCloudExtractor;
 }
 }
 
@@ -78,9 +84,22 @@ class Module:public Visualization::Abstract::Module
 	typedef Visualization::Wrappers::ArrowRakeExtractor<DataSet> ArrowRakeExtractor; // Arrow rake extractor class
 	typedef Visualization::Wrappers::StreamlineExtractor<DataSet> StreamlineExtractor; // Streamline extractor class
 	typedef Visualization::Wrappers::MultiStreamlineExtractor<DataSet> MultiStreamlineExtractor; // Streamline bundle extractor class
+	typedef Visualization::Wrappers::EvenlySpacedStreamlineExtractor<DataSet> EvenlySpacedStreamlineExtractor; // Evenly-spaced streamline extractor class
+	typedef Visualization::Wrappers::LICSliceExtractor<DataSet> LICSliceExtractor; // Line integral convolution slice extractor class
 	typedef Visualization::Wrappers::StreamsurfaceExtractor<DataSet> StreamsurfaceExtractor; // Stream surface extractor class
+	typedef Visualization::Wrappers::ParticleCloudExtractor<DataSet> ParticleCloudExtractor; // Particle cloud extractor class
+	
+	/* Protected methods: */
+	protected:
+	virtual DataSet* createDataSet(const std::vector<std::string>& args) const; // Creates an empty data set wrapper of the same type as created by the load method; returns null if the module's data sets cannot be recreated from cache files
+	
+	/* Protected methods from Visualization::Abstract::Module: */
+	virtual bool writeDataSetCache(const std::vector<std::string>& args,const Visualization::Abstract::DataSet* dataSet,IO::File& cacheFile) const;
+	virtual void loadDeferredData(const Visualization::Abstract::DataSet* dataSet) const;
+	virtual Visualization::Abstract::DataSet* readDataSetCache(const std::vector<std::string>& args,IO::File& cacheFile) const;
 	
 	/* Constructors and destructors: */
+	public:
 	Module(const char* sClassName);
 	
 	/* Methods: */
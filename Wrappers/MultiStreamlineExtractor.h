@@ -2,7 +2,7 @@
 MultiStreamlineExtractor - Wrapper class to map from the abstract
 visualization algorithm interface to a templatized multi-streamline
 extractor implementation.
-Copyright (c) 2006-2012 Oliver Kreylos
+Copyright (c) 2006-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -32,6 +32,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Abstract/Algorithm.h>
 
 #include <Wrappers/MultiStreamline.h>
+#include <Wrappers/StreamlineCache.h>
 
 /* Forward declarations: */
 namespace Visualization {
@@ -82,6 +83,7 @@ class MultiStreamlineExtractor:public Visualization::Abstract::Algorithm
 	typedef Visualization::Wrappers::MultiStreamline<DataSetWrapper> MultiStreamline; // Type of created visualization elements
 	typedef Misc::Autopointer<MultiStreamline> MultiStreamlinePointer; // Type for pointers to created visualization elements
 	typedef typename MultiStreamline::MultiPolyline MultiPolyline; // Type of low-level multi-streamline representation
+	typedef typename MultiPolyline::Vertex Vertex; // Type of streamline vertices
 	typedef Visualization::Templatized::MultiStreamlineExtractor<DS,VE,SE,MultiPolyline> MSLE; // Type of templatized multi-streamline extractor
 	
 	private:
@@ -131,6 +133,7 @@ class MultiStreamlineExtractor:public Visualization::Abstract::Algorithm
 	Parameters parameters; // The streamline extraction parameters used by this extractor
 	MSLE msle; // The templatized multistreamline extractor
 	MultiStreamlinePointer currentMultiStreamline; // The currently extracted multi-streamline visualization element
+	bool currentCached; // Flag whether the currently extracted multi-streamline was retrieved from the streamline cache
 	
 	/* UI elements: */
 	GLMotif::TextFieldSlider* maxNumVerticesSlider;
@@ -138,6 +141,11 @@ class MultiStreamlineExtractor:public Visualization::Abstract::Algorithm
 	GLMotif::TextFieldSlider* numStreamlinesSlider;
 	GLMotif::TextFieldSlider* diskRadiusSlider;
 	
+	/* Private methods: */
+	StreamlineCache::Key getCacheKey(const Parameters& extractParameters) const; // Returns the streamline cache key for the given extraction parameters
+	bool retrieveMultiStreamline(const Parameters& extractParameters,MultiPolyline& multiPolyline) const; // Fills the given empty multi-polyline from the streamline cache; returns false on a cache miss
+	void cacheMultiStreamline(const Parameters& extractParameters,const MultiPolyline& multiPolyline) const; // Stores the given completely extracted multi-polyline in the streamline cache
+	
 	/* Constructors and destructors: */
 	public:
 	MultiStreamlineExtractor(Visualization::Abstract::VariableManager* sVariableManager,Cluster::MulticastPipe* sPipe); // Creates a multi-streamline extractor
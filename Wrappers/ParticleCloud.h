@@ -0,0 +1,86 @@
+/***********************************************************************
+ParticleCloud - Wrapper class for clouds of advected particles as
+visualization elements.
+Part of the wrapper layer of the templatized visualization
+components.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_WRAPPERS_PARTICLECLOUD_INCLUDED
+#define VISUALIZATION_WRAPPERS_PARTICLECLOUD_INCLUDED
+
+#include <vector>
+#include <Threads/Mutex.h>
+#include <GL/gl.h>
+#include <GL/GLVertex.h>
+
+#include <Abstract/Element.h>
+
+namespace Visualization {
+
+namespace Wrappers {
+
+template <class DataSetWrapperParam>
+class ParticleCloud:public Visualization::Abstract::Element
+	{
+	/* Embedded classes: */
+	public:
+	typedef Visualization::Abstract::Element Base; // Base class
+	typedef DataSetWrapperParam DataSetWrapper; // Compatible data set type
+	typedef GLVertex<GLfloat,1,void,0,void,GLfloat,3> Vertex; // Data type for particle vertices, as created by the templatized particle advector
+	
+	/* Elements: */
+	private:
+	int scalarVariableIndex; // Index of the scalar variable used to color the particles
+	Cluster::MulticastPipe* pipe; // Pipe to send particles from the master node to the slave nodes
+	mutable Threads::Mutex pointsMutex; // Mutex serializing access to the particles between the extractor and rendering threads
+	std::vector<Vertex> points; // Current particle positions and scalar values
+	
+	/* Constructors and destructors: */
+	public:
+	ParticleCloud(Visualization::Abstract::VariableManager* sVariableManager,Visualization::Abstract::Parameters* sParameters,int sScalarVariableIndex,Cluster::MulticastPipe* sPipe); // Creates an empty particle cloud for the given parameters
+	private:
+	ParticleCloud(const ParticleCloud& source); // Prohibit copy constructor
+	ParticleCloud& operator=(const ParticleCloud& source); // Prohibit assignment operator
+	public:
+	virtual ~ParticleCloud(void);
+	
+	/* Methods from Visualization::Abstract::Element: */
+	virtual std::string getName(void) const;
+	virtual size_t getSize(void) const;
+	virtual void glRenderAction(GLRenderState& renderState) const;
+	
+	/* New methods: */
+	void setPoints(const std::vector<Vertex>& newPoints); // Replaces the current particles; sends them to the slave nodes if called on the master node
+	void receivePoints(void); // Replaces the current particles with the next set of particles sent by the master node
+	size_t getElementSize(void) const // Returns the number of particles in the cloud
+		{
+		return getSize();
+		}
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_WRAPPERS_PARTICLECLOUD_IMPLEMENTATION
+#include <Wrappers/ParticleCloud.icpp>
+#endif
+
+#endif
@@ -0,0 +1,200 @@
+/***********************************************************************
+ParticleCloudExtractor - Wrapper class to map from the abstract
+visualization algorithm interface to a templatized particle advector
+implementation.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_WRAPPERS_PARTICLECLOUDEXTRACTOR_INCLUDED
+#define VISUALIZATION_WRAPPERS_PARTICLECLOUDEXTRACTOR_INCLUDED
+
+#include <Misc/Autopointer.h>
+#include <GLMotif/TextFieldSlider.h>
+
+#include <Abstract/DataSet.h>
+#include <Abstract/Parameters.h>
+#include <Abstract/Algorithm.h>
+
+#include <Wrappers/ParticleCloud.h>
+
+/* Forward declarations: */
+namespace Visualization {
+namespace Abstract {
+class VectorExtractor;
+class ScalarExtractor;
+class Element;
+}
+namespace Templatized {
+template <class VectorParam,class SourceValueParam>
+class VectorExtractor;
+template <class ScalarParam,class SourceValueParam>
+class ScalarExtractor;
+template <class DataSetParam,class VectorExtractorParam,class ScalarExtractorParam>
+class ParticleAdvector;
+}
+namespace Wrappers {
+template <class VEParam>
+class VectorExtractor;
+template <class SEParam>
+class ScalarExtractor;
+}
+}
+
+namespace Visualization {
+
+namespace Wrappers {
+
+template <class DataSetWrapperParam>
+class ParticleCloudExtractor:public Visualization::Abstract::Algorithm
+	{
+	/* Embedded classes: */
+	public:
+	typedef Visualization::Abstract::Algorithm Base; // Base class
+	typedef DataSetWrapperParam DataSetWrapper; // Compatible data set type
+	typedef typename DataSetWrapper::DS DS; // Type of templatized data set
+	typedef typename DS::Scalar Scalar; // Scalar type of templatized data set
+	static const int dimension=DS::dimension; // Dimension of data set's domain
+	typedef typename DS::Point Point; // Type for points in data set's domain
+	typedef typename DataSetWrapper::DSL DSL; // Type of templatized locator
+	typedef typename DataSetWrapper::Locator Locator; // Type of locator wrapper
+	typedef typename DataSetWrapper::VE VE; // Type of templatized vector extractor
+	typedef typename DataSetWrapper::VectorExtractor VectorExtractor; // Compatible vector extractor wrapper class
+	typedef typename DataSetWrapper::SE SE; // Type of templatized scalar extractor
+	typedef typename DataSetWrapper::ScalarExtractor ScalarExtractor; // Compatible scalar extractor wrapper class
+	typedef Visualization::Wrappers::ParticleCloud<DataSetWrapper> ParticleCloud; // Type of created visualization elements
+	typedef Misc::Autopointer<ParticleCloud> ParticleCloudPointer; // Type for pointers to created visualization elements
+	typedef Visualization::Templatized::ParticleAdvector<DS,VE,SE> PA; // Type of templatized particle advector
+	
+	private:
+	class Parameters:public Visualization::Abstract::Parameters // Class to store extraction parameters for particle clouds
+		{
+		friend class ParticleCloudExtractor;
+		
+		/* Elements: */
+		private:
+		int vectorVariableIndex; // Index of the vector variable advecting the particles
+		int colorScalarVariableIndex; // Index of the scalar variable used to color the particles
+		unsigned int numParticles; // Number of particles to seed
+		Scalar seedRadius; // Radius of the sphere around the seed point in which particles are seeded
+		Scalar stepSize; // Fixed particle advection step size
+		Scalar advectionTime; // Total time for which particles are advected
+		Point seedPoint; // Center of the seeded particle cloud
+		const DS* ds; // Data set in which to advect particles
+		const VE* ve; // Vector extractor for data set
+		const SE* cse; // Color scalar extractor for data set
+		DSL dsl; // Templatized data set locator following the seed point
+		bool locatorValid; // Flag if the locator has been properly initialized, and is inside the data set's domain
+		
+		/* Constructors and destructors: */
+		public:
+		Parameters(Visualization::Abstract::VariableManager* variableManager);
+		
+		/* Methods from Abstract::Parameters: */
+		virtual bool isValid(void) const
+			{
+			return locatorValid;
+			}
+		virtual Visualization::Abstract::Parameters* clone(void) const
+			{
+			return new Parameters(*this);
+			}
+		virtual void write(Visualization::Abstract::ParametersSink& sink) const;
+		virtual void read(Visualization::Abstract::ParametersSource& source);
+		
+		/* New methods: */
+		void update(Visualization::Abstract::VariableManager* variableManager,bool track); // Updates derived parameters after a read operation
+		};
+	
+	/* Elements: */
+	private:
+	static const char* name; // Identifying name of this algorithm
+	Parameters parameters; // The particle cloud extraction parameters used by this extractor
+	PA pa; // The templatized particle advector
+	ParticleCloudPointer currentParticleCloud; // The currently extracted particle cloud visualization element
+	size_t numStepsLeft; // Number of advection steps left for the currently extracted particle cloud
+	
+	/* UI components: */
+	GLMotif::TextFieldSlider* numParticlesSlider;
+	GLMotif::TextFieldSlider* seedRadiusSlider;
+	GLMotif::TextFieldSlider* stepSizeSlider;
+	GLMotif::TextFieldSlider* advectionTimeSlider;
+	
+	/* Private methods: */
+	void seedParticles(const Parameters& extractParameters); // Prepares the particle advector and seeds a new particle cloud for the given extraction parameters
+	
+	/* Constructors and destructors: */
+	public:
+	ParticleCloudExtractor(Visualization::Abstract::VariableManager* sVariableManager,Cluster::MulticastPipe* sPipe); // Creates a particle cloud extractor
+	virtual ~ParticleCloudExtractor(void);
+	
+	/* Methods from Visualization::Abstract::Algorithm: */
+	virtual const char* getName(void) const
+		{
+		return name;
+		}
+	virtual bool hasSeededCreator(void) const
+		{
+		return true;
+		}
+	virtual bool hasIncrementalCreator(void) const
+		{
+		return true;
+		}
+	virtual GLMotif::Widget* createSettingsDialog(GLMotif::WidgetManager* widgetManager);
+	virtual void readParameters(Visualization::Abstract::ParametersSource& source);
+	virtual Visualization::Abstract::Parameters* cloneParameters(void) const
+		{
+		return new Parameters(parameters);
+		}
+	virtual void setSeedLocator(const Visualization::Abstract::DataSet::Locator* seedLocator);
+	virtual Visualization::Abstract::Element* createElement(Visualization::Abstract::Parameters* extractParameters);
+	virtual Visualization::Abstract::Element* startElement(Visualization::Abstract::Parameters* extractParameters);
+	virtual bool continueElement(const Realtime::AlarmTimer& alarm);
+	virtual void finishElement(void);
+	virtual Visualization::Abstract::Element* startSlaveElement(Visualization::Abstract::Parameters* extractParameters);
+	virtual void continueSlaveElement(void);
+	
+	/* New methods: */
+	static const char* getClassName(void) // Returns the algorithm class name
+		{
+		return name;
+		}
+	const PA& getPa(void) const // Returns the templatized particle advector
+		{
+		return pa;
+		}
+	PA& getPa(void) // Ditto
+		{
+		return pa;
+		}
+	void numParticlesCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
+	void seedRadiusCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
+	void stepSizeCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
+	void advectionTimeCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_WRAPPERS_PARTICLECLOUDEXTRACTOR_IMPLEMENTATION
+#include <Wrappers/ParticleCloudExtractor.icpp>
+#endif
+
+#endif
@@ -0,0 +1,195 @@
+/***********************************************************************
+PathlineExtractor - Wrapper class to map from the abstract visualization
+algorithm interface to a templatized pathline and streakline extractor
+implementation.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_WRAPPERS_PATHLINEEXTRACTOR_INCLUDED
+#define VISUALIZATION_WRAPPERS_PATHLINEEXTRACTOR_INCLUDED
+
+#include <Misc/Autopointer.h>
+#include <GLMotif/RadioBox.h>
+#include <GLMotif/TextFieldSlider.h>
+
+#include <Abstract/DataSet.h>
+#include <Abstract/Parameters.h>
+#include <Abstract/Algorithm.h>
+
+#include <Wrappers/Streamline.h>
+#include <Wrappers/TimeVaryingDataSet.h>
+
+/* Forward declarations: */
+namespace Visualization {
+namespace Abstract {
+class VectorExtractor;
+class ScalarExtractor;
+class Element;
+}
+namespace Templatized {
+template <class VectorParam,class SourceValueParam>
+class VectorExtractor;
+template <class ScalarParam,class SourceValueParam>
+class ScalarExtractor;
+template <class DataSetParam,class VectorExtractorParam,class ScalarExtractorParam,class PolylineParam>
+class PathlineExtractor;
+}
+namespace Wrappers {
+template <class VEParam>
+class VectorExtractor;
+template <class SEParam>
+class ScalarExtractor;
+}
+}
+
+namespace Visualization {
+
+namespace Wrappers {
+
+template <class DataSetWrapperParam>
+class PathlineExtractor:public Visualization::Abstract::Algorithm
+	{
+	/* Embedded classes: */
+	public:
+	typedef Visualization::Abstract::Algorithm Base; // Base class
+	typedef DataSetWrapperParam DataSetWrapper; // Compatible data set type
+	typedef Visualization::Wrappers::TimeVaryingDataSet<DataSetWrapper> TimeVaryingDataSet; // Compatible time-varying data set type
+	typedef typename TimeVaryingDataSet::TimeSeries TimeSeries; // Type of time series providing the time steps
+	typedef typename DataSetWrapper::DS DS; // Type of templatized data set
+	typedef typename DS::Scalar Scalar; // Scalar type of templatized data set, also used for simulation time
+	static const int dimension=DS::dimension; // Dimension of data set's domain
+	typedef typename DS::Point Point; // Type for points in data set's domain
+	typedef typename DataSetWrapper::DSL DSL; // Type of templatized locator
+	typedef typename DataSetWrapper::Locator Locator; // Type of locator wrapper
+	typedef typename DataSetWrapper::VE VE; // Type of templatized vector extractor
+	typedef typename DataSetWrapper::VectorExtractor VectorExtractor; // Compatible vector extractor wrapper class
+	typedef typename DataSetWrapper::SE SE; // Type of templatized scalar extractor
+	typedef typename DataSetWrapper::ScalarExtractor ScalarExtractor; // Compatible scalar extractor wrapper class
+	typedef Visualization::Wrappers::Streamline<DataSetWrapper> Streamline; // Type of created visualization elements
+	typedef Misc::Autopointer<Streamline> StreamlinePointer; // Type for pointers to created visualization elements
+	typedef typename Streamline::Polyline Polyline; // Type of low-level pathline representation
+	typedef Visualization::Templatized::PathlineExtractor<DS,VE,SE,Polyline> PLE; // Type of templatized pathline extractor
+	
+	private:
+	class Parameters:public Visualization::Abstract::Parameters // Class to store extraction parameters for pathlines and streaklines
+		{
+		friend class PathlineExtractor;
+		
+		/* Elements: */
+		private:
+		int vectorVariableIndex; // Index of the vector variable advecting the particles
+		int colorScalarVariableIndex; // Index of the scalar variable used to color the pathlines
+		bool streakline; // Flag whether to extract streaklines instead of pathlines
+		size_t maxNumVertices; // Maximum number of vertices to be extracted
+		Scalar stepSize; // Maximum integration step size in simulation time
+		Scalar startTime; // Simulation time at which the first particle is released
+		Scalar endTime; // Simulation time at which particle advection ends
+		Scalar releaseInterval; // Simulation time between particle releases for streaklines
+		Point seedPoint; // The point at which particles are released
+		const TimeVaryingDataSet* tvds; // Time-varying data set from which to extract pathlines
+		const VE* ve; // Vector extractor for data set
+		const SE* cse; // Color scalar extractor for data set
+		DSL dsl; // Templatized data set locator following the seed point in the data set's first time step
+		bool locatorValid; // Flag if the locator has been properly initialized, and is inside the data set's domain
+		
+		/* Constructors and destructors: */
+		public:
+		Parameters(Visualization::Abstract::VariableManager* variableManager);
+		
+		/* Methods from Abstract::Parameters: */
+		virtual bool isValid(void) const
+			{
+			return locatorValid;
+			}
+		virtual Visualization::Abstract::Parameters* clone(void) const
+			{
+			return new Parameters(*this);
+			}
+		virtual void write(Visualization::Abstract::ParametersSink& sink) const;
+		virtual void read(Visualization::Abstract::ParametersSource& source);
+		
+		/* New methods: */
+		void update(Visualization::Abstract::VariableManager* variableManager,bool track); // Updates derived parameters after a read operation
+		};
+	
+	/* Elements: */
+	private:
+	static const char* name; // Identifying name of this algorithm
+	Parameters parameters; // The pathline extraction parameters used by this extractor
+	const TimeVaryingDataSet* timeSeriesDataSet; // Time-varying data set whose time steps are loaded by the time series
+	TimeSeries* timeSeries; // Time series providing the time steps to the pathline extractor; created on first extraction on the master node
+	PLE* ple; // The templatized pathline extractor; created together with the time series
+	
+	/* UI components: */
+	GLMotif::RadioBox* lineTypeBox;
+	GLMotif::TextFieldSlider* maxNumVerticesSlider;
+	GLMotif::TextFieldSlider* stepSizeSlider;
+	GLMotif::TextFieldSlider* startTimeSlider;
+	GLMotif::TextFieldSlider* endTimeSlider;
+	GLMotif::TextFieldSlider* releaseIntervalSlider;
+	
+	/* Private methods: */
+	void preparePle(const Parameters& extractParameters); // Creates the time series and templatized pathline extractor if necessary and sets them up for the given extraction parameters
+	
+	/* Constructors and destructors: */
+	public:
+	PathlineExtractor(Visualization::Abstract::VariableManager* sVariableManager,Cluster::MulticastPipe* sPipe); // Creates a pathline extractor
+	virtual ~PathlineExtractor(void);
+	
+	/* Methods from Visualization::Abstract::Algorithm: */
+	virtual const char* getName(void) const
+		{
+		return name;
+		}
+	virtual bool hasSeededCreator(void) const
+		{
+		return true;
+		}
+	virtual GLMotif::Widget* createSettingsDialog(GLMotif::WidgetManager* widgetManager);
+	virtual void readParameters(Visualization::Abstract::ParametersSource& source);
+	virtual Visualization::Abstract::Parameters* cloneParameters(void) const
+		{
+		return new Parameters(parameters);
+		}
+	virtual void setSeedLocator(const Visualization::Abstract::DataSet::Locator* seedLocator);
+	virtual Visualization::Abstract::Element* createElement(Visualization::Abstract::Parameters* extractParameters);
+	virtual Visualization::Abstract::Element* startSlaveElement(Visualization::Abstract::Parameters* extractParameters);
+	
+	/* New methods: */
+	static const char* getClassName(void) // Returns the algorithm class name
+		{
+		return name;
+		}
+	void lineTypeBoxCallback(GLMotif::RadioBox::ValueChangedCallbackData* cbData);
+	void maxNumVerticesCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
+	void stepSizeCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
+	void startTimeCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
+	void endTimeCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
+	void releaseIntervalCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_WRAPPERS_PATHLINEEXTRACTOR_IMPLEMENTATION
+#include <Wrappers/PathlineExtractor.icpp>
+#endif
+
+#endif
@@ -2,7 +2,7 @@
 SlicedScalarVectorDataValue - Class for data value descriptors giving
 access to multiple scalar and/or vector variables stored in a sliced
 data set.
-Copyright (c) 2008 Oliver Kreylos
+Copyright (c) 2008-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 ***********************************************************************/
 
 #include <string.h>
+#include <stdexcept>
 
 #include <Wrappers/SlicedScalarVectorDataValue.h>
 
@@ -33,8 +34,22 @@ namespace Wrappers {
 Methods of class SlicedScalarVectorDataValueBase:
 ************************************************/
 
+void SlicedScalarVectorDataValueBase::deleteSliceLoaders(void)
+	{
+	/* Delete each loader once, even if it is shared by several scalar variables: */
+	for(int i=0;i<numScalarVariables;++i)
+		if(scalarVariableLoaders[i]!=0)
+			{
+			SliceLoader* loader=scalarVariableLoaders[i];
+			for(int j=i;j<numScalarVariables;++j)
+				if(scalarVariableLoaders[j]==loader)
+					scalarVariableLoaders[j]=0;
+			delete loader;
+			}
+	}
+
 SlicedScalarVectorDataValueBase::SlicedScalarVectorDataValueBase(void)
-	:numScalarVariables(0),scalarVariableNames(0),
+	:numScalarVariables(0),scalarVariableNames(0),scalarVariableLoaders(0),
 	 numVectorComponents(0),
 	 numVectorVariables(0),vectorVariableNames(0),vectorVariableScalarIndices(0)
 	{
@@ -42,6 +57,8 @@ SlicedScalarVectorDataValueBase::SlicedScalarVectorDataValueBase(void)
 
 SlicedScalarVectorDataValueBase::~SlicedScalarVectorDataValueBase(void)
 	{
+	deleteSliceLoaders();
+	delete[] scalarVariableLoaders;
 	for(int i=0;i<numScalarVariables;++i)
 		delete[] scalarVariableNames[i];
 	delete[] scalarVariableNames;
@@ -54,13 +71,19 @@ SlicedScalarVectorDataValueBase::~SlicedScalarVectorDataValueBase(void)
 void SlicedScalarVectorDataValueBase::initialize(int sNumScalarVariables,int sNumVectorComponents,int sNumVectorVariables)
 	{
 	/* Initialize scalar value arrays: */
+	deleteSliceLoaders();
+	delete[] scalarVariableLoaders;
 	for(int i=0;i<numScalarVariables;++i)
 		delete[] scalarVariableNames[i];
 	delete[] scalarVariableNames;
 	numScalarVariables=sNumScalarVariables;
 	scalarVariableNames=new char*[numScalarVariables];
+	scalarVariableLoaders=new SliceLoader*[numScalarVariables];
 	for(int i=0;i<numScalarVariables;++i)
+		{
 		scalarVariableNames[i]=0;
+		scalarVariableLoaders[i]=0;
+		}
 	
 	/* Initialize vector variable arrays: */
 	for(int i=0;i<numVectorVariables;++i)
@@ -98,19 +121,74 @@ int SlicedScalarVectorDataValueBase::addScalarVariable(const char* newScalarVari
 	{
 	/* Make room in the scalar variable array and copy the old variable names and create the new one: */
 	char** newScalarVariableNames=new char*[numScalarVariables+1];
+	SliceLoader** newScalarVariableLoaders=new SliceLoader*[numScalarVariables+1];
 	for(int i=0;i<numScalarVariables;++i)
+		{
 		newScalarVariableNames[i]=scalarVariableNames[i];
+		newScalarVariableLoaders[i]=scalarVariableLoaders[i];
+		}
 	newScalarVariableNames[numScalarVariables]=new char[strlen(newScalarVariableName)+1];
 	strcpy(newScalarVariableNames[numScalarVariables],newScalarVariableName);
+	newScalarVariableLoaders[numScalarVariables]=0;
 	
 	/* Install the new scalar variable array: */
 	delete[] scalarVariableNames;
+	delete[] scalarVariableLoaders;
 	++numScalarVariables;
 	scalarVariableNames=newScalarVariableNames;
+	scalarVariableLoaders=newScalarVariableLoaders;
 	
 	return numScalarVariables-1;
 	}
 
+void SlicedScalarVectorDataValueBase::setSliceLoader(int firstScalarVariableIndex,int numLoaderScalarVariables,SlicedScalarVectorDataValueBase::SliceLoader* loader)
+	{
+	Threads::Mutex::Lock loaderLock(loaderMutex);
+	for(int i=0;i<numLoaderScalarVariables;++i)
+		scalarVariableLoaders[firstScalarVariableIndex+i]=loader;
+	}
+
+void SlicedScalarVectorDataValueBase::loadScalarVariable(int scalarVariableIndex) const
+	{
+	/* Get the scalar variable's loader: */
+	SliceLoader* loader;
+	{
+	Threads::Mutex::Lock loaderLock(loaderMutex);
+	loader=scalarVariableLoaders[scalarVariableIndex];
+	}
+	if(loader==0)
+		return;
+	
+	/* Hold only the loader's own lock while reading, so that other groups can be read concurrently: */
+	Threads::Mutex::Lock loadLock(loader->loadMutex);
+	
+	/* Report an earlier failure again; the group's slices may be partially written and must not be handed out: */
+	if(!loader->loadError.empty())
+		throw std::runtime_error(loader->loadError);
+	
+	if(!loader->loaded)
+		{
+		/* Read the loader's entire group: */
+		try
+			{
+			loader->loadSlices();
+			}
+		catch(std::runtime_error err)
+			{
+			/* Remember the error to report it consistently on every following use of the group: */
+			loader->loadError=err.what();
+			throw;
+			}
+		loader->loaded=true;
+		}
+	}
+
+void SlicedScalarVectorDataValueBase::loadAllScalarVariables(void) const
+	{
+	for(int i=0;i<numScalarVariables;++i)
+		loadScalarVariable(i);
+	}
+
 void SlicedScalarVectorDataValueBase::setVectorVariableName(int vectorVariableIndex,const char* newVectorVariableName)
 	{
 	delete[] vectorVariableNames[vectorVariableIndex];
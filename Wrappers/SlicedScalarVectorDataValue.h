@@ -2,7 +2,7 @@
 SlicedScalarVectorDataValue - Class for data value descriptors giving
 access to multiple scalar and/or vector variables stored in a sliced
 data set.
-Copyright (c) 2008 Oliver Kreylos
+Copyright (c) 2008-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -24,6 +24,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef VISUALIZATION_WRAPPERS_SLICEDSCALARVECTORDATAVALUE_INCLUDED
 #define VISUALIZATION_WRAPPERS_SLICEDSCALARVECTORDATAVALUE_INCLUDED
 
+#include <string>
+#include <Threads/Mutex.h>
+
 #include <Templatized/SlicedScalarExtractor.h>
 #include <Templatized/SlicedVectorExtractor.h>
 #include <Wrappers/DataValue.h>
@@ -34,15 +37,46 @@ namespace Wrappers {
 
 class SlicedScalarVectorDataValueBase // Base class managing variable naming and indexing
 	{
+	/* Embedded classes: */
+	public:
+	class SliceLoader // Abstract base class for objects reading the values of a group of scalar variables on first use
+		{
+		friend class SlicedScalarVectorDataValueBase;
+		
+		/* Elements: */
+		private:
+		Threads::Mutex loadMutex; // Mutex serializing reading of the loader's group
+		bool loaded; // Flag whether the loader's group has been read successfully
+		std::string loadError; // Error message from a failed attempt to read the loader's group; failed groups are never read again
+		
+		/* Constructors and destructors: */
+		public:
+		SliceLoader(void)
+			:loaded(false)
+			{
+			}
+		virtual ~SliceLoader(void)
+			{
+			}
+		
+		/* Methods: */
+		virtual void loadSlices(void) =0; // Reads the values of all scalar variables in the loader's group into their data set slices; should release the loader's resources when done
+		};
+	
 	/* Elements: */
 	private:
 	int numScalarVariables; // Number of scalar variables in the sliced data set
 	char** scalarVariableNames; // Array of names of the individual scalar variables
+	SliceLoader** scalarVariableLoaders; // Array of loaders for scalar variables whose values are read on first use, or null for variables that were read at load time
+	mutable Threads::Mutex loaderMutex; // Mutex protecting the scalar variable loader array
 	int numVectorComponents; // Dimension of vectors
 	int numVectorVariables; // Number of vector variables in the sliced data set
 	char** vectorVariableNames; // Array of names of the individual vector variables
 	int* vectorVariableScalarIndices; // 2D array of indices of scalar variables defining each vector variable
 	
+	/* Private methods: */
+	void deleteSliceLoaders(void); // Deletes all loaders of unread scalar variables
+	
 	/* Constructors and destructors: */
 	public:
 	SlicedScalarVectorDataValueBase(void); // Creates uninitialized data value
@@ -50,6 +84,9 @@ class SlicedScalarVectorDataValueBase // Base class managing variable naming and
 	
 	/* Methods: */
 	void initialize(int sNumScalarVariables,int sNumVectorComponents,int sNumVectorVariables); // Prepares data value for the given number of scalar and vector variables
+	void setSliceLoader(int firstScalarVariableIndex,int numLoaderScalarVariables,SliceLoader* loader); // Defers reading the values of the given range of scalar variables until one of them is first used; adopts loader
+	void loadScalarVariable(int scalarVariableIndex) const; // Reads the values of the given scalar variable and the rest of its loader's group if they have not been read yet; throws the same exception on every call if reading the group failed
+	void loadAllScalarVariables(void) const; // Reads the values of all scalar variables that have not been read yet
 	void setScalarVariableName(int scalarVariableIndex,const char* newScalarVariableName); // Sets the given scalar variable's name
 	int addScalarVariable(const char* newScalarVariableName); // Adds another scalar variable
 	void setVectorVariableName(int vectorVariableIndex,const char* newVectorVariableName); // Sets the given vector variable's name
@@ -118,13 +155,18 @@ class SlicedScalarVectorDataValue:public SlicedScalarVectorDataValueBase,public
 	using SlicedScalarVectorDataValueBase::getVectorVariableName;
 	SE getScalarExtractor(int scalarVariableIndex) const
 		{
+		loadScalarVariable(scalarVariableIndex);
 		return SE(scalarVariableIndex,dataSet->getSliceArray(scalarVariableIndex));
 		}
 	VE getVectorExtractor(int vectorVariableIndex) const
 		{
 		VE result;
 		for(int i=0;i<dimension;++i)
-			result.setSlice(i,dataSet->getSliceArray(getVectorVariableScalarIndex(vectorVariableIndex,i)));
+			{
+			int scalarVariableIndex=getVectorVariableScalarIndex(vectorVariableIndex,i);
+			loadScalarVariable(scalarVariableIndex);
+			result.setSlice(i,dataSet->getSliceArray(scalarVariableIndex));
+			}
 		return result;
 		}
 	};
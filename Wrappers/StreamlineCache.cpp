@@ -0,0 +1,267 @@
+/***********************************************************************
+StreamlineCache - Class to cache extracted streamline polylines and
+stream surfaces keyed by their extraction parameters, to avoid
+re-integrating streamlines from the same seeds, with an in-memory tier
+and an optional on-disk tier.
+Part of the wrapper layer of the templatized visualization
+components.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <Wrappers/StreamlineCache.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdexcept>
+#include <Misc/Endianness.h>
+#include <IO/File.h>
+#include <IO/OpenFile.h>
+
+#include <Abstract/Module.h>
+
+namespace Visualization {
+
+namespace Wrappers {
+
+namespace {
+
+/****************
+Helper constants:
+****************/
+
+const char cacheFileMagic[]="Visualizer streamline cache file v1.0\n";
+
+}
+
+/****************************************
+Static elements of class StreamlineCache:
+****************************************/
+
+StreamlineCache StreamlineCache::theCache;
+
+/********************************
+Methods of class StreamlineCache:
+********************************/
+
+std::string StreamlineCache::getFileName(const std::string& fullKey) const
+	{
+	/* Name the file after a 64-bit FNV-1a hash of the full key; the key itself is stored in the file to resolve collisions: */
+	unsigned long long hash=0xcbf29ce484222325ULL;
+	for(std::string::const_iterator kIt=fullKey.begin();kIt!=fullKey.end();++kIt)
+		{
+		hash^=(unsigned long long)(unsigned char)(*kIt);
+		hash*=0x100000001b3ULL;
+		}
+	char hashName[32];
+	snprintf(hashName,sizeof(hashName),"%016llx.slc",hash);
+	return cacheDirectory+"/"+hashName;
+	}
+
+void StreamlineCache::insert(const std::string& fullKey,std::vector<char>& data)
+	{
+	/* Don't cache data larger than the entire in-memory tier: */
+	if(data.size()>maxMemorySize)
+		return;
+	
+	/* Replace an existing entry for the same key: */
+	EntryMap::iterator eIt=entries.find(fullKey);
+	if(eIt!=entries.end())
+		{
+		memorySize-=eIt->second.data.size();
+		lruList.erase(eIt->second.lruIt);
+		entries.erase(eIt);
+		}
+	
+	/* Evict the least recently used entries until the new data fits: */
+	while(memorySize+data.size()>maxMemorySize&&!lruList.empty())
+		{
+		EntryMap::iterator lruEIt=entries.find(lruList.back());
+		memorySize-=lruEIt->second.data.size();
+		entries.erase(lruEIt);
+		lruList.pop_back();
+		}
+	
+	/* Insert the new entry: */
+	lruList.push_front(fullKey);
+	Entry& entry=entries[fullKey];
+	entry.data.swap(data);
+	entry.lruIt=lruList.begin();
+	memorySize+=entry.data.size();
+	}
+
+bool StreamlineCache::lookupData(const StreamlineCache::Key& key,std::vector<char>& data)
+	{
+	Threads::Mutex::Lock lock(mutex);
+	std::string fullKey=dataSetId;
+	fullKey.push_back('\0');
+	fullKey.append(key.bytes);
+	
+	/* Check the in-memory tier first: */
+	EntryMap::iterator eIt=entries.find(fullKey);
+	if(eIt!=entries.end())
+		{
+		/* Mark the entry as most recently used: */
+		lruList.splice(lruList.begin(),lruList,eIt->second.lruIt);
+		data=eIt->second.data;
+		return true;
+		}
+	
+	/* Check the on-disk tier: */
+	if(cacheDirectory.empty()||dataSetId.empty()||module==0)
+		return false;
+	try
+		{
+		IO::FilePtr cacheFile(IO::openFile(getFileName(fullKey).c_str()));
+		cacheFile->setEndianness(Misc::LittleEndian);
+		
+		/* Check that the file was written for the same key: */
+		char magic[sizeof(cacheFileMagic)-1];
+		cacheFile->read<char>(magic,sizeof(magic));
+		if(memcmp(magic,cacheFileMagic,sizeof(magic))!=0)
+			return false;
+		unsigned int keySize=cacheFile->read<unsigned int>();
+		if(keySize!=fullKey.size())
+			return false;
+		std::vector<char> fileKey(keySize);
+		cacheFile->read<char>(&fileKey[0],keySize);
+		if(fullKey.compare(0,keySize,&fileKey[0],keySize)!=0)
+			return false;
+		
+		/* Check that the data set was not regenerated since the file was written: */
+		if(!Visualization::Abstract::Module::checkSourceFileStamps(*cacheFile))
+			return false;
+		
+		/* Read the cached data: */
+		unsigned int dataSize=cacheFile->read<unsigned int>();
+		std::vector<char> fileData(dataSize);
+		if(dataSize>0)
+			cacheFile->read<char>(&fileData[0],dataSize);
+		data=fileData;
+		
+		/* Promote the data to the in-memory tier: */
+		insert(fullKey,fileData);
+		return true;
+		}
+	catch(std::runtime_error)
+		{
+		/* Treat missing, stale, or truncated files as cache misses: */
+		return false;
+		}
+	}
+
+void StreamlineCache::storeData(const StreamlineCache::Key& key,std::vector<char>& data)
+	{
+	Threads::Mutex::Lock lock(mutex);
+	std::string fullKey=dataSetId;
+	fullKey.push_back('\0');
+	fullKey.append(key.bytes);
+	
+	if(!cacheDirectory.empty()&&!dataSetId.empty()&&module!=0)
+		{
+		/* Write the data to a temporary file and move it into place, so that concurrent readers never see partial files: */
+		std::string fileName=getFileName(fullKey);
+		char tempSuffix[32];
+		snprintf(tempSuffix,sizeof(tempSuffix),".%d",int(getpid()));
+		std::string tempFileName=fileName+tempSuffix;
+		try
+			{
+				{
+				IO::FilePtr cacheFile(IO::openFile(tempFileName.c_str(),IO::File::WriteOnly));
+				cacheFile->setEndianness(Misc::LittleEndian);
+				cacheFile->write<char>(cacheFileMagic,sizeof(cacheFileMagic)-1);
+				cacheFile->write<unsigned int>((unsigned int)(fullKey.size()));
+				cacheFile->write<char>(fullKey.data(),fullKey.size());
+				module->writeSourceFileStamps(*cacheFile);
+				cacheFile->write<unsigned int>((unsigned int)(data.size()));
+				if(!data.empty())
+					cacheFile->write<char>(&data[0],data.size());
+				}
+			rename(tempFileName.c_str(),fileName.c_str());
+			}
+		catch(std::runtime_error)
+			{
+			/* The on-disk tier is best-effort; ignore write errors: */
+			remove(tempFileName.c_str());
+			}
+		}
+	
+	/* Store the data in the in-memory tier: */
+	insert(fullKey,data);
+	}
+
+StreamlineCache::StreamlineCache(void)
+	:module(0),
+	 maxMemorySize(size_t(64)*1024*1024),memorySize(0)
+	{
+	/* Check for overrides from the environment: */
+	const char* maxMemorySizeEnv=getenv("VISUALIZER_STREAMLINECACHESIZE");
+	if(maxMemorySizeEnv!=0)
+		maxMemorySize=size_t(atoi(maxMemorySizeEnv))*1024*1024;
+	const char* cacheDirectoryEnv=getenv("VISUALIZER_STREAMLINECACHEDIR");
+	if(cacheDirectoryEnv!=0)
+		cacheDirectory=cacheDirectoryEnv;
+	}
+
+void StreamlineCache::setDataSet(const std::string& newDataSetId,const Visualization::Abstract::Module* newModule)
+	{
+	Threads::Mutex::Lock lock(mutex);
+	if(dataSetId!=newDataSetId||module!=newModule)
+		{
+		/* Entries for the old data set can no longer be hit: */
+		entries.clear();
+		lruList.clear();
+		memorySize=0;
+		dataSetId=newDataSetId;
+		module=newModule;
+		}
+	}
+
+void StreamlineCache::setMaxMemorySize(size_t newMaxMemorySize)
+	{
+	Threads::Mutex::Lock lock(mutex);
+	maxMemorySize=newMaxMemorySize;
+	
+	/* Evict the least recently used entries until the in-memory tier fits: */
+	while(memorySize>maxMemorySize&&!lruList.empty())
+		{
+		EntryMap::iterator lruEIt=entries.find(lruList.back());
+		memorySize-=lruEIt->second.data.size();
+		entries.erase(lruEIt);
+		lruList.pop_back();
+		}
+	}
+
+void StreamlineCache::setCacheDirectory(const std::string& newCacheDirectory)
+	{
+	Threads::Mutex::Lock lock(mutex);
+	cacheDirectory=newCacheDirectory;
+	}
+
+void StreamlineCache::clear(void)
+	{
+	Threads::Mutex::Lock lock(mutex);
+	entries.clear();
+	lruList.clear();
+	memorySize=0;
+	}
+
+}
+
+}
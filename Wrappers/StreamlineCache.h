@@ -0,0 +1,228 @@
+/***********************************************************************
+StreamlineCache - Class to cache extracted streamline polylines and
+stream surfaces keyed by their extraction parameters, to avoid
+re-integrating streamlines from the same seeds, with an in-memory tier
+and an optional on-disk tier.
+Part of the wrapper layer of the templatized visualization
+components.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_WRAPPERS_STREAMLINECACHE_INCLUDED
+#define VISUALIZATION_WRAPPERS_STREAMLINECACHE_INCLUDED
+
+#include <stddef.h>
+#include <string.h>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include <Threads/Mutex.h>
+
+/* Forward declarations: */
+namespace Visualization {
+namespace Abstract {
+class Module;
+}
+}
+
+namespace Visualization {
+
+namespace Wrappers {
+
+class StreamlineCache
+	{
+	/* Embedded classes: */
+	public:
+	class Key // Class to assemble cache keys from streamline extraction parameters
+		{
+		friend class StreamlineCache;
+		
+		/* Elements: */
+		private:
+		std::string bytes; // Binary representation of the key
+		
+		/* Constructors and destructors: */
+		public:
+		Key(const char* algorithmName) // Starts a key for the given extraction algorithm
+			:bytes(algorithmName,strlen(algorithmName)+1)
+			{
+			}
+		
+		/* Methods: */
+		template <class ValueParam>
+		Key& operator<<(const ValueParam& value) // Appends the binary representation of the given value to the key
+			{
+			bytes.append(reinterpret_cast<const char*>(&value),sizeof(ValueParam));
+			return *this;
+			}
+		};
+	
+	private:
+	typedef std::list<std::string> LruList; // Type for lists of keys in order of last use
+	
+	struct Entry // Structure for cached polyline data
+		{
+		/* Elements: */
+		public:
+		std::vector<char> data; // Serialized polyline data
+		LruList::iterator lruIt; // Position of the entry's key in the last-use list
+		};
+	
+	typedef std::map<std::string,Entry> EntryMap; // Type for maps from full keys to cached entries
+	
+	/* Elements: */
+	static StreamlineCache theCache; // The cache shared by all streamline extractors
+	Threads::Mutex mutex; // Mutex serializing access from concurrent extraction threads
+	std::string dataSetId; // Identifier of the current data set, prefixed to all keys
+	const Visualization::Abstract::Module* module; // Module that loaded the current data set, used to stamp on-disk entries with the data set's source files
+	size_t maxMemorySize; // Maximum amount of polyline data kept in memory in bytes
+	size_t memorySize; // Amount of polyline data currently kept in memory in bytes
+	EntryMap entries; // Map of in-memory cache entries
+	LruList lruList; // Keys of in-memory cache entries, most recently used first
+	std::string cacheDirectory; // Directory holding the on-disk tier, or empty to disable the on-disk tier
+	
+	/* Private methods: */
+	std::string getFileName(const std::string& fullKey) const; // Returns the name of the on-disk tier file for the given full key
+	void insert(const std::string& fullKey,std::vector<char>& data); // Moves the given data into the in-memory tier, evicting the least recently used entries as needed
+	bool lookupData(const Key& key,std::vector<char>& data); // Retrieves the serialized data for the given key; returns false on a cache miss
+	void storeData(const Key& key,std::vector<char>& data); // Stores the given serialized data under the given key; the data vector's contents are consumed
+	
+	/* Constructors and destructors: */
+	StreamlineCache(void); // Creates an empty cache configured from the environment
+	StreamlineCache(const StreamlineCache& source); // Prohibit copy constructor
+	StreamlineCache& operator=(const StreamlineCache& source); // Prohibit assignment operator
+	
+	/* Methods: */
+	public:
+	static StreamlineCache& getCache(void) // Returns the shared streamline cache
+		{
+		return theCache;
+		}
+	void setDataSet(const std::string& newDataSetId,const Visualization::Abstract::Module* newModule); // Sets the identifier of the current data set and the module that loaded it; on-disk caching requires a non-empty identifier and a module
+	void setMaxMemorySize(size_t newMaxMemorySize); // Sets the maximum size of the in-memory tier in bytes
+	void setCacheDirectory(const std::string& newCacheDirectory); // Sets the on-disk tier's directory; empty string disables the on-disk tier
+	void clear(void); // Removes all entries from the in-memory tier
+	template <class VertexParam>
+	bool lookup(const Key& key,std::vector<unsigned int>& numVertices,std::vector<VertexParam>& vertices) // Retrieves the vertex counts and concatenated vertices of a set of polylines; returns false on a cache miss
+		{
+		std::vector<char> data;
+		if(!lookupData(key,data)||data.size()<sizeof(unsigned int))
+			return false;
+		
+		/* Unpack the polyline vertex counts: */
+		const char* dPtr=&data[0];
+		unsigned int numPolylines;
+		memcpy(&numPolylines,dPtr,sizeof(unsigned int));
+		dPtr+=sizeof(unsigned int);
+		size_t headerSize=sizeof(unsigned int)*(1+size_t(numPolylines));
+		if(data.size()<headerSize)
+			return false;
+		numVertices.resize(numPolylines);
+		size_t totalNumVertices=0;
+		for(unsigned int i=0;i<numPolylines;++i,dPtr+=sizeof(unsigned int))
+			{
+			memcpy(&numVertices[i],dPtr,sizeof(unsigned int));
+			totalNumVertices+=numVertices[i];
+			}
+		if(data.size()!=headerSize+totalNumVertices*sizeof(VertexParam))
+			return false;
+		
+		/* Unpack the vertices: */
+		vertices.resize(totalNumVertices);
+		if(totalNumVertices>0)
+			memcpy(&vertices[0],dPtr,totalNumVertices*sizeof(VertexParam));
+		return true;
+		}
+	template <class VertexParam>
+	void store(const Key& key,const std::vector<unsigned int>& numVertices,const std::vector<VertexParam>& vertices) // Stores the vertex counts and concatenated vertices of a set of polylines
+		{
+		/* Pack the polyline vertex counts and vertices: */
+		unsigned int numPolylines=(unsigned int)(numVertices.size());
+		std::vector<char> data(sizeof(unsigned int)*(1+size_t(numPolylines))+vertices.size()*sizeof(VertexParam));
+		char* dPtr=&data[0];
+		memcpy(dPtr,&numPolylines,sizeof(unsigned int));
+		dPtr+=sizeof(unsigned int);
+		if(numPolylines>0)
+			{
+			memcpy(dPtr,&numVertices[0],numPolylines*sizeof(unsigned int));
+			dPtr+=numPolylines*sizeof(unsigned int);
+			}
+		if(!vertices.empty())
+			memcpy(dPtr,&vertices[0],vertices.size()*sizeof(VertexParam));
+		storeData(key,data);
+		}
+	template <class VertexParam,class IndexParam,class StripLengthParam>
+	bool lookup(const Key& key,std::vector<StripLengthParam>& stripLengths,std::vector<IndexParam>& indices,std::vector<VertexParam>& vertices) // Retrieves the triangle strip lengths, vertex indices, and vertices of a surface; returns false on a cache miss
+		{
+		std::vector<char> data;
+		if(!lookupData(key,data)||data.size()<sizeof(unsigned int)*3)
+			return false;
+		
+		/* Unpack the array sizes: */
+		const char* dPtr=&data[0];
+		unsigned int sizes[3];
+		memcpy(sizes,dPtr,sizeof(sizes));
+		dPtr+=sizeof(sizes);
+		if(data.size()!=sizeof(sizes)+size_t(sizes[0])*sizeof(StripLengthParam)+size_t(sizes[1])*sizeof(IndexParam)+size_t(sizes[2])*sizeof(VertexParam))
+			return false;
+		
+		/* Unpack the arrays: */
+		stripLengths.resize(sizes[0]);
+		if(sizes[0]>0)
+			memcpy(&stripLengths[0],dPtr,size_t(sizes[0])*sizeof(StripLengthParam));
+		dPtr+=size_t(sizes[0])*sizeof(StripLengthParam);
+		indices.resize(sizes[1]);
+		if(sizes[1]>0)
+			memcpy(&indices[0],dPtr,size_t(sizes[1])*sizeof(IndexParam));
+		dPtr+=size_t(sizes[1])*sizeof(IndexParam);
+		vertices.resize(sizes[2]);
+		if(sizes[2]>0)
+			memcpy(&vertices[0],dPtr,size_t(sizes[2])*sizeof(VertexParam));
+		return true;
+		}
+	template <class VertexParam,class IndexParam,class StripLengthParam>
+	void store(const Key& key,const std::vector<StripLengthParam>& stripLengths,const std::vector<IndexParam>& indices,const std::vector<VertexParam>& vertices) // Stores the triangle strip lengths, vertex indices, and vertices of a surface
+		{
+		/* Pack the array sizes and arrays: */
+		unsigned int sizes[3];
+		sizes[0]=(unsigned int)(stripLengths.size());
+		sizes[1]=(unsigned int)(indices.size());
+		sizes[2]=(unsigned int)(vertices.size());
+		std::vector<char> data(sizeof(sizes)+stripLengths.size()*sizeof(StripLengthParam)+indices.size()*sizeof(IndexParam)+vertices.size()*sizeof(VertexParam));
+		char* dPtr=&data[0];
+		memcpy(dPtr,sizes,sizeof(sizes));
+		dPtr+=sizeof(sizes);
+		if(!stripLengths.empty())
+			memcpy(dPtr,&stripLengths[0],stripLengths.size()*sizeof(StripLengthParam));
+		dPtr+=stripLengths.size()*sizeof(StripLengthParam);
+		if(!indices.empty())
+			memcpy(dPtr,&indices[0],indices.size()*sizeof(IndexParam));
+		dPtr+=indices.size()*sizeof(IndexParam);
+		if(!vertices.empty())
+			memcpy(dPtr,&vertices[0],vertices.size()*sizeof(VertexParam));
+		storeData(key,data);
+		}
+	};
+
+}
+
+}
+
+#endif
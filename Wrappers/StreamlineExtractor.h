@@ -2,7 +2,7 @@
 StreamlineExtractor - Wrapper class to map from the abstract
 visualization algorithm interface to a templatized streamline extractor
 implementation.
-Copyright (c) 2006-2012 Oliver Kreylos
+Copyright (c) 2006-2017 Oliver Kreylos
 
 This file is part of the 3D Data Visualizer (Visualizer).
 
@@ -32,6 +32,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Abstract/Algorithm.h>
 
 #include <Wrappers/Streamline.h>
+#include <Wrappers/StreamlineCache.h>
 
 /* Forward declarations: */
 namespace Visualization {
@@ -81,6 +82,7 @@ class StreamlineExtractor:public Visualization::Abstract::Algorithm
 	typedef Visualization::Wrappers::Streamline<DataSetWrapper> Streamline; // Type of created visualization elements
 	typedef Misc::Autopointer<Streamline> StreamlinePointer; // Type for pointers to created visualization elements
 	typedef typename Streamline::Polyline Polyline; // Type of low-level streamline representation
+	typedef typename Polyline::Vertex Vertex; // Type of streamline vertices
 	typedef Visualization::Templatized::StreamlineExtractor<DS,VE,SE,Polyline> SLE; // Type of templatized streamline extractor
 	
 	private:
@@ -127,11 +129,17 @@ class StreamlineExtractor:public Visualization::Abstract::Algorithm
 	Parameters parameters; // The streamline extraction parameters used by this extractor
 	SLE sle; // The templatized streamline extractor
 	StreamlinePointer currentStreamline; // The currently extracted streamline visualization element
+	bool currentCached; // Flag whether the currently extracted streamline was retrieved from the streamline cache
 	
 	/* UI components: */
 	GLMotif::TextFieldSlider* maxNumVerticesSlider;
 	GLMotif::TextFieldSlider* epsilonSlider;
 	
+	/* Private methods: */
+	StreamlineCache::Key getCacheKey(const Parameters& extractParameters) const; // Returns the streamline cache key for the given extraction parameters
+	bool retrieveStreamline(const Parameters& extractParameters,Polyline& polyline) const; // Fills the given empty polyline from the streamline cache; returns false on a cache miss
+	void cacheStreamline(const Parameters& extractParameters,const Polyline& polyline) const; // Stores the given completely extracted polyline in the streamline cache
+	
 	/* Constructors and destructors: */
 	public:
 	StreamlineExtractor(Visualization::Abstract::VariableManager* sVariableManager,Cluster::MulticastPipe* sPipe); // Creates a streamline extractor
@@ -0,0 +1,75 @@
+/***********************************************************************
+TimeVaryingDataSet - Wrapper class to add a sequence of time steps to an
+arbitrary data set wrapper, which itself represents the first time step.
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_WRAPPERS_TIMEVARYINGDATASET_INCLUDED
+#define VISUALIZATION_WRAPPERS_TIMEVARYINGDATASET_INCLUDED
+
+#include <vector>
+
+#include <Templatized/TimeSeries.h>
+
+namespace Visualization {
+
+namespace Wrappers {
+
+template <class DataSetBaseParam>
+class TimeVaryingDataSet:public DataSetBaseParam // Data set class
+	{
+	/* Embedded classes: */
+	public:
+	typedef DataSetBaseParam DataSetBase; // Base class for data set wrapper class
+	typedef typename DataSetBase::DS DS; // Type of templatized data set
+	typedef typename DS::Scalar DSScalar; // Scalar type of templatized data set's domain, also used for simulation time
+	typedef Visualization::Templatized::TimeSeries<DS> TimeSeries; // Type of time series of templatized data sets
+	typedef typename TimeSeries::Loader Loader; // Type of objects loading individual time steps
+	
+	/* Elements: */
+	private:
+	Loader* loader; // Object loading the time steps of the data set
+	std::vector<DSScalar> times; // Simulation times of all time steps in increasing order
+	
+	/* Constructors and destructors: */
+	public:
+	TimeVaryingDataSet(Loader* sLoader,const std::vector<DSScalar>& sTimes); // Creates a time-varying data set with the given time step loader and time step times; adopts loader
+	virtual ~TimeVaryingDataSet(void);
+	
+	/* New methods: */
+	unsigned int getNumTimeSteps(void) const // Returns the number of time steps
+		{
+		return (unsigned int)(times.size());
+		}
+	DSScalar getTime(unsigned int timeStepIndex) const // Returns the simulation time of the given time step
+		{
+		return times[timeStepIndex];
+		}
+	TimeSeries* createTimeSeries(unsigned int windowSize =3) const; // Returns a new time series loading the data set's time steps in a sliding window of the given size
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_WRAPPERS_TIMEVARYINGDATASET_IMPLEMENTATION
+#include <Wrappers/TimeVaryingDataSet.icpp>
+#endif
+
+#endif
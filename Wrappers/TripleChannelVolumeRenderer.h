@@ -80,6 +80,7 @@ class TripleChannelVolumeRenderer:public Visualization::Abstract::Element
 	void sliceFactorCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
 	void channelEnabledCallback(GLMotif::ToggleButton::ValueChangedCallbackData* cbData);
 	void transparencyGammaCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
+	void preintegratedCallback(GLMotif::ToggleButton::ValueChangedCallbackData* cbData);
 	};
 
 }
@@ -25,6 +25,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef VISUALIZATION_WRAPPERS_VOLUMERENDERER_INCLUDED
 #define VISUALIZATION_WRAPPERS_VOLUMERENDERER_INCLUDED
 
+#include <GLMotif/ToggleButton.h>
 #include <GLMotif/TextFieldSlider.h>
 
 #include <Abstract/Element.h>
@@ -86,6 +87,9 @@ class VolumeRenderer:public Visualization::Abstract::Element
 	/* New methods: */
 	void sliceFactorCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
 	void transparencyGammaCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
+	#ifdef VISUALIZATION_USE_SHADERS
+	void preintegratedCallback(GLMotif::ToggleButton::ValueChangedCallbackData* cbData);
+	#endif
 	};
 
 }
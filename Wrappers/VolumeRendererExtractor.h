@@ -25,6 +25,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #define VISUALIZATION_WRAPPERS_VOLUMERENDEREREXTRACTOR_INCLUDED
 
 #include <Misc/Autopointer.h>
+#include <GLMotif/ToggleButton.h>
 #include <GLMotif/TextFieldSlider.h>
 
 #include <Abstract/DataSet.h>
@@ -78,6 +79,7 @@ class VolumeRendererExtractor:public Visualization::Abstract::Algorithm
 		VScalar outOfDomainValue; // Value to assign to volume renderer voxels that are outside the data set's domain
 		Scalar sliceFactor; // Slice distance for texture- or raycasting-based volume rendering
 		float transparencyGamma; // Overall transparency adjustment factor
+		bool adaptive; // Flag whether to adapt the volume renderer's local resolution to the data set's local cell size
 		
 		/* Constructors and destructors: */
 		public:
@@ -104,6 +106,7 @@ class VolumeRendererExtractor:public Visualization::Abstract::Algorithm
 	static const char* name; // Identifying name of this algorithm
 	Parameters parameters; // The volume renderer extraction parameters used by this extractor
 	GLMotif::TextFieldSlider* outOfDomainValueSlider;
+	GLMotif::ToggleButton* adaptiveToggle;
 	
 	/* Constructors and destructors: */
 	public:
@@ -134,6 +137,7 @@ class VolumeRendererExtractor:public Visualization::Abstract::Algorithm
 		return name;
 		}
 	void outOfDomainValueCallback(GLMotif::TextFieldSlider::ValueChangedCallbackData* cbData);
+	void adaptiveToggleCallback(GLMotif::ToggleButton::ValueChangedCallbackData* cbData);
 	};
 
 }
@@ -0,0 +1,135 @@
+/***********************************************************************
+Fragment shader for GPU-based single-channel raycasting of bricked
+volumes held in a texture memory brick cache
+Copyright (c) 2017 Oliver Kreylos
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+uniform vec3 mcScale;
+uniform sampler2D depthSampler;
+uniform mat4 depthMatrix;
+uniform vec2 depthSize;
+uniform vec3 eyePosition;
+uniform float stepSize;
+uniform sampler3D volumeSampler;
+uniform sampler1D colorMapSampler;
+uniform bool preintegrated;
+uniform sampler2D preintegratedSampler;
+uniform sampler3D brickTableSampler;
+uniform vec3 brickTableScale;
+uniform vec3 numBricks;
+uniform float brickStep;
+uniform float subSlotSize;
+uniform vec3 atlasScale;
+
+varying vec3 mcPosition;
+varying vec3 dcPosition;
+
+float sampleVolume(vec3 dcPos)
+	{
+	/* Find the brick containing the sample position in voxel index space: */
+	vec3 brick=clamp(floor(dcPos/brickStep),vec3(0.0),numBricks-vec3(1.0));
+	
+	/* Look up the brick's sub-slot and resolution level in the brick cache; bricks that are not resident are treated as empty: */
+	vec4 entry=texture3D(brickTableSampler,(brick+vec3(0.5))*brickTableScale);
+	if(entry.a<0.5)
+		return -1.0;
+	vec3 slot=floor(entry.rgb*255.0+vec3(0.5));
+	float level=floor((1.0-entry.a)*255.0+0.5);
+	
+	/* Scale the position inside the brick to the brick's resolution level: */
+	float levelScale=floor(brickStep/exp2(level))/brickStep;
+	
+	/* Sample the brick cache inside the sub-slot's one-voxel border at voxel centers; the brick's overlap voxels make interpolation seamless across brick boundaries: */
+	vec3 local=clamp(dcPos-brick*brickStep,vec3(0.0),vec3(brickStep))*levelScale;
+	return texture3D(volumeSampler,(slot*subSlotSize+local+vec3(1.5))*atlasScale).a;
+	}
+
+void main()
+	{
+	/* Calculate the ray direction in model coordinates: */
+	vec3 mcDir=mcPosition-eyePosition;
+	
+	/* Get the distance from the eye to the ray starting point: */
+	float eyeDist=length(mcDir);
+	
+	/* Normalize and multiply the ray direction with the current step size: */
+	mcDir=normalize(mcDir);
+	mcDir*=stepSize;
+	eyeDist/=stepSize;
+	
+	/* Get the fragment's ray termination depth from the depth texture: */
+	float termDepth=2.0*texture2D(depthSampler,gl_FragCoord.xy/depthSize).x-1.0;
+	
+	/* Calculate the maximum number of steps based on the termination depth: */
+	vec4 cc1=depthMatrix*vec4(mcPosition,1.0);
+	vec4 cc2=depthMatrix*vec4(mcDir,0.0);
+	float lambdaMax=-(termDepth*cc1.w-cc1.z)/(termDepth*cc2.w-cc2.z);
+	
+	/* Convert the ray direction to data coordinates: */
+	vec3 dcDir=mcDir*mcScale;
+	
+	/* Cast the ray and accumulate opacities and colors: */
+	vec4 accum=vec4(0.0,0.0,0.0,0.0);
+	
+	/* Move the ray starting position forward to an integer multiple of the step size: */
+	vec3 samplePos=dcPosition;
+	float lambda=ceil(eyeDist)-eyeDist;
+	if(lambda<lambdaMax)
+		{
+		samplePos+=dcDir*lambda;
+		float frontValue=sampleVolume(samplePos);
+		for(int i=0;i<1500;++i)
+			{
+			vec4 vol;
+			if(preintegrated)
+				{
+				/* Look up the pre-integrated color and opacity of the ray segment to the next sample position: */
+				float backValue=sampleVolume(samplePos+dcDir);
+				if(frontValue>=0.0&&backValue>=0.0)
+					vol=texture2D(preintegratedSampler,vec2(frontValue,backValue));
+				else
+					vol=vec4(0.0,0.0,0.0,0.0);
+				frontValue=backValue;
+				}
+			else
+				{
+				/* Get the volume data value at the current sample position: */
+				float value=sampleVolume(samplePos);
+				if(value>=0.0)
+					vol=texture1D(colorMapSampler,value);
+				else
+					vol=vec4(0.0,0.0,0.0,0.0);
+				}
+			
+			/* Accumulate color and opacity: */
+			accum+=vol*(1.0-accum.a);
+			
+			/* Bail out when opacity hits 1.0: */
+			if(accum.a>=1.0-1.0/256.0||lambda>=lambdaMax)
+				break;
+			
+			/* Advance the sample position: */
+			samplePos+=dcDir;
+			lambda+=1.0;
+			}
+		}
+	
+	/* Assign the final color value: */
+	gl_FragColor=accum;
+	}
@@ -27,6 +27,8 @@ uniform vec3 eyePosition;
 uniform float stepSize;
 uniform sampler3D volumeSampler;
 uniform sampler1D colorMapSampler;
+uniform bool preintegrated;
+uniform sampler2D preintegratedSampler;
 
 varying vec3 mcPosition;
 varying vec3 dcPosition;
@@ -64,10 +66,22 @@ void main()
 	if(lambda<lambdaMax)
 		{
 		samplePos+=dcDir*lambda;
+		float frontValue=texture3D(volumeSampler,samplePos).a;
 		for(int i=0;i<1500;++i)
 			{
-			/* Get the volume data value at the current sample position: */
-			vec4 vol=texture1D(colorMapSampler,texture3D(volumeSampler,samplePos).a);
+			vec4 vol;
+			if(preintegrated)
+				{
+				/* Look up the pre-integrated color and opacity of the ray segment to the next sample position: */
+				float backValue=texture3D(volumeSampler,samplePos+dcDir).a;
+				vol=texture2D(preintegratedSampler,vec2(frontValue,backValue));
+				frontValue=backValue;
+				}
+			else
+				{
+				/* Get the volume data value at the current sample position: */
+				vol=texture1D(colorMapSampler,texture3D(volumeSampler,samplePos).a);
+				}
 			
 			/* Accumulate color and opacity: */
 			accum+=vol*(1.0-accum.a);
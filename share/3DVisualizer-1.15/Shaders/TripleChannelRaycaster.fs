@@ -28,6 +28,8 @@ uniform float stepSize;
 uniform sampler3D volumeSampler;
 uniform bool channelEnableds[3];
 uniform sampler1D colorMapSamplers[3];
+uniform bool preintegrated;
+uniform sampler2D preintegratedSamplers[3];
 
 varying vec3 mcPosition;
 varying vec3 dcPosition;
@@ -65,19 +67,37 @@ void main()
 	if(lambda<lambdaMax)
 		{
 		samplePos+=dcDir*lambda;
+		vec3 frontData=texture3D(volumeSampler,samplePos).rgb;
 		for(int i=0;i<1500;++i)
 			{
-			/* Get the volume data value at the current sample position: */
-			vec3 data=texture3D(volumeSampler,samplePos);
-			
-			/* Apply the three transfer functions: */
 			vec4 vol=vec4(0.0,0.0,0.0,0.0);
-			if(channelEnableds[0])
-				vol+=texture1D(colorMapSamplers[0],data.r);
-			if(channelEnableds[1])
-				vol+=texture1D(colorMapSamplers[1],data.g);
-			if(channelEnableds[2])
-				vol+=texture1D(colorMapSamplers[2],data.b);
+			if(preintegrated)
+				{
+				/* Get the volume data value at the next sample position: */
+				vec3 backData=texture3D(volumeSampler,samplePos+dcDir).rgb;
+				
+				/* Apply the three pre-integrated transfer functions to the ray segment: */
+				if(channelEnableds[0])
+					vol+=texture2D(preintegratedSamplers[0],vec2(frontData.r,backData.r));
+				if(channelEnableds[1])
+					vol+=texture2D(preintegratedSamplers[1],vec2(frontData.g,backData.g));
+				if(channelEnableds[2])
+					vol+=texture2D(preintegratedSamplers[2],vec2(frontData.b,backData.b));
+				frontData=backData;
+				}
+			else
+				{
+				/* Get the volume data value at the current sample position: */
+				vec3 data=texture3D(volumeSampler,samplePos).rgb;
+				
+				/* Apply the three transfer functions: */
+				if(channelEnableds[0])
+					vol+=texture1D(colorMapSamplers[0],data.r);
+				if(channelEnableds[1])
+					vol+=texture1D(colorMapSamplers[1],data.g);
+				if(channelEnableds[2])
+					vol+=texture1D(colorMapSamplers[2],data.b);
+				}
 			
 			/* Limit sample's opacity to [0.0, 1.0] range: */
 			vol.a=clamp(vol.a,0.0,1.0);